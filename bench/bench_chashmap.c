@@ -0,0 +1,92 @@
+/**
+ * @file bench_chashmap.c
+ * @brief Read scaling of ConcurrentHashMap against a mutex-wrapped HashMap
+ * 
+ * Each thread performs random lookups over a pre-filled map. With one
+ * global mutex the total rate stays flat or drops as threads are added;
+ * with per-shard reader-writer locks it should grow with core count.
+ */
+
+#include <cyan/option.h>
+#include <cyan/hashmap.h>
+#include <cyan/concurrent_hashmap.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+OPTION_DEFINE(u64);
+HASHMAP_DEFINE_SCALAR(u64, u64);
+CONCURRENT_HASHMAP_DEFINE(u64, u64);
+
+#define NUM_KEYS (1u << 16)
+#define LOOKUPS_PER_THREAD (2u << 20)
+#define MAX_THREADS 16
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static HashMap_u64_u64 g_plain;
+static pthread_mutex_t g_plain_lock = PTHREAD_MUTEX_INITIALIZER;
+static ConcurrentHashMap_u64_u64 g_sharded;
+
+/* Sink to keep the compiler from discarding lookups */
+static volatile u64 g_sink;
+
+static void *read_plain(void *arg) {
+    u64 x = (u64)(uintptr_t)arg * 0x9E3779B97F4A7C15ull + 1;
+    u64 sum = 0;
+    for (u32 i = 0; i < LOOKUPS_PER_THREAD; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        pthread_mutex_lock(&g_plain_lock);
+        Option_u64 v = hashmap_u64_u64_get(&g_plain, x % NUM_KEYS);
+        pthread_mutex_unlock(&g_plain_lock);
+        sum += v.value;
+    }
+    g_sink = sum;
+    return NULL;
+}
+
+static void *read_sharded(void *arg) {
+    u64 x = (u64)(uintptr_t)arg * 0x9E3779B97F4A7C15ull + 1;
+    u64 sum = 0;
+    for (u32 i = 0; i < LOOKUPS_PER_THREAD; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        sum += chashmap_u64_u64_get(&g_sharded, x % NUM_KEYS).value;
+    }
+    g_sink = sum;
+    return NULL;
+}
+
+/* Run fn on n threads and return total lookups per second */
+static double run(void *(*fn)(void *), int n) {
+    pthread_t threads[MAX_THREADS];
+    double t0 = now_sec();
+    for (int i = 0; i < n; i++) pthread_create(&threads[i], NULL, fn, (void *)(uintptr_t)(i + 1));
+    for (int i = 0; i < n; i++) pthread_join(threads[i], NULL);
+    return (double)n * LOOKUPS_PER_THREAD / (now_sec() - t0);
+}
+
+int main(void) {
+    g_plain = hashmap_u64_u64_with_capacity(NUM_KEYS);
+    g_sharded = chashmap_u64_u64_new();
+    for (u64 k = 0; k < NUM_KEYS; k++) {
+        hashmap_u64_u64_insert(&g_plain, k, k);
+        chashmap_u64_u64_insert(&g_sharded, k, k);
+    }
+    
+    printf("Read throughput (M lookups/s, %u keys, %d shards):\n",
+           NUM_KEYS, CYAN_CONCURRENT_HASHMAP_SHARDS);
+    printf("  %-8s %14s %14s\n", "threads", "mutex+HashMap", "Concurrent");
+    for (int n = 1; n <= MAX_THREADS; n *= 2) {
+        double plain = run(read_plain, n);
+        double sharded = run(read_sharded, n);
+        printf("  %-8d %14.1f %14.1f\n", n, plain / 1e6, sharded / 1e6);
+    }
+    
+    hashmap_u64_u64_free(&g_plain);
+    chashmap_u64_u64_free(&g_sharded);
+    return 0;
+}
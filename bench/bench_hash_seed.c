@@ -0,0 +1,71 @@
+/**
+ * @file bench_hash_seed.c
+ * @brief Probe lengths under a collision attack, with and without seeding
+ *
+ * Brute-forces keys whose unseeded FNV-1a hashes share their low bits, as
+ * an attacker who knows the hash function can do offline, then inserts
+ * them into a map using that fixed hash and into a default (seeded) map.
+ * Every key lands in the same home slot of the fixed-hash map, so probe
+ * lengths and insert time grow with the number of keys; the seeded map
+ * scatters the same keys like any others.
+ */
+
+#include <cyan/option.h>
+#include <cyan/hash.h>
+#include <cyan/hashmap.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+OPTION_DEFINE(u64);
+HASHMAP_DEFINE(u64, u64);
+
+#define NUM_KEYS 8192
+#define COLLIDE_BITS 14     /* Home slot collides in every table up to 2^14 slots */
+
+static u64 now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+}
+
+static void run(const char *name, HashMap_u64_u64 m, const u64 *keys) {
+    u64 start = now_ns();
+    for (u32 i = 0; i < NUM_KEYS; i++) hashmap_u64_u64_insert(&m, keys[i], i);
+    double insert_ms = (double)(now_ns() - start) / 1e6;
+
+    start = now_ns();
+    u64 sum = 0;
+    for (u32 i = 0; i < NUM_KEYS; i++) sum += hashmap_u64_u64_get(&m, keys[i]).value;
+    double lookup_ms = (double)(now_ns() - start) / 1e6;
+
+    HashMapStats st = hashmap_u64_u64_stats(&m);
+    printf("  %-20s %10.2f %10.2f %10zu %10.1f  (sum %llu)\n", name, insert_ms, lookup_ms,
+           st.max_probe, st.mean_probe, (unsigned long long)sum);
+
+    hashmap_u64_u64_free(&m);
+}
+
+int main(void) {
+    u64 *keys = malloc(NUM_KEYS * sizeof(u64));
+    if (!keys) return 1;
+
+    /* The attacker's offline search: keep keys whose low hash bits are zero */
+    const size_t mask = ((size_t)1 << COLLIDE_BITS) - 1;
+    u64 start = now_ns();
+    u32 n = 0;
+    for (u64 k = 0; n < NUM_KEYS; k++) {
+        if ((_cyan_fnv1a_hash(&k, sizeof(k)) & mask) == 0) keys[n++] = k;
+    }
+    printf("Found %d colliding keys in %.0f ms\n\n", NUM_KEYS, (double)(now_ns() - start) / 1e6);
+
+    printf("  %-20s %10s %10s %10s %10s\n", "map", "insert ms", "lookup ms", "max probe", "mean");
+
+    HashMap_u64_u64 fixed = hashmap_u64_u64_new();
+    fixed.hash_fn = _cyan_fnv1a_hash;
+    run("fnv1a, unseeded", fixed, keys);
+    run("wyhash, seeded", hashmap_u64_u64_new(), keys);
+
+    free(keys);
+    return 0;
+}
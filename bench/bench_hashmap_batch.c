@@ -0,0 +1,73 @@
+/**
+ * @file bench_hashmap_batch.c
+ * @brief Random lookups one at a time vs hashmap_K_V_get_batch
+ * 
+ * Probes maps from cache-resident to far larger than the last-level cache
+ * with uniformly random keys, half of them present. Once the table spills
+ * out of cache each lookup costs a memory round trip; the batch API
+ * prefetches a group of buckets so those round trips overlap.
+ */
+
+#include <cyan/option.h>
+#include <cyan/hashmap.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+OPTION_DEFINE(u64);
+HASHMAP_DEFINE_SCALAR(u64, u64);
+
+#define NUM_QUERIES (4u << 20)
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Sink to keep the compiler from discarding lookups */
+static volatile u64 g_sink;
+
+int main(void) {
+    u64 *queries = malloc(NUM_QUERIES * sizeof(u64));
+    u64 *out = malloc(NUM_QUERIES * sizeof(u64));
+    bool *found = malloc(NUM_QUERIES * sizeof(bool));
+    if (!queries || !out || !found) return 1;
+    
+    printf("Random lookups (ns/key):\n");
+    printf("  %-10s %10s %10s %10s\n", "entries", "get", "get_batch", "speedup");
+    
+    for (u64 entries = 1u << 12; entries <= (16u << 20); entries <<= 2) {
+        HashMap_u64_u64 m = hashmap_u64_u64_with_capacity(entries * 2);
+        for (u64 k = 0; k < entries; k++) hashmap_u64_u64_insert(&m, k * 2, k);
+        
+        u64 x = 0x9E3779B97F4A7C15ull;
+        for (u32 i = 0; i < NUM_QUERIES; i++) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            queries[i] = x % (entries * 2);
+        }
+        
+        double t0 = now_sec();
+        u64 sum = 0;
+        for (u32 i = 0; i < NUM_QUERIES; i++) {
+            Option_u64 v = hashmap_u64_u64_get(&m, queries[i]);
+            if (v.has_value) sum += v.value;
+        }
+        double single = (now_sec() - t0) * 1e9 / NUM_QUERIES;
+        g_sink = sum;
+        
+        t0 = now_sec();
+        hashmap_u64_u64_get_batch(&m, queries, NUM_QUERIES, out, found);
+        double batch = (now_sec() - t0) * 1e9 / NUM_QUERIES;
+        g_sink = out[NUM_QUERIES / 2];
+        
+        printf("  %-10llu %10.1f %10.1f %9.2fx\n",
+               (unsigned long long)entries, single, batch, single / batch);
+        hashmap_u64_u64_free(&m);
+    }
+    
+    free(queries);
+    free(out);
+    free(found);
+    return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file bench_hashmap_mmap.c
+ * @brief Startup cost: rebuilding a HashMap vs mapping a saved snapshot
+ * 
+ * Builds a large map by inserting every entry, saves it, then measures how
+ * long it takes before the first lookups can be answered: by inserting all
+ * entries again, or by open_mmap on the snapshot. The mapped case also
+ * times a burst of random lookups, which fault pages in from the page cache.
+ */
+
+#include <cyan/option.h>
+#include <cyan/result.h>
+#include <cyan/hashmap.h>
+#include <cyan/hashmap_mmap.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+OPTION_DEFINE(u64);
+HASHMAP_DEFINE_SCALAR(u64, u64);
+HASHMAP_MMAP_DEFINE(u64, u64);
+
+#define NUM_ENTRIES (8u << 20)
+#define NUM_LOOKUPS (1u << 20)
+#define SNAPSHOT_PATH "/tmp/cyan_bench_snapshot.map"
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Sink to keep the compiler from discarding lookups */
+static volatile u64 g_sink;
+
+static u64 lookups(HashMap_u64_u64 *m) {
+    u64 x = 0x9E3779B97F4A7C15ull, sum = 0;
+    for (u32 i = 0; i < NUM_LOOKUPS; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        Option_u64 v = hashmap_u64_u64_get(m, x % NUM_ENTRIES);
+        if (v.has_value) sum += v.value;
+    }
+    return sum;
+}
+
+int main(void) {
+    double t0 = now_sec();
+    HashMap_u64_u64 m = hashmap_u64_u64_new();
+    for (u64 k = 0; k < NUM_ENTRIES; k++) hashmap_u64_u64_insert(&m, k, k * 3);
+    double build = now_sec() - t0;
+    
+    t0 = now_sec();
+    Result_size_t_MapFileError saved = hashmap_u64_u64_save(&m, SNAPSHOT_PATH);
+    double save = now_sec() - t0;
+    if (!is_ok(saved)) {
+        fprintf(stderr, "save failed: %s\n", unwrap_err(saved));
+        return 1;
+    }
+    
+    t0 = now_sec();
+    g_sink = lookups(&m);
+    double warm = now_sec() - t0;
+    hashmap_u64_u64_free(&m);
+    
+    t0 = now_sec();
+    Result_HashMap_u64_u64_MapFileError r = hashmap_u64_u64_open_mmap(SNAPSHOT_PATH);
+    double open = now_sec() - t0;
+    if (!is_ok(r)) {
+        fprintf(stderr, "open failed: %s\n", unwrap_err(r));
+        return 1;
+    }
+    HashMap_u64_u64 mapped = unwrap_ok(r);
+    
+    t0 = now_sec();
+    g_sink = lookups(&mapped);
+    double cold = now_sec() - t0;
+    
+    printf("%u entries, snapshot %.0f MB:\n", NUM_ENTRIES, (double)unwrap_ok(saved) / 1e6);
+    printf("  rebuild by insert     %9.1f ms\n", build * 1e3);
+    printf("  save                  %9.1f ms\n", save * 1e3);
+    printf("  open_mmap             %9.3f ms\n", open * 1e3);
+    printf("  %u lookups, heap   %9.1f ms\n", NUM_LOOKUPS, warm * 1e3);
+    printf("  %u lookups, mapped %9.1f ms (first touch)\n", NUM_LOOKUPS, cold * 1e3);
+    
+    hashmap_u64_u64_close_mmap(&mapped);
+    remove(SNAPSHOT_PATH);
+    return 0;
+}
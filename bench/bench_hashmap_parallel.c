@@ -0,0 +1,68 @@
+/**
+ * @file bench_hashmap_parallel.c
+ * @brief Bulk map construction: insert loop vs from_slices_parallel
+ * 
+ * Builds a map from random key and value arrays by inserting one pair at
+ * a time, then with from_slices_parallel at growing thread counts. The
+ * parallel build sizes the table once, so even on one thread it skips the
+ * intermediate resizes; beyond that it should scale with core count.
+ */
+
+#include <cyan/option.h>
+#include <cyan/hashmap.h>
+#include <cyan/hashmap_parallel.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+OPTION_DEFINE(u64);
+HASHMAP_DEFINE_SCALAR(u64, u64);
+HASHMAP_PARALLEL_DEFINE(u64, u64);
+
+#define NUM_PAIRS (1u << 24)
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static u64 xorshift(u64 *x) {
+    *x ^= *x << 13; *x ^= *x >> 7; *x ^= *x << 17;
+    return *x;
+}
+
+int main(void) {
+    u64 *keys = malloc(NUM_PAIRS * sizeof(u64));
+    u64 *values = malloc(NUM_PAIRS * sizeof(u64));
+    if (!keys || !values) return 1;
+    u64 x = 0x9E3779B97F4A7C15ull;
+    for (u32 i = 0; i < NUM_PAIRS; i++) {
+        keys[i] = xorshift(&x);
+        values[i] = i;
+    }
+    
+    printf("Build a map from %u pairs (%ld CPUs online):\n", NUM_PAIRS, sysconf(_SC_NPROCESSORS_ONLN));
+    printf("  %-16s %10s %10s\n", "method", "seconds", "Mpairs/s");
+    
+    double t0 = now_sec();
+    HashMap_u64_u64 m = hashmap_u64_u64_new();
+    for (u32 i = 0; i < NUM_PAIRS; i++) hashmap_u64_u64_insert(&m, keys[i], values[i]);
+    double secs = now_sec() - t0;
+    printf("  %-16s %10.3f %10.1f\n", "insert loop", secs, NUM_PAIRS / secs / 1e6);
+    hashmap_u64_u64_free(&m);
+    
+    for (size_t threads = 1; threads <= 16; threads *= 2) {
+        t0 = now_sec();
+        m = hashmap_u64_u64_from_slices_parallel(keys, values, NUM_PAIRS, threads);
+        secs = now_sec() - t0;
+        char label[32];
+        snprintf(label, sizeof(label), "parallel x%zu", threads);
+        printf("  %-16s %10.3f %10.1f  (len %zu)\n", label, secs, NUM_PAIRS / secs / 1e6, hashmap_u64_u64_len(&m));
+        hashmap_u64_u64_free(&m);
+    }
+    
+    free(values);
+    free(keys);
+    return 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file bench_hashmap_resize.c
+ * @brief Insert tail latency with stop-the-world vs incremental resizing
+ * 
+ * Times every single insert while growing a map from empty and reports
+ * latency percentiles. A regular map pays for each doubling inside one
+ * insert, so its maximum grows with the map; an incremental map spreads
+ * the rehash over later operations and keeps the tail flat.
+ */
+
+#include <cyan/option.h>
+#include <cyan/hashmap.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+OPTION_DEFINE(u64);
+HASHMAP_DEFINE_SCALAR(u64, u64);
+
+#define NUM_INSERTS (8u << 20)
+
+static u64 now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    u64 x = *(const u64 *)a, y = *(const u64 *)b;
+    return (x > y) - (x < y);
+}
+
+static void run(const char *name, bool incremental, u64 *lat) {
+    HashMap_u64_u64 m = hashmap_u64_u64_new();
+    hashmap_u64_u64_set_incremental(&m, incremental);
+    
+    u64 x = 0x243F6A8885A308D3ull;
+    u64 start = now_ns();
+    for (u32 i = 0; i < NUM_INSERTS; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        u64 t0 = now_ns();
+        hashmap_u64_u64_insert(&m, x, i);
+        lat[i] = now_ns() - t0;
+    }
+    double total_ms = (double)(now_ns() - start) / 1e6;
+    
+    qsort(lat, NUM_INSERTS, sizeof(u64), cmp_u64);
+    printf("  %-12s %8.0f %8llu %8llu %8llu %10llu\n", name, total_ms,
+           (unsigned long long)lat[NUM_INSERTS / 2],
+           (unsigned long long)lat[(u64)NUM_INSERTS * 999 / 1000],
+           (unsigned long long)lat[(u64)NUM_INSERTS * 99999 / 100000],
+           (unsigned long long)lat[NUM_INSERTS - 1]);
+    
+    hashmap_u64_u64_free(&m);
+}
+
+int main(void) {
+    u64 *lat = malloc(NUM_INSERTS * sizeof(u64));
+    if (!lat) return 1;
+    
+    printf("Insert latency (%u inserts, ns; total in ms):\n", NUM_INSERTS);
+    printf("  %-12s %8s %8s %8s %8s %10s\n", "mode", "total", "p50", "p99.9", "p99.999", "max");
+    run("regular", false, lat);
+    run("incremental", true, lat);
+    
+    free(lat);
+    return 0;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file bench_indexmap_iter.c
+ * @brief Full iteration of HashMap vs IndexMap after deletions
+ * 
+ * Fills both maps, removes a growing share of the keys, then sums every
+ * value. HashMap walks all of its buckets, so its cost follows capacity;
+ * IndexMap walks a dense entry array, so its cost follows len.
+ */
+
+#include <cyan/option.h>
+#include <cyan/hashmap.h>
+#include <cyan/indexmap.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+OPTION_DEFINE(u64);
+HASHMAP_DEFINE_SCALAR(u64, u64);
+HASHMAP_ITER_DEFINE(u64, u64);
+INDEXMAP_DEFINE_SCALAR(u64, u64);
+
+#define NUM_ENTRIES (1u << 20)
+#define PASSES 20
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Sink to keep the compiler from discarding sums */
+static volatile u64 g_sink;
+
+int main(void) {
+    printf("Iterate all entries (%u inserted, ns/live entry):\n", NUM_ENTRIES);
+    printf("  %-10s %10s %10s %10s\n", "removed", "hashmap", "indexmap", "speedup");
+    
+    for (u32 removed_pct = 0; removed_pct <= 90; removed_pct += 30) {
+        HashMap_u64_u64 hm = hashmap_u64_u64_new();
+        IndexMap_u64_u64 im = indexmap_u64_u64_new();
+        for (u64 k = 0; k < NUM_ENTRIES; k++) {
+            hashmap_u64_u64_insert(&hm, k, k);
+            indexmap_u64_u64_insert(&im, k, k);
+        }
+        for (u64 k = 0; k < NUM_ENTRIES; k++) {
+            if (k % 100 < removed_pct) {
+                hashmap_u64_u64_remove(&hm, k);
+                indexmap_u64_u64_swap_remove(&im, k);
+            }
+        }
+        size_t live = hashmap_u64_u64_len(&hm);
+        
+        double t0 = now_sec();
+        u64 sum = 0;
+        for (int p = 0; p < PASSES; p++) {
+            HashMapIter_u64_u64 it = hashmap_u64_u64_iter(&hm);
+            Option_MapPair_u64_u64 e;
+            while ((e = hashmap_u64_u64_iter_next(&it)).has_value) sum += e.value.value;
+        }
+        double hash_ns = (now_sec() - t0) * 1e9 / ((double)live * PASSES);
+        g_sink = sum;
+        
+        t0 = now_sec();
+        sum = 0;
+        for (int p = 0; p < PASSES; p++) {
+            Slice_IndexMapEntry_u64_u64 all = indexmap_u64_u64_entries(&im);
+            for (size_t i = 0; i < all.len; i++) sum += all.data[i].value;
+        }
+        double index_ns = (now_sec() - t0) * 1e9 / ((double)live * PASSES);
+        g_sink = sum;
+        
+        printf("  %8u%% %10.2f %10.2f %9.2fx\n", removed_pct, hash_ns, index_ns, hash_ns / index_ns);
+        hashmap_u64_u64_free(&hm);
+        indexmap_u64_u64_free(&im);
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file bench_intern.c
+ * @brief Symbol tables: string-keyed StrMap vs interned atoms
+ *
+ * Models a compiler front end: a token stream of identifiers drawn from a
+ * fixed vocabulary is resolved against a symbol table many times. The
+ * string version hashes and compares the identifier bytes on every lookup
+ * (StrMap); the atom version interns each token once, then looks atoms up
+ * in an ATOM_HASHMAP that hashes by the stored hash and compares pointers.
+ * Also times interning itself from 1..N threads into one interner.
+ */
+
+#include <cyan/strmap.h>
+#include <cyan/intern.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+OPTION_DEFINE(u32);
+STRMAP_DEFINE(u32);
+ATOM_HASHMAP_DEFINE(u32);
+
+#define VOCAB 20000
+#define TOKENS 2000000
+#define PASSES 5
+#define MAX_THREADS 8
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Sink to keep the compiler from discarding results */
+static volatile size_t g_sink;
+
+static char g_words[VOCAB][32];
+static const char *g_tokens[TOKENS];
+
+/* Identifiers share long prefixes, as in real code */
+static void make_tokens(void) {
+    static const char *prefixes[] = { "request_", "handle_connection_", "m_", "CYAN_INTERNAL_" };
+    u32 seed = 12345;
+    for (u32 i = 0; i < VOCAB; i++) {
+        snprintf(g_words[i], sizeof(g_words[i]), "%s%u", prefixes[i % 4], i);
+    }
+    for (u32 i = 0; i < TOKENS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        /* Skewed: most tokens hit a small set of hot identifiers */
+        u32 r = seed >> 8;
+        g_tokens[i] = g_words[(r & 3) ? r % 256 : r % VOCAB];
+    }
+}
+
+typedef struct {
+    Interner *in;
+    size_t from, to;
+} InternSpan;
+
+static void *intern_span(void *arg) {
+    InternSpan *s = (InternSpan *)arg;
+    size_t sum = 0;
+    for (size_t i = s->from; i < s->to; i++) sum += atom_len(interner_intern(s->in, g_tokens[i]));
+    g_sink += sum;
+    return NULL;
+}
+
+int main(void) {
+    make_tokens();
+
+    /* String-keyed symbol table */
+    StrMap_u32 by_name = strmap_u32_new();
+    for (u32 i = 0; i < VOCAB; i++) strmap_u32_insert(&by_name, g_words[i], i);
+    double t0 = now_sec();
+    size_t sum = 0;
+    for (int p = 0; p < PASSES; p++) {
+        for (size_t i = 0; i < TOKENS; i++) sum += strmap_u32_get(&by_name, g_tokens[i]).value;
+    }
+    double str_ns = (now_sec() - t0) * 1e9 / ((double)TOKENS * PASSES);
+
+    /* Atom-keyed symbol table: intern once, resolve by identity after */
+    Interner in = interner_new();
+    HashMap_Atom_u32 by_atom = hashmap_Atom_u32_new();
+    for (u32 i = 0; i < VOCAB; i++) hashmap_Atom_u32_insert(&by_atom, interner_intern(&in, g_words[i]), i);
+    t0 = now_sec();
+    Atom *atoms = (Atom *)malloc(TOKENS * sizeof(Atom));
+    for (size_t i = 0; i < TOKENS; i++) atoms[i] = interner_intern(&in, g_tokens[i]);
+    double intern_ns = (now_sec() - t0) * 1e9 / (double)TOKENS;
+    t0 = now_sec();
+    size_t sum2 = 0;
+    for (int p = 0; p < PASSES; p++) {
+        for (size_t i = 0; i < TOKENS; i++) sum2 += hashmap_Atom_u32_get(&by_atom, atoms[i]).value;
+    }
+    double atom_ns = (now_sec() - t0) * 1e9 / ((double)TOKENS * PASSES);
+    if (sum != sum2) {
+        fprintf(stderr, "mismatch: %zu vs %zu\n", sum, sum2);
+        return 1;
+    }
+    g_sink += sum;
+
+    /* Equality of adjacent tokens */
+    t0 = now_sec();
+    size_t eq = 0;
+    for (int p = 0; p < PASSES; p++) {
+        for (size_t i = 1; i < TOKENS; i++) eq += strcmp(g_tokens[i], g_tokens[i - 1]) == 0;
+    }
+    double strcmp_ns = (now_sec() - t0) * 1e9 / ((double)TOKENS * PASSES);
+    t0 = now_sec();
+    size_t eq2 = 0;
+    for (int p = 0; p < PASSES; p++) {
+        for (size_t i = 1; i < TOKENS; i++) eq2 += atom_eq(atoms[i], atoms[i - 1]);
+    }
+    double ptr_ns = (now_sec() - t0) * 1e9 / ((double)TOKENS * PASSES);
+    g_sink += eq + eq2;
+
+    printf("%u tokens over %u identifiers (ns/token):\n", TOKENS, VOCAB);
+    printf("  %-34s %8.1f\n", "StrMap lookup by name", str_ns);
+    printf("  %-34s %8.1f\n", "intern token (once)", intern_ns);
+    printf("  %-34s %8.1f\n", "ATOM_HASHMAP lookup by atom", atom_ns);
+    printf("  %-34s %8.2f\n", "strcmp equality", strcmp_ns);
+    printf("  %-34s %8.2f\n", "atom_eq equality", ptr_ns);
+
+    free(atoms);
+    hashmap_Atom_u32_free(&by_atom);
+    strmap_u32_free(&by_name);
+    interner_free(&in);
+
+    /* Interning throughput by thread count, into a fresh interner each run */
+    printf("\nConcurrent interning of all tokens (Mtokens/s):\n");
+    for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        Interner shared = interner_new();
+        pthread_t tid[MAX_THREADS];
+        InternSpan spans[MAX_THREADS];
+        t0 = now_sec();
+        for (int k = 0; k < threads; k++) {
+            spans[k] = (InternSpan){ &shared, (size_t)k * TOKENS / threads, (size_t)(k + 1) * TOKENS / threads };
+            pthread_create(&tid[k], NULL, intern_span, &spans[k]);
+        }
+        for (int k = 0; k < threads; k++) pthread_join(tid[k], NULL);
+        double s = now_sec() - t0;
+        printf("  %d thread%s %8.1f\n", threads, threads == 1 ? " " : "s", (double)TOKENS / s / 1e6);
+        interner_free(&shared);
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file bench_phf.c
+ * @brief Perfect-hash tables vs HashMap: build time, lookup throughput, footprint
+ *
+ * Freezes random key sets of several sizes into a PHF and looks up every
+ * key in shuffled order, next to a HashMap holding the same entries. A PHF
+ * lookup is one hash, one displacement read, one slot read and one
+ * compare; a HashMap lookup also scans a probe sequence. The PHF holds
+ * exactly len entries plus 2 bytes of displacements per key.
+ */
+
+#include <cyan/option.h>
+#include <cyan/hashmap.h>
+#include <cyan/phf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+OPTION_DEFINE(u64);
+HASHMAP_DEFINE(u64, u64);
+PHF_DEFINE(u64, u64);
+
+#define NUM_LOOKUPS (1u << 24)
+
+static u64 now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+}
+
+static u64 xorshift(u64 *x) {
+    *x ^= *x << 13; *x ^= *x >> 7; *x ^= *x << 17;
+    return *x;
+}
+
+static void run(u32 n) {
+    u64 *keys = malloc(n * sizeof(u64));
+    u64 *probes = malloc(NUM_LOOKUPS * sizeof(u64));
+    if (!keys || !probes) exit(1);
+    u64 x = 0x9E3779B97F4A7C15ull ^ n;
+    for (u32 i = 0; i < n; i++) keys[i] = xorshift(&x);
+    for (u32 i = 0; i < NUM_LOOKUPS; i++) probes[i] = keys[xorshift(&x) % n];
+
+    HashMap_u64_u64 m = hashmap_u64_u64_new();
+    for (u32 i = 0; i < n; i++) hashmap_u64_u64_insert(&m, keys[i], i);
+
+    u64 start = now_ns();
+    Result_Phf_u64_u64_PhfError r = phf_u64_u64_build(keys, keys, n);
+    double build_ms = (double)(now_ns() - start) / 1e6;
+    Phf_u64_u64 p = unwrap_ok(r);
+
+    u64 sum = 0;
+    start = now_ns();
+    for (u32 i = 0; i < NUM_LOOKUPS; i++) sum += hashmap_u64_u64_get(&m, probes[i]).value;
+    double map_secs = (double)(now_ns() - start) / 1e9;
+
+    start = now_ns();
+    for (u32 i = 0; i < NUM_LOOKUPS; i++) sum += phf_u64_u64_get(&p, probes[i]).value;
+    double phf_secs = (double)(now_ns() - start) / 1e9;
+
+    double map_mb = (double)m.capacity * _CYAN_MAP_SLOT_SIZE(_MapEntry_u64_u64, u64) / 1e6;
+    double phf_mb = (double)(p.len * sizeof(PhfEntry_u64_u64) + p.buckets * 2 * sizeof(u32)) / 1e6;
+    printf("  %10u %10.1f %12.1f %12.1f %10.2f %10.2f  (sum %llu)\n", n, build_ms,
+           NUM_LOOKUPS / map_secs / 1e6, NUM_LOOKUPS / phf_secs / 1e6, map_mb, phf_mb,
+           (unsigned long long)sum);
+
+    phf_u64_u64_free(&p);
+    hashmap_u64_u64_free(&m);
+    free(probes);
+    free(keys);
+}
+
+int main(void) {
+    printf("  %10s %10s %12s %12s %10s %10s\n", "keys", "build ms", "map Mops/s", "phf Mops/s", "map MB", "phf MB");
+    run(1000);
+    run(100000);
+    run(1000000);
+    run(4000000);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file bench_shared_string.c
+ * @brief Fan-out of one payload: deep copies vs SharedString clones
+ *
+ * Hands one payload to several consumers (a logger, a cache, a metrics
+ * sink, a forwarder), each of which keeps it for a while and then drops
+ * it. The copy version gives each consumer string_from(string_cstr(...));
+ * the shared version gives each a shared_string_clone of one SharedString,
+ * and the forwarder takes a substring view of the body instead of copying
+ * it. Also times shared_string_into_string for the last owner, which
+ * reuses the allocation.
+ */
+
+#include <cyan/string.h>
+#include <cyan/shared_string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define CONSUMERS 4
+#define MESSAGES 200000
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Sink to keep the compiler from discarding results */
+static volatile size_t g_sink;
+
+int main(void) {
+    static const size_t sizes[] = { 64, 1024, 16384, 262144 };
+    printf("%-12s %14s %14s %9s %14s\n", "payload", "copy ns/msg", "shared ns/msg", "speedup",
+           "into_string ns");
+
+    for (size_t si = 0; si < sizeof(sizes) / sizeof(sizes[0]); si++) {
+        size_t size = sizes[si];
+        size_t messages = MESSAGES * 64 / (size < 64 ? 64 : size) + 1000;
+        char *text = (char *)malloc(size + 1);
+        for (size_t i = 0; i < size; i++) text[i] = (char)('a' + i % 26);
+        text[size] = '\0';
+
+        /* Deep copy per consumer */
+        double t0 = now_sec();
+        for (size_t m = 0; m < messages; m++) {
+            String payload = string_from(text);
+            String held[CONSUMERS];
+            for (int c = 0; c < CONSUMERS; c++) held[c] = string_from(string_cstr(&payload));
+            for (int c = 0; c < CONSUMERS; c++) {
+                g_sink += string_len(&held[c]);
+                string_free(&held[c]);
+            }
+            string_free(&payload);
+        }
+        double copy_ns = (now_sec() - t0) * 1e9 / (double)messages;
+
+        /* One allocation, a clone per consumer, a view for the forwarder */
+        t0 = now_sec();
+        for (size_t m = 0; m < messages; m++) {
+            SharedString payload = shared_string_from(text);
+            SharedString held[CONSUMERS];
+            for (int c = 0; c < CONSUMERS - 1; c++) held[c] = shared_string_clone(&payload);
+            held[CONSUMERS - 1] = shared_string_substr(&payload, 16, size);
+            for (int c = 0; c < CONSUMERS; c++) {
+                g_sink += shared_string_len(&held[c]);
+                shared_string_release(&held[c]);
+            }
+            shared_string_release(&payload);
+        }
+        double shared_ns = (now_sec() - t0) * 1e9 / (double)messages;
+
+        /* Last owner converts to a mutable String */
+        t0 = now_sec();
+        for (size_t m = 0; m < messages; m++) {
+            SharedString payload = shared_string_from(text);
+            String mine = shared_string_into_string(&payload);
+            g_sink += string_len(&mine);
+            string_free(&mine);
+        }
+        double into_ns = (now_sec() - t0) * 1e9 / (double)messages;
+
+        printf("%-12zu %14.1f %14.1f %8.2fx %14.1f\n", size, copy_ns, shared_ns, copy_ns / shared_ns, into_ns);
+        free(text);
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file bench_string.c
+ * @brief String construction: inline small strings vs heap allocation
+ *
+ * Builds many short tokens of a fixed length and frees them again, once
+ * with string_from (inline up to CYAN_STRING_INLINE_CAP characters) and
+ * once through a forced heap buffer, which is what every String cost
+ * before the small string optimization. Push-built tokens are measured
+ * the same way.
+ */
+
+#include <cyan/string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NUM_TOKENS (1u << 20)
+#define PASSES 5
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Sink to keep the compiler from discarding results */
+static volatile size_t g_sink;
+
+/* string_from on every token */
+static double bench_from(String *out, const char *token) {
+    double t0 = now_sec();
+    for (int p = 0; p < PASSES; p++) {
+        for (u32 i = 0; i < NUM_TOKENS; i++) out[i] = string_from(token);
+        for (u32 i = 0; i < NUM_TOKENS; i++) {
+            g_sink += string_len(&out[i]);
+            string_free(&out[i]);
+        }
+    }
+    return (now_sec() - t0) * 1e9 / ((double)NUM_TOKENS * PASSES);
+}
+
+/* Same content in a buffer that is always heap-allocated */
+static double bench_heap(String *out, const char *token) {
+    double t0 = now_sec();
+    for (int p = 0; p < PASSES; p++) {
+        for (u32 i = 0; i < NUM_TOKENS; i++) {
+            out[i] = string_with_capacity(CYAN_STRING_INLINE_CAP + 1);
+            string_append(&out[i], token);
+        }
+        for (u32 i = 0; i < NUM_TOKENS; i++) {
+            g_sink += string_len(&out[i]);
+            string_free(&out[i]);
+        }
+    }
+    return (now_sec() - t0) * 1e9 / ((double)NUM_TOKENS * PASSES);
+}
+
+/* Character-at-a-time construction from an empty string */
+static double bench_push(String *out, const char *token, size_t len) {
+    double t0 = now_sec();
+    for (int p = 0; p < PASSES; p++) {
+        for (u32 i = 0; i < NUM_TOKENS; i++) {
+            out[i] = string_new();
+            for (size_t c = 0; c < len; c++) string_push(&out[i], token[c]);
+        }
+        for (u32 i = 0; i < NUM_TOKENS; i++) {
+            g_sink += string_len(&out[i]);
+            string_free(&out[i]);
+        }
+    }
+    return (now_sec() - t0) * 1e9 / ((double)NUM_TOKENS * PASSES);
+}
+
+int main(void) {
+    String *out = (String *)malloc(NUM_TOKENS * sizeof(String));
+    if (!out) return 1;
+
+    printf("Build and free %u tokens (ns/token, inline cap %zu):\n",
+           NUM_TOKENS, (size_t)CYAN_STRING_INLINE_CAP);
+    printf("  %-6s %10s %10s %10s %10s\n", "len", "heap", "from", "push", "speedup");
+
+    static const size_t lens[] = { 4, 12, 20, 22, 40 };
+    char token[64];
+    for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+        size_t len = lens[l];
+        for (size_t c = 0; c < len; c++) token[c] = (char)('a' + c % 26);
+        token[len] = '\0';
+
+        double heap_ns = bench_heap(out, token);
+        double from_ns = bench_from(out, token);
+        double push_ns = bench_push(out, token, len);
+        printf("  %-6zu %10.1f %10.1f %10.1f %9.2fx\n",
+               len, heap_ns, from_ns, push_ns, heap_ns / from_ns);
+    }
+
+    free(out);
+    return 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file bench_string_builder.c
+ * @brief Large outputs: growing a String vs a chunked StringBuilder
+ *
+ * Writes the same CSV-like report of a given size three ways: string_format
+ * into one growing String, string_builder_format followed by a single join,
+ * and string_builder_format written straight to /dev/null with writev. Peak
+ * bytes are the largest buffer set alive at once: old plus new buffer
+ * during a String realloc, all chunks plus the joined copy for join, and
+ * the chunks alone for writev.
+ */
+
+#include <cyan/string.h>
+#include <cyan/string_builder.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ROW_FMT "%u,item-%u,%u.%02u,status-ok\n"
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Sink to keep the compiler from discarding results */
+static volatile size_t g_sink;
+
+int main(void) {
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull < 0) return 1;
+
+    printf("Build a report (ms, peak MB):\n");
+    printf("  %-8s %10s %8s %10s %8s %10s %8s\n",
+           "size MB", "String", "peak", "join", "peak", "writev", "peak");
+
+    static const size_t sizes_mb[] = { 16, 64, 256 };
+    for (size_t s = 0; s < sizeof(sizes_mb) / sizeof(sizes_mb[0]); s++) {
+        size_t target = sizes_mb[s] << 20;
+
+        /* One growing String: each realloc may copy everything so far */
+        double t0 = now_sec();
+        String str = string_new();
+        size_t peak_str = 0;
+        for (u32 i = 0; string_len(&str) < target; i++) {
+            size_t cap = string_capacity(&str);
+            string_format(&str, ROW_FMT, i, i * 7u, i % 1000u, i % 100u);
+            if (string_capacity(&str) != cap && cap + string_capacity(&str) > peak_str) {
+                peak_str = cap + string_capacity(&str);
+            }
+        }
+        double str_ms = (now_sec() - t0) * 1e3;
+        size_t len = string_len(&str);
+        g_sink += len;
+        string_free(&str);
+
+        /* Builder plus one join */
+        t0 = now_sec();
+        StringBuilder sb = string_builder_new();
+        for (u32 i = 0; string_builder_len(&sb) < target; i++) {
+            string_builder_format(&sb, ROW_FMT, i, i * 7u, i % 1000u, i % 100u);
+        }
+        String joined = string_builder_join(&sb);
+        double join_ms = (now_sec() - t0) * 1e3;
+        size_t chunk_bytes = string_builder_chunk_count(&sb) * CYAN_STRING_BUILDER_CHUNK;
+        size_t peak_join = chunk_bytes + string_len(&joined);
+        g_sink += string_len(&joined);
+        string_free(&joined);
+        string_builder_free(&sb);
+
+        /* Builder written out without joining */
+        t0 = now_sec();
+        sb = string_builder_new();
+        for (u32 i = 0; string_builder_len(&sb) < target; i++) {
+            string_builder_format(&sb, ROW_FMT, i, i * 7u, i % 1000u, i % 100u);
+        }
+        g_sink += (size_t)string_builder_writev(&sb, devnull);
+        double writev_ms = (now_sec() - t0) * 1e3;
+        string_builder_free(&sb);
+
+        printf("  %-8zu %10.1f %8.0f %10.1f %8.0f %10.1f %8.0f\n", sizes_mb[s],
+               str_ms, (double)peak_str / (1 << 20),
+               join_ms, (double)peak_join / (1 << 20),
+               writev_ms, (double)chunk_bytes / (1 << 20));
+    }
+
+    close(devnull);
+    return 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file bench_string_fmt.c
+ * @brief Access-log formatting: two-pass vs single-pass string_format vs string_fmt
+ *
+ * Appends combined-log-format lines to one String three ways:
+ * - the previous string_format, which ran vsnprintf once to size the
+ *   output and again to write it (reproduced here as the baseline)
+ * - string_format, which formats into the spare capacity and only formats
+ *   again when the output did not fit
+ * - string_fmt, which picks an appender per argument at compile time and
+ *   parses no format string
+ */
+
+#include <cyan/string.h>
+#include <cyan/string_num.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define LINES 1000000
+#define PASSES 3
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Sink to keep the compiler from discarding results */
+static volatile size_t g_sink;
+
+/* string_format before the single-pass change */
+static void two_pass_format(String *s, const char *fmt, ...) {
+    va_list args, args_copy;
+    va_start(args, fmt);
+    va_copy(args_copy, args);
+    int needed = vsnprintf(NULL, 0, fmt, args);
+    va_end(args);
+    if (needed < 0) {
+        va_end(args_copy);
+        return;
+    }
+    _string_check_capacity(s, (size_t)needed);
+    size_t len = _string_len(s);
+    vsnprintf(_string_buf(s) + len, (size_t)needed + 1, fmt, args_copy);
+    va_end(args_copy);
+    _string_set_len(s, len + (size_t)needed);
+}
+
+typedef struct {
+    const char *ip;
+    const char *method;
+    const char *path;
+    u32 status;
+    u64 bytes;
+    double seconds;
+} Request;
+
+static Request g_reqs[256];
+
+static void make_requests(void) {
+    static const char *ips[] = { "10.0.0.1", "192.168.10.24", "172.16.254.3", "10.1.2.3" };
+    static const char *methods[] = { "GET", "POST", "PUT" };
+    static const char *paths[] = { "/index.html", "/api/v1/users/1234", "/static/app.min.js", "/login" };
+    u32 seed = 12345;
+    for (int i = 0; i < 256; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        g_reqs[i] = (Request){
+            ips[seed % 4], methods[(seed >> 4) % 3], paths[(seed >> 8) % 4],
+            (seed >> 12) % 5 ? 200 : 404, (seed >> 6) % 100000, (double)((seed >> 10) % 5000) / 1000.0
+        };
+    }
+}
+
+int main(void) {
+    make_requests();
+    const char *fmt = "%s - - [16/Oct/2026:10:00:00 +0000] \"%s %s HTTP/1.1\" %u %llu %.3f\n";
+    double best[3] = { 1e30, 1e30, 1e30 };
+    size_t lens[3] = { 0, 0, 0 };
+
+    for (int p = 0; p < PASSES; p++) {
+        for (int way = 0; way < 3; way++) {
+            String log = string_new();
+            double t0 = now_sec();
+            for (u32 i = 0; i < LINES; i++) {
+                const Request *r = &g_reqs[i & 255];
+                if (way == 0) {
+                    two_pass_format(&log, fmt, r->ip, r->method, r->path, r->status,
+                                    (unsigned long long)r->bytes, r->seconds);
+                } else if (way == 1) {
+                    string_format(&log, fmt, r->ip, r->method, r->path, r->status,
+                                  (unsigned long long)r->bytes, r->seconds);
+                } else {
+                    /* Shortest digits for the duration instead of %.3f */
+                    string_fmt(&log, r->ip, " - - [16/Oct/2026:10:00:00 +0000] \"", r->method, " ",
+                               r->path, " HTTP/1.1\" ", r->status, " ", r->bytes, " ", r->seconds, "\n");
+                }
+            }
+            double ns = (now_sec() - t0) * 1e9 / LINES;
+            if (ns < best[way]) best[way] = ns;
+            lens[way] = string_len(&log);
+            g_sink += string_len(&log);
+            string_free(&log);
+        }
+    }
+
+    printf("Append %u access-log lines (ns/line, best of %d):\n", LINES, PASSES);
+    printf("  %-34s %8.1f\n", "two-pass vsnprintf (previous)", best[0]);
+    printf("  %-34s %8.1f  %5.2fx\n", "string_format (single pass)", best[1], best[0] / best[1]);
+    printf("  %-34s %8.1f  %5.2fx\n", "string_fmt", best[2], best[0] / best[2]);
+    printf("  output bytes: %zu / %zu / %zu\n", lens[0], lens[1], lens[2]);
+    return 0;
+}
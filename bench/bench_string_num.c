@@ -0,0 +1,113 @@
+/**
+ * @file bench_string_num.c
+ * @brief Number formatting: string_format vs string_num.h appends
+ *
+ * Formats metrics-style lines ("requests=1234 latency=0.0153 id=7f3a\n")
+ * into one String, once with string_format ("%llu", "%.17g", "%llx") and
+ * once with string_append_u64 / _f64 / _hex, and times each number kind
+ * on its own. Also times serialize_double, which now formats with
+ * cyan_fmt_f64 instead of snprintf.
+ */
+
+#include <cyan/string.h>
+#include <cyan/string_num.h>
+#include <cyan/serialize.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define COUNT 2000000
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Sink to keep the compiler from discarding results */
+static volatile size_t g_sink;
+
+static u64 g_ints[COUNT];
+static double g_doubles[COUNT];
+
+static void make_values(void) {
+    u64 seed = 88172645463325252ULL;
+    for (size_t i = 0; i < COUNT; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        /* Counters of every magnitude, gauges with a few decimals */
+        g_ints[i] = seed >> (seed & 63);
+        g_doubles[i] = (double)(seed % 1000000) / 1000.0 * ((seed >> 20) % 3 ? 1.0 : 1e-6);
+    }
+}
+
+int main(void) {
+    make_values();
+
+    printf("%-22s %12s %12s %9s\n", "ns/number", "format", "append", "speedup");
+    static const char *kinds[] = { "u64", "f64", "hex" };
+    for (int kind = 0; kind < 3; kind++) {
+        String a = string_new();
+        double t0 = now_sec();
+        for (size_t i = 0; i < COUNT; i++) {
+            if (kind == 0) string_format(&a, "%llu ", (unsigned long long)g_ints[i]);
+            else if (kind == 1) string_format(&a, "%.17g ", g_doubles[i]);
+            else string_format(&a, "%llx ", (unsigned long long)g_ints[i]);
+        }
+        double fmt_ns = (now_sec() - t0) * 1e9 / COUNT;
+
+        String b = string_new();
+        t0 = now_sec();
+        for (size_t i = 0; i < COUNT; i++) {
+            if (kind == 0) string_append_u64(&b, g_ints[i]);
+            else if (kind == 1) string_append_f64(&b, g_doubles[i]);
+            else string_append_hex(&b, g_ints[i]);
+            string_push(&b, ' ');
+        }
+        double app_ns = (now_sec() - t0) * 1e9 / COUNT;
+        printf("%-22s %12.1f %12.1f %8.2fx\n", kinds[kind], fmt_ns, app_ns, fmt_ns / app_ns);
+        if (kind == 1) {
+            printf("%-22s %12.2f %12.2f\n", "  f64 bytes/number",
+                   (double)string_len(&a) / COUNT, (double)string_len(&b) / COUNT);
+        }
+        g_sink += string_len(&a) + string_len(&b);
+        string_free(&a);
+        string_free(&b);
+    }
+
+    /* Metrics lines mixing all three */
+    String a = string_new();
+    double t0 = now_sec();
+    for (size_t i = 0; i < COUNT; i++) {
+        string_format(&a, "requests=%llu latency=%.17g id=%llx\n", (unsigned long long)g_ints[i],
+                      g_doubles[i], (unsigned long long)(g_ints[i] & 0xffff));
+    }
+    double fmt_ns = (now_sec() - t0) * 1e9 / COUNT;
+    String b = string_new();
+    t0 = now_sec();
+    for (size_t i = 0; i < COUNT; i++) {
+        string_append(&b, "requests=");
+        string_append_u64(&b, g_ints[i]);
+        string_append(&b, " latency=");
+        string_append_f64(&b, g_doubles[i]);
+        string_append(&b, " id=");
+        string_append_hex(&b, g_ints[i] & 0xffff);
+        string_push(&b, '\n');
+    }
+    double app_ns = (now_sec() - t0) * 1e9 / COUNT;
+    printf("%-22s %12.1f %12.1f %8.2fx\n", "metrics line", fmt_ns, app_ns, fmt_ns / app_ns);
+    g_sink += string_len(&a) + string_len(&b);
+    string_free(&a);
+    string_free(&b);
+
+    /* serialize_double: one malloc plus the formatter */
+    t0 = now_sec();
+    for (size_t i = 0; i < COUNT; i++) {
+        char *s = serialize_double(g_doubles[i]);
+        g_sink += (size_t)s[0];
+        free(s);
+    }
+    printf("%-22s %12s %12.1f\n", "serialize_double", "", (now_sec() - t0) * 1e9 / COUNT);
+    return 0;
+}
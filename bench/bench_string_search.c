@@ -0,0 +1,124 @@
+/**
+ * @file bench_string_search.c
+ * @brief Substring search and splitting: libc vs string_search.h
+ *
+ * Searches a synthetic access log for needles of several lengths with
+ * strstr on string_cstr and with string_find, counting every match. Then
+ * splits each log line into fields, once by copying each field out with
+ * strstr + malloc (the pattern string_split_iter replaces) and once with
+ * the allocation-free split iterator.
+ */
+
+#include <cyan/string.h>
+#include <cyan/string_search.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define LOG_LINES 200000
+#define PASSES 5
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Sink to keep the compiler from discarding results */
+static volatile size_t g_sink;
+
+static String make_log(void) {
+    static const char *paths[] = { "/index.html", "/api/v1/users", "/static/app.js", "/login" };
+    static const char *agents[] = { "curl/8.1", "Mozilla/5.0 (X11; Linux x86_64)", "bot/2.0" };
+    String log = string_new();
+    u32 seed = 12345;
+    for (u32 i = 0; i < LOG_LINES; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        string_format(&log, "10.0.%u.%u - - [16/Oct/2026:10:%02u:%02u] \"GET %s HTTP/1.1\" %u %u \"%s\"\n",
+                      (seed >> 8) & 255, (seed >> 16) & 255, i % 60, (i / 60) % 60,
+                      paths[(seed >> 4) % 4], (seed >> 12) % 3 ? 200 : 404,
+                      (seed >> 5) % 50000, agents[(seed >> 20) % 3]);
+    }
+    return log;
+}
+
+int main(void) {
+    String log = make_log();
+    const char *text = string_cstr(&log);
+    size_t len = string_len(&log);
+
+    printf("Count matches in a %.1f MB log (GB/s):\n", (double)len / (1 << 20));
+    printf("  %-32s %10s %10s %10s\n", "needle", "strstr", "find", "speedup");
+    static const char *needles[] = { "\" 404 ", "/api/v1/users", "Mozilla/5.0 (X11; Linux x86_64)", "not-present-anywhere" };
+    for (size_t n = 0; n < sizeof(needles) / sizeof(needles[0]); n++) {
+        const char *nd = needles[n];
+        size_t m = strlen(nd);
+
+        double t0 = now_sec();
+        size_t hits = 0;
+        for (int p = 0; p < PASSES; p++) {
+            for (const char *at = text; (at = strstr(at, nd)) != NULL; at += m) hits++;
+        }
+        double libc_s = now_sec() - t0;
+
+        t0 = now_sec();
+        size_t hits2 = 0;
+        for (int p = 0; p < PASSES; p++) {
+            Slice_char rest = string_as_slice(&log);
+            Slice_char needle = slice_char_from_array(nd, m);
+            for (Option_size_t at; (at = slice_char_find(rest, needle)).has_value; hits2++) {
+                rest = slice_char_subslice(rest, at.value + m, rest.len);
+            }
+        }
+        double find_s = now_sec() - t0;
+        if (hits != hits2) {
+            fprintf(stderr, "mismatch for %s: %zu vs %zu\n", nd, hits, hits2);
+            return 1;
+        }
+        g_sink += hits;
+        double gb = (double)len * PASSES / 1e9;
+        printf("  %-32s %10.2f %10.2f %9.2fx\n", nd, gb / libc_s, gb / find_s, libc_s / find_s);
+    }
+
+    printf("\nSplit every line into space-separated fields (ns/line):\n");
+    double t0 = now_sec();
+    for (int p = 0; p < PASSES; p++) {
+        const char *line = text;
+        const char *end = text + len;
+        while (line < end) {
+            const char *nl = strchr(line, '\n');
+            const char *field = line;
+            for (;;) {
+                const char *sp = strstr(field, " ");
+                if (!sp || sp > nl) sp = nl;
+                size_t flen = (size_t)(sp - field);
+                char *copy = (char *)malloc(flen + 1);
+                memcpy(copy, field, flen);
+                copy[flen] = '\0';
+                g_sink += flen;
+                free(copy);
+                if (sp == nl) break;
+                field = sp + 1;
+            }
+            line = nl + 1;
+        }
+    }
+    double copy_ns = (now_sec() - t0) * 1e9 / ((double)LOG_LINES * PASSES);
+
+    t0 = now_sec();
+    for (int p = 0; p < PASSES; p++) {
+        SplitIter lines = string_split_iter(&log, "\n");
+        Slice_char line;
+        while (split_iter_next(&lines, &line)) {
+            SplitIter fields = slice_char_split_iter(line, slice_char_from_array(" ", 1));
+            Slice_char field;
+            while (split_iter_next(&fields, &field)) g_sink += field.len;
+        }
+    }
+    double iter_ns = (now_sec() - t0) * 1e9 / ((double)LOG_LINES * PASSES);
+    printf("  %-32s %10.1f\n  %-32s %10.1f\n", "strstr + malloc per field", copy_ns,
+           "split_iter views", iter_ns);
+
+    string_free(&log);
+    return 0;
+}
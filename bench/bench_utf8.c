@@ -0,0 +1,136 @@
+/**
+ * @file bench_utf8.c
+ * @brief UTF-8 validation, counting and transcoding throughput
+ *
+ * Validates 16 MB payloads of three kinds (ASCII JSON, Latin text with
+ * accents, and CJK with emoji) three ways:
+ * - a byte-at-a-time loop that decodes every byte (the baseline)
+ * - the scalar fallback, which skips ASCII a word at a time
+ * - slice_char_utf8_validate, which uses the AVX2 lookup kernel when the
+ *   running CPU supports it
+ * Also times code-point counting and UTF-8 -> UTF-16 -> UTF-8.
+ */
+
+#include <cyan/utf8.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define PAYLOAD (16u << 20)
+#define PASSES 5
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Sink to keep the compiler from discarding results */
+static volatile size_t g_sink;
+
+/* Byte-at-a-time validator: one branchy decode step per byte */
+static bool byte_loop_validate(const unsigned char *p, size_t n) {
+    size_t i = 0;
+    while (i < n) {
+        unsigned char b = p[i];
+        if (b < 0x80) {
+            i++;
+            continue;
+        }
+        size_t len = b >= 0xF0 ? 4 : b >= 0xE0 ? 3 : 2;
+        if (b < 0xC2 || b > 0xF4 || i + len > n) return false;
+        u32 cp = b & (0x7F >> len);
+        for (size_t k = 1; k < len; k++) {
+            if ((p[i + k] & 0xC0) != 0x80) return false;
+            cp = (cp << 6) | (p[i + k] & 0x3F);
+        }
+        if ((len == 3 && (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF))) ||
+            (len == 4 && (cp < 0x10000 || cp > 0x10FFFF))) {
+            return false;
+        }
+        i += len;
+    }
+    return true;
+}
+
+/* Fill a payload by repeating samples picked at random */
+static char *make_payload(const char *const *samples, size_t count) {
+    char *buf = (char *)malloc(PAYLOAD);
+    size_t n = 0;
+    u32 seed = 12345;
+    while (1) {
+        seed = seed * 1664525u + 1013904223u;
+        const char *s = samples[(seed >> 8) % count];
+        size_t len = strlen(s);
+        if (n + len > PAYLOAD) break;
+        memcpy(buf + n, s, len);
+        n += len;
+    }
+    memset(buf + n, ' ', PAYLOAD - n);
+    return buf;
+}
+
+static double gbps(double seconds) {
+    return (double)PAYLOAD * PASSES / seconds / 1e9;
+}
+
+int main(void) {
+    static const char *ascii[] = {
+        "{\"id\":12345,\"name\":\"request\",\"tags\":[\"a\",\"b\"]},",
+        "{\"path\":\"/api/v1/users\",\"status\":200,\"ok\":true},",
+    };
+    static const char *latin[] = {
+        "Le cœur a ses raisons que la raison ne connaît point. ",
+        "Straße, Müller, Ærøskøbing, São Paulo, Kraków. ",
+    };
+    static const char *cjk[] = {
+        "日本語のテキストと絵文字🎉🚀。",
+        "中文字符和表情符号😀，한국어 텍스트도 있습니다. ",
+    };
+    const char *const *sets[] = { ascii, latin, cjk };
+    const char *names[] = { "ASCII JSON", "Latin text", "CJK + emoji" };
+    u16 *units = (u16 *)malloc(PAYLOAD * sizeof(u16));
+
+    printf("%-14s %10s %10s %10s %10s %10s   (GB/s)\n", "payload", "byte loop", "scalar",
+           "validate", "count", "utf16 rt");
+    for (int k = 0; k < 3; k++) {
+        char *buf = make_payload(sets[k], 2);
+        const unsigned char *p = (const unsigned char *)buf;
+        Slice_char s = slice_char_from_array(buf, PAYLOAD);
+        double t[5];
+
+        double t0 = now_sec();
+        for (int r = 0; r < PASSES; r++) g_sink += byte_loop_validate(p, PAYLOAD);
+        t[0] = now_sec() - t0;
+        t0 = now_sec();
+        for (int r = 0; r < PASSES; r++) g_sink += _cyan_utf8_validate_scalar(p, PAYLOAD);
+        t[1] = now_sec() - t0;
+        t0 = now_sec();
+        for (int r = 0; r < PASSES; r++) g_sink += slice_char_utf8_validate(s);
+        t[2] = now_sec() - t0;
+        t0 = now_sec();
+        for (int r = 0; r < PASSES; r++) g_sink += slice_char_utf8_count(s);
+        t[3] = now_sec() - t0;
+
+        /* Round trip through UTF-16 */
+        String back = string_with_capacity(PAYLOAD);
+        t0 = now_sec();
+        for (int r = 0; r < PASSES; r++) {
+            Option_size_t w = slice_char_utf8_to_utf16(s, units);
+            string_clear(&back);
+            if (!w.has_value || !string_append_utf16(&back, units, w.value)) return 1;
+        }
+        t[4] = now_sec() - t0;
+        if (string_len(&back) != PAYLOAD || memcmp(string_cstr(&back), buf, PAYLOAD) != 0) {
+            fprintf(stderr, "round trip mismatch\n");
+            return 1;
+        }
+
+        printf("%-14s %10.2f %10.2f %10.2f %10.2f %10.2f\n", names[k], gbps(t[0]), gbps(t[1]),
+               gbps(t[2]), gbps(t[3]), gbps(t[4]));
+        string_free(&back);
+        free(buf);
+    }
+    free(units);
+    return 0;
+}
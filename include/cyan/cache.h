@@ -0,0 +1,697 @@
+/**
+ * @file cache.h
+ * @brief Fixed-capacity LRU and CLOCK caches for the Cyan library
+ *
+ * This header provides bounded caches built on HashMap. Entries live in a
+ * node array allocated once at construction and are linked by u32 index
+ * rather than by pointer; the map only stores key -> node index. A hit
+ * costs one hash probe plus one array access, and no operation allocates
+ * after construction.
+ *
+ * Two eviction policies are available:
+ * - LruCache_K_V: exact least-recently-used order. A hit moves the node
+ *   to the front of a doubly linked index list.
+ * - ClockCache_K_V: CLOCK (second chance). A hit only sets the node's
+ *   reference bit; to evict, a hand sweeps the array, clearing set bits
+ *   and taking the first node whose bit was already clear. Hits write no
+ *   list links, which suits read-heavy and multi-threaded use.
+ *
+ * Usage:
+ *   OPTION_DEFINE(int);              // Required for Option_int
+ *   LRU_CACHE_DEFINE(int, int);      // Define LruCache_int_int type
+ *
+ *   LruCache_int_int c = lrucache_int_int_new(1024);
+ *   lrucache_int_int_put(&c, 42, 100);
+ *   Option_int v = lrucache_int_int_get(&c, 42);   // 42 is now most recent
+ *   lrucache_int_int_free(&c);
+ *
+ * For caches shared between threads, see concurrent_cache.h.
+ */
+
+#ifndef CYAN_CACHE_H
+#define CYAN_CACHE_H
+
+#include "common.h"
+#include "option.h"
+#include "hash.h"
+#include "hashmap.h"
+#include <stdint.h>
+#include <string.h>
+
+/* Node index meaning "no node": list ends and the end of the free list */
+#define _CYAN_CACHE_NIL UINT32_MAX
+
+/*
+ * Mark a CLOCK node referenced. Hits may run concurrently under a shared
+ * lock (see concurrent_cache.h), so the bit is read and set atomically,
+ * and only written when it was clear to keep hot lines clean.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define _CYAN_CACHE_TOUCH(bit) \
+    do { \
+        if (!__atomic_load_n(&(bit), __ATOMIC_RELAXED)) __atomic_store_n(&(bit), 1, __ATOMIC_RELAXED); \
+    } while (0)
+#else
+#define _CYAN_CACHE_TOUCH(bit) do { if (!(bit)) (bit) = 1; } while (0)
+#endif
+
+/*============================================================================
+ * LRU Cache Type Definition Macro
+ *============================================================================*/
+
+/**
+ * @brief Generate an LRU cache type for given key and value types
+ * @param K The key type
+ * @param V The value type
+ *
+ * Creates:
+ * - LruCache_K_V: The cache structure
+ * - LruCacheVT_K_V: Vtable laid out like HashMapVT_K_V (insert is put), so
+ *   the MAP_* convenience macros work on caches too
+ * - CacheEvictFn_K_V: Eviction callback type
+ * - lrucache_K_V_new(capacity): Create a cache holding at most capacity entries
+ * - lrucache_K_V_get(c, key): Get value as Option and mark key most recent
+ * - lrucache_K_V_peek(c, key): Get value as Option without touching the order
+ * - lrucache_K_V_contains(c, key): Check if key is cached (does not touch)
+ * - lrucache_K_V_put(c, key, value): Insert or update, evicting the LRU entry when full
+ * - lrucache_K_V_remove(c, key): Remove entry, return value
+ * - lrucache_K_V_len(c), lrucache_K_V_clear(c), lrucache_K_V_free(c)
+ *
+ * Assign c.on_evict (and c.evict_ctx) to be told about every entry put
+ * pushes out. The callback runs after the new entry is stored and must not
+ * call back into the cache. Explicit removes do not call it.
+ *
+ * Keys are hashed like HashMap keys; the key map (c.map) may be given a
+ * hash_fn or seed before the first put.
+ *
+ * Requires: OPTION_DEFINE(V) must be called before LRU_CACHE_DEFINE(K, V)
+ */
+#define LRU_CACHE_DEFINE(K, V) \
+    /* Key map: key -> node index */ \
+    typedef uint32_t LruSlot_##K##_##V; \
+    OPTION_DEFINE(LruSlot_##K##_##V); \
+    HASHMAP_DEFINE(K, LruSlot_##K##_##V); \
+    \
+    /** \
+     * @brief Callback for entries evicted by put \
+     * @param key The evicted key \
+     * @param value The evicted value \
+     * @param ctx The cache's evict_ctx \
+     */ \
+    typedef void (*CacheEvictFn_##K##_##V)(K key, V value, void *ctx); \
+    \
+    /* Cache node, linked into the recency list or the free list by index */ \
+    typedef struct { \
+        K key; \
+        V value; \
+        uint32_t prev;          /* Toward the most recent, or _CYAN_CACHE_NIL */ \
+        uint32_t next;          /* Toward the least recent (or next free node) */ \
+    } _LruNode_##K##_##V; \
+    \
+    /* Forward declare LruCache_K_V for use in vtable */ \
+    typedef struct LruCache_##K##_##V LruCache_##K##_##V; \
+    \
+    /** \
+     * @brief Vtable structure for LruCache_K_V, laid out like HashMapVT_K_V \
+     */ \
+    typedef struct { \
+        void (*insert)(LruCache_##K##_##V *c, K key, V value); \
+        Option_##V (*get)(LruCache_##K##_##V *c, K key); \
+        bool (*contains)(LruCache_##K##_##V *c, K key); \
+        Option_##V (*remove)(LruCache_##K##_##V *c, K key); \
+        size_t (*len)(LruCache_##K##_##V *c); \
+        void (*free)(LruCache_##K##_##V *c); \
+    } LruCacheVT_##K##_##V; \
+    \
+    /** \
+     * @brief LRU cache structure with vtable pointer \
+     */ \
+    struct LruCache_##K##_##V { \
+        HashMap_##K##_LruSlot_##K##_##V map; /* Key -> node index; never grows */ \
+        _LruNode_##K##_##V *nodes; /* capacity nodes, allocated once */ \
+        size_t capacity; \
+        size_t len; \
+        uint32_t head;          /* Most recently used node, or _CYAN_CACHE_NIL */ \
+        uint32_t tail;          /* Least recently used node, or _CYAN_CACHE_NIL */ \
+        uint32_t free_list;     /* Unused nodes, linked through next */ \
+        size_t removed;         /* Keys removed from map since its tombstones were cleared */ \
+        CacheEvictFn_##K##_##V on_evict; /* Called for each evicted entry, or NULL */ \
+        void *evict_ctx; \
+        const LruCacheVT_##K##_##V *vt; \
+    }; \
+    \
+    /* Forward declare vtable instance */ \
+    static const LruCacheVT_##K##_##V _lrucache_##K##_##V##_vt; \
+    \
+    /** \
+     * @brief Create an empty cache \
+     * @param capacity Maximum number of entries (at least 1, below UINT32_MAX) \
+     * @return A new LruCache_K_V with all storage allocated \
+     */ \
+    static inline LruCache_##K##_##V lrucache_##K##_##V##_new(size_t capacity) { \
+        if (capacity == 0 || capacity >= _CYAN_CACHE_NIL) CYAN_PANIC("lrucache_new: invalid capacity"); \
+        \
+        LruCache_##K##_##V c = { \
+            /* At most 50% full, so the map never resizes */ \
+            .map = hashmap_##K##_LruSlot_##K##_##V##_with_capacity(capacity * 2), \
+            .nodes = (_LruNode_##K##_##V *)malloc(capacity * sizeof(_LruNode_##K##_##V)), \
+            .capacity = capacity, \
+            .len = 0, \
+            .head = _CYAN_CACHE_NIL, \
+            .tail = _CYAN_CACHE_NIL, \
+            .free_list = 0, \
+            .removed = 0, \
+            .on_evict = NULL, \
+            .evict_ctx = NULL, \
+            .vt = &_lrucache_##K##_##V##_vt \
+        }; \
+        if (!c.nodes) CYAN_PANIC("allocation failed"); \
+        for (size_t i = 0; i < capacity; i++) { \
+            c.nodes[i].next = i + 1 < capacity ? (uint32_t)(i + 1) : _CYAN_CACHE_NIL; \
+        } \
+        return c; \
+    } \
+    \
+    /* Hash a key the way the cache's map does */ \
+    static inline size_t _lrucache_##K##_##V##_hash(LruCache_##K##_##V *c, K key) { \
+        return _hashmap_##K##_LruSlot_##K##_##V##_hash(&c->map, key); \
+    } \
+    \
+    /** \
+     * @brief Find a key's node given its hash \
+     * @return Node index, or _CYAN_CACHE_NIL if not cached \
+     */ \
+    static inline uint32_t _lrucache_##K##_##V##_find(LruCache_##K##_##V *c, K key, size_t hash) { \
+        LruSlot_##K##_##V *slot; \
+        if (!_hashmap_##K##_LruSlot_##K##_##V##_lookup_hashed(&c->map, key, hash, &slot)) { \
+            return _CYAN_CACHE_NIL; \
+        } \
+        return *slot; \
+    } \
+    \
+    /* Detach a node from the recency list */ \
+    static inline void _lrucache_##K##_##V##_unlink(LruCache_##K##_##V *c, uint32_t i) { \
+        _LruNode_##K##_##V *n = &c->nodes[i]; \
+        if (n->prev != _CYAN_CACHE_NIL) c->nodes[n->prev].next = n->next; \
+        else c->head = n->next; \
+        if (n->next != _CYAN_CACHE_NIL) c->nodes[n->next].prev = n->prev; \
+        else c->tail = n->prev; \
+    } \
+    \
+    /* Attach a detached node as the most recent */ \
+    static inline void _lrucache_##K##_##V##_push_front(LruCache_##K##_##V *c, uint32_t i) { \
+        _LruNode_##K##_##V *n = &c->nodes[i]; \
+        n->prev = _CYAN_CACHE_NIL; \
+        n->next = c->head; \
+        if (c->head != _CYAN_CACHE_NIL) c->nodes[c->head].prev = i; \
+        else c->tail = i; \
+        c->head = i; \
+    } \
+    \
+    /* Move a cached node to the front; a node already there costs nothing */ \
+    static inline void _lrucache_##K##_##V##_touch(LruCache_##K##_##V *c, uint32_t i) { \
+        if (c->head == i) return; \
+        _lrucache_##K##_##V##_unlink(c, i); \
+        _lrucache_##K##_##V##_push_front(c, i); \
+    } \
+    \
+    /** \
+     * @brief Get the value for a key with a precomputed hash and mark it most recent \
+     * @note Used by the sharded cache, which has already hashed the key \
+     */ \
+    static inline Option_##V _lrucache_##K##_##V##_get_hashed( \
+        LruCache_##K##_##V *c, K key, size_t hash \
+    ) { \
+        uint32_t i = _lrucache_##K##_##V##_find(c, key, hash); \
+        if (i == _CYAN_CACHE_NIL) return None(V); \
+        _lrucache_##K##_##V##_touch(c, i); \
+        return Some(V, c->nodes[i].value); \
+    } \
+    \
+    /** \
+     * @brief Get the value for a key and mark it most recently used \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @return Option containing the value, or None if not cached \
+     */ \
+    static inline Option_##V lrucache_##K##_##V##_get(LruCache_##K##_##V *c, K key) { \
+        return _lrucache_##K##_##V##_get_hashed(c, key, _lrucache_##K##_##V##_hash(c, key)); \
+    } \
+    \
+    /** \
+     * @brief Get the value for a key without changing its recency \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @return Option containing the value, or None if not cached \
+     */ \
+    static inline Option_##V lrucache_##K##_##V##_peek(LruCache_##K##_##V *c, K key) { \
+        uint32_t i = _lrucache_##K##_##V##_find(c, key, _lrucache_##K##_##V##_hash(c, key)); \
+        if (i == _CYAN_CACHE_NIL) return None(V); \
+        return Some(V, c->nodes[i].value); \
+    } \
+    \
+    /** \
+     * @brief Check if a key is cached, without changing its recency \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @return true if cached, false otherwise \
+     */ \
+    static inline bool lrucache_##K##_##V##_contains(LruCache_##K##_##V *c, K key) { \
+        return _lrucache_##K##_##V##_find(c, key, _lrucache_##K##_##V##_hash(c, key)) != _CYAN_CACHE_NIL; \
+    } \
+    \
+    /** \
+     * @brief Insert or update a key, evicting the least recently used entry if full \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @param value The value; the key becomes most recently used \
+     */ \
+    static inline void lrucache_##K##_##V##_put(LruCache_##K##_##V *c, K key, V value) { \
+        /* Removed keys leave tombstones; clear them before they slow probes */ \
+        if (c->removed > c->map.capacity / 4) { \
+            _hashmap_##K##_LruSlot_##K##_##V##_resize(&c->map, c->map.capacity); \
+            c->removed = 0; \
+        } \
+        \
+        HashMapEntry_##K##_LruSlot_##K##_##V e = hashmap_##K##_LruSlot_##K##_##V##_entry(&c->map, key); \
+        if (hashmap_##K##_LruSlot_##K##_##V##_entry_is_occupied(&e)) { \
+            uint32_t i = *hashmap_##K##_LruSlot_##K##_##V##_entry_get(&e); \
+            c->nodes[i].value = value; \
+            _lrucache_##K##_##V##_touch(c, i); \
+            return; \
+        } \
+        \
+        uint32_t i; \
+        bool evicted = false; \
+        K old_key; \
+        V old_value; \
+        if (c->free_list != _CYAN_CACHE_NIL) { \
+            i = c->free_list; \
+            c->free_list = c->nodes[i].next; \
+            c->len++; \
+        } else { \
+            /* Full: reuse the least recently used node. Removing its key \
+               only marks another slot deleted, so e stays valid. */ \
+            i = c->tail; \
+            _lrucache_##K##_##V##_unlink(c, i); \
+            old_key = c->nodes[i].key; \
+            old_value = c->nodes[i].value; \
+            hashmap_##K##_LruSlot_##K##_##V##_remove(&c->map, old_key); \
+            c->removed++; \
+            evicted = true; \
+        } \
+        \
+        c->nodes[i].key = key; \
+        c->nodes[i].value = value; \
+        hashmap_##K##_LruSlot_##K##_##V##_entry_insert(&e, i); \
+        _lrucache_##K##_##V##_push_front(c, i); \
+        \
+        if (evicted && c->on_evict) c->on_evict(old_key, old_value, c->evict_ctx); \
+    } \
+    \
+    /** \
+     * @brief Remove a key from the cache \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @return Option containing the removed value, or None if not cached \
+     */ \
+    static inline Option_##V lrucache_##K##_##V##_remove(LruCache_##K##_##V *c, K key) { \
+        Option_LruSlot_##K##_##V slot = hashmap_##K##_LruSlot_##K##_##V##_remove(&c->map, key); \
+        if (!slot.has_value) return None(V); \
+        \
+        uint32_t i = slot.value; \
+        _lrucache_##K##_##V##_unlink(c, i); \
+        c->nodes[i].next = c->free_list; \
+        c->free_list = i; \
+        c->len--; \
+        c->removed++; \
+        return Some(V, c->nodes[i].value); \
+    } \
+    \
+    /** \
+     * @brief Get the number of cached entries \
+     * @param c Pointer to the cache \
+     * @return Number of entries (at most capacity) \
+     */ \
+    static inline size_t lrucache_##K##_##V##_len(LruCache_##K##_##V *c) { \
+        return c->len; \
+    } \
+    \
+    /** \
+     * @brief Remove every entry, keeping the storage and hash settings \
+     * @param c Pointer to the cache \
+     */ \
+    static inline void lrucache_##K##_##V##_clear(LruCache_##K##_##V *c) { \
+        HashMap_##K##_LruSlot_##K##_##V map = hashmap_##K##_LruSlot_##K##_##V##_with_capacity(c->map.capacity); \
+        map.hash_fn = c->map.hash_fn; \
+        map.equal_fn = c->map.equal_fn; \
+        map.seeded_hash_fn = c->map.seeded_hash_fn; \
+        map.seed = c->map.seed; \
+        hashmap_##K##_LruSlot_##K##_##V##_free(&c->map); \
+        c->map = map; \
+        \
+        for (size_t i = 0; i < c->capacity; i++) { \
+            c->nodes[i].next = i + 1 < c->capacity ? (uint32_t)(i + 1) : _CYAN_CACHE_NIL; \
+        } \
+        c->len = 0; \
+        c->head = _CYAN_CACHE_NIL; \
+        c->tail = _CYAN_CACHE_NIL; \
+        c->free_list = 0; \
+        c->removed = 0; \
+    } \
+    \
+    /** \
+     * @brief Free all memory associated with the cache \
+     * @param c Pointer to the cache \
+     */ \
+    static inline void lrucache_##K##_##V##_free(LruCache_##K##_##V *c) { \
+        hashmap_##K##_LruSlot_##K##_##V##_free(&c->map); \
+        free(c->nodes); \
+        c->nodes = NULL; \
+        c->capacity = 0; \
+        c->len = 0; \
+        c->head = _CYAN_CACHE_NIL; \
+        c->tail = _CYAN_CACHE_NIL; \
+        c->free_list = _CYAN_CACHE_NIL; \
+    } \
+    \
+    /** \
+     * @brief Static const vtable instance shared by all LruCache_K_V instances \
+     */ \
+    static const LruCacheVT_##K##_##V _lrucache_##K##_##V##_vt = { \
+        .insert = lrucache_##K##_##V##_put, \
+        .get = lrucache_##K##_##V##_get, \
+        .contains = lrucache_##K##_##V##_contains, \
+        .remove = lrucache_##K##_##V##_remove, \
+        .len = lrucache_##K##_##V##_len, \
+        .free = lrucache_##K##_##V##_free \
+    }; \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef LruCache_##K##_##V LruCache_##K##_##V##_defined
+
+/*============================================================================
+ * CLOCK Cache Type Definition Macro
+ *============================================================================*/
+
+/**
+ * @brief Generate a CLOCK (second chance) cache type for given key and value types
+ * @param K The key type
+ * @param V The value type
+ *
+ * Same API as LRU_CACHE_DEFINE with the clockcache_ prefix:
+ * - ClockCache_K_V, ClockCacheVT_K_V, CacheEvictFn_K_V
+ * - clockcache_K_V_new(capacity), clockcache_K_V_get(c, key)
+ * - clockcache_K_V_peek(c, key), clockcache_K_V_contains(c, key)
+ * - clockcache_K_V_put(c, key, value), clockcache_K_V_remove(c, key)
+ * - clockcache_K_V_len(c), clockcache_K_V_clear(c), clockcache_K_V_free(c)
+ *
+ * get and put of a cached key set its reference bit instead of relinking
+ * it. New entries start unreferenced, so a key read only once is evicted
+ * before keys that were read again. Eviction order approximates LRU; a
+ * full sweep visits each node at most twice.
+ *
+ * Requires: OPTION_DEFINE(V) must be called before CLOCK_CACHE_DEFINE(K, V)
+ */
+#define CLOCK_CACHE_DEFINE(K, V) \
+    /* Key map: key -> node index */ \
+    typedef uint32_t ClockSlot_##K##_##V; \
+    OPTION_DEFINE(ClockSlot_##K##_##V); \
+    HASHMAP_DEFINE(K, ClockSlot_##K##_##V); \
+    \
+    /* Same type as in LRU_CACHE_DEFINE; C11 allows the repeated typedef */ \
+    typedef void (*CacheEvictFn_##K##_##V)(K key, V value, void *ctx); \
+    \
+    /* Cache node; free nodes are linked through next_free */ \
+    typedef struct { \
+        K key; \
+        V value; \
+        uint32_t next_free; \
+        uint8_t referenced;     /* Hit since the hand last passed */ \
+    } _ClockNode_##K##_##V; \
+    \
+    /* Forward declare ClockCache_K_V for use in vtable */ \
+    typedef struct ClockCache_##K##_##V ClockCache_##K##_##V; \
+    \
+    /** \
+     * @brief Vtable structure for ClockCache_K_V, laid out like HashMapVT_K_V \
+     */ \
+    typedef struct { \
+        void (*insert)(ClockCache_##K##_##V *c, K key, V value); \
+        Option_##V (*get)(ClockCache_##K##_##V *c, K key); \
+        bool (*contains)(ClockCache_##K##_##V *c, K key); \
+        Option_##V (*remove)(ClockCache_##K##_##V *c, K key); \
+        size_t (*len)(ClockCache_##K##_##V *c); \
+        void (*free)(ClockCache_##K##_##V *c); \
+    } ClockCacheVT_##K##_##V; \
+    \
+    /** \
+     * @brief CLOCK cache structure with vtable pointer \
+     */ \
+    struct ClockCache_##K##_##V { \
+        HashMap_##K##_ClockSlot_##K##_##V map; /* Key -> node index; never grows */ \
+        _ClockNode_##K##_##V *nodes; /* capacity nodes, allocated once */ \
+        size_t capacity; \
+        size_t len; \
+        uint32_t hand;          /* Next node the eviction sweep examines */ \
+        uint32_t free_list;     /* Unused nodes, linked through next_free */ \
+        size_t removed;         /* Keys removed from map since its tombstones were cleared */ \
+        CacheEvictFn_##K##_##V on_evict; /* Called for each evicted entry, or NULL */ \
+        void *evict_ctx; \
+        const ClockCacheVT_##K##_##V *vt; \
+    }; \
+    \
+    /* Forward declare vtable instance */ \
+    static const ClockCacheVT_##K##_##V _clockcache_##K##_##V##_vt; \
+    \
+    /** \
+     * @brief Create an empty cache \
+     * @param capacity Maximum number of entries (at least 1, below UINT32_MAX) \
+     * @return A new ClockCache_K_V with all storage allocated \
+     */ \
+    static inline ClockCache_##K##_##V clockcache_##K##_##V##_new(size_t capacity) { \
+        if (capacity == 0 || capacity >= _CYAN_CACHE_NIL) CYAN_PANIC("clockcache_new: invalid capacity"); \
+        \
+        ClockCache_##K##_##V c = { \
+            /* At most 50% full, so the map never resizes */ \
+            .map = hashmap_##K##_ClockSlot_##K##_##V##_with_capacity(capacity * 2), \
+            .nodes = (_ClockNode_##K##_##V *)malloc(capacity * sizeof(_ClockNode_##K##_##V)), \
+            .capacity = capacity, \
+            .len = 0, \
+            .hand = 0, \
+            .free_list = 0, \
+            .removed = 0, \
+            .on_evict = NULL, \
+            .evict_ctx = NULL, \
+            .vt = &_clockcache_##K##_##V##_vt \
+        }; \
+        if (!c.nodes) CYAN_PANIC("allocation failed"); \
+        for (size_t i = 0; i < capacity; i++) { \
+            c.nodes[i].next_free = i + 1 < capacity ? (uint32_t)(i + 1) : _CYAN_CACHE_NIL; \
+        } \
+        return c; \
+    } \
+    \
+    /* Hash a key the way the cache's map does */ \
+    static inline size_t _clockcache_##K##_##V##_hash(ClockCache_##K##_##V *c, K key) { \
+        return _hashmap_##K##_ClockSlot_##K##_##V##_hash(&c->map, key); \
+    } \
+    \
+    /** \
+     * @brief Find a key's node given its hash \
+     * @return Node index, or _CYAN_CACHE_NIL if not cached \
+     */ \
+    static inline uint32_t _clockcache_##K##_##V##_find(ClockCache_##K##_##V *c, K key, size_t hash) { \
+        ClockSlot_##K##_##V *slot; \
+        if (!_hashmap_##K##_ClockSlot_##K##_##V##_lookup_hashed(&c->map, key, hash, &slot)) { \
+            return _CYAN_CACHE_NIL; \
+        } \
+        return *slot; \
+    } \
+    \
+    /** \
+     * @brief Get the value for a key with a precomputed hash and mark it referenced \
+     * @note Writes nothing but the reference bit, so the sharded cache runs \
+     *       it under a shared lock \
+     */ \
+    static inline Option_##V _clockcache_##K##_##V##_get_hashed( \
+        ClockCache_##K##_##V *c, K key, size_t hash \
+    ) { \
+        uint32_t i = _clockcache_##K##_##V##_find(c, key, hash); \
+        if (i == _CYAN_CACHE_NIL) return None(V); \
+        _CYAN_CACHE_TOUCH(c->nodes[i].referenced); \
+        return Some(V, c->nodes[i].value); \
+    } \
+    \
+    /** \
+     * @brief Get the value for a key and mark it referenced \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @return Option containing the value, or None if not cached \
+     */ \
+    static inline Option_##V clockcache_##K##_##V##_get(ClockCache_##K##_##V *c, K key) { \
+        return _clockcache_##K##_##V##_get_hashed(c, key, _clockcache_##K##_##V##_hash(c, key)); \
+    } \
+    \
+    /** \
+     * @brief Get the value for a key without marking it referenced \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @return Option containing the value, or None if not cached \
+     */ \
+    static inline Option_##V clockcache_##K##_##V##_peek(ClockCache_##K##_##V *c, K key) { \
+        uint32_t i = _clockcache_##K##_##V##_find(c, key, _clockcache_##K##_##V##_hash(c, key)); \
+        if (i == _CYAN_CACHE_NIL) return None(V); \
+        return Some(V, c->nodes[i].value); \
+    } \
+    \
+    /** \
+     * @brief Check if a key is cached, without marking it referenced \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @return true if cached, false otherwise \
+     */ \
+    static inline bool clockcache_##K##_##V##_contains(ClockCache_##K##_##V *c, K key) { \
+        return _clockcache_##K##_##V##_find(c, key, _clockcache_##K##_##V##_hash(c, key)) != _CYAN_CACHE_NIL; \
+    } \
+    \
+    /** \
+     * @brief Advance the hand to the next node without a second chance \
+     * @param c Pointer to the cache (full, so every node is in use) \
+     * @return Index of the node to evict; the hand is left just past it \
+     */ \
+    static inline uint32_t _clockcache_##K##_##V##_sweep(ClockCache_##K##_##V *c) { \
+        for (;;) { \
+            uint32_t i = c->hand; \
+            c->hand = i + 1 < c->capacity ? i + 1 : 0; \
+            if (!c->nodes[i].referenced) return i; \
+            c->nodes[i].referenced = 0; \
+        } \
+    } \
+    \
+    /** \
+     * @brief Insert or update a key, evicting an unreferenced entry if full \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @param value The value; an existing key is marked referenced \
+     */ \
+    static inline void clockcache_##K##_##V##_put(ClockCache_##K##_##V *c, K key, V value) { \
+        /* Removed keys leave tombstones; clear them before they slow probes */ \
+        if (c->removed > c->map.capacity / 4) { \
+            _hashmap_##K##_ClockSlot_##K##_##V##_resize(&c->map, c->map.capacity); \
+            c->removed = 0; \
+        } \
+        \
+        HashMapEntry_##K##_ClockSlot_##K##_##V e = hashmap_##K##_ClockSlot_##K##_##V##_entry(&c->map, key); \
+        if (hashmap_##K##_ClockSlot_##K##_##V##_entry_is_occupied(&e)) { \
+            uint32_t i = *hashmap_##K##_ClockSlot_##K##_##V##_entry_get(&e); \
+            c->nodes[i].value = value; \
+            c->nodes[i].referenced = 1; \
+            return; \
+        } \
+        \
+        uint32_t i; \
+        bool evicted = false; \
+        K old_key; \
+        V old_value; \
+        if (c->free_list != _CYAN_CACHE_NIL) { \
+            i = c->free_list; \
+            c->free_list = c->nodes[i].next_free; \
+            c->len++; \
+        } else { \
+            /* Full: removing the victim's key only marks another slot \
+               deleted, so e stays valid */ \
+            i = _clockcache_##K##_##V##_sweep(c); \
+            old_key = c->nodes[i].key; \
+            old_value = c->nodes[i].value; \
+            hashmap_##K##_ClockSlot_##K##_##V##_remove(&c->map, old_key); \
+            c->removed++; \
+            evicted = true; \
+        } \
+        \
+        c->nodes[i].key = key; \
+        c->nodes[i].value = value; \
+        c->nodes[i].referenced = 0; \
+        hashmap_##K##_ClockSlot_##K##_##V##_entry_insert(&e, i); \
+        \
+        if (evicted && c->on_evict) c->on_evict(old_key, old_value, c->evict_ctx); \
+    } \
+    \
+    /** \
+     * @brief Remove a key from the cache \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @return Option containing the removed value, or None if not cached \
+     */ \
+    static inline Option_##V clockcache_##K##_##V##_remove(ClockCache_##K##_##V *c, K key) { \
+        Option_ClockSlot_##K##_##V slot = hashmap_##K##_ClockSlot_##K##_##V##_remove(&c->map, key); \
+        if (!slot.has_value) return None(V); \
+        \
+        uint32_t i = slot.value; \
+        c->nodes[i].next_free = c->free_list; \
+        c->free_list = i; \
+        c->len--; \
+        c->removed++; \
+        return Some(V, c->nodes[i].value); \
+    } \
+    \
+    /** \
+     * @brief Get the number of cached entries \
+     * @param c Pointer to the cache \
+     * @return Number of entries (at most capacity) \
+     */ \
+    static inline size_t clockcache_##K##_##V##_len(ClockCache_##K##_##V *c) { \
+        return c->len; \
+    } \
+    \
+    /** \
+     * @brief Remove every entry, keeping the storage and hash settings \
+     * @param c Pointer to the cache \
+     */ \
+    static inline void clockcache_##K##_##V##_clear(ClockCache_##K##_##V *c) { \
+        HashMap_##K##_ClockSlot_##K##_##V map = hashmap_##K##_ClockSlot_##K##_##V##_with_capacity(c->map.capacity); \
+        map.hash_fn = c->map.hash_fn; \
+        map.equal_fn = c->map.equal_fn; \
+        map.seeded_hash_fn = c->map.seeded_hash_fn; \
+        map.seed = c->map.seed; \
+        hashmap_##K##_ClockSlot_##K##_##V##_free(&c->map); \
+        c->map = map; \
+        \
+        for (size_t i = 0; i < c->capacity; i++) { \
+            c->nodes[i].next_free = i + 1 < c->capacity ? (uint32_t)(i + 1) : _CYAN_CACHE_NIL; \
+            c->nodes[i].referenced = 0; \
+        } \
+        c->len = 0; \
+        c->hand = 0; \
+        c->free_list = 0; \
+        c->removed = 0; \
+    } \
+    \
+    /** \
+     * @brief Free all memory associated with the cache \
+     * @param c Pointer to the cache \
+     */ \
+    static inline void clockcache_##K##_##V##_free(ClockCache_##K##_##V *c) { \
+        hashmap_##K##_ClockSlot_##K##_##V##_free(&c->map); \
+        free(c->nodes); \
+        c->nodes = NULL; \
+        c->capacity = 0; \
+        c->len = 0; \
+        c->hand = 0; \
+        c->free_list = _CYAN_CACHE_NIL; \
+    } \
+    \
+    /** \
+     * @brief Static const vtable instance shared by all ClockCache_K_V instances \
+     */ \
+    static const ClockCacheVT_##K##_##V _clockcache_##K##_##V##_vt = { \
+        .insert = clockcache_##K##_##V##_put, \
+        .get = clockcache_##K##_##V##_get, \
+        .contains = clockcache_##K##_##V##_contains, \
+        .remove = clockcache_##K##_##V##_remove, \
+        .len = clockcache_##K##_##V##_len, \
+        .free = clockcache_##K##_##V##_free \
+    }; \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef ClockCache_##K##_##V ClockCache_##K##_##V##_defined
+
+#endif /* CYAN_CACHE_H */
@@ -92,6 +92,16 @@
 #define CYAN_STRINGIFY_(x) #x
 #define CYAN_STRINGIFY(x) CYAN_STRINGIFY_(x)
 
+/**
+ * @brief Hint that memory at addr will be read soon
+ * @param addr Address to prefetch (need not be valid; never faults)
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define CYAN_PREFETCH(addr) __builtin_prefetch((addr), 0, 3)
+#else
+#define CYAN_PREFETCH(addr) ((void)(addr))
+#endif
+
 /*============================================================================
  * Boolean Type (pre-C23 compatibility)
  *============================================================================
@@ -0,0 +1,328 @@
+/**
+ * @file concurrent_cache.h
+ * @brief Sharded thread-safe LRU and CLOCK caches for the Cyan library
+ *
+ * This header splits a cache into a power-of-two number of shards, each an
+ * ordinary LruCache or ClockCache guarded by its own reader-writer lock,
+ * like ConcurrentHashMap. Keys are hashed once: the high bits pick the
+ * shard and the same hash is reused for the probe inside it.
+ *
+ * An LRU hit relinks its node, so it takes the shard's write lock. A CLOCK
+ * hit only sets a reference bit atomically, so it takes the read lock and
+ * readers of one shard do not serialize. Recency is tracked per shard, so
+ * eviction is LRU (or CLOCK) within a shard rather than across the cache.
+ *
+ * Usage:
+ *   OPTION_DEFINE(int);
+ *   CLOCK_CACHE_DEFINE(int, int);             // Shard cache type
+ *   CONCURRENT_CLOCK_CACHE_DEFINE(int, int);  // ConcurrentClockCache_int_int
+ *
+ *   ConcurrentClockCache_int_int c = cclockcache_int_int_new(100000);
+ *   cclockcache_int_int_put(&c, 1, 100);      // From any thread
+ *   Option_int v = cclockcache_int_int_get(&c, 1);
+ *   cclockcache_int_int_free(&c);             // After all threads are done
+ *
+ * Requires POSIX threads (compile with -std=gnu11 or define _POSIX_C_SOURCE
+ * and link with -lpthread).
+ */
+
+#ifndef CYAN_CONCURRENT_CACHE_H
+#define CYAN_CONCURRENT_CACHE_H
+
+#include "common.h"
+#include "option.h"
+#include "cache.h"
+#include <pthread.h>
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+/**
+ * @brief Default number of shards (must be a power of 2)
+ */
+#ifndef CYAN_CONCURRENT_CACHE_SHARDS
+#define CYAN_CONCURRENT_CACHE_SHARDS 16
+#endif
+
+/**
+ * @brief Cache line size used to pad shards apart
+ */
+#ifndef CYAN_CACHE_LINE
+#define CYAN_CACHE_LINE 64
+#endif
+
+/*============================================================================
+ * Concurrent Cache Type Definition Macros
+ *============================================================================*/
+
+/**
+ * @brief Internal: generate a sharded cache over a single-threaded one (do not use directly)
+ * @param Name Type name prefix of the sharded cache (ConcurrentLruCache)
+ * @param fn Function prefix of the sharded cache (clrucache)
+ * @param Inner Type name prefix of the shard cache (LruCache)
+ * @param inner Function prefix of the shard cache (lrucache)
+ * @param K The key type
+ * @param V The value type
+ * @param get_lock Lock function taken by get: pthread_rwlock_rdlock or _wrlock
+ */
+#define _CONCURRENT_CACHE_DEFINE(Name, fn, Inner, inner, K, V, get_lock) \
+    /* One shard: a lock and a cache, padded to its own cache lines */ \
+    typedef struct { \
+        _Alignas(CYAN_CACHE_LINE) pthread_rwlock_t lock; \
+        Inner##_##K##_##V cache; \
+    } _##Name##Shard_##K##_##V; \
+    \
+    /* Forward declare the cache for use in vtable */ \
+    typedef struct Name##_##K##_##V Name##_##K##_##V; \
+    \
+    /** \
+     * @brief Vtable structure for the sharded cache, laid out like HashMapVT_K_V \
+     */ \
+    typedef struct { \
+        void (*insert)(Name##_##K##_##V *c, K key, V value); \
+        Option_##V (*get)(Name##_##K##_##V *c, K key); \
+        bool (*contains)(Name##_##K##_##V *c, K key); \
+        Option_##V (*remove)(Name##_##K##_##V *c, K key); \
+        size_t (*len)(Name##_##K##_##V *c); \
+        void (*free)(Name##_##K##_##V *c); \
+    } Name##VT_##K##_##V; \
+    \
+    /** \
+     * @brief Sharded cache structure with vtable pointer \
+     */ \
+    struct Name##_##K##_##V { \
+        _##Name##Shard_##K##_##V *shards; \
+        size_t shard_count;     /* Power of 2 */ \
+        unsigned shard_shift;   /* Hash bits to drop to get the shard index */ \
+        const Name##VT_##K##_##V *vt; \
+    }; \
+    \
+    /* Forward declare vtable instance */ \
+    static const Name##VT_##K##_##V _##fn##_##K##_##V##_vt; \
+    \
+    /** \
+     * @brief Create a cache with a given number of shards \
+     * @param capacity Total entries; split evenly, rounding up, over the shards \
+     * @param shards Requested shard count (rounded up to a power of 2, at least 1) \
+     * @return A new cache with all storage allocated \
+     */ \
+    static inline Name##_##K##_##V fn##_##K##_##V##_with_shards(size_t capacity, size_t shards) { \
+        size_t count = 1; \
+        unsigned bits = 0; \
+        while (count < shards) { count *= 2; bits++; } \
+        size_t per_shard = (capacity + count - 1) / count; \
+        \
+        Name##_##K##_##V c; \
+        c.shards = (_##Name##Shard_##K##_##V *)aligned_alloc( \
+            CYAN_CACHE_LINE, count * sizeof(_##Name##Shard_##K##_##V)); \
+        if (!c.shards) CYAN_PANIC("allocation failed"); \
+        c.shard_count = count; \
+        c.shard_shift = (unsigned)(sizeof(size_t) * 8) - bits; \
+        c.vt = &_##fn##_##K##_##V##_vt; \
+        \
+        for (size_t i = 0; i < count; i++) { \
+            if (pthread_rwlock_init(&c.shards[i].lock, NULL) != 0) { \
+                CYAN_PANIC(#fn "_new: rwlock initialization failed"); \
+            } \
+            c.shards[i].cache = inner##_##K##_##V##_new(per_shard > 0 ? per_shard : 1); \
+        } \
+        return c; \
+    } \
+    \
+    /** \
+     * @brief Create a cache with the default number of shards \
+     * @param capacity Total entries \
+     * @return A new cache with all storage allocated \
+     */ \
+    static inline Name##_##K##_##V fn##_##K##_##V##_new(size_t capacity) { \
+        return fn##_##K##_##V##_with_shards(capacity, CYAN_CONCURRENT_CACHE_SHARDS); \
+    } \
+    \
+    /** \
+     * @brief Set the eviction callback of every shard \
+     * @param c Pointer to the cache (before it is shared between threads) \
+     * @param on_evict Callback, run under the shard's write lock, or NULL \
+     * @param ctx User context passed to on_evict \
+     */ \
+    static inline void fn##_##K##_##V##_set_on_evict( \
+        Name##_##K##_##V *c, CacheEvictFn_##K##_##V on_evict, void *ctx \
+    ) { \
+        for (size_t i = 0; i < c->shard_count; i++) { \
+            c->shards[i].cache.on_evict = on_evict; \
+            c->shards[i].cache.evict_ctx = ctx; \
+        } \
+    } \
+    \
+    /** \
+     * @brief Select the shard responsible for a key \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @param hash Set to the key's hash, for the probe inside the shard \
+     * @return Pointer to the shard \
+     */ \
+    static inline _##Name##Shard_##K##_##V *_##fn##_##K##_##V##_shard( \
+        Name##_##K##_##V *c, K key, size_t *hash \
+    ) { \
+        /* Shards share hash settings, so shard 0 can hash for all of them */ \
+        *hash = _##inner##_##K##_##V##_hash(&c->shards[0].cache, key); \
+        if (c->shard_count == 1) return &c->shards[0]; \
+        return &c->shards[*hash >> c->shard_shift]; \
+    } \
+    \
+    /** \
+     * @brief Get a copy of the value for a key, counting it as a hit \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @return Option containing the value, or None if not cached \
+     */ \
+    static inline Option_##V fn##_##K##_##V##_get(Name##_##K##_##V *c, K key) { \
+        size_t hash; \
+        _##Name##Shard_##K##_##V *s = _##fn##_##K##_##V##_shard(c, key, &hash); \
+        get_lock(&s->lock); \
+        Option_##V result = _##inner##_##K##_##V##_get_hashed(&s->cache, key, hash); \
+        pthread_rwlock_unlock(&s->lock); \
+        return result; \
+    } \
+    \
+    /** \
+     * @brief Get a copy of the value for a key without counting a hit \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @return Option containing the value, or None if not cached \
+     */ \
+    static inline Option_##V fn##_##K##_##V##_peek(Name##_##K##_##V *c, K key) { \
+        size_t hash; \
+        _##Name##Shard_##K##_##V *s = _##fn##_##K##_##V##_shard(c, key, &hash); \
+        pthread_rwlock_rdlock(&s->lock); \
+        Option_##V result = inner##_##K##_##V##_peek(&s->cache, key); \
+        pthread_rwlock_unlock(&s->lock); \
+        return result; \
+    } \
+    \
+    /** \
+     * @brief Check if a key is cached \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @return true if cached, false otherwise \
+     */ \
+    static inline bool fn##_##K##_##V##_contains(Name##_##K##_##V *c, K key) { \
+        size_t hash; \
+        _##Name##Shard_##K##_##V *s = _##fn##_##K##_##V##_shard(c, key, &hash); \
+        pthread_rwlock_rdlock(&s->lock); \
+        bool result = _##inner##_##K##_##V##_find(&s->cache, key, hash) != _CYAN_CACHE_NIL; \
+        pthread_rwlock_unlock(&s->lock); \
+        return result; \
+    } \
+    \
+    /** \
+     * @brief Insert or update a key, evicting within its shard if full \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @param value The value \
+     */ \
+    static inline void fn##_##K##_##V##_put(Name##_##K##_##V *c, K key, V value) { \
+        size_t hash; \
+        _##Name##Shard_##K##_##V *s = _##fn##_##K##_##V##_shard(c, key, &hash); \
+        pthread_rwlock_wrlock(&s->lock); \
+        inner##_##K##_##V##_put(&s->cache, key, value); \
+        pthread_rwlock_unlock(&s->lock); \
+    } \
+    \
+    /** \
+     * @brief Remove a key and return its value \
+     * @param c Pointer to the cache \
+     * @param key The key \
+     * @return Option containing the removed value, or None if not cached \
+     */ \
+    static inline Option_##V fn##_##K##_##V##_remove(Name##_##K##_##V *c, K key) { \
+        size_t hash; \
+        _##Name##Shard_##K##_##V *s = _##fn##_##K##_##V##_shard(c, key, &hash); \
+        pthread_rwlock_wrlock(&s->lock); \
+        Option_##V result = inner##_##K##_##V##_remove(&s->cache, key); \
+        pthread_rwlock_unlock(&s->lock); \
+        return result; \
+    } \
+    \
+    /** \
+     * @brief Get the number of cached entries \
+     * @param c Pointer to the cache \
+     * @return Sum of shard sizes (may be stale if other threads are writing) \
+     */ \
+    static inline size_t fn##_##K##_##V##_len(Name##_##K##_##V *c) { \
+        size_t total = 0; \
+        for (size_t i = 0; i < c->shard_count; i++) { \
+            pthread_rwlock_rdlock(&c->shards[i].lock); \
+            total += inner##_##K##_##V##_len(&c->shards[i].cache); \
+            pthread_rwlock_unlock(&c->shards[i].lock); \
+        } \
+        return total; \
+    } \
+    \
+    /** \
+     * @brief Free all memory associated with the cache \
+     * @param c Pointer to the cache \
+     * @note Not thread-safe: no other thread may use the cache during or after free \
+     */ \
+    static inline void fn##_##K##_##V##_free(Name##_##K##_##V *c) { \
+        if (!c->shards) return; \
+        for (size_t i = 0; i < c->shard_count; i++) { \
+            inner##_##K##_##V##_free(&c->shards[i].cache); \
+            pthread_rwlock_destroy(&c->shards[i].lock); \
+        } \
+        free(c->shards); \
+        c->shards = NULL; \
+        c->shard_count = 0; \
+    } \
+    \
+    /** \
+     * @brief Static const vtable instance shared by all instances \
+     */ \
+    static const Name##VT_##K##_##V _##fn##_##K##_##V##_vt = { \
+        .insert = fn##_##K##_##V##_put, \
+        .get = fn##_##K##_##V##_get, \
+        .contains = fn##_##K##_##V##_contains, \
+        .remove = fn##_##K##_##V##_remove, \
+        .len = fn##_##K##_##V##_len, \
+        .free = fn##_##K##_##V##_free \
+    }
+
+/**
+ * @brief Generate a thread-safe sharded LRU cache type
+ * @param K The key type
+ * @param V The value type
+ *
+ * Creates ConcurrentLruCache_K_V and ConcurrentLruCacheVT_K_V with:
+ * - clrucache_K_V_new(capacity), clrucache_K_V_with_shards(capacity, n)
+ * - clrucache_K_V_set_on_evict(c, fn, ctx)
+ * - clrucache_K_V_get/peek/contains/put/remove(c, ...), clrucache_K_V_len(c)
+ * - clrucache_K_V_free(c)
+ *
+ * get takes the shard's write lock, since a hit relinks the entry.
+ *
+ * Requires: LRU_CACHE_DEFINE(K, V) must be called before CONCURRENT_LRU_CACHE_DEFINE(K, V)
+ */
+#define CONCURRENT_LRU_CACHE_DEFINE(K, V) \
+    _CONCURRENT_CACHE_DEFINE(ConcurrentLruCache, clrucache, LruCache, lrucache, K, V, \
+                             pthread_rwlock_wrlock); \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef ConcurrentLruCache_##K##_##V ConcurrentLruCache_##K##_##V##_defined
+
+/**
+ * @brief Generate a thread-safe sharded CLOCK cache type
+ * @param K The key type
+ * @param V The value type
+ *
+ * Creates ConcurrentClockCache_K_V and ConcurrentClockCacheVT_K_V with the
+ * same functions as CONCURRENT_LRU_CACHE_DEFINE under the cclockcache_
+ * prefix. get takes only the shard's read lock.
+ *
+ * Requires: CLOCK_CACHE_DEFINE(K, V) must be called before CONCURRENT_CLOCK_CACHE_DEFINE(K, V)
+ */
+#define CONCURRENT_CLOCK_CACHE_DEFINE(K, V) \
+    _CONCURRENT_CACHE_DEFINE(ConcurrentClockCache, cclockcache, ClockCache, clockcache, K, V, \
+                             pthread_rwlock_rdlock); \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef ConcurrentClockCache_##K##_##V ConcurrentClockCache_##K##_##V##_defined
+
+#endif /* CYAN_CONCURRENT_CACHE_H */
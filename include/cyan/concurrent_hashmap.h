@@ -0,0 +1,314 @@
+/**
+ * @file concurrent_hashmap.h
+ * @brief Sharded thread-safe hash map for the Cyan library
+ *
+ * This header provides a hash map that can be shared between threads. Keys
+ * are partitioned into a power-of-two number of shards, each an ordinary
+ * HashMap guarded by its own reader-writer lock, so readers never block one
+ * another and writers only contend with threads that hit the same shard.
+ *
+ * Usage:
+ *   OPTION_DEFINE(int);
+ *   HASHMAP_DEFINE(int, int);             // Shard map type
+ *   CONCURRENT_HASHMAP_DEFINE(int, int);  // ConcurrentHashMap_int_int
+ *
+ *   ConcurrentHashMap_int_int m = chashmap_int_int_new();
+ *   chashmap_int_int_insert(&m, 1, 100);   // From any thread
+ *   Option_int v = chashmap_int_int_get(&m, 1);
+ *   chashmap_int_int_free(&m);             // After all threads are done
+ *
+ * Requires POSIX threads (compile with -std=gnu11 or define _POSIX_C_SOURCE
+ * and link with -lpthread).
+ */
+
+#ifndef CYAN_CONCURRENT_HASHMAP_H
+#define CYAN_CONCURRENT_HASHMAP_H
+
+#include "common.h"
+#include "option.h"
+#include "hashmap.h"
+#include <pthread.h>
+#include <string.h>
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+/**
+ * @brief Default number of shards (must be a power of 2)
+ */
+#ifndef CYAN_CONCURRENT_HASHMAP_SHARDS
+#define CYAN_CONCURRENT_HASHMAP_SHARDS 16
+#endif
+
+/**
+ * @brief Cache line size used to pad shards apart
+ */
+#ifndef CYAN_CACHE_LINE
+#define CYAN_CACHE_LINE 64
+#endif
+
+/*============================================================================
+ * ConcurrentHashMap Type Definition Macro
+ *============================================================================*/
+
+/**
+ * @brief Generate a thread-safe sharded HashMap type for given key and value types
+ * @param K The key type
+ * @param V The value type
+ *
+ * Creates:
+ * - ConcurrentHashMap_K_V: The sharded map structure
+ * - ConcurrentHashMapVT_K_V: Vtable structure with function pointers
+ * - chashmap_K_V_new(): Create a map with CYAN_CONCURRENT_HASHMAP_SHARDS shards
+ * - chashmap_K_V_with_shards(n): Create a map with n shards (rounded up to a power of 2)
+ * - chashmap_K_V_insert(m, key, value): Insert or update
+ * - chashmap_K_V_get(m, key): Get a copy of the value as Option
+ * - chashmap_K_V_contains(m, key): Check if key exists
+ * - chashmap_K_V_remove(m, key): Remove and return value as Option
+ * - chashmap_K_V_compute(m, key, fn, ctx): Read-modify-write under the shard lock
+ * - chashmap_K_V_len(m): Number of entries
+ * - chashmap_K_V_free(m): Free all shards
+ *
+ * Each shard uses the hash and equality of HashMap_K_V, so a map defined
+ * with HASHMAP_DEFINE_WITH or HASHMAP_DEFINE_SCALAR shards with the same
+ * hash. The shard is chosen from the high bits of the hash and the bucket
+ * from the low bits, so the two stay independent.
+ *
+ * Every operation except free is safe to call concurrently. Values are
+ * copied out under the lock; pointers into a shard are never returned
+ * because another thread may resize it. The vtable matches HashMap's, so
+ * the MAP_* convenience macros work on ConcurrentHashMap_K_V too.
+ *
+ * Requires: HASHMAP_DEFINE(K, V) (or a variant) must be called before
+ * CONCURRENT_HASHMAP_DEFINE(K, V)
+ */
+#define CONCURRENT_HASHMAP_DEFINE(K, V) \
+    /** \
+     * @brief Callback for chashmap_K_V_compute \
+     * @param key The key being computed \
+     * @param value Current value if present, zeroed storage otherwise; may be modified \
+     * @param present true if the key was in the map \
+     * @param ctx User context pointer \
+     * @return true to store *value under key, false to remove the key \
+     */ \
+    typedef bool (*ConcurrentHashMapComputeFn_##K##_##V)( \
+        K key, V *value, bool present, void *ctx); \
+    \
+    /* One shard: a lock and a map, padded to its own cache lines */ \
+    typedef struct { \
+        _Alignas(CYAN_CACHE_LINE) pthread_rwlock_t lock; \
+        HashMap_##K##_##V map; \
+    } _CShard_##K##_##V; \
+    \
+    /* Forward declare ConcurrentHashMap_K_V for use in vtable */ \
+    typedef struct ConcurrentHashMap_##K##_##V ConcurrentHashMap_##K##_##V; \
+    \
+    /** \
+     * @brief Vtable structure for ConcurrentHashMap_K_V containing function pointers \
+     */ \
+    typedef struct { \
+        void (*insert)(ConcurrentHashMap_##K##_##V *m, K key, V value); \
+        Option_##V (*get)(ConcurrentHashMap_##K##_##V *m, K key); \
+        bool (*contains)(ConcurrentHashMap_##K##_##V *m, K key); \
+        Option_##V (*remove)(ConcurrentHashMap_##K##_##V *m, K key); \
+        size_t (*len)(ConcurrentHashMap_##K##_##V *m); \
+        void (*free)(ConcurrentHashMap_##K##_##V *m); \
+    } ConcurrentHashMapVT_##K##_##V; \
+    \
+    /** \
+     * @brief Sharded map structure with vtable pointer \
+     */ \
+    struct ConcurrentHashMap_##K##_##V { \
+        _CShard_##K##_##V *shards; \
+        size_t shard_count;     /* Power of 2 */ \
+        unsigned shard_shift;   /* Hash bits to drop to get the shard index */ \
+        const ConcurrentHashMapVT_##K##_##V *vt; \
+    }; \
+    \
+    /* Forward declare vtable instance */ \
+    static const ConcurrentHashMapVT_##K##_##V _chashmap_##K##_##V##_vt; \
+    \
+    /** \
+     * @brief Create a map with a given number of shards \
+     * @param shards Requested shard count (rounded up to a power of 2, at least 1) \
+     * @return A new ConcurrentHashMap_K_V \
+     */ \
+    static inline ConcurrentHashMap_##K##_##V chashmap_##K##_##V##_with_shards(size_t shards) { \
+        size_t count = 1; \
+        unsigned bits = 0; \
+        while (count < shards) { count *= 2; bits++; } \
+        \
+        ConcurrentHashMap_##K##_##V m; \
+        m.shards = (_CShard_##K##_##V *)aligned_alloc( \
+            CYAN_CACHE_LINE, count * sizeof(_CShard_##K##_##V)); \
+        if (!m.shards) CYAN_PANIC("allocation failed"); \
+        m.shard_count = count; \
+        m.shard_shift = (unsigned)(sizeof(size_t) * 8) - bits; \
+        m.vt = &_chashmap_##K##_##V##_vt; \
+        \
+        for (size_t i = 0; i < count; i++) { \
+            if (pthread_rwlock_init(&m.shards[i].lock, NULL) != 0) { \
+                CYAN_PANIC("chashmap_new: rwlock initialization failed"); \
+            } \
+            m.shards[i].map = hashmap_##K##_##V##_new(); \
+        } \
+        return m; \
+    } \
+    \
+    /** \
+     * @brief Create a map with the default number of shards \
+     * @return A new ConcurrentHashMap_K_V \
+     */ \
+    static inline ConcurrentHashMap_##K##_##V chashmap_##K##_##V##_new(void) { \
+        return chashmap_##K##_##V##_with_shards(CYAN_CONCURRENT_HASHMAP_SHARDS); \
+    } \
+    \
+    /** \
+     * @brief Select the shard responsible for a key \
+     * @param m Pointer to the map \
+     * @param key The key \
+     * @return Pointer to the shard \
+     */ \
+    static inline _CShard_##K##_##V *_chashmap_##K##_##V##_shard( \
+        ConcurrentHashMap_##K##_##V *m, K key \
+    ) { \
+        if (m->shard_count == 1) return &m->shards[0]; \
+        /* Shards share hash settings, so shard 0 can hash for all of them */ \
+        size_t h = _hashmap_##K##_##V##_hash(&m->shards[0].map, key); \
+        return &m->shards[h >> m->shard_shift]; \
+    } \
+    \
+    /** \
+     * @brief Insert or update a key-value pair \
+     * @param m Pointer to the map \
+     * @param key The key \
+     * @param value The value \
+     */ \
+    static inline void chashmap_##K##_##V##_insert(ConcurrentHashMap_##K##_##V *m, K key, V value) { \
+        _CShard_##K##_##V *s = _chashmap_##K##_##V##_shard(m, key); \
+        pthread_rwlock_wrlock(&s->lock); \
+        hashmap_##K##_##V##_insert(&s->map, key, value); \
+        pthread_rwlock_unlock(&s->lock); \
+    } \
+    \
+    /** \
+     * @brief Get a copy of the value for a key \
+     * @param m Pointer to the map \
+     * @param key The key \
+     * @return Option containing the value, or None if not found \
+     */ \
+    static inline Option_##V chashmap_##K##_##V##_get(ConcurrentHashMap_##K##_##V *m, K key) { \
+        _CShard_##K##_##V *s = _chashmap_##K##_##V##_shard(m, key); \
+        pthread_rwlock_rdlock(&s->lock); \
+        Option_##V result = hashmap_##K##_##V##_get(&s->map, key); \
+        pthread_rwlock_unlock(&s->lock); \
+        return result; \
+    } \
+    \
+    /** \
+     * @brief Check if a key exists \
+     * @param m Pointer to the map \
+     * @param key The key \
+     * @return true if key exists, false otherwise \
+     */ \
+    static inline bool chashmap_##K##_##V##_contains(ConcurrentHashMap_##K##_##V *m, K key) { \
+        _CShard_##K##_##V *s = _chashmap_##K##_##V##_shard(m, key); \
+        pthread_rwlock_rdlock(&s->lock); \
+        bool result = hashmap_##K##_##V##_contains(&s->map, key); \
+        pthread_rwlock_unlock(&s->lock); \
+        return result; \
+    } \
+    \
+    /** \
+     * @brief Remove a key and return its value \
+     * @param m Pointer to the map \
+     * @param key The key \
+     * @return Option containing the removed value, or None if not found \
+     */ \
+    static inline Option_##V chashmap_##K##_##V##_remove(ConcurrentHashMap_##K##_##V *m, K key) { \
+        _CShard_##K##_##V *s = _chashmap_##K##_##V##_shard(m, key); \
+        pthread_rwlock_wrlock(&s->lock); \
+        Option_##V result = hashmap_##K##_##V##_remove(&s->map, key); \
+        pthread_rwlock_unlock(&s->lock); \
+        return result; \
+    } \
+    \
+    /** \
+     * @brief Atomically read, modify and store or remove a value \
+     * @param m Pointer to the map \
+     * @param key The key \
+     * @param fn Callback run while the shard's write lock is held \
+     * @param ctx User context passed to fn \
+     * @return true if the key is present after the call \
+     * @note fn must not call back into the same map \
+     */ \
+    static inline bool chashmap_##K##_##V##_compute( \
+        ConcurrentHashMap_##K##_##V *m, K key, \
+        ConcurrentHashMapComputeFn_##K##_##V fn, void *ctx \
+    ) { \
+        _CShard_##K##_##V *s = _chashmap_##K##_##V##_shard(m, key); \
+        pthread_rwlock_wrlock(&s->lock); \
+        \
+        HashMapEntry_##K##_##V e = hashmap_##K##_##V##_entry(&s->map, key); \
+        bool keep; \
+        if (hashmap_##K##_##V##_entry_is_occupied(&e)) { \
+            keep = fn(key, hashmap_##K##_##V##_entry_get(&e), true, ctx); \
+            if (!keep) hashmap_##K##_##V##_entry_remove(&e); \
+        } else { \
+            V value; \
+            memset(&value, 0, sizeof(V)); \
+            keep = fn(key, &value, false, ctx); \
+            if (keep) hashmap_##K##_##V##_entry_insert(&e, value); \
+        } \
+        \
+        pthread_rwlock_unlock(&s->lock); \
+        return keep; \
+    } \
+    \
+    /** \
+     * @brief Get the number of entries \
+     * @param m Pointer to the map \
+     * @return Sum of shard sizes (may be stale if other threads are writing) \
+     */ \
+    static inline size_t chashmap_##K##_##V##_len(ConcurrentHashMap_##K##_##V *m) { \
+        size_t total = 0; \
+        for (size_t i = 0; i < m->shard_count; i++) { \
+            pthread_rwlock_rdlock(&m->shards[i].lock); \
+            total += hashmap_##K##_##V##_len(&m->shards[i].map); \
+            pthread_rwlock_unlock(&m->shards[i].lock); \
+        } \
+        return total; \
+    } \
+    \
+    /** \
+     * @brief Free all memory associated with the map \
+     * @param m Pointer to the map \
+     * @note Not thread-safe: no other thread may use the map during or after free \
+     */ \
+    static inline void chashmap_##K##_##V##_free(ConcurrentHashMap_##K##_##V *m) { \
+        if (!m->shards) return; \
+        for (size_t i = 0; i < m->shard_count; i++) { \
+            hashmap_##K##_##V##_free(&m->shards[i].map); \
+            pthread_rwlock_destroy(&m->shards[i].lock); \
+        } \
+        free(m->shards); \
+        m->shards = NULL; \
+        m->shard_count = 0; \
+    } \
+    \
+    /** \
+     * @brief Static const vtable instance shared by all ConcurrentHashMap_K_V instances \
+     */ \
+    static const ConcurrentHashMapVT_##K##_##V _chashmap_##K##_##V##_vt = { \
+        .insert = chashmap_##K##_##V##_insert, \
+        .get = chashmap_##K##_##V##_get, \
+        .contains = chashmap_##K##_##V##_contains, \
+        .remove = chashmap_##K##_##V##_remove, \
+        .len = chashmap_##K##_##V##_len, \
+        .free = chashmap_##K##_##V##_free \
+    }; \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef ConcurrentHashMap_##K##_##V ConcurrentHashMap_##K##_##V##_defined
+
+#endif /* CYAN_CONCURRENT_HASHMAP_H */
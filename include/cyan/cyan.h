@@ -21,6 +21,7 @@
  * - CYAN_GROWTH_FACTOR - Growth multiplier for collections (default: 2)
  * - CYAN_CORO_STACK_SIZE - Coroutine stack size in bytes (default: 64KB)
  * - CYAN_CHANNEL_THREADSAFE - Enable thread-safe channels
+ * - CYAN_CONCURRENT_HASHMAP_SHARDS - Default shard count for ConcurrentHashMap (default: 16)
  */
 
 #ifndef CYAN_H
@@ -83,9 +84,42 @@
 /** @brief Defined when HashMap is available */
 #define CYAN_HAS_HASHMAP 1
 
+/** @brief Defined when the hash function suite is available */
+#define CYAN_HAS_HASH 1
+
+/** @brief Defined when the string-keyed StrMap is available */
+#define CYAN_HAS_STRMAP 1
+
+/** @brief Defined when HashSet is available */
+#define CYAN_HAS_HASHSET 1
+
+/** @brief Defined when the insertion-ordered IndexMap is available */
+#define CYAN_HAS_INDEXMAP 1
+
+/** @brief Defined when the LRU and CLOCK caches are available */
+#define CYAN_HAS_CACHE 1
+
+/** @brief Defined when static perfect-hash tables are available */
+#define CYAN_HAS_PHF 1
+
 /** @brief Defined when dynamic String is available */
 #define CYAN_HAS_STRING 1
 
+/** @brief Defined when the chunked StringBuilder is available */
+#define CYAN_HAS_STRING_BUILDER 1
+
+/** @brief Defined when substring search and split iterators are available */
+#define CYAN_HAS_STRING_SEARCH 1
+
+/** @brief Defined when fast number formatting into String is available */
+#define CYAN_HAS_STRING_NUM 1
+
+/** @brief Defined when UTF-8 validation and transcoding are available */
+#define CYAN_HAS_UTF8 1
+
+/** @brief Defined when reference-counted SharedString is available */
+#define CYAN_HAS_SHARED_STRING 1
+
 /** @brief Defined when pattern matching macros are available */
 #define CYAN_HAS_MATCH 1
 
@@ -134,7 +168,44 @@
 #include "vector.h"
 #include "slice.h"
 #include "string.h"
+#include "string_builder.h"
+#include "string_search.h"
+#include "numfmt.h"
+#include "string_num.h"
+#include "utf8.h"
+#include "shared_string.h"
+#include "hash.h"
 #include "hashmap.h"
+#include "hashset.h"
+#include "indexmap.h"
+#include "cache.h"
+#include "phf.h"
+
+/* Thread- and file-based containers need POSIX; skipped under strict ISO builds */
+#if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L
+#include "concurrent_hashmap.h"
+#include "concurrent_cache.h"
+#include "hashmap_mmap.h"
+#include "hashmap_parallel.h"
+#define CYAN_HAS_CONCURRENT_HASHMAP 1
+#define CYAN_HAS_CONCURRENT_CACHE 1
+#define CYAN_HAS_HASHMAP_MMAP 1
+#define CYAN_HAS_HASHMAP_PARALLEL 1
+#else
+#define CYAN_HAS_CONCURRENT_HASHMAP 0
+#define CYAN_HAS_CONCURRENT_CACHE 0
+#define CYAN_HAS_HASHMAP_MMAP 0
+#define CYAN_HAS_HASHMAP_PARALLEL 0
+#endif
+#include "strmap.h"
+
+/* String interning - arena-backed like strmap, locked with pthreads */
+#if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L
+#include "intern.h"
+#define CYAN_HAS_INTERN 1
+#else
+#define CYAN_HAS_INTERN 0
+#endif
 
 /* Functional primitives - work with collections */
 #include "functional.h"
@@ -0,0 +1,557 @@
+/**
+ * @file hash.h
+ * @brief Hash functions for the Cyan library's hashed containers
+ * 
+ * This header provides the HashFn/EqualFn function types used by HashMap
+ * together with a family of hash functions to choose from:
+ * - FNV-1a: byte-at-a-time, tiny and portable (unseeded; used only when
+ *   assigned as a map's hash_fn)
+ * - wyhash: reads 8-16 bytes per step, fast for medium and long keys (its
+ *   seeded form is the HashMap default, see below)
+ * - CRC32C: uses the SSE4.2 crc32 instruction when the CPU supports it
+ * - Integer mixer: a single finalizer for 4- and 8-byte keys
+ * 
+ * Every function has the HashFn signature, so it can be assigned to a
+ * map's hash_fn field, and a matching CYAN_HASH_* expression macro for
+ * HASHMAP_DEFINE_WITH.
+ * 
+ * It also provides seeded variants (SeededHashFn) and the random seeds the
+ * hashed containers use by default: new maps hash with seeded_hash_fn =
+ * cyan_hash_wy_seeded under a seed from cyan_hash_process_seed(), so that
+ * callers who choose keys (for example HTTP header names) cannot
+ * precompute keys that collide.
+ * 
+ * Usage:
+ *   HashMap_int_int m = hashmap_int_int_new();
+ *   m.hash_fn = cyan_hash_int;            // Unseeded, fixed hash
+ * 
+ *   HASHMAP_DEFINE_WITH(Point, int, CYAN_HASH_WY, CYAN_EQ_BYTES);
+ */
+
+#ifndef CYAN_HASH_H
+#define CYAN_HASH_H
+
+#include "common.h"
+#include <string.h>
+#include <time.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<sys/random.h>)
+#include <sys/random.h>
+#define _CYAN_HASH_HAS_GETRANDOM 1
+#endif
+#endif
+#ifndef _CYAN_HASH_HAS_GETRANDOM
+#define _CYAN_HASH_HAS_GETRANDOM 0
+#endif
+
+#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+#include <stdlib.h>
+#define _CYAN_HASH_HAS_ARC4RANDOM 1
+#else
+#define _CYAN_HASH_HAS_ARC4RANDOM 0
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define _CYAN_HASH_HAS_X86_CRC 1
+#else
+#define _CYAN_HASH_HAS_X86_CRC 0
+#endif
+
+/*============================================================================
+ * Hash Function Types
+ *============================================================================*/
+
+/**
+ * @brief Hash function type
+ * @param key Pointer to the key data
+ * @param key_size Size of the key in bytes
+ * @return Hash value
+ */
+typedef size_t (*HashFn)(const void *key, size_t key_size);
+
+/**
+ * @brief Equality function type
+ * @param a Pointer to first key
+ * @param b Pointer to second key
+ * @param size Size of keys in bytes
+ * @return true if keys are equal
+ */
+typedef bool (*EqualFn)(const void *a, const void *b, size_t size);
+
+/**
+ * @brief Seeded hash function type
+ * @param key Pointer to the key data
+ * @param key_size Size of the key in bytes
+ * @param seed Secret that changes which keys collide
+ * @return Hash value
+ */
+typedef size_t (*SeededHashFn)(const void *key, size_t key_size, uint64_t seed);
+
+/*============================================================================
+ * Default Hash Function (FNV-1a)
+ *============================================================================*/
+
+/**
+ * @brief FNV-1a hash function
+ * 
+ * A fast, non-cryptographic hash function with good distribution.
+ * Uses the 64-bit FNV-1a algorithm.
+ */
+static inline size_t _cyan_fnv1a_hash(const void *key, size_t key_size) {
+    const unsigned char *data = (const unsigned char *)key;
+    size_t hash = 14695981039346656037ULL;  /* FNV offset basis */
+    
+    for (size_t i = 0; i < key_size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;  /* FNV prime */
+    }
+    
+    return hash;
+}
+
+/**
+ * @brief Default equality function using memcmp
+ */
+static inline bool _cyan_default_equal(const void *a, const void *b, size_t size) {
+    return memcmp(a, b, size) == 0;
+}
+
+/**
+ * @brief 64-bit integer mixer (splitmix64 finalizer)
+ * 
+ * Spreads every input bit over the whole output so that sequential or
+ * strided integer keys land in different buckets.
+ */
+static inline uint64_t _cyan_hash_u64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/*============================================================================
+ * wyhash
+ *============================================================================*/
+
+/* wyhash default secret */
+#define _CYAN_WY_S0 0x2d358dccaa6c78a5ULL
+#define _CYAN_WY_S1 0x8bb84b93962eacc9ULL
+#define _CYAN_WY_S2 0x4b33a62ed433d4a3ULL
+#define _CYAN_WY_S3 0x4d5a2da51de1aa47ULL
+
+/**
+ * @brief 64x64 -> 128 bit multiply, low half into *a and high half into *b
+ */
+static inline void _cyan_wy_mum(uint64_t *a, uint64_t *b) {
+#if CYAN_HAS_INT128
+    u128 r = (u128)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32;
+    uint64_t la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t _cyan_wy_mix(uint64_t a, uint64_t b) {
+    _cyan_wy_mum(&a, &b);
+    return a ^ b;
+}
+
+static inline uint64_t _cyan_wy_r8(const unsigned char *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint64_t _cyan_wy_r4(const unsigned char *p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+static inline uint64_t _cyan_wy_r3(const unsigned char *p, size_t k) {
+    return ((uint64_t)p[0] << 16) | ((uint64_t)p[k >> 1] << 8) | p[k - 1];
+}
+
+/**
+ * @brief wyhash over a byte range with an explicit seed
+ * @param key Pointer to the key data
+ * @param len Size of the key in bytes
+ * @param seed Seed mixed into the initial state
+ * @return 64-bit hash value
+ */
+static inline uint64_t _cyan_wyhash(const void *key, size_t len, uint64_t seed) {
+    const unsigned char *p = (const unsigned char *)key;
+    uint64_t a, b;
+    
+    seed ^= _cyan_wy_mix(seed ^ _CYAN_WY_S0, _CYAN_WY_S1);
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (_cyan_wy_r4(p) << 32) | _cyan_wy_r4(p + ((len >> 3) << 2));
+            b = (_cyan_wy_r4(p + len - 4) << 32) | _cyan_wy_r4(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = _cyan_wy_r3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            /* Three independent lanes of 16 bytes each */
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = _cyan_wy_mix(_cyan_wy_r8(p) ^ _CYAN_WY_S1, _cyan_wy_r8(p + 8) ^ seed);
+                see1 = _cyan_wy_mix(_cyan_wy_r8(p + 16) ^ _CYAN_WY_S2, _cyan_wy_r8(p + 24) ^ see1);
+                see2 = _cyan_wy_mix(_cyan_wy_r8(p + 32) ^ _CYAN_WY_S3, _cyan_wy_r8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = _cyan_wy_mix(_cyan_wy_r8(p) ^ _CYAN_WY_S1, _cyan_wy_r8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = _cyan_wy_r8(p + i - 16);
+        b = _cyan_wy_r8(p + i - 8);
+    }
+    
+    a ^= _CYAN_WY_S1;
+    b ^= seed;
+    _cyan_wy_mum(&a, &b);
+    return _cyan_wy_mix(a ^ _CYAN_WY_S0 ^ len, b ^ _CYAN_WY_S1);
+}
+
+/*============================================================================
+ * CRC32C
+ *============================================================================*/
+
+/**
+ * @brief CRC32C (Castagnoli) lookup table for the portable fallback
+ */
+static const uint32_t _cyan_crc32c_table[256] = {
+    0x00000000U, 0xf26b8303U, 0xe13b70f7U, 0x1350f3f4U, 0xc79a971fU, 0x35f1141cU,
+    0x26a1e7e8U, 0xd4ca64ebU, 0x8ad958cfU, 0x78b2dbccU, 0x6be22838U, 0x9989ab3bU,
+    0x4d43cfd0U, 0xbf284cd3U, 0xac78bf27U, 0x5e133c24U, 0x105ec76fU, 0xe235446cU,
+    0xf165b798U, 0x030e349bU, 0xd7c45070U, 0x25afd373U, 0x36ff2087U, 0xc494a384U,
+    0x9a879fa0U, 0x68ec1ca3U, 0x7bbcef57U, 0x89d76c54U, 0x5d1d08bfU, 0xaf768bbcU,
+    0xbc267848U, 0x4e4dfb4bU, 0x20bd8edeU, 0xd2d60dddU, 0xc186fe29U, 0x33ed7d2aU,
+    0xe72719c1U, 0x154c9ac2U, 0x061c6936U, 0xf477ea35U, 0xaa64d611U, 0x580f5512U,
+    0x4b5fa6e6U, 0xb93425e5U, 0x6dfe410eU, 0x9f95c20dU, 0x8cc531f9U, 0x7eaeb2faU,
+    0x30e349b1U, 0xc288cab2U, 0xd1d83946U, 0x23b3ba45U, 0xf779deaeU, 0x05125dadU,
+    0x1642ae59U, 0xe4292d5aU, 0xba3a117eU, 0x4851927dU, 0x5b016189U, 0xa96ae28aU,
+    0x7da08661U, 0x8fcb0562U, 0x9c9bf696U, 0x6ef07595U, 0x417b1dbcU, 0xb3109ebfU,
+    0xa0406d4bU, 0x522bee48U, 0x86e18aa3U, 0x748a09a0U, 0x67dafa54U, 0x95b17957U,
+    0xcba24573U, 0x39c9c670U, 0x2a993584U, 0xd8f2b687U, 0x0c38d26cU, 0xfe53516fU,
+    0xed03a29bU, 0x1f682198U, 0x5125dad3U, 0xa34e59d0U, 0xb01eaa24U, 0x42752927U,
+    0x96bf4dccU, 0x64d4cecfU, 0x77843d3bU, 0x85efbe38U, 0xdbfc821cU, 0x2997011fU,
+    0x3ac7f2ebU, 0xc8ac71e8U, 0x1c661503U, 0xee0d9600U, 0xfd5d65f4U, 0x0f36e6f7U,
+    0x61c69362U, 0x93ad1061U, 0x80fde395U, 0x72966096U, 0xa65c047dU, 0x5437877eU,
+    0x4767748aU, 0xb50cf789U, 0xeb1fcbadU, 0x197448aeU, 0x0a24bb5aU, 0xf84f3859U,
+    0x2c855cb2U, 0xdeeedfb1U, 0xcdbe2c45U, 0x3fd5af46U, 0x7198540dU, 0x83f3d70eU,
+    0x90a324faU, 0x62c8a7f9U, 0xb602c312U, 0x44694011U, 0x5739b3e5U, 0xa55230e6U,
+    0xfb410cc2U, 0x092a8fc1U, 0x1a7a7c35U, 0xe811ff36U, 0x3cdb9bddU, 0xceb018deU,
+    0xdde0eb2aU, 0x2f8b6829U, 0x82f63b78U, 0x709db87bU, 0x63cd4b8fU, 0x91a6c88cU,
+    0x456cac67U, 0xb7072f64U, 0xa457dc90U, 0x563c5f93U, 0x082f63b7U, 0xfa44e0b4U,
+    0xe9141340U, 0x1b7f9043U, 0xcfb5f4a8U, 0x3dde77abU, 0x2e8e845fU, 0xdce5075cU,
+    0x92a8fc17U, 0x60c37f14U, 0x73938ce0U, 0x81f80fe3U, 0x55326b08U, 0xa759e80bU,
+    0xb4091bffU, 0x466298fcU, 0x1871a4d8U, 0xea1a27dbU, 0xf94ad42fU, 0x0b21572cU,
+    0xdfeb33c7U, 0x2d80b0c4U, 0x3ed04330U, 0xccbbc033U, 0xa24bb5a6U, 0x502036a5U,
+    0x4370c551U, 0xb11b4652U, 0x65d122b9U, 0x97baa1baU, 0x84ea524eU, 0x7681d14dU,
+    0x2892ed69U, 0xdaf96e6aU, 0xc9a99d9eU, 0x3bc21e9dU, 0xef087a76U, 0x1d63f975U,
+    0x0e330a81U, 0xfc588982U, 0xb21572c9U, 0x407ef1caU, 0x532e023eU, 0xa145813dU,
+    0x758fe5d6U, 0x87e466d5U, 0x94b49521U, 0x66df1622U, 0x38cc2a06U, 0xcaa7a905U,
+    0xd9f75af1U, 0x2b9cd9f2U, 0xff56bd19U, 0x0d3d3e1aU, 0x1e6dcdeeU, 0xec064eedU,
+    0xc38d26c4U, 0x31e6a5c7U, 0x22b65633U, 0xd0ddd530U, 0x0417b1dbU, 0xf67c32d8U,
+    0xe52cc12cU, 0x1747422fU, 0x49547e0bU, 0xbb3ffd08U, 0xa86f0efcU, 0x5a048dffU,
+    0x8ecee914U, 0x7ca56a17U, 0x6ff599e3U, 0x9d9e1ae0U, 0xd3d3e1abU, 0x21b862a8U,
+    0x32e8915cU, 0xc083125fU, 0x144976b4U, 0xe622f5b7U, 0xf5720643U, 0x07198540U,
+    0x590ab964U, 0xab613a67U, 0xb831c993U, 0x4a5a4a90U, 0x9e902e7bU, 0x6cfbad78U,
+    0x7fab5e8cU, 0x8dc0dd8fU, 0xe330a81aU, 0x115b2b19U, 0x020bd8edU, 0xf0605beeU,
+    0x24aa3f05U, 0xd6c1bc06U, 0xc5914ff2U, 0x37faccf1U, 0x69e9f0d5U, 0x9b8273d6U,
+    0x88d28022U, 0x7ab90321U, 0xae7367caU, 0x5c18e4c9U, 0x4f48173dU, 0xbd23943eU,
+    0xf36e6f75U, 0x0105ec76U, 0x12551f82U, 0xe03e9c81U, 0x34f4f86aU, 0xc69f7b69U,
+    0xd5cf889dU, 0x27a40b9eU, 0x79b737baU, 0x8bdcb4b9U, 0x988c474dU, 0x6ae7c44eU,
+    0xbe2da0a5U, 0x4c4623a6U, 0x5f16d052U, 0xad7d5351U
+};
+
+/**
+ * @brief Portable CRC32C, one byte per step
+ */
+static inline uint32_t _cyan_crc32c_sw(uint32_t crc, const unsigned char *p, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc = _cyan_crc32c_table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#if _CYAN_HASH_HAS_X86_CRC
+/**
+ * @brief CRC32C using the SSE4.2 crc32 instruction, 8 bytes per step
+ */
+__attribute__((target("sse4.2")))
+static inline uint32_t _cyan_crc32c_hw(uint32_t crc, const unsigned char *p, size_t len) {
+#if defined(__x86_64__)
+    uint64_t c = crc;
+    while (len >= 8) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        c = _mm_crc32_u64(c, v);
+        p += 8;
+        len -= 8;
+    }
+    crc = (uint32_t)c;
+#endif
+    while (len >= 4) {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        crc = _mm_crc32_u32(crc, v);
+        p += 4;
+        len -= 4;
+    }
+    while (len > 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+        len--;
+    }
+    return crc;
+}
+#endif
+
+/**
+ * @brief Compute CRC32C over a byte range
+ * @param data Pointer to the data
+ * @param len Number of bytes
+ * @param crc Running CRC from a previous call, or 0 to start
+ * @return Updated CRC32C value
+ * 
+ * Uses the SSE4.2 crc32 instruction when the running CPU supports it,
+ * otherwise a table-driven loop. Both paths produce identical results.
+ */
+static inline uint32_t cyan_crc32c(const void *data, size_t len, uint32_t crc) {
+    const unsigned char *p = (const unsigned char *)data;
+    crc = ~crc;
+#if _CYAN_HASH_HAS_X86_CRC
+    if (__builtin_cpu_supports("sse4.2")) {
+        return ~_cyan_crc32c_hw(crc, p, len);
+    }
+#endif
+    return ~_cyan_crc32c_sw(crc, p, len);
+}
+
+/*============================================================================
+ * HashFn-Compatible Hash Functions
+ *============================================================================*/
+
+/**
+ * @brief FNV-1a hash (HashFn)
+ */
+static inline size_t cyan_hash_fnv1a(const void *key, size_t key_size) {
+    return _cyan_fnv1a_hash(key, key_size);
+}
+
+/**
+ * @brief wyhash (HashFn)
+ * 
+ * Processes 16-48 bytes per step; the best general-purpose choice for
+ * keys longer than a few bytes.
+ */
+static inline size_t cyan_hash_wy(const void *key, size_t key_size) {
+    return (size_t)_cyan_wyhash(key, key_size, 0);
+}
+
+/**
+ * @brief CRC32C-based hash (HashFn)
+ * 
+ * The 32-bit CRC is passed through the integer mixer so the upper bits of
+ * the result are populated as well.
+ */
+static inline size_t cyan_hash_crc32c(const void *key, size_t key_size) {
+    return (size_t)_cyan_hash_u64(cyan_crc32c(key, key_size, 0) ^ ((uint64_t)key_size << 32));
+}
+
+/**
+ * @brief Finalizer-only hash for 4- and 8-byte keys (HashFn)
+ * 
+ * Loads the key as one integer and runs the integer mixer once. Keys of
+ * any other size fall back to wyhash.
+ */
+static inline size_t cyan_hash_int(const void *key, size_t key_size) {
+    if (key_size == 8) {
+        uint64_t v;
+        memcpy(&v, key, 8);
+        return (size_t)_cyan_hash_u64(v);
+    }
+    if (key_size == 4) {
+        uint32_t v;
+        memcpy(&v, key, 4);
+        return (size_t)_cyan_hash_u64(v);
+    }
+    return cyan_hash_wy(key, key_size);
+}
+
+/*============================================================================
+ * Seeded Hash Functions
+ *============================================================================*/
+
+/**
+ * @brief wyhash with a seed (SeededHashFn)
+ * 
+ * The default hash of HashMap, HashSet and IndexMap. Every seed bit takes
+ * part in the mixing, so keys that collide under one seed are unrelated
+ * under another.
+ */
+static inline size_t cyan_hash_wy_seeded(const void *key, size_t key_size, uint64_t seed) {
+    return (size_t)_cyan_wyhash(key, key_size, seed);
+}
+
+/**
+ * @brief Integer mixer with a seed (SeededHashFn)
+ * 
+ * Mixes the seed into 4- and 8-byte keys before the finalizer; keys of
+ * any other size fall back to seeded wyhash.
+ */
+static inline size_t cyan_hash_int_seeded(const void *key, size_t key_size, uint64_t seed) {
+    if (key_size == 8) {
+        uint64_t v;
+        memcpy(&v, key, 8);
+        return (size_t)_cyan_hash_u64(v ^ seed);
+    }
+    if (key_size == 4) {
+        uint32_t v;
+        memcpy(&v, key, 4);
+        return (size_t)_cyan_hash_u64(v ^ seed);
+    }
+    return cyan_hash_wy_seeded(key, key_size, seed);
+}
+
+/*
+ * There are no seeded FNV-1a or CRC32C variants: the low bits of FNV-1a
+ * depend only on the low bits of its state, and CRC is linear, so in both
+ * cases keys that collide in the bucket index collide for almost any seed.
+ */
+
+/*============================================================================
+ * Hash Seeds
+ *============================================================================*/
+
+/**
+ * @brief Draw a fresh random seed
+ * @return 64 random bits
+ * 
+ * Uses getrandom on Linux and arc4random elsewhere where available. If
+ * neither works, mixes the clock and an address, which still defeats
+ * precomputed key sets but is not cryptographically strong.
+ */
+static inline uint64_t cyan_hash_random_seed(void) {
+    uint64_t seed = 0;
+#if _CYAN_HASH_HAS_GETRANDOM
+    if (getrandom(&seed, sizeof(seed), GRND_NONBLOCK) == (ssize_t)sizeof(seed)) return seed;
+#elif _CYAN_HASH_HAS_ARC4RANDOM
+    arc4random_buf(&seed, sizeof(seed));
+    return seed;
+#endif
+    static uint64_t counter;
+    seed = (uint64_t)time(NULL) ^ ((uint64_t)clock() << 32) ^ (uint64_t)(uintptr_t)&seed;
+    return _cyan_hash_u64(seed + ++counter * 0x9E3779B97F4A7C15ULL);
+}
+
+/* Process-wide seed shared by every translation unit; 0 until first drawn */
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((weak)) uint64_t _cyan_hash_process_seed_value;
+#define _CYAN_SEED_LOAD() __atomic_load_n(&_cyan_hash_process_seed_value, __ATOMIC_ACQUIRE)
+#define _CYAN_SEED_PUBLISH(expected, fresh) \
+    __atomic_compare_exchange_n(&_cyan_hash_process_seed_value, (expected), (fresh), false, \
+                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#else
+static uint64_t _cyan_hash_process_seed_value;  /* One per translation unit */
+#define _CYAN_SEED_LOAD() _cyan_hash_process_seed_value
+#define _CYAN_SEED_PUBLISH(expected, fresh) (_cyan_hash_process_seed_value = (fresh), true)
+#endif
+
+/**
+ * @brief Get the per-process seed used by newly created containers
+ * @return The same non-zero value for the life of the process
+ * 
+ * Drawn from cyan_hash_random_seed on first use. Define
+ * CYAN_HASH_DETERMINISTIC to use a fixed seed instead, for reproducible
+ * iteration order in tests. Each container stores its own copy of the
+ * seed, so compilers without weak symbols (where every translation unit
+ * draws its own) still hash consistently.
+ */
+static inline uint64_t cyan_hash_process_seed(void) {
+#ifdef CYAN_HASH_DETERMINISTIC
+    return 0x9E3779B97F4A7C15ULL;
+#else
+    uint64_t seed = _CYAN_SEED_LOAD();
+    if (seed == 0) {
+        uint64_t fresh = cyan_hash_random_seed() | 1;
+        /* The first thread to publish wins; losers adopt its value */
+        if (_CYAN_SEED_PUBLISH(&seed, fresh)) seed = fresh;
+    }
+    return seed;
+#endif
+}
+
+/*============================================================================
+ * Compile-Time Hash and Equality Expressions
+ *============================================================================
+ * For use with HASHMAP_DEFINE_WITH and PHF_DEFINE_WITH. Each takes key
+ * values (not pointers); the byte-wise variants require the key to be an
+ * lvalue.
+ */
+
+/**
+ * @brief Hash an integer, enum or pointer key with the integer mixer
+ */
+#define CYAN_HASH_SCALAR(k) ((size_t)_cyan_hash_u64((uint64_t)(k)))
+
+/**
+ * @brief Compare two scalar keys with ==
+ */
+#define CYAN_EQ_SCALAR(a, b) ((a) == (b))
+
+/**
+ * @brief Hash the raw bytes of a key with FNV-1a
+ */
+#define CYAN_HASH_BYTES(k) _cyan_fnv1a_hash(&(k), sizeof(k))
+
+/**
+ * @brief Hash the raw bytes of a key with wyhash
+ */
+#define CYAN_HASH_WY(k) cyan_hash_wy(&(k), sizeof(k))
+
+/**
+ * @brief Hash the raw bytes of a key with CRC32C
+ */
+#define CYAN_HASH_CRC32C(k) cyan_hash_crc32c(&(k), sizeof(k))
+
+/**
+ * @brief Compare the raw bytes of two keys with memcmp (same as HASHMAP_DEFINE)
+ */
+#define CYAN_EQ_BYTES(a, b) (memcmp(&(a), &(b), sizeof(a)) == 0)
+
+/**
+ * @brief Hash the characters of a NUL-terminated string key with wyhash
+ */
+#define CYAN_HASH_CSTR(k) cyan_hash_wy((k), strlen(k))
+
+/**
+ * @brief Compare two NUL-terminated string keys with strcmp
+ */
+#define CYAN_EQ_CSTR(a, b) (strcmp((a), (b)) == 0)
+
+#endif /* CYAN_HASH_H */
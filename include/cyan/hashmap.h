@@ -14,6 +14,9 @@
  *   hashmap_int_int_insert(&m, 42, 100);
  *   Option_int val = hashmap_int_int_get(&m, 42);
  *   hashmap_int_int_free(&m);
+ * 
+ * For integer keys, HASHMAP_DEFINE_SCALAR(int, int) inlines the hash and
+ * comparison instead of calling them through function pointers.
  */
 
 #ifndef CYAN_HASHMAP_H
@@ -21,75 +24,54 @@
 
 #include "common.h"
 #include "option.h"
+#include "hash.h"
 #include <string.h>
+#include <time.h>
 
 /*============================================================================
- * Hash Function Types
+ * Configuration
  *============================================================================*/
 
 /**
- * @brief Hash function type
- * @param key Pointer to the key data
- * @param key_size Size of the key in bytes
- * @return Hash value
+ * @brief Default initial capacity for hash maps
  */
-typedef size_t (*HashFn)(const void *key, size_t key_size);
+#ifndef CYAN_HASHMAP_INITIAL_CAPACITY
+#define CYAN_HASHMAP_INITIAL_CAPACITY 16
+#endif
 
 /**
- * @brief Equality function type
- * @param a Pointer to first key
- * @param b Pointer to second key
- * @param size Size of keys in bytes
- * @return true if keys are equal
+ * @brief Load factor threshold for resizing (as percentage)
+ * When (len * 100 / capacity) exceeds this, the map resizes
  */
-typedef bool (*EqualFn)(const void *a, const void *b, size_t size);
-
-/*============================================================================
- * Default Hash Function (FNV-1a)
- *============================================================================*/
+#ifndef CYAN_HASHMAP_LOAD_FACTOR
+#define CYAN_HASHMAP_LOAD_FACTOR 70
+#endif
 
 /**
- * @brief FNV-1a hash function
- * 
- * A fast, non-cryptographic hash function with good distribution.
- * Uses the 64-bit FNV-1a algorithm.
+ * @brief Old buckets moved per mutating operation during an incremental resize
+ * Must be at least 2 so the move finishes before the new table fills up
  */
-static inline size_t _cyan_fnv1a_hash(const void *key, size_t key_size) {
-    const unsigned char *data = (const unsigned char *)key;
-    size_t hash = 14695981039346656037ULL;  /* FNV offset basis */
-    
-    for (size_t i = 0; i < key_size; i++) {
-        hash ^= data[i];
-        hash *= 1099511628211ULL;  /* FNV prime */
-    }
-    
-    return hash;
-}
+#ifndef CYAN_HASHMAP_MIGRATE_STEP
+#define CYAN_HASHMAP_MIGRATE_STEP 8
+#endif
 
 /**
- * @brief Default equality function using memcmp
+ * @brief Keys hashed and prefetched together by the batch lookup functions
  */
-static inline bool _cyan_default_equal(const void *a, const void *b, size_t size) {
-    return memcmp(a, b, size) == 0;
-}
-
-/*============================================================================
- * Configuration
- *============================================================================*/
+#ifndef CYAN_HASHMAP_BATCH
+#define CYAN_HASHMAP_BATCH 16
+#endif
 
 /**
- * @brief Default initial capacity for hash maps
+ * @brief Probe-length histogram buckets in HashMapStats
+ * The last bucket counts every key at that probe length or longer
  */
-#ifndef CYAN_HASHMAP_INITIAL_CAPACITY
-#define CYAN_HASHMAP_INITIAL_CAPACITY 16
+#ifndef CYAN_HASHMAP_STATS_BUCKETS
+#define CYAN_HASHMAP_STATS_BUCKETS 16
 #endif
 
-/**
- * @brief Load factor threshold for resizing (as percentage)
- * When (len * 100 / capacity) exceeds this, the map resizes
- */
-#ifndef CYAN_HASHMAP_LOAD_FACTOR
-#define CYAN_HASHMAP_LOAD_FACTOR 70
+#if CYAN_HASHMAP_MIGRATE_STEP < 2
+#error "CYAN_HASHMAP_MIGRATE_STEP must be at least 2"
 #endif
 
 /*============================================================================
@@ -106,38 +88,183 @@ typedef enum {
 } _CyanEntryState;
 
 /*============================================================================
- * HashMap Type Definition Macro
+ * Hash Tags and Slot Layout
  *============================================================================*/
 
+/*
+ * Each HashMap slot stores the low 32 bits of its key's hash as a tag.
+ * The two smallest tag values double as the empty and tombstone markers,
+ * so there is no separate state field. The tag is compared before the key,
+ * and while the capacity fits in 31 bits its low bits give the slot's
+ * home bucket, so resizing never calls the hash function.
+ */
+#define _CYAN_TAG_EMPTY 0u      /* Slot never used */
+#define _CYAN_TAG_DELETED 1u    /* Slot was deleted (tombstone) */
+#define _CYAN_TAG_IS_FULL(t) ((t) > _CYAN_TAG_DELETED)
+
+/* Largest capacity whose bucket index can be read from a tag */
+#define _CYAN_TAG_INDEX_LIMIT ((size_t)1 << 31)
+
 /**
- * @brief Generate a HashMap type for given key and value types
- * @param K The key type
- * @param V The value type
+ * @brief Derive a slot tag from a full hash
+ * @param hash The key's hash
+ * @return Tag greater than _CYAN_TAG_DELETED with the hash's low 31 bits
+ */
+static inline uint32_t _cyan_map_tag(size_t hash) {
+    uint32_t tag = (uint32_t)hash;
+    /* Tags that collide with the markers move up; the low 31 bits stay intact */
+    return _CYAN_TAG_IS_FULL(tag) ? tag : (tag | 0x80000000u);
+}
+
+/**
+ * @brief Store values apart from keys
  * 
- * Creates:
- * - _MapEntry_K_V: Internal entry structure
- * - HashMap_K_V: The hash map structure
- * - HashMapVT_K_V: Vtable structure with function pointers
- * - hashmap_K_V_new(): Create empty map
- * - hashmap_K_V_with_capacity(cap): Create map with initial capacity
- * - hashmap_K_V_insert(m, key, value): Insert or update entry
- * - hashmap_K_V_get(m, key): Get value as Option
- * - hashmap_K_V_contains(m, key): Check if key exists
- * - hashmap_K_V_remove(m, key): Remove entry
- * - hashmap_K_V_len(m): Get number of entries
- * - hashmap_K_V_free(m): Free map memory
+ * Define CYAN_HASHMAP_SPLIT_VALUES before including this header (the same
+ * way in every translation unit) to place each table's values in a second
+ * array after its {tag, key} slots, in the same allocation. Probes then
+ * walk densely packed keys and only touch the value of the matching slot,
+ * which helps when V is large compared to K.
+ */
+#ifdef CYAN_HASHMAP_SPLIT_VALUES
+#define _CYAN_MAP_VALUE_FIELD(V)
+#define _CYAN_MAP_SLOT_SIZE(E, V) (sizeof(E) + sizeof(V))
+#define _CYAN_MAP_VAL(V, buckets, cap, i) \
+    ((V *)((char *)(buckets) + (cap) * sizeof(*(buckets))) + (i))
+#else
+#define _CYAN_MAP_VALUE_FIELD(V) V value;
+#define _CYAN_MAP_SLOT_SIZE(E, V) sizeof(E)
+#define _CYAN_MAP_VAL(V, buckets, cap, i) ((void)(cap), &(buckets)[i].value)
+#endif
+
+/*
+ * Every table allocation ends with an occupancy bitmap: bit i % 64 of word
+ * i / 64 is set while slot i holds a key. Writers keep it in step with the
+ * tags, so full scans (iteration, retain) test 64 slots per word and skip
+ * empty and deleted runs without touching the slots themselves.
+ */
+
+/**
+ * @brief Byte offset of a table's occupancy bitmap
+ * @param cap Slots in the table
+ * @param slot_size Bytes per slot, split values included
+ * @return Offset past the slots (and values), rounded up to 8 bytes
+ */
+static inline size_t _cyan_map_occ_offset(size_t cap, size_t slot_size) {
+    return (cap * slot_size + 7) & ~(size_t)7;
+}
+
+/**
+ * @brief Bytes in a table allocation: slots, split values and bitmap
+ * @param cap Slots in the table
+ * @param slot_size Bytes per slot, split values included
+ * @return Size of the allocation
+ */
+static inline size_t _cyan_map_table_size(size_t cap, size_t slot_size) {
+    return _cyan_map_occ_offset(cap, slot_size) + (cap + 63) / 64 * sizeof(uint64_t);
+}
+
+#define _CYAN_MAP_OCC(E, V, buckets, cap) \
+    ((uint64_t *)((char *)(buckets) + _cyan_map_occ_offset((cap), _CYAN_MAP_SLOT_SIZE(E, V))))
+
+/* Mark slot i occupied or free in a bitmap */
+static inline void _cyan_map_occ_set(uint64_t *occ, size_t i) {
+    occ[i >> 6] |= (uint64_t)1 << (i & 63);
+}
+
+static inline void _cyan_map_occ_clear(uint64_t *occ, size_t i) {
+    occ[i >> 6] &= ~((uint64_t)1 << (i & 63));
+}
+
+/* Index of the lowest set bit of a non-zero word */
+static inline unsigned _cyan_map_ctz(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(x);
+#else
+    unsigned n = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/*============================================================================
+ * Health Statistics
+ *============================================================================*/
+
+/**
+ * @brief Probe counters kept by maps built with CYAN_HASHMAP_PROFILE
  * 
- * Also generates a vtable struct HashMapVT_K_V and convenience macros:
- * - MAP_INSERT(m, k, v), MAP_GET(m, k), MAP_CONTAINS(m, k), MAP_REMOVE(m, k), MAP_LEN(m), MAP_FREE(m)
+ * Define CYAN_HASHMAP_PROFILE before including this header (the same way in
+ * every translation unit) to count the slots each operation examines. This
+ * makes lookups write to the map, so profiled maps must not be read from
+ * several threads at once, including through ConcurrentHashMap.
+ */
+typedef struct {
+    size_t probes;          /* Slots examined by every probe, removes included */
+    size_t lookups;         /* get, get_ptr, contains, remove and batch keys */
+    size_t lookup_probes;   /* Slots examined by those lookups */
+    size_t inserts;         /* insert, get_or_insert and entry calls */
+    size_t insert_probes;   /* Slots examined by those inserts */
+} HashMapProfile;
+
+/**
+ * @brief Snapshot of a map's health, from hashmap_K_V_stats
  * 
- * Requires: OPTION_DEFINE(V) must be called before HASHMAP_DEFINE(K, V)
+ * Probe lengths count the slots a lookup examines to find a key, so a key
+ * in its home slot has length 1. Long or skewed probe lengths at a normal
+ * load factor point to a poor hash function or adversarial keys; many
+ * tombstones point to heavy churn that only a resize will clear.
  */
-#define HASHMAP_DEFINE(K, V) \
-    /* Entry structure */ \
+typedef struct {
+    size_t len;             /* Number of entries */
+    size_t capacity;        /* Slots in the current table */
+    size_t tombstones;      /* Deleted slots still lengthening probes */
+    double load_factor;     /* len / capacity */
+    size_t max_probe;       /* Longest probe length over all keys */
+    double mean_probe;      /* Average probe length over all keys */
+    size_t probe_histogram[CYAN_HASHMAP_STATS_BUCKETS]; /* [i]: keys with length i + 1 */
+    size_t resizes;         /* Times the table has grown */
+    uint64_t rehash_ns;     /* Time spent rehashing into a new table */
+    HashMapProfile profile; /* All zero unless CYAN_HASHMAP_PROFILE */
+} HashMapStats;
+
+#ifdef CYAN_HASHMAP_PROFILE
+#define _CYAN_MAP_PROFILE(...) __VA_ARGS__
+#else
+#define _CYAN_MAP_PROFILE(...)
+#endif
+
+/**
+ * @brief Read a clock for rehash timing, in nanoseconds
+ * @return Monotonic time where POSIX provides it, else wall-clock time
+ */
+static inline uint64_t _cyan_map_now_ns(void) {
+    struct timespec ts;
+#if defined(CLOCK_MONOTONIC)
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get(&ts, TIME_UTC);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/*============================================================================
+ * HashMap Type Definition Macro
+ *============================================================================*/
+
+/**
+ * @brief Internal: generate the entry, vtable and map structures (do not use directly)
+ * @param K The key type
+ * @param V The value type
+ */
+#define _HASHMAP_DEFINE_TYPES(K, V) \
+    /* Entry structure; the value lives here unless CYAN_HASHMAP_SPLIT_VALUES */ \
     typedef struct { \
-        _CyanEntryState state; \
+        uint32_t tag;           /* Hash tag, or _CYAN_TAG_EMPTY / _CYAN_TAG_DELETED */ \
         K key; \
-        V value; \
+        _CYAN_MAP_VALUE_FIELD(V) \
     } _MapEntry_##K##_##V; \
     \
     /* Forward declare HashMap_K_V for use in vtable */ \
@@ -162,17 +289,78 @@ typedef enum {
         _MapEntry_##K##_##V *buckets; \
         size_t capacity; \
         size_t len; \
-        HashFn hash_fn; \
+        HashFn hash_fn;         /* Unseeded override; NULL to use seeded_hash_fn */ \
         EqualFn equal_fn; \
+        SeededHashFn seeded_hash_fn; \
+        uint64_t seed;          /* Change only while the map is empty */ \
+        /* Incremental resize state; old_buckets is NULL when not resizing */ \
+        _MapEntry_##K##_##V *old_buckets; \
+        size_t old_capacity; \
+        size_t migrate_pos;     /* Next old bucket to move */ \
+        bool incremental;       /* Resize incrementally instead of all at once */ \
+        /* Health counters reported by hashmap_K_V_stats */ \
+        size_t resizes; \
+        uint64_t rehash_ns; \
+        _CYAN_MAP_PROFILE(HashMapProfile profile;) \
         const HashMapVT_##K##_##V *vt; \
     }; \
     \
+    /** \
+     * @brief Slot found by hashmap_K_V_entry, either occupied or vacant \
+     */ \
+    typedef struct { \
+        HashMap_##K##_##V *map; \
+        size_t index;           /* Matching slot, or slot to fill if vacant */ \
+        K key; \
+        uint32_t tag; \
+        bool occupied; \
+    } HashMapEntry_##K##_##V; \
+    \
+    /** \
+     * @brief Predicate for hashmap_K_V_retain: true to keep the entry \
+     * \
+     * May update *value in place; must not insert into or remove from the map. \
+     */ \
+    typedef bool (*HashMapRetainFn_##K##_##V)(const K *key, V *value, void *ctx)
+
+/**
+ * @brief Internal: generate the map operations (do not use directly)
+ * @param K The key type
+ * @param V The value type
+ * 
+ * Expects _hashmap_K_V_hash(m, key) and _hashmap_K_V_eq(m, a, b) to be
+ * defined beforehand; every probe goes through these two functions.
+ */
+#define _HASHMAP_DEFINE_OPS(K, V) \
     /* Forward declare vtable instance */ \
     static const HashMapVT_##K##_##V _hashmap_##K##_##V##_vt; \
     \
     /* Forward declaration for resize */ \
     static inline void _hashmap_##K##_##V##_resize(HashMap_##K##_##V *m, size_t new_cap); \
     \
+    /** \
+     * @brief Allocate a zeroed table (all slots empty) \
+     * @param cap Number of slots (power of 2) \
+     * @return Pointer to the slots; split values and the occupancy bitmap \
+     *         follow them in the same block \
+     */ \
+    static inline _MapEntry_##K##_##V *_hashmap_##K##_##V##_alloc(size_t cap) { \
+        _MapEntry_##K##_##V *buckets = (_MapEntry_##K##_##V *)calloc( \
+            1, _cyan_map_table_size(cap, _CYAN_MAP_SLOT_SIZE(_MapEntry_##K##_##V, V))); \
+        if (!buckets) CYAN_PANIC("allocation failed"); \
+        return buckets; \
+    } \
+    \
+    /** \
+     * @brief Get a table's occupancy bitmap \
+     * @param buckets Table \
+     * @param cap Capacity of buckets \
+     * @return (cap + 63) / 64 words, one bit per slot \
+     */ \
+    static inline uint64_t *_hashmap_##K##_##V##_occ(_MapEntry_##K##_##V *buckets, size_t cap) { \
+        return _CYAN_MAP_OCC(_MapEntry_##K##_##V, V, buckets, cap); \
+    } \
+    \
     /** \
      * @brief Create an empty hash map \
      * @return A new empty HashMap_K_V \
@@ -182,8 +370,10 @@ typedef enum {
             .buckets = NULL, \
             .capacity = 0, \
             .len = 0, \
-            .hash_fn = _cyan_fnv1a_hash, \
+            .hash_fn = NULL, \
             .equal_fn = _cyan_default_equal, \
+            .seeded_hash_fn = cyan_hash_wy_seeded, \
+            .seed = cyan_hash_process_seed(), \
             .vt = &_hashmap_##K##_##V##_vt \
         }; \
         return m; \
@@ -200,64 +390,238 @@ typedef enum {
         while (actual_cap < cap) actual_cap *= 2; \
         \
         HashMap_##K##_##V m = { \
-            .buckets = (_MapEntry_##K##_##V *)calloc(actual_cap, sizeof(_MapEntry_##K##_##V)), \
+            .buckets = _hashmap_##K##_##V##_alloc(actual_cap), \
             .capacity = actual_cap, \
             .len = 0, \
-            .hash_fn = _cyan_fnv1a_hash, \
+            .hash_fn = NULL, \
             .equal_fn = _cyan_default_equal, \
+            .seeded_hash_fn = cyan_hash_wy_seeded, \
+            .seed = cyan_hash_process_seed(), \
             .vt = &_hashmap_##K##_##V##_vt \
         }; \
-        if (!m.buckets) CYAN_PANIC("allocation failed"); \
         return m; \
     } \
     \
     /** \
-     * @brief Find the bucket index for a key \
-     * @param m Pointer to the map \
+     * @brief Probe one bucket array for a key \
+     * @param m Pointer to the map (for key comparison) \
+     * @param buckets Bucket array to probe \
+     * @param cap Capacity of buckets (non-zero power of 2) \
+     * @param hash Hash of the key \
      * @param key The key to find \
      * @param for_insert If true, returns first available slot; if false, returns exact match only \
-     * @return Bucket index, or capacity if not found (when for_insert is false) \
+     * @return Bucket index, or cap if not found (when for_insert is false) \
      */ \
-    static inline size_t _hashmap_##K##_##V##_find_bucket( \
-        HashMap_##K##_##V *m, K key, bool for_insert \
+    static inline size_t _hashmap_##K##_##V##_probe( \
+        HashMap_##K##_##V *m, _MapEntry_##K##_##V *buckets, size_t cap, \
+        size_t hash, K key, bool for_insert \
     ) { \
-        if (m->capacity == 0) return 0; \
+        size_t idx = hash & (cap - 1); /* capacity is power of 2 */ \
+        size_t first_deleted = cap; /* sentinel for "not found" */ \
+        uint32_t tag = _cyan_map_tag(hash); \
         \
-        size_t hash = m->hash_fn(&key, sizeof(K)); \
-        size_t idx = hash & (m->capacity - 1); /* capacity is power of 2 */ \
-        size_t first_deleted = m->capacity; /* sentinel for "not found" */ \
-        \
-        for (size_t i = 0; i < m->capacity; i++) { \
-            size_t probe_idx = (idx + i) & (m->capacity - 1); \
-            _MapEntry_##K##_##V *entry = &m->buckets[probe_idx]; \
+        for (size_t i = 0; i < cap; i++) { \
+            size_t probe_idx = (idx + i) & (cap - 1); \
+            _MapEntry_##K##_##V *entry = &buckets[probe_idx]; \
+            _CYAN_MAP_PROFILE(m->profile.probes++;) \
             \
-            if (entry->state == _CYAN_ENTRY_EMPTY) { \
+            if (entry->tag == _CYAN_TAG_EMPTY) { \
                 /* Empty slot - key not in map */ \
                 if (for_insert) { \
-                    return (first_deleted < m->capacity) ? first_deleted : probe_idx; \
+                    return (first_deleted < cap) ? first_deleted : probe_idx; \
                 } \
-                return m->capacity; /* Not found */ \
+                return cap; /* Not found */ \
             } \
             \
-            if (entry->state == _CYAN_ENTRY_DELETED) { \
+            if (entry->tag == _CYAN_TAG_DELETED) { \
                 /* Remember first deleted slot for insertion */ \
-                if (for_insert && first_deleted == m->capacity) { \
+                if (for_insert && first_deleted == cap) { \
                     first_deleted = probe_idx; \
                 } \
                 continue; \
             } \
             \
-            /* Occupied slot - check if key matches */ \
-            if (m->equal_fn(&entry->key, &key, sizeof(K))) { \
+            /* Occupied slot - compare keys only if the tags agree */ \
+            if (entry->tag == tag && _hashmap_##K##_##V##_eq(m, entry->key, key)) { \
                 return probe_idx; /* Found */ \
             } \
         } \
         \
         /* Table is full (shouldn't happen with proper load factor) */ \
-        if (for_insert && first_deleted < m->capacity) { \
+        if (for_insert && first_deleted < cap) { \
             return first_deleted; \
         } \
-        return m->capacity; \
+        return cap; \
+    } \
+    \
+    /** \
+     * @brief Find the bucket index for a key in the current table \
+     * @param m Pointer to the map \
+     * @param key The key to find \
+     * @param for_insert If true, returns first available slot; if false, returns exact match only \
+     * @return Bucket index, or capacity if not found (when for_insert is false) \
+     */ \
+    static inline size_t _hashmap_##K##_##V##_find_bucket( \
+        HashMap_##K##_##V *m, K key, bool for_insert \
+    ) { \
+        if (m->capacity == 0) return 0; \
+        \
+        size_t hash = _hashmap_##K##_##V##_hash(m, key); \
+        return _hashmap_##K##_##V##_probe(m, m->buckets, m->capacity, hash, key, for_insert); \
+    } \
+    \
+    /** \
+     * @brief Get the home bucket of an occupied slot in a table of a given size \
+     * @param m Pointer to the map \
+     * @param entry The occupied slot \
+     * @param cap Capacity of the target table (power of 2) \
+     * @return Bucket index where probing for the slot's key starts \
+     */ \
+    static inline size_t _hashmap_##K##_##V##_home( \
+        const HashMap_##K##_##V *m, const _MapEntry_##K##_##V *entry, size_t cap \
+    ) { \
+        /* The tag holds the hash's low 31 bits, enough for any index below the limit */ \
+        if (cap <= _CYAN_TAG_INDEX_LIMIT) return entry->tag & (cap - 1); \
+        return _hashmap_##K##_##V##_hash(m, entry->key) & (cap - 1); \
+    } \
+    \
+    /** \
+     * @brief Copy an occupied slot into a free slot of another table \
+     * @param dst Destination table \
+     * @param dst_cap Capacity of dst \
+     * @param di Free slot in dst \
+     * @param src Source table \
+     * @param src_cap Capacity of src \
+     * @param si Occupied slot in src \
+     */ \
+    static inline void _hashmap_##K##_##V##_copy_slot( \
+        _MapEntry_##K##_##V *dst, size_t dst_cap, size_t di, \
+        _MapEntry_##K##_##V *src, size_t src_cap, size_t si \
+    ) { \
+        dst[di] = src[si]; \
+        *_CYAN_MAP_VAL(V, dst, dst_cap, di) = *_CYAN_MAP_VAL(V, src, src_cap, si); \
+    } \
+    \
+    /** \
+     * @brief Find the entry holding a key in either table, given its hash \
+     * @param m Pointer to the map (must have capacity) \
+     * @param key The key to find \
+     * @param hash Hash of the key \
+     * @param value Set to the entry's value slot when found \
+     * @return Pointer to the occupied entry, or NULL if not found \
+     */ \
+    static inline _MapEntry_##K##_##V *_hashmap_##K##_##V##_lookup_hashed( \
+        HashMap_##K##_##V *m, K key, size_t hash, V **value \
+    ) { \
+        _CYAN_MAP_PROFILE(size_t probes_before = m->profile.probes;) \
+        _MapEntry_##K##_##V *found = NULL; \
+        \
+        size_t idx = _hashmap_##K##_##V##_probe(m, m->buckets, m->capacity, hash, key, false); \
+        if (idx < m->capacity) { \
+            *value = _CYAN_MAP_VAL(V, m->buckets, m->capacity, idx); \
+            found = &m->buckets[idx]; \
+        } else if (m->old_buckets) { \
+            idx = _hashmap_##K##_##V##_probe(m, m->old_buckets, m->old_capacity, hash, key, false); \
+            if (idx < m->old_capacity) { \
+                *value = _CYAN_MAP_VAL(V, m->old_buckets, m->old_capacity, idx); \
+                found = &m->old_buckets[idx]; \
+            } \
+        } \
+        \
+        _CYAN_MAP_PROFILE( \
+            m->profile.lookups++; \
+            m->profile.lookup_probes += m->profile.probes - probes_before; \
+        ) \
+        return found; \
+    } \
+    \
+    /** \
+     * @brief Find the entry holding a key in either table \
+     * @param m Pointer to the map \
+     * @param key The key to find \
+     * @param value Set to the entry's value slot when found \
+     * @return Pointer to the occupied entry, or NULL if not found \
+     * @note Never modifies the map, so concurrent lookups are safe \
+     *       (except for the counters of CYAN_HASHMAP_PROFILE) \
+     */ \
+    static inline _MapEntry_##K##_##V *_hashmap_##K##_##V##_lookup( \
+        HashMap_##K##_##V *m, K key, V **value \
+    ) { \
+        if (m->capacity == 0) return NULL; \
+        \
+        return _hashmap_##K##_##V##_lookup_hashed(m, key, _hashmap_##K##_##V##_hash(m, key), value); \
+    } \
+    \
+    /** \
+     * @brief Move old buckets into the current table \
+     * @param m Pointer to the map (must be resizing incrementally) \
+     * @param steps Maximum number of old buckets to visit \
+     * \
+     * Frees the old table once every bucket has been moved. Moved slots \
+     * become tombstones so probe chains through the old table stay intact. \
+     * A call that moves the rest of the table blocks like a full resize \
+     * and adds to rehash_ns; shorter steps are timed only when profiling. \
+     */ \
+    static inline void _hashmap_##K##_##V##_migrate(HashMap_##K##_##V *m, size_t steps) { \
+        bool timed = steps >= m->old_capacity - m->migrate_pos _CYAN_MAP_PROFILE(|| true); \
+        uint64_t start = timed ? _cyan_map_now_ns() : 0; \
+        size_t mask = m->capacity - 1; \
+        \
+        for (; steps > 0 && m->migrate_pos < m->old_capacity; steps--) { \
+            size_t si = m->migrate_pos++; \
+            _MapEntry_##K##_##V *src = &m->old_buckets[si]; \
+            if (!_CYAN_TAG_IS_FULL(src->tag)) continue; \
+            \
+            /* A key lives in only one table, so any free slot will do */ \
+            size_t idx = _hashmap_##K##_##V##_home(m, src, m->capacity); \
+            while (_CYAN_TAG_IS_FULL(m->buckets[idx].tag)) idx = (idx + 1) & mask; \
+            _hashmap_##K##_##V##_copy_slot(m->buckets, m->capacity, idx, m->old_buckets, m->old_capacity, si); \
+            _cyan_map_occ_set(_hashmap_##K##_##V##_occ(m->buckets, m->capacity), idx); \
+            src->tag = _CYAN_TAG_DELETED; \
+            _cyan_map_occ_clear(_hashmap_##K##_##V##_occ(m->old_buckets, m->old_capacity), si); \
+        } \
+        \
+        if (m->migrate_pos == m->old_capacity) { \
+            free(m->old_buckets); \
+            m->old_buckets = NULL; \
+            m->old_capacity = 0; \
+            m->migrate_pos = 0; \
+        } \
+        if (timed) m->rehash_ns += _cyan_map_now_ns() - start; \
+    } \
+    \
+    /** \
+     * @brief Find the slot to write a key to, moving it out of the old table if needed \
+     * @param m Pointer to the map (must have capacity) \
+     * @param key The key \
+     * @param hash Hash of the key \
+     * @param tag Set to the key's hash tag, for filling a free slot \
+     * @return Index in the current table: the key's slot, or a free slot for it \
+     */ \
+    static inline size_t _hashmap_##K##_##V##_claim(HashMap_##K##_##V *m, K key, size_t hash, uint32_t *tag) { \
+        _CYAN_MAP_PROFILE(size_t probes_before = m->profile.probes;) \
+        *tag = _cyan_map_tag(hash); \
+        \
+        size_t old_idx = m->old_capacity; \
+        if (m->old_buckets) { \
+            old_idx = _hashmap_##K##_##V##_probe(m, m->old_buckets, m->old_capacity, hash, key, false); \
+        } \
+        \
+        size_t idx = _hashmap_##K##_##V##_probe(m, m->buckets, m->capacity, hash, key, true); \
+        if (old_idx < m->old_capacity) { \
+            /* Not yet migrated: move it now so updates land in one place */ \
+            _hashmap_##K##_##V##_copy_slot(m->buckets, m->capacity, idx, \
+                                           m->old_buckets, m->old_capacity, old_idx); \
+            _cyan_map_occ_set(_hashmap_##K##_##V##_occ(m->buckets, m->capacity), idx); \
+            m->old_buckets[old_idx].tag = _CYAN_TAG_DELETED; \
+            _cyan_map_occ_clear(_hashmap_##K##_##V##_occ(m->old_buckets, m->old_capacity), old_idx); \
+        } \
+        \
+        _CYAN_MAP_PROFILE( \
+            m->profile.inserts++; \
+            m->profile.insert_probes += m->profile.probes - probes_before; \
+        ) \
+        return idx; \
     } \
     \
     /** \
@@ -266,59 +630,165 @@ typedef enum {
      * @param new_cap New capacity (must be power of 2) \
      */ \
     static inline void _hashmap_##K##_##V##_resize(HashMap_##K##_##V *m, size_t new_cap) { \
+        /* Settle any incremental resize so all entries are in one table */ \
+        if (m->old_buckets) _hashmap_##K##_##V##_migrate(m, m->old_capacity); \
+        \
+        uint64_t start = _cyan_map_now_ns(); \
         _MapEntry_##K##_##V *old_buckets = m->buckets; \
         size_t old_cap = m->capacity; \
         \
-        m->buckets = (_MapEntry_##K##_##V *)calloc(new_cap, sizeof(_MapEntry_##K##_##V)); \
-        if (!m->buckets) { \
-            m->buckets = old_buckets; \
-            CYAN_PANIC("allocation failed"); \
-        } \
+        m->buckets = _hashmap_##K##_##V##_alloc(new_cap); \
         m->capacity = new_cap; \
-        m->len = 0; \
         \
-        /* Rehash all existing entries */ \
+        /* Place every entry from its tag; keys are unique, so no comparisons */ \
+        size_t mask = new_cap - 1; \
+        uint64_t *occ = _hashmap_##K##_##V##_occ(m->buckets, new_cap); \
         for (size_t i = 0; i < old_cap; i++) { \
-            if (old_buckets[i].state == _CYAN_ENTRY_OCCUPIED) { \
-                size_t idx = _hashmap_##K##_##V##_find_bucket(m, old_buckets[i].key, true); \
-                m->buckets[idx].state = _CYAN_ENTRY_OCCUPIED; \
-                m->buckets[idx].key = old_buckets[i].key; \
-                m->buckets[idx].value = old_buckets[i].value; \
-                m->len++; \
-            } \
+            if (!_CYAN_TAG_IS_FULL(old_buckets[i].tag)) continue; \
+            size_t idx = _hashmap_##K##_##V##_home(m, &old_buckets[i], new_cap); \
+            while (m->buckets[idx].tag != _CYAN_TAG_EMPTY) idx = (idx + 1) & mask; \
+            _hashmap_##K##_##V##_copy_slot(m->buckets, new_cap, idx, old_buckets, old_cap, i); \
+            _cyan_map_occ_set(occ, idx); \
         } \
         \
         free(old_buckets); \
+        m->resizes++; \
+        m->rehash_ns += _cyan_map_now_ns() - start; \
     } \
     \
     /** \
-     * @brief Insert or update a key-value pair \
+     * @brief Start an incremental resize \
+     * @param m Pointer to the map (must not already be resizing) \
+     * @param new_cap New capacity (must be power of 2) \
+     */ \
+    static inline void _hashmap_##K##_##V##_begin_resize(HashMap_##K##_##V *m, size_t new_cap) { \
+        _MapEntry_##K##_##V *buckets = _hashmap_##K##_##V##_alloc(new_cap); \
+        \
+        m->old_buckets = m->buckets; \
+        m->old_capacity = m->capacity; \
+        m->migrate_pos = 0; \
+        m->buckets = buckets; \
+        m->capacity = new_cap; \
+        m->resizes++; \
+    } \
+    \
+    /** \
+     * @brief Make room for one more entry \
      * @param m Pointer to the map \
-     * @param key The key \
-     * @param value The value \
-     * @note Overwrites existing value if key already exists \
+     * \
+     * Allocates the initial table on first use and doubles the capacity \
+     * when one more entry would exceed the load factor. Keeps the hash \
+     * functions and seed as configured. In incremental mode, doubling only allocates \
+     * the new table, and each call moves CYAN_HASHMAP_MIGRATE_STEP old \
+     * buckets across. \
      */ \
-    static inline void hashmap_##K##_##V##_insert(HashMap_##K##_##V *m, K key, V value) { \
+    static inline void _hashmap_##K##_##V##_reserve_one(HashMap_##K##_##V *m) { \
         /* Initialize if empty */ \
         if (m->capacity == 0) { \
-            *m = hashmap_##K##_##V##_with_capacity(CYAN_HASHMAP_INITIAL_CAPACITY); \
+            m->buckets = _hashmap_##K##_##V##_alloc(CYAN_HASHMAP_INITIAL_CAPACITY); \
+            m->capacity = CYAN_HASHMAP_INITIAL_CAPACITY; \
+            m->len = 0; \
         } \
         \
+        if (m->old_buckets) _hashmap_##K##_##V##_migrate(m, CYAN_HASHMAP_MIGRATE_STEP); \
+        \
         /* Check load factor and resize if needed */ \
         if ((m->len + 1) * 100 / m->capacity > CYAN_HASHMAP_LOAD_FACTOR) { \
-            _hashmap_##K##_##V##_resize(m, m->capacity * 2); \
+            if (m->incremental && !m->old_buckets) { \
+                _hashmap_##K##_##V##_begin_resize(m, m->capacity * 2); \
+            } else { \
+                _hashmap_##K##_##V##_resize(m, m->capacity * 2); \
+            } \
         } \
+    } \
+    \
+    /** \
+     * @brief Finish any incremental resize in progress \
+     * @param m Pointer to the map \
+     * \
+     * Afterwards all entries are in a single table. Useful before a burst \
+     * of latency-sensitive operations, or before handing the map to code \
+     * that walks the buckets directly. \
+     */ \
+    static inline void hashmap_##K##_##V##_finish_resize(HashMap_##K##_##V *m) { \
+        if (m->old_buckets) _hashmap_##K##_##V##_migrate(m, m->old_capacity); \
+    } \
+    \
+    /** \
+     * @brief Turn incremental resizing on or off \
+     * @param m Pointer to the map \
+     * @param on true to spread each resize over later operations \
+     * \
+     * When on, growing the table allocates the larger array and leaves the \
+     * entries in place; each later insert, remove or entry call then moves \
+     * CYAN_HASHMAP_MIGRATE_STEP old buckets, and lookups check both tables \
+     * until the move is done. This bounds the worst-case insert latency at \
+     * the cost of a second probe for keys not yet moved. Turning it off \
+     * finishes any resize in progress. \
+     */ \
+    static inline void hashmap_##K##_##V##_set_incremental(HashMap_##K##_##V *m, bool on) { \
+        if (!on) hashmap_##K##_##V##_finish_resize(m); \
+        m->incremental = on; \
+    } \
+    \
+    /** \
+     * @brief Find a key's slot, making room only if the key is new \
+     * @param m Pointer to the map \
+     * @param key The key \
+     * @param tag Set to the key's hash tag, for filling a free slot \
+     * @return Index in the current table: the key's slot, or a free slot for it \
+     * \
+     * Finding a key that is already present never grows the table or \
+     * advances an incremental resize, so pointers to other values stay \
+     * valid; a present key still in the old table is moved on its own. \
+     * When no resize is due, this hashes and probes once. \
+     */ \
+    static inline size_t _hashmap_##K##_##V##_slot(HashMap_##K##_##V *m, K key, uint32_t *tag) { \
+        size_t hash = _hashmap_##K##_##V##_hash(m, key); \
+        if (m->capacity == 0 || m->old_buckets || \
+            (m->len + 1) * 100 / m->capacity > CYAN_HASHMAP_LOAD_FACTOR) { \
+            _CYAN_MAP_PROFILE(size_t probes_before = m->profile.probes;) \
+            bool present = false; \
+            if (m->capacity) { \
+                size_t idx = _hashmap_##K##_##V##_probe(m, m->buckets, m->capacity, hash, key, false); \
+                if (idx < m->capacity) { \
+                    *tag = _cyan_map_tag(hash); \
+                    _CYAN_MAP_PROFILE( \
+                        m->profile.inserts++; \
+                        m->profile.insert_probes += m->profile.probes - probes_before; \
+                    ) \
+                    return idx; \
+                } \
+                present = m->old_buckets && \
+                    _hashmap_##K##_##V##_probe(m, m->old_buckets, m->old_capacity, hash, key, false) < m->old_capacity; \
+            } \
+            _CYAN_MAP_PROFILE(m->profile.insert_probes += m->profile.probes - probes_before;) \
+            if (!present) _hashmap_##K##_##V##_reserve_one(m); \
+        } \
+        return _hashmap_##K##_##V##_claim(m, key, hash, tag); \
+    } \
+    \
+    /** \
+     * @brief Insert or update a key-value pair \
+     * @param m Pointer to the map \
+     * @param key The key \
+     * @param value The value \
+     * @note Overwrites existing value if key already exists; only a new \
+     *       key can resize the table \
+     */ \
+    static inline void hashmap_##K##_##V##_insert(HashMap_##K##_##V *m, K key, V value) { \
+        uint32_t tag; \
+        size_t idx = _hashmap_##K##_##V##_slot(m, key, &tag); \
         \
-        size_t idx = _hashmap_##K##_##V##_find_bucket(m, key, true); \
-        \
-        if (m->buckets[idx].state != _CYAN_ENTRY_OCCUPIED) { \
+        if (!_CYAN_TAG_IS_FULL(m->buckets[idx].tag)) { \
             /* New entry */ \
+            _cyan_map_occ_set(_hashmap_##K##_##V##_occ(m->buckets, m->capacity), idx); \
             m->len++; \
         } \
         \
-        m->buckets[idx].state = _CYAN_ENTRY_OCCUPIED; \
+        m->buckets[idx].tag = tag; \
         m->buckets[idx].key = key; \
-        m->buckets[idx].value = value; \
+        *_CYAN_MAP_VAL(V, m->buckets, m->capacity, idx) = value; \
     } \
     \
     /** \
@@ -328,12 +798,10 @@ typedef enum {
      * @return Option_V containing the value if found, None otherwise \
      */ \
     static inline Option_##V hashmap_##K##_##V##_get(HashMap_##K##_##V *m, K key) { \
-        if (m->capacity == 0) return None(V); \
-        \
-        size_t idx = _hashmap_##K##_##V##_find_bucket(m, key, false); \
-        if (idx >= m->capacity) return None(V); \
+        V *value; \
+        if (!_hashmap_##K##_##V##_lookup(m, key, &value)) return None(V); \
         \
-        return Some(V, m->buckets[idx].value); \
+        return Some(V, *value); \
     } \
     \
     /** \
@@ -343,10 +811,24 @@ typedef enum {
      * @return true if key exists, false otherwise \
      */ \
     static inline bool hashmap_##K##_##V##_contains(HashMap_##K##_##V *m, K key) { \
-        if (m->capacity == 0) return false; \
+        V *value; \
+        return _hashmap_##K##_##V##_lookup(m, key, &value) != NULL; \
+    } \
+    \
+    /** \
+     * @brief Turn an occupied slot of either table into a tombstone \
+     * @param m Pointer to the map \
+     * @param entry The occupied slot \
+     * @note Leaves the slot's key and value in place for the caller to read \
+     */ \
+    static inline void _hashmap_##K##_##V##_erase(HashMap_##K##_##V *m, _MapEntry_##K##_##V *entry) { \
+        bool in_new = entry >= m->buckets && entry < m->buckets + m->capacity; \
+        _MapEntry_##K##_##V *table = in_new ? m->buckets : m->old_buckets; \
+        size_t cap = in_new ? m->capacity : m->old_capacity; \
         \
-        size_t idx = _hashmap_##K##_##V##_find_bucket(m, key, false); \
-        return idx < m->capacity; \
+        entry->tag = _CYAN_TAG_DELETED; \
+        _cyan_map_occ_clear(_hashmap_##K##_##V##_occ(table, cap), (size_t)(entry - table)); \
+        m->len--; \
     } \
     \
     /** \
@@ -356,16 +838,278 @@ typedef enum {
      * @return Option_V containing the removed value if found, None otherwise \
      */ \
     static inline Option_##V hashmap_##K##_##V##_remove(HashMap_##K##_##V *m, K key) { \
-        if (m->capacity == 0) return None(V); \
+        if (m->old_buckets) _hashmap_##K##_##V##_migrate(m, CYAN_HASHMAP_MIGRATE_STEP); \
         \
-        size_t idx = _hashmap_##K##_##V##_find_bucket(m, key, false); \
-        if (idx >= m->capacity) return None(V); \
+        V *value; \
+        _MapEntry_##K##_##V *entry = _hashmap_##K##_##V##_lookup(m, key, &value); \
+        if (!entry) return None(V); \
         \
-        V value = m->buckets[idx].value; \
-        m->buckets[idx].state = _CYAN_ENTRY_DELETED; \
-        m->len--; \
+        _hashmap_##K##_##V##_erase(m, entry); \
+        return Some(V, *value); \
+    } \
+    \
+    /** \
+     * @brief Get a pointer to the value stored for a key \
+     * @param m Pointer to the map \
+     * @param key The key to look up \
+     * @return Pointer to the value in the map, or NULL if not found \
+     * @note The pointer is invalidated by the next insert of a new key or \
+     *       remove \
+     */ \
+    static inline V *hashmap_##K##_##V##_get_ptr(HashMap_##K##_##V *m, K key) { \
+        V *value; \
+        return _hashmap_##K##_##V##_lookup(m, key, &value) ? value : NULL; \
+    } \
+    \
+    /** \
+     * @brief Look up many keys, hashing and prefetching ahead of the probes \
+     * @param m Pointer to the map \
+     * @param keys Array of n keys \
+     * @param n Number of keys \
+     * @param out Array of n values, or NULL to only test membership \
+     * @param found Array of n presence flags, or NULL \
+     * @return Number of keys found \
+     */ \
+    static inline size_t _hashmap_##K##_##V##_batch( \
+        HashMap_##K##_##V *m, const K *keys, size_t n, V *out, bool *found \
+    ) { \
+        if (m->capacity == 0) { \
+            if (found && n > 0) memset(found, 0, n * sizeof(bool)); \
+            return 0; \
+        } \
         \
-        return Some(V, value); \
+        size_t hashes[CYAN_HASHMAP_BATCH]; \
+        size_t hits = 0; \
+        \
+        for (size_t base = 0; base < n; base += CYAN_HASHMAP_BATCH) { \
+            size_t count = n - base < CYAN_HASHMAP_BATCH ? n - base : CYAN_HASHMAP_BATCH; \
+            \
+            /* Hash the group and start loading every home bucket */ \
+            for (size_t i = 0; i < count; i++) { \
+                hashes[i] = _hashmap_##K##_##V##_hash(m, keys[base + i]); \
+                CYAN_PREFETCH(&m->buckets[hashes[i] & (m->capacity - 1)]); \
+                if (m->old_buckets) { \
+                    CYAN_PREFETCH(&m->old_buckets[hashes[i] & (m->old_capacity - 1)]); \
+                } \
+            } \
+            \
+            /* Probe now that the buckets are on their way to the cache */ \
+            for (size_t i = 0; i < count; i++) { \
+                V *value; \
+                bool hit = _hashmap_##K##_##V##_lookup_hashed(m, keys[base + i], hashes[i], &value) != NULL; \
+                if (found) found[base + i] = hit; \
+                if (!hit) continue; \
+                hits++; \
+                if (out) out[base + i] = *value; \
+            } \
+        } \
+        return hits; \
+    } \
+    \
+    /** \
+     * @brief Get the values for many keys at once \
+     * @param m Pointer to the map \
+     * @param keys Array of n keys \
+     * @param n Number of keys \
+     * @param out Array of n values; out[i] is written only if keys[i] is found \
+     * @param found Array of n flags set to whether keys[i] is present (may be NULL) \
+     * @return Number of keys found \
+     * \
+     * Hashes keys in groups of CYAN_HASHMAP_BATCH and prefetches their \
+     * buckets before probing any of them, so on maps larger than the cache \
+     * the misses overlap instead of being paid one after another. Never \
+     * modifies the map. \
+     */ \
+    static inline size_t hashmap_##K##_##V##_get_batch( \
+        HashMap_##K##_##V *m, const K *keys, size_t n, V *out, bool *found \
+    ) { \
+        return _hashmap_##K##_##V##_batch(m, keys, n, out, found); \
+    } \
+    \
+    /** \
+     * @brief Check many keys for membership at once \
+     * @param m Pointer to the map \
+     * @param keys Array of n keys \
+     * @param n Number of keys \
+     * @param found Array of n flags set to whether keys[i] is present (may be NULL) \
+     * @return Number of keys found \
+     * @note Prefetches like hashmap_K_V_get_batch \
+     */ \
+    static inline size_t hashmap_##K##_##V##_contains_batch( \
+        HashMap_##K##_##V *m, const K *keys, size_t n, bool *found \
+    ) { \
+        return _hashmap_##K##_##V##_batch(m, keys, n, NULL, found); \
+    } \
+    \
+    /** \
+     * @brief Get a pointer to a key's value, inserting a default if absent \
+     * @param m Pointer to the map \
+     * @param key The key \
+     * @param default_val Value stored if the key is not yet present \
+     * @return Pointer to the value in the map \
+     * @note Hashes and probes once unless the table is due to grow \
+     * @note Finding an existing key never resizes, so pointers to other \
+     *       values stay valid; inserting a new key or removing any key \
+     *       may move every entry \
+     * \
+     * Example: \
+     *   (*hashmap_int_int_get_or_insert(&counts, word_id, 0))++; \
+     */ \
+    static inline V *hashmap_##K##_##V##_get_or_insert(HashMap_##K##_##V *m, K key, V default_val) { \
+        uint32_t tag; \
+        size_t idx = _hashmap_##K##_##V##_slot(m, key, &tag); \
+        _MapEntry_##K##_##V *entry = &m->buckets[idx]; \
+        V *value = _CYAN_MAP_VAL(V, m->buckets, m->capacity, idx); \
+        \
+        if (!_CYAN_TAG_IS_FULL(entry->tag)) { \
+            entry->tag = tag; \
+            entry->key = key; \
+            *value = default_val; \
+            _cyan_map_occ_set(_hashmap_##K##_##V##_occ(m->buckets, m->capacity), idx); \
+            m->len++; \
+        } \
+        return value; \
+    } \
+    \
+    /** \
+     * @brief Look up the slot for a key, for later inspection or update \
+     * @param m Pointer to the map \
+     * @param key The key \
+     * @return Entry that is either occupied (key present) or vacant \
+     * @note Hashes and probes once unless the table is due to grow; the \
+     *       entry_* functions do not probe again \
+     * @note An occupied entry never resizes, so pointers to other values \
+     *       stay valid; a vacant one reserves room first, which may move \
+     *       every entry \
+     * @note The entry is invalidated by any other insert or remove on the map \
+     */ \
+    static inline HashMapEntry_##K##_##V hashmap_##K##_##V##_entry(HashMap_##K##_##V *m, K key) { \
+        /* A vacant entry is reserved now so filling it never has to resize */ \
+        uint32_t tag; \
+        size_t idx = _hashmap_##K##_##V##_slot(m, key, &tag); \
+        return (HashMapEntry_##K##_##V){ \
+            .map = m, \
+            .index = idx, \
+            .key = key, \
+            .tag = tag, \
+            .occupied = _CYAN_TAG_IS_FULL(m->buckets[idx].tag) \
+        }; \
+    } \
+    \
+    /** \
+     * @brief Check whether an entry holds a value \
+     * @param e Pointer to the entry \
+     * @return true if occupied, false if vacant \
+     */ \
+    static inline bool hashmap_##K##_##V##_entry_is_occupied(const HashMapEntry_##K##_##V *e) { \
+        return e->occupied; \
+    } \
+    \
+    /** \
+     * @brief Get a pointer to an occupied entry's value \
+     * @param e Pointer to the entry \
+     * @return Pointer to the value, or NULL if the entry is vacant \
+     */ \
+    static inline V *hashmap_##K##_##V##_entry_get(HashMapEntry_##K##_##V *e) { \
+        return e->occupied ? _CYAN_MAP_VAL(V, e->map->buckets, e->map->capacity, e->index) : NULL; \
+    } \
+    \
+    /** \
+     * @brief Store a value in the entry, replacing any existing value \
+     * @param e Pointer to the entry (becomes occupied) \
+     * @param value The value \
+     * @return Pointer to the stored value \
+     */ \
+    static inline V *hashmap_##K##_##V##_entry_insert(HashMapEntry_##K##_##V *e, V value) { \
+        _MapEntry_##K##_##V *slot = &e->map->buckets[e->index]; \
+        if (!e->occupied) { \
+            slot->tag = e->tag; \
+            slot->key = e->key; \
+            _cyan_map_occ_set(_hashmap_##K##_##V##_occ(e->map->buckets, e->map->capacity), e->index); \
+            e->map->len++; \
+            e->occupied = true; \
+        } \
+        V *dst = _CYAN_MAP_VAL(V, e->map->buckets, e->map->capacity, e->index); \
+        *dst = value; \
+        return dst; \
+    } \
+    \
+    /** \
+     * @brief Get the entry's value, storing a default first if vacant \
+     * @param e Pointer to the entry (becomes occupied) \
+     * @param default_val Value stored if the entry is vacant \
+     * @return Pointer to the value \
+     */ \
+    static inline V *hashmap_##K##_##V##_entry_or_insert(HashMapEntry_##K##_##V *e, V default_val) { \
+        if (e->occupied) return _CYAN_MAP_VAL(V, e->map->buckets, e->map->capacity, e->index); \
+        return hashmap_##K##_##V##_entry_insert(e, default_val); \
+    } \
+    \
+    /** \
+     * @brief Remove an occupied entry from the map \
+     * @param e Pointer to the entry (becomes vacant) \
+     * @return Option_V containing the removed value, or None if already vacant \
+     */ \
+    static inline Option_##V hashmap_##K##_##V##_entry_remove(HashMapEntry_##K##_##V *e) { \
+        if (!e->occupied) return None(V); \
+        \
+        _hashmap_##K##_##V##_erase(e->map, &e->map->buckets[e->index]); \
+        e->occupied = false; \
+        return Some(V, *_CYAN_MAP_VAL(V, e->map->buckets, e->map->capacity, e->index)); \
+    } \
+    \
+    /** \
+     * @brief Apply a retain predicate to one table \
+     * @param m Pointer to the map \
+     * @param buckets Table to scan \
+     * @param cap Capacity of buckets \
+     * @param keep Predicate; entries it rejects become tombstones \
+     * @param ctx Passed to keep \
+     * @return Number of entries removed \
+     */ \
+    static inline size_t _hashmap_##K##_##V##_retain_table( \
+        HashMap_##K##_##V *m, _MapEntry_##K##_##V *buckets, size_t cap, \
+        HashMapRetainFn_##K##_##V keep, void *ctx \
+    ) { \
+        uint64_t *occ = _hashmap_##K##_##V##_occ(buckets, cap); \
+        size_t removed = 0; \
+        for (size_t w = 0; w < (cap + 63) / 64; w++) { \
+            for (uint64_t bits = occ[w]; bits; bits &= bits - 1) { \
+                size_t i = w * 64 + _cyan_map_ctz(bits); \
+                if (keep(&buckets[i].key, _CYAN_MAP_VAL(V, buckets, cap, i), ctx)) continue; \
+                buckets[i].tag = _CYAN_TAG_DELETED; \
+                _cyan_map_occ_clear(occ, i); \
+                removed++; \
+            } \
+        } \
+        m->len -= removed; \
+        return removed; \
+    } \
+    \
+    /** \
+     * @brief Remove every entry a predicate rejects, in one pass \
+     * @param m Pointer to the map \
+     * @param keep Called as keep(&key, &value, ctx); return false to remove \
+     * @param ctx Passed through to keep \
+     * @return Number of entries removed \
+     * @note Walks the occupancy bitmap, so empty and deleted runs cost one \
+     *       word test per 64 slots. Suited to expiry sweeps. \
+     * \
+     * Example: \
+     *   static bool fresh(const u64 *key, Session *s, void *now) { \
+     *       return s->expires > *(u64 *)now; \
+     *   } \
+     *   hashmap_u64_Session_retain(&sessions, fresh, &now); \
+     */ \
+    static inline size_t hashmap_##K##_##V##_retain( \
+        HashMap_##K##_##V *m, HashMapRetainFn_##K##_##V keep, void *ctx \
+    ) { \
+        if (m->capacity == 0) return 0; \
+        size_t removed = _hashmap_##K##_##V##_retain_table(m, m->buckets, m->capacity, keep, ctx); \
+        if (m->old_buckets) { \
+            removed += _hashmap_##K##_##V##_retain_table(m, m->old_buckets, m->old_capacity, keep, ctx); \
+        } \
+        return removed; \
     } \
     \
     /** \
@@ -377,15 +1121,75 @@ typedef enum {
         return m->len; \
     } \
     \
+    /** \
+     * @brief Add one table's slots to a stats snapshot \
+     * @param m Pointer to the map \
+     * @param buckets Table to scan \
+     * @param cap Capacity of buckets \
+     * @param st Stats being accumulated \
+     * @param total_probe Running sum of probe lengths \
+     */ \
+    static inline void _hashmap_##K##_##V##_scan_stats( \
+        const HashMap_##K##_##V *m, const _MapEntry_##K##_##V *buckets, size_t cap, \
+        HashMapStats *st, size_t *total_probe \
+    ) { \
+        for (size_t i = 0; i < cap; i++) { \
+            uint32_t tag = buckets[i].tag; \
+            if (tag == _CYAN_TAG_DELETED) st->tombstones++; \
+            if (!_CYAN_TAG_IS_FULL(tag)) continue; \
+            \
+            /* Linear probing: a lookup walks from the home slot to this one */ \
+            size_t probe = ((i - _hashmap_##K##_##V##_home(m, &buckets[i], cap)) & (cap - 1)) + 1; \
+            size_t bucket = probe <= CYAN_HASHMAP_STATS_BUCKETS ? probe - 1 : CYAN_HASHMAP_STATS_BUCKETS - 1; \
+            st->probe_histogram[bucket]++; \
+            if (probe > st->max_probe) st->max_probe = probe; \
+            *total_probe += probe; \
+        } \
+    } \
+    \
+    /** \
+     * @brief Take a snapshot of the map's health \
+     * @param m Pointer to the map \
+     * @return Load, tombstone, probe-length and resize figures \
+     * @note Scans every slot, so the cost is O(capacity); meant for \
+     *       periodic export to metrics, not for hot paths \
+     * @note During an incremental resize both tables are scanned, and keys \
+     *       in the old table are measured against it \
+     */ \
+    static inline HashMapStats hashmap_##K##_##V##_stats(HashMap_##K##_##V *m) { \
+        HashMapStats st = { \
+            .len = m->len, \
+            .capacity = m->capacity, \
+            .resizes = m->resizes, \
+            .rehash_ns = m->rehash_ns \
+        }; \
+        _CYAN_MAP_PROFILE(st.profile = m->profile;) \
+        if (m->capacity == 0) return st; \
+        \
+        size_t total_probe = 0; \
+        _hashmap_##K##_##V##_scan_stats(m, m->buckets, m->capacity, &st, &total_probe); \
+        if (m->old_buckets) { \
+            _hashmap_##K##_##V##_scan_stats(m, m->old_buckets, m->old_capacity, &st, &total_probe); \
+        } \
+        \
+        st.load_factor = (double)m->len / (double)m->capacity; \
+        st.mean_probe = m->len ? (double)total_probe / (double)m->len : 0.0; \
+        return st; \
+    } \
+    \
     /** \
      * @brief Free all memory associated with the map \
      * @param m Pointer to the map \
      */ \
     static inline void hashmap_##K##_##V##_free(HashMap_##K##_##V *m) { \
         free(m->buckets); \
+        free(m->old_buckets); \
         m->buckets = NULL; \
         m->capacity = 0; \
         m->len = 0; \
+        m->old_buckets = NULL; \
+        m->old_capacity = 0; \
+        m->migrate_pos = 0; \
     } \
     \
     /** \
@@ -398,10 +1202,131 @@ typedef enum {
         .remove = hashmap_##K##_##V##_remove, \
         .len = hashmap_##K##_##V##_len, \
         .free = hashmap_##K##_##V##_free \
-    }; \
+    }
+
+/**
+ * @brief Generate a HashMap type for given key and value types
+ * @param K The key type
+ * @param V The value type
+ * 
+ * Creates:
+ * - _MapEntry_K_V: Internal entry structure
+ * - HashMap_K_V: The hash map structure
+ * - HashMapVT_K_V: Vtable structure with function pointers
+ * - hashmap_K_V_new(): Create empty map
+ * - hashmap_K_V_with_capacity(cap): Create map with initial capacity
+ * - hashmap_K_V_with_seed(seed): Create empty map with a fixed hash seed
+ * - hashmap_K_V_insert(m, key, value): Insert or update entry
+ * - hashmap_K_V_get(m, key): Get value as Option
+ * - hashmap_K_V_contains(m, key): Check if key exists
+ * - hashmap_K_V_remove(m, key): Remove entry
+ * - hashmap_K_V_get_ptr(m, key): Get pointer to value in place
+ * - hashmap_K_V_get_batch(m, keys, n, out, found): Prefetching bulk lookup
+ * - hashmap_K_V_contains_batch(m, keys, n, found): Prefetching bulk membership
+ * - hashmap_K_V_get_or_insert(m, key, default): Get pointer, inserting if absent
+ * - hashmap_K_V_entry(m, key): Probe once, then inspect/fill/remove the slot
+ * - hashmap_K_V_retain(m, keep, ctx): Remove every entry keep rejects
+ * - hashmap_K_V_set_incremental(m, on): Spread resizes over later operations
+ * - hashmap_K_V_finish_resize(m): Complete an incremental resize now
+ * - hashmap_K_V_stats(m): Load, tombstone, probe-length and resize figures
+ * - hashmap_K_V_len(m): Get number of entries
+ * - hashmap_K_V_free(m): Free map memory
+ * 
+ * Also generates a vtable struct HashMapVT_K_V and convenience macros:
+ * - MAP_INSERT(m, k, v), MAP_GET(m, k), MAP_CONTAINS(m, k), MAP_REMOVE(m, k), MAP_LEN(m), MAP_FREE(m)
+ * 
+ * Keys are hashed with seeded_hash_fn (wyhash by default) under the map's
+ * seed, which new maps take from cyan_hash_process_seed, so key sets that
+ * collide cannot be precomputed. Assigning hash_fn replaces this with a
+ * fixed, unseeded hash. Keys are compared through equal_fn (memcmp over
+ * sizeof(K) bytes by default). Use HASHMAP_DEFINE_WITH to inline both into
+ * the generated functions.
+ * 
+ * Requires: OPTION_DEFINE(V) must be called before HASHMAP_DEFINE(K, V)
+ */
+#define HASHMAP_DEFINE(K, V) \
+    _HASHMAP_DEFINE_TYPES(K, V); \
+    \
+    /* Hash a key through the map's hash function pointers */ \
+    static inline size_t _hashmap_##K##_##V##_hash(const HashMap_##K##_##V *m, K key) { \
+        return m->hash_fn ? m->hash_fn(&key, sizeof(K)) \
+                          : m->seeded_hash_fn(&key, sizeof(K), m->seed); \
+    } \
+    \
+    /* Compare two keys through the map's equality function pointer */ \
+    static inline bool _hashmap_##K##_##V##_eq(const HashMap_##K##_##V *m, K a, K b) { \
+        return m->equal_fn(&a, &b, sizeof(K)); \
+    } \
+    \
+    _HASHMAP_DEFINE_OPS(K, V); \
+    \
+    /** \
+     * @brief Create an empty hash map with a fixed hash seed \
+     * @param seed Seed for seeded_hash_fn \
+     * @return A new empty HashMap_K_V \
+     * @note Maps built with the same seed and insertion order have the \
+     *       same layout, which is useful for reproducible tests \
+     */ \
+    static inline HashMap_##K##_##V hashmap_##K##_##V##_with_seed(uint64_t seed) { \
+        HashMap_##K##_##V m = hashmap_##K##_##V##_new(); \
+        m.seed = seed; \
+        return m; \
+    } \
+    \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef HashMap_##K##_##V HashMap_##K##_##V##_defined
+
+/**
+ * @brief Generate a HashMap type with compile-time hash and equality
+ * @param K The key type
+ * @param V The value type
+ * @param hash_expr Function or function-like macro called as hash_expr(key), yielding the hash
+ * @param eq_expr Function or function-like macro called as eq_expr(a, b), yielding true if equal
+ * 
+ * Generates the same API as HASHMAP_DEFINE, but hash_expr and eq_expr are
+ * expanded directly into the probe loop instead of being called through
+ * hash_fn/equal_fn, so the compiler can inline them. The hash_fn, equal_fn,
+ * seeded_hash_fn and seed fields are still present but ignored by maps of
+ * this type, so they are unseeded unless hash_expr mixes in a seed itself,
+ * and hashmap_K_V_with_seed is not generated for them.
+ * 
+ * Example:
+ *   OPTION_DEFINE(int);
+ *   HASHMAP_DEFINE_WITH(int, int, CYAN_HASH_SCALAR, CYAN_EQ_SCALAR);
+ * 
+ * Requires: OPTION_DEFINE(V) must be called before HASHMAP_DEFINE_WITH(K, V, ...)
+ */
+#define HASHMAP_DEFINE_WITH(K, V, hash_expr, eq_expr) \
+    _HASHMAP_DEFINE_TYPES(K, V); \
+    \
+    /* Hash a key with the compile-time hash expression */ \
+    static inline size_t _hashmap_##K##_##V##_hash(const HashMap_##K##_##V *m, K key) { \
+        (void)m; \
+        return (size_t)(hash_expr(key)); \
+    } \
+    \
+    /* Compare two keys with the compile-time equality expression */ \
+    static inline bool _hashmap_##K##_##V##_eq(const HashMap_##K##_##V *m, K a, K b) { \
+        (void)m; \
+        return (eq_expr(a, b)); \
+    } \
+    \
+    _HASHMAP_DEFINE_OPS(K, V); \
     /* Dummy typedef to absorb trailing semicolon */ \
     typedef HashMap_##K##_##V HashMap_##K##_##V##_defined
 
+/**
+ * @brief Generate a HashMap type for integer, enum or pointer keys
+ * @param K The key type (must be comparable with == and convertible to uint64_t)
+ * @param V The value type
+ * 
+ * Shorthand for HASHMAP_DEFINE_WITH(K, V, CYAN_HASH_SCALAR, CYAN_EQ_SCALAR).
+ * 
+ * Requires: OPTION_DEFINE(V) must be called before HASHMAP_DEFINE_SCALAR(K, V)
+ */
+#define HASHMAP_DEFINE_SCALAR(K, V) \
+    HASHMAP_DEFINE_WITH(K, V, CYAN_HASH_SCALAR, CYAN_EQ_SCALAR)
+
 /*============================================================================
  * HashMap Iterator Definition Macro
  *============================================================================*/
@@ -415,6 +1340,13 @@ typedef enum {
  * - HashMapIter_K_V: Iterator structure
  * - hashmap_K_V_iter(m): Create iterator from map
  * - hashmap_K_V_iter_next(it): Get next entry as Option
+ * - hashmap_K_V_iter_next_ptr(it, &key, &value): Point at the next entry in place
+ * - hashmap_K_V_iter_remove(it): Remove the entry last returned
+ * 
+ * The iterator walks each table's occupancy bitmap a word at a time, so
+ * empty and deleted runs cost one test per 64 slots. iter_next_ptr avoids
+ * copying the pair; the pointers stay valid until the map is next inserted
+ * into or removed from other than through iter_remove.
  * 
  * Requires: HASHMAP_DEFINE(K, V) must be called first
  */
@@ -434,7 +1366,9 @@ typedef enum {
     /* Iterator structure */ \
     typedef struct { \
         HashMap_##K##_##V *map; \
-        size_t index; \
+        size_t word;            /* Next bitmap word: the current table's, then the old table's */ \
+        uint64_t bits;          /* Occupied slots not yet returned in word - 1 */ \
+        _MapEntry_##K##_##V *last; /* Slot last returned, or NULL */ \
     } HashMapIter_##K##_##V; \
     \
     /** \
@@ -443,7 +1377,50 @@ typedef enum {
      * @return Iterator positioned before the first element \
      */ \
     static inline HashMapIter_##K##_##V hashmap_##K##_##V##_iter(HashMap_##K##_##V *m) { \
-        return (HashMapIter_##K##_##V){ .map = m, .index = 0 }; \
+        return (HashMapIter_##K##_##V){ .map = m, .word = 0, .bits = 0, .last = NULL }; \
+    } \
+    \
+    /** \
+     * @brief Advance to the next entry and point at it in place \
+     * @param it Pointer to the iterator \
+     * @param key Set to the entry's key (read-only) \
+     * @param value Set to the entry's value, which may be updated in place \
+     * @return true if an entry was found, false when iteration is complete \
+     * \
+     * Example: \
+     *   const int *k; \
+     *   int *v; \
+     *   while (hashmap_int_int_iter_next_ptr(&it, &k, &v)) *v += *k; \
+     */ \
+    static inline bool hashmap_##K##_##V##_iter_next_ptr( \
+        HashMapIter_##K##_##V *it, const K **key, V **value \
+    ) { \
+        /* Walk the current table, then any old table still being moved */ \
+        HashMap_##K##_##V *m = it->map; \
+        size_t new_words = (m->capacity + 63) / 64; \
+        size_t words = new_words + (m->old_buckets ? (m->old_capacity + 63) / 64 : 0); \
+        while (it->bits == 0) { \
+            if (it->word >= words) { \
+                it->last = NULL; \
+                return false; \
+            } \
+            size_t w = it->word++; \
+            it->bits = w < new_words \
+                ? _hashmap_##K##_##V##_occ(m->buckets, m->capacity)[w] \
+                : _hashmap_##K##_##V##_occ(m->old_buckets, m->old_capacity)[w - new_words]; \
+        } \
+        \
+        size_t w = it->word - 1; \
+        bool in_new = w < new_words; \
+        _MapEntry_##K##_##V *table = in_new ? m->buckets : m->old_buckets; \
+        size_t cap = in_new ? m->capacity : m->old_capacity; \
+        size_t slot = (in_new ? w : w - new_words) * 64 + _cyan_map_ctz(it->bits); \
+        it->bits &= it->bits - 1; \
+        \
+        it->last = &table[slot]; \
+        *key = &table[slot].key; \
+        *value = _CYAN_MAP_VAL(V, table, cap, slot); \
+        return true; \
     } \
     \
     /** \
@@ -454,17 +1431,27 @@ typedef enum {
     static inline Option_MapPair_##K##_##V hashmap_##K##_##V##_iter_next( \
         HashMapIter_##K##_##V *it \
     ) { \
-        while (it->index < it->map->capacity) { \
-            _MapEntry_##K##_##V *entry = &it->map->buckets[it->index]; \
-            it->index++; \
-            \
-            if (entry->state == _CYAN_ENTRY_OCCUPIED) { \
-                _MapPair_##K##_##V pair = { .key = entry->key, .value = entry->value }; \
-                return (Option_MapPair_##K##_##V){ .has_value = true, .value = pair }; \
-            } \
+        const K *key; \
+        V *value; \
+        if (!hashmap_##K##_##V##_iter_next_ptr(it, &key, &value)) { \
+            return (Option_MapPair_##K##_##V){ .has_value = false }; \
         } \
-        \
-        return (Option_MapPair_##K##_##V){ .has_value = false }; \
+        _MapPair_##K##_##V pair = { .key = *key, .value = *value }; \
+        return (Option_MapPair_##K##_##V){ .has_value = true, .value = pair }; \
+    } \
+    \
+    /** \
+     * @brief Remove the entry the iterator last returned \
+     * @param it Pointer to the iterator \
+     * @return true if an entry was removed, false if there was none to remove \
+     * @note Leaves every other entry in place, so iteration continues \
+     *       normally; use hashmap_K_V_retain to filter a whole map \
+     */ \
+    static inline bool hashmap_##K##_##V##_iter_remove(HashMapIter_##K##_##V *it) { \
+        if (!it->last) return false; \
+        _hashmap_##K##_##V##_erase(it->map, it->last); \
+        it->last = NULL; \
+        return true; \
     } \
     /* Dummy typedef to absorb trailing semicolon */ \
     typedef HashMapIter_##K##_##V HashMapIter_##K##_##V##_defined
@@ -0,0 +1,355 @@
+/**
+ * @file hashmap_mmap.h
+ * @brief Memory-mapped HashMap snapshots for the Cyan library
+ *
+ * This header saves a HashMap's bucket array to a file and maps it back
+ * read-only. The file is a 64-byte header followed by the table, values and
+ * occupancy bitmap exactly as they sit in memory, so opening a snapshot is
+ * one mmap: no parsing, no inserts, no rehashing. Pages load on first touch
+ * and are shared between every process that maps the same file.
+ *
+ * Usage:
+ *   OPTION_DEFINE(u64);
+ *   HASHMAP_DEFINE_SCALAR(u64, u64);      // Map type
+ *   HASHMAP_MMAP_DEFINE(u64, u64);        // save / open_mmap / close_mmap
+ *
+ *   hashmap_u64_u64_save(&m, "prices.map");
+ *
+ *   Result_HashMap_u64_u64_MapFileError r = hashmap_u64_u64_open_mmap("prices.map");
+ *   if (is_ok(r)) {
+ *       HashMap_u64_u64 prices = unwrap_ok(r);
+ *       Option_u64 p = hashmap_u64_u64_get(&prices, 42);
+ *       hashmap_u64_u64_close_mmap(&prices);
+ *   }
+ *
+ * Only plain-old-data K and V are supported: the bytes are written as is,
+ * so pointers inside keys or values would dangle. Files are tied to the
+ * machine's byte order and to the type sizes and slot layout recorded in
+ * the header; open_mmap rejects any mismatch.
+ *
+ * Requires POSIX (compile with -std=gnu11 or define _POSIX_C_SOURCE).
+ */
+
+#ifndef CYAN_HASHMAP_MMAP_H
+#define CYAN_HASHMAP_MMAP_H
+
+#include "common.h"
+#include "option.h"
+#include "result.h"
+#include "hashmap.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*============================================================================
+ * File Format
+ *============================================================================*/
+
+/** @brief Layout version; bump whenever the header or slot layout changes */
+#define CYAN_MAP_FILE_VERSION 3u
+
+/* Header flag: values stored apart from keys (CYAN_HASHMAP_SPLIT_VALUES) */
+#define _CYAN_MAP_FILE_SPLIT 1u
+
+#ifdef CYAN_HASHMAP_SPLIT_VALUES
+#define _CYAN_MAP_FILE_FLAGS _CYAN_MAP_FILE_SPLIT
+#else
+#define _CYAN_MAP_FILE_FLAGS 0u
+#endif
+
+/**
+ * @brief Snapshot file header, followed directly by the table allocation
+ *
+ * 64 bytes, so the table that follows starts at a cache-line boundary of
+ * the page-aligned mapping.
+ */
+typedef struct {
+    char magic[8];          /* "CYANMAP" and a NUL */
+    uint32_t version;       /* CYAN_MAP_FILE_VERSION; also catches byte-order mismatches */
+    uint32_t flags;         /* _CYAN_MAP_FILE_* bits */
+    uint64_t key_size;      /* sizeof(K) */
+    uint64_t value_size;    /* sizeof(V) */
+    uint64_t slot_size;     /* Bytes per slot, values included */
+    uint64_t capacity;      /* Slots in the table (power of 2, or 0) */
+    uint64_t len;           /* Occupied slots */
+    uint64_t seed;          /* Hash seed the tags were computed with */
+} CyanMapFileHeader;
+
+_Static_assert(sizeof(CyanMapFileHeader) == 64, "CyanMapFileHeader must be 64 bytes");
+
+/** @brief Error type for snapshot operations: a static message, with errno set on I/O errors */
+typedef const char *MapFileError;
+
+/* Result type for hashmap_K_V_save: bytes written */
+RESULT_DEFINE(size_t, MapFileError);
+
+/**
+ * @brief Write a whole buffer to a file descriptor
+ * @param fd Destination
+ * @param data Bytes to write
+ * @param size Number of bytes
+ * @return true on success, false with errno set
+ */
+static inline bool _cyan_map_file_write(int fd, const void *data, size_t size) {
+    const char *p = (const char *)data;
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * @brief Write a header and table to path, replacing any existing file atomically
+ * @param path Destination path
+ * @param header Header to write
+ * @param table Table allocation (may be NULL when capacity is 0)
+ * @param table_size Bytes in the table allocation
+ * @return Ok with the file size, or Err with a message and errno set
+ *
+ * Writes to "<path>.tmp", syncs it and renames it over path, so processes
+ * that have the old file mapped keep a consistent view.
+ */
+static inline Result_size_t_MapFileError _cyan_map_file_save(
+    const char *path, const CyanMapFileHeader *header, const void *table, size_t table_size
+) {
+    size_t path_len = strlen(path);
+    char *tmp = (char *)malloc(path_len + 5);
+    if (!tmp) CYAN_PANIC("allocation failed");
+    memcpy(tmp, path, path_len);
+    memcpy(tmp + path_len, ".tmp", 5);
+
+    MapFileError err = NULL;
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        err = "cannot create snapshot file";
+    } else {
+        if (!_cyan_map_file_write(fd, header, sizeof(*header)) ||
+            !_cyan_map_file_write(fd, table, table_size)) {
+            err = "cannot write snapshot file";
+        } else if (fsync(fd) != 0) {
+            err = "cannot sync snapshot file";
+        }
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        if (!err && rename(tmp, path) != 0) err = "cannot rename snapshot file";
+        if (err) {
+            saved = errno;
+            unlink(tmp);
+            errno = saved;
+        }
+    }
+
+    free(tmp);
+    if (err) return Err(size_t, MapFileError, err);
+    return Ok(size_t, MapFileError, sizeof(*header) + table_size);
+}
+
+/**
+ * @brief Map a snapshot file read-only and validate its header
+ * @param path Snapshot path
+ * @param expected Header fields the caller's map type requires (sizes, flags)
+ * @param header Set to the file's header
+ * @param table Set to the mapped table, or NULL for an empty map
+ * @return NULL on success, or an error message (errno set on I/O errors)
+ */
+static inline MapFileError _cyan_map_file_open(
+    const char *path, const CyanMapFileHeader *expected,
+    CyanMapFileHeader *header, void **table
+) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return "cannot open snapshot file";
+
+    MapFileError err = NULL;
+    struct stat st;
+    ssize_t n;
+    do {
+        n = pread(fd, header, sizeof(*header), 0);
+    } while (n < 0 && errno == EINTR);
+
+    if (fstat(fd, &st) != 0) {
+        err = "cannot stat snapshot file";
+    } else if (n != (ssize_t)sizeof(*header) || memcmp(header->magic, "CYANMAP", 8) != 0) {
+        err = "not a snapshot file";
+    } else if (header->version != CYAN_MAP_FILE_VERSION) {
+        err = "unsupported snapshot version or byte order";
+    } else if (header->key_size != expected->key_size ||
+               header->value_size != expected->value_size ||
+               header->slot_size != expected->slot_size ||
+               header->flags != expected->flags) {
+        err = "snapshot layout does not match map type";
+    } else if ((header->capacity & (header->capacity - 1)) != 0 ||
+               header->len > header->capacity ||
+               (header->capacity != 0 && header->capacity > (SIZE_MAX - sizeof(*header)) / (header->slot_size + 1)) ||
+               (uint64_t)st.st_size != sizeof(*header) + _cyan_map_table_size(
+                   (size_t)header->capacity, (size_t)header->slot_size)) {
+        err = "snapshot file is truncated or corrupt";
+    }
+
+    *table = NULL;
+    if (!err && header->capacity > 0) {
+        size_t size = (size_t)st.st_size;
+        void *base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) {
+            err = "cannot map snapshot file";
+        } else {
+            /* Lookups jump around the table, so readahead would be wasted */
+            posix_madvise(base, size, POSIX_MADV_RANDOM);
+            *table = (char *)base + sizeof(*header);
+        }
+    }
+
+    int saved = errno;
+    close(fd);
+    errno = saved;
+    return err;
+}
+
+/*============================================================================
+ * Snapshot Definition Macro
+ *============================================================================*/
+
+/**
+ * @brief Generate snapshot functions for HashMap_K_V
+ * @param K The key type (plain old data)
+ * @param V The value type (plain old data)
+ *
+ * Creates:
+ * - Result_HashMap_K_V_MapFileError: result of opening a snapshot
+ * - hashmap_K_V_save(m, path): Write the map to path
+ * - hashmap_K_V_open_mmap(path): Map a snapshot read-only
+ * - hashmap_K_V_open_mmap_with(path, hash_fn, equal_fn): Same, for maps
+ *   saved with custom runtime hash or equality functions
+ * - hashmap_K_V_close_mmap(m): Unmap a map returned by open_mmap
+ *
+ * A mapped map supports every read: get, get_ptr (read-only), contains,
+ * the batch lookups, iteration and stats. Writing to it (insert, remove,
+ * entry, get_or_insert) faults, because the pages are mapped read-only.
+ * Release it with close_mmap, never with hashmap_K_V_free.
+ *
+ * The map's seed is stored in the header, so a snapshot of a seeded map
+ * opens with the seed it was built under, in any process.
+ *
+ * Requires: HASHMAP_DEFINE(K, V) (or a _WITH/_SCALAR variant) must be called first
+ */
+#define HASHMAP_MMAP_DEFINE(K, V) \
+    RESULT_DEFINE(HashMap_##K##_##V, MapFileError); \
+    \
+    /** \
+     * @brief Header fields that HashMap_K_V requires of a snapshot \
+     * @return Header with sizes and flags filled in \
+     */ \
+    static inline CyanMapFileHeader _hashmap_##K##_##V##_file_header(void) { \
+        CyanMapFileHeader h = { \
+            .magic = "CYANMAP", \
+            .version = CYAN_MAP_FILE_VERSION, \
+            .flags = _CYAN_MAP_FILE_FLAGS, \
+            .key_size = sizeof(K), \
+            .value_size = sizeof(V), \
+            .slot_size = _CYAN_MAP_SLOT_SIZE(_MapEntry_##K##_##V, V) \
+        }; \
+        return h; \
+    } \
+    \
+    /** \
+     * @brief Save the map to a snapshot file \
+     * @param m Pointer to the map (any incremental resize is finished first) \
+     * @param path Destination path; replaced atomically \
+     * @return Ok with the file size in bytes, or Err with a message and errno set \
+     */ \
+    static inline Result_size_t_MapFileError hashmap_##K##_##V##_save( \
+        HashMap_##K##_##V *m, const char *path \
+    ) { \
+        hashmap_##K##_##V##_finish_resize(m); \
+        \
+        CyanMapFileHeader h = _hashmap_##K##_##V##_file_header(); \
+        h.capacity = m->capacity; \
+        h.len = m->len; \
+        h.seed = m->seed; \
+        size_t table_size = m->capacity ? _cyan_map_table_size(m->capacity, (size_t)h.slot_size) : 0; \
+        return _cyan_map_file_save(path, &h, m->buckets, table_size); \
+    } \
+    \
+    /** \
+     * @brief Map a snapshot with explicit hash and equality functions \
+     * @param path Snapshot path \
+     * @param hash_fn Hash function the map was saved with, or NULL for the \
+     *        default seeded hash under the stored seed \
+     * @param equal_fn Equality function the map was saved with \
+     * @return Ok with a read-only map, or Err with a message \
+     * \
+     * Rehashes a few stored keys and compares them with their stored tags, \
+     * so a snapshot saved under a different hash function is rejected \
+     * instead of silently missing keys. \
+     */ \
+    static inline Result_HashMap_##K##_##V##_MapFileError hashmap_##K##_##V##_open_mmap_with( \
+        const char *path, HashFn hash_fn, EqualFn equal_fn \
+    ) { \
+        CyanMapFileHeader expected = _hashmap_##K##_##V##_file_header(); \
+        CyanMapFileHeader h; \
+        void *table; \
+        MapFileError err = _cyan_map_file_open(path, &expected, &h, &table); \
+        if (err) return Err(HashMap_##K##_##V, MapFileError, err); \
+        \
+        HashMap_##K##_##V m = hashmap_##K##_##V##_new(); \
+        m.hash_fn = hash_fn; \
+        m.equal_fn = equal_fn; \
+        m.seed = h.seed; \
+        m.buckets = (_MapEntry_##K##_##V *)table; \
+        m.capacity = (size_t)h.capacity; \
+        m.len = (size_t)h.len; \
+        \
+        size_t checked = 0; \
+        for (size_t i = 0; i < m.capacity && checked < 8; i++) { \
+            if (!_CYAN_TAG_IS_FULL(m.buckets[i].tag)) continue; \
+            if (_cyan_map_tag(_hashmap_##K##_##V##_hash(&m, m.buckets[i].key)) != m.buckets[i].tag) { \
+                munmap((char *)table - sizeof(CyanMapFileHeader), \
+                       sizeof(CyanMapFileHeader) + _cyan_map_table_size(m.capacity, (size_t)h.slot_size)); \
+                return Err(HashMap_##K##_##V, MapFileError, "snapshot was saved with a different hash"); \
+            } \
+            checked++; \
+        } \
+        return Ok(HashMap_##K##_##V, MapFileError, m); \
+    } \
+    \
+    /** \
+     * @brief Map a snapshot saved by hashmap_K_V_save \
+     * @param path Snapshot path \
+     * @return Ok with a read-only map, or Err with a message \
+     * @note Uses the default seeded hash and equal_fn; see open_mmap_with \
+     */ \
+    static inline Result_HashMap_##K##_##V##_MapFileError hashmap_##K##_##V##_open_mmap( \
+        const char *path \
+    ) { \
+        return hashmap_##K##_##V##_open_mmap_with(path, NULL, _cyan_default_equal); \
+    } \
+    \
+    /** \
+     * @brief Unmap a map returned by open_mmap \
+     * @param m Pointer to the mapped map; left empty \
+     */ \
+    static inline void hashmap_##K##_##V##_close_mmap(HashMap_##K##_##V *m) { \
+        if (m->buckets) { \
+            munmap((char *)m->buckets - sizeof(CyanMapFileHeader), \
+                   sizeof(CyanMapFileHeader) + \
+                   _cyan_map_table_size(m->capacity, _CYAN_MAP_SLOT_SIZE(_MapEntry_##K##_##V, V))); \
+        } \
+        m->buckets = NULL; \
+        m->capacity = 0; \
+        m->len = 0; \
+    } \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef HashMap_##K##_##V HashMap_##K##_##V##_mmap_defined
+
+#endif /* CYAN_HASHMAP_MMAP_H */
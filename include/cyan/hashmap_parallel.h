@@ -0,0 +1,319 @@
+/**
+ * @file hashmap_parallel.h
+ * @brief Multi-threaded bulk construction of HashMaps for the Cyan library
+ *
+ * This header builds a HashMap from parallel key and value arrays on
+ * several threads. The table is sized for every key up front and split
+ * into equal regions of slots. Keys are sorted by the region holding their
+ * home bucket, and each thread fills its own regions, so no two threads
+ * write the same slot and no locks are taken.
+ *
+ * Usage:
+ *   OPTION_DEFINE(u64);
+ *   HASHMAP_DEFINE_SCALAR(u64, u64);          // Map type
+ *   HASHMAP_PARALLEL_DEFINE(u64, u64);        // from_slices_parallel
+ *
+ *   HashMap_u64_u64 m = hashmap_u64_u64_from_slices_parallel(keys, values, n, 0);
+ *   hashmap_u64_u64_free(&m);
+ *
+ * The result is an ordinary HashMap, identical in content to inserting the
+ * pairs one by one in array order: a repeated key keeps its last value.
+ *
+ * Requires POSIX threads (compile with -std=gnu11 or define _POSIX_C_SOURCE
+ * and link with -lpthread).
+ */
+
+#ifndef CYAN_HASHMAP_PARALLEL_H
+#define CYAN_HASHMAP_PARALLEL_H
+
+#include "common.h"
+#include "option.h"
+#include "hashmap.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+/**
+ * @brief Inputs smaller than this are inserted on the calling thread
+ */
+#ifndef CYAN_HASHMAP_PARALLEL_MIN
+#define CYAN_HASHMAP_PARALLEL_MIN 16384
+#endif
+
+/**
+ * @brief Regions per thread
+ * More regions even out the work when keys cluster, at the cost of more
+ * keys spilling past a region's end (those are inserted afterwards).
+ */
+#ifndef CYAN_HASHMAP_PARALLEL_REGIONS
+#define CYAN_HASHMAP_PARALLEL_REGIONS 8
+#endif
+
+/*============================================================================
+ * Thread Helpers
+ *============================================================================*/
+
+/**
+ * @brief Resolve a requested thread count
+ * @param threads Requested count, or 0 for one per online CPU
+ * @return At least 1
+ */
+static inline size_t _cyan_map_parallel_threads(size_t threads) {
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (size_t)cpus : 1;
+    }
+    return threads;
+}
+
+/**
+ * @brief Run fn once per task, one task on each of count threads
+ * @param fn Thread function
+ * @param tasks Array of count task structures
+ * @param task_size Size of one task structure
+ * @param count Number of tasks
+ *
+ * The calling thread runs the first task itself. A task whose thread
+ * cannot be started also runs on the calling thread, so every task runs
+ * exactly once.
+ */
+static inline void _cyan_map_parallel_run(
+    void *(*fn)(void *), void *tasks, size_t task_size, size_t count
+) {
+    pthread_t *ids = (pthread_t *)calloc(count, sizeof(pthread_t));
+    bool *started = (bool *)calloc(count, sizeof(bool));
+    if (!ids || !started) CYAN_PANIC("allocation failed");
+
+    for (size_t t = 1; t < count; t++) {
+        started[t] = pthread_create(&ids[t], NULL, fn, (char *)tasks + t * task_size) == 0;
+    }
+    fn(tasks);
+    for (size_t t = 1; t < count; t++) {
+        if (started[t]) pthread_join(ids[t], NULL);
+        else fn((char *)tasks + t * task_size);
+    }
+
+    free(started);
+    free(ids);
+}
+
+/*============================================================================
+ * Parallel Build Definition Macro
+ *============================================================================*/
+
+/**
+ * @brief Generate hashmap_K_V_from_slices_parallel for HashMap_K_V
+ * @param K The key type
+ * @param V The value type
+ *
+ * Creates:
+ * - hashmap_K_V_from_slices_parallel(keys, values, n, threads): Build a
+ *   map from n pairs on the given number of threads (0 for one per CPU)
+ *
+ * The build runs in four steps: threads hash their share of the keys and
+ * count keys per region; the counts become each region's offsets in one
+ * shared index array; threads scatter key indices into it, keeping array
+ * order within a region; then each thread fills its regions by linear
+ * probing. A probe that reaches the end of its region stops there and the
+ * key is inserted on the calling thread once all threads are done. Regions
+ * are whole multiples of 64 slots, so threads never share a word of the
+ * occupancy bitmap.
+ *
+ * Keys are hashed through the new map's hash (the process seed, unless
+ * the map type inlines its own), which must be safe to call from several
+ * threads at once.
+ *
+ * Requires: HASHMAP_DEFINE(K, V) (or a _WITH/_SCALAR variant) must be called first
+ */
+#define HASHMAP_PARALLEL_DEFINE(K, V) \
+    /* State shared by every thread of one build */ \
+    typedef struct { \
+        HashMap_##K##_##V *map; \
+        const K *keys; \
+        const V *values; \
+        size_t n; \
+        size_t threads; \
+        size_t regions;         /* Power of 2 */ \
+        unsigned shift;         /* Home bucket >> shift gives its region */ \
+        int phase;              /* 0: hash and count, 1: scatter, 2: place */ \
+        size_t *hashes;         /* Hash of keys[i] */ \
+        size_t *order;          /* Key indices grouped by region; spills are moved to the front */ \
+        size_t *offsets;        /* [t * regions + r]: next order slot for thread t's keys in r */ \
+        size_t *starts;         /* regions + 1 entries: each region's first order slot */ \
+        size_t *spills;         /* Keys of each region left for the calling thread */ \
+    } _HashMapBuild_##K##_##V; \
+    \
+    /* One thread's part of a build */ \
+    typedef struct { \
+        _HashMapBuild_##K##_##V *b; \
+        size_t t; \
+        size_t placed;          /* New keys stored by this thread */ \
+    } _HashMapBuildTask_##K##_##V; \
+    \
+    /** \
+     * @brief Fill one region of the table from its keys \
+     * @param b Build state \
+     * @param r Region index \
+     * @return Number of new keys stored \
+     */ \
+    static inline size_t _hashmap_##K##_##V##_build_region(_HashMapBuild_##K##_##V *b, size_t r) { \
+        HashMap_##K##_##V *m = b->map; \
+        uint64_t *occ = _hashmap_##K##_##V##_occ(m->buckets, m->capacity); \
+        size_t end = (r + 1) << b->shift; \
+        size_t placed = 0, spilled = 0; \
+        \
+        for (size_t o = b->starts[r]; o < b->starts[r + 1]; o++) { \
+            size_t i = b->order[o]; \
+            size_t hash = b->hashes[i]; \
+            uint32_t tag = _cyan_map_tag(hash); \
+            size_t idx = hash & (m->capacity - 1); \
+            \
+            for (; idx < end; idx++) { \
+                _MapEntry_##K##_##V *slot = &m->buckets[idx]; \
+                if (slot->tag == _CYAN_TAG_EMPTY) { \
+                    slot->tag = tag; \
+                    slot->key = b->keys[i]; \
+                    _cyan_map_occ_set(occ, idx); \
+                    placed++; \
+                    break; \
+                } \
+                if (slot->tag == tag && _hashmap_##K##_##V##_eq(m, slot->key, b->keys[i])) break; \
+            } \
+            \
+            if (idx == end) { \
+                /* Ran out of region; later copies of this key will too */ \
+                b->order[b->starts[r] + spilled++] = i; \
+            } else { \
+                *_CYAN_MAP_VAL(V, m->buckets, m->capacity, idx) = b->values[i]; \
+            } \
+        } \
+        \
+        b->spills[r] = spilled; \
+        return placed; \
+    } \
+    \
+    /* Thread function: run the current phase for one thread's share */ \
+    static inline void *_hashmap_##K##_##V##_build_worker(void *arg) { \
+        _HashMapBuildTask_##K##_##V *task = (_HashMapBuildTask_##K##_##V *)arg; \
+        _HashMapBuild_##K##_##V *b = task->b; \
+        size_t mask = b->map->capacity - 1; \
+        size_t lo = b->n * task->t / b->threads; \
+        size_t hi = b->n * (task->t + 1) / b->threads; \
+        size_t *offsets = &b->offsets[task->t * b->regions]; \
+        \
+        if (b->phase == 0) { \
+            for (size_t i = lo; i < hi; i++) { \
+                size_t hash = _hashmap_##K##_##V##_hash(b->map, b->keys[i]); \
+                b->hashes[i] = hash; \
+                offsets[(hash & mask) >> b->shift]++; \
+            } \
+        } else if (b->phase == 1) { \
+            for (size_t i = lo; i < hi; i++) { \
+                b->order[offsets[(b->hashes[i] & mask) >> b->shift]++] = i; \
+            } \
+        } else { \
+            for (size_t r = task->t; r < b->regions; r += b->threads) { \
+                task->placed += _hashmap_##K##_##V##_build_region(b, r); \
+            } \
+        } \
+        return NULL; \
+    } \
+    \
+    /** \
+     * @brief Build a map from parallel key and value arrays on several threads \
+     * @param keys Array of n keys \
+     * @param values Array of n values; values[i] is stored for keys[i] \
+     * @param n Number of pairs \
+     * @param threads Number of threads to use, or 0 for one per online CPU \
+     * @return A new map holding every pair; a repeated key keeps its last value \
+     * @note Inputs below CYAN_HASHMAP_PARALLEL_MIN pairs, or threads == 1, \
+     *       are inserted on the calling thread \
+     * @note Uses 2 * n * sizeof(size_t) bytes of scratch space during the build \
+     */ \
+    static inline HashMap_##K##_##V hashmap_##K##_##V##_from_slices_parallel( \
+        const K *keys, const V *values, size_t n, size_t threads \
+    ) { \
+        /* Size so that n inserts would never resize */ \
+        size_t cap = CYAN_HASHMAP_INITIAL_CAPACITY; \
+        while ((n + 1) * 100 / cap > CYAN_HASHMAP_LOAD_FACTOR) cap *= 2; \
+        HashMap_##K##_##V m = hashmap_##K##_##V##_with_capacity(cap); \
+        \
+        threads = _cyan_map_parallel_threads(threads); \
+        if (threads > n / 64) threads = n / 64; \
+        size_t regions = 1; \
+        while (regions < threads * CYAN_HASHMAP_PARALLEL_REGIONS && regions * 128 <= cap) regions *= 2; \
+        \
+        if (threads <= 1 || n < CYAN_HASHMAP_PARALLEL_MIN || regions < 2) { \
+            for (size_t i = 0; i < n; i++) hashmap_##K##_##V##_insert(&m, keys[i], values[i]); \
+            return m; \
+        } \
+        \
+        _HashMapBuild_##K##_##V b = { \
+            .map = &m, \
+            .keys = keys, \
+            .values = values, \
+            .n = n, \
+            .threads = threads, \
+            .regions = regions, \
+            .shift = 0, \
+            .phase = 0, \
+            .hashes = (size_t *)malloc(n * sizeof(size_t)), \
+            .order = (size_t *)malloc(n * sizeof(size_t)), \
+            .offsets = (size_t *)calloc(threads * regions, sizeof(size_t)), \
+            .starts = (size_t *)malloc((regions + 1) * sizeof(size_t)), \
+            .spills = (size_t *)calloc(regions, sizeof(size_t)) \
+        }; \
+        if (!b.hashes || !b.order || !b.offsets || !b.starts || !b.spills) CYAN_PANIC("allocation failed"); \
+        while (((size_t)1 << b.shift) * regions < cap) b.shift++; \
+        \
+        _HashMapBuildTask_##K##_##V *tasks = \
+            (_HashMapBuildTask_##K##_##V *)calloc(threads, sizeof(_HashMapBuildTask_##K##_##V)); \
+        if (!tasks) CYAN_PANIC("allocation failed"); \
+        for (size_t t = 0; t < threads; t++) { \
+            tasks[t].b = &b; \
+            tasks[t].t = t; \
+        } \
+        \
+        /* Hash and count, then turn the counts into scatter offsets */ \
+        _cyan_map_parallel_run(_hashmap_##K##_##V##_build_worker, tasks, sizeof(*tasks), threads); \
+        size_t pos = 0; \
+        for (size_t r = 0; r < regions; r++) { \
+            b.starts[r] = pos; \
+            for (size_t t = 0; t < threads; t++) { \
+                size_t count = b.offsets[t * regions + r]; \
+                b.offsets[t * regions + r] = pos; \
+                pos += count; \
+            } \
+        } \
+        b.starts[regions] = pos; \
+        \
+        b.phase = 1; \
+        _cyan_map_parallel_run(_hashmap_##K##_##V##_build_worker, tasks, sizeof(*tasks), threads); \
+        b.phase = 2; \
+        _cyan_map_parallel_run(_hashmap_##K##_##V##_build_worker, tasks, sizeof(*tasks), threads); \
+        \
+        for (size_t t = 0; t < threads; t++) m.len += tasks[t].placed; \
+        \
+        /* Keys whose probe crossed a region boundary, in array order per region */ \
+        for (size_t r = 0; r < regions; r++) { \
+            for (size_t o = b.starts[r]; o < b.starts[r] + b.spills[r]; o++) { \
+                hashmap_##K##_##V##_insert(&m, keys[b.order[o]], values[b.order[o]]); \
+            } \
+        } \
+        \
+        free(tasks); \
+        free(b.spills); \
+        free(b.starts); \
+        free(b.offsets); \
+        free(b.order); \
+        free(b.hashes); \
+        return m; \
+    } \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef HashMap_##K##_##V HashMap_##K##_##V##_parallel_defined
+
+#endif /* CYAN_HASHMAP_PARALLEL_H */
@@ -0,0 +1,554 @@
+/**
+ * @file hashset.h
+ * @brief Type-safe hash set for the Cyan library
+ *
+ * This header provides a generic hash set that stores keys only, using the
+ * same open addressing scheme as HashMap. Compared to a HashMap_K_bool it
+ * needs no value slot per entry and answers membership with a plain bool.
+ *
+ * Usage:
+ *   OPTION_DEFINE(int);    // Required for Option_int
+ *   VECTOR_DEFINE(int);    // Required for Slice_int
+ *   SLICE_DEFINE(int);     // Required for hashset_int_extend
+ *   HASHSET_DEFINE(int);   // Define HashSet_int type
+ *
+ *   HashSet_int s = hashset_int_new();
+ *   hashset_int_insert(&s, 42);
+ *   bool present = hashset_int_contains(&s, 42);
+ *   hashset_int_free(&s);
+ */
+
+#ifndef CYAN_HASHSET_H
+#define CYAN_HASHSET_H
+
+#include "common.h"
+#include "option.h"
+#include "vector.h"
+#include "slice.h"
+#include "hash.h"
+#include "hashmap.h"
+#include <string.h>
+
+/*============================================================================
+ * HashSet Type Definition Macro
+ *============================================================================*/
+
+/**
+ * @brief Internal: generate the entry, vtable and set structures (do not use directly)
+ * @param K The key type
+ */
+#define _HASHSET_DEFINE_TYPES(K) \
+    /* Entry structure */ \
+    typedef struct { \
+        _CyanEntryState state; \
+        K key; \
+    } _SetEntry_##K; \
+    \
+    /* Forward declare HashSet_K for use in vtable */ \
+    typedef struct HashSet_##K HashSet_##K; \
+    \
+    /** \
+     * @brief Vtable structure for HashSet_K containing function pointers \
+     */ \
+    typedef struct { \
+        bool (*insert)(HashSet_##K *s, K key); \
+        bool (*contains)(const HashSet_##K *s, K key); \
+        bool (*remove)(HashSet_##K *s, K key); \
+        size_t (*len)(const HashSet_##K *s); \
+        void (*free)(HashSet_##K *s); \
+    } HashSetVT_##K; \
+    \
+    /** \
+     * @brief HashSet structure with vtable pointer \
+     */ \
+    struct HashSet_##K { \
+        _SetEntry_##K *buckets; \
+        size_t capacity; \
+        size_t len; \
+        size_t tombstones;      /* Deleted slots still lengthening probes */ \
+        HashFn hash_fn;         /* Unseeded override; NULL to use seeded_hash_fn */ \
+        EqualFn equal_fn; \
+        SeededHashFn seeded_hash_fn; \
+        uint64_t seed;          /* Change only while the set is empty */ \
+        const HashSetVT_##K *vt; \
+    }; \
+    \
+    /* Iterator structure */ \
+    typedef struct { \
+        const HashSet_##K *set; \
+        size_t index; \
+    } HashSetIter_##K
+
+/**
+ * @brief Internal: generate the set operations (do not use directly)
+ * @param K The key type
+ *
+ * Expects _hashset_K_hash(s, key) and _hashset_K_eq(s, a, b) to be
+ * defined beforehand.
+ */
+#define _HASHSET_DEFINE_OPS(K) \
+    /* Forward declare vtable instance */ \
+    static const HashSetVT_##K _hashset_##K##_vt; \
+    \
+    /** \
+     * @brief Create an empty hash set \
+     * @return A new empty HashSet_K \
+     */ \
+    static inline HashSet_##K hashset_##K##_new(void) { \
+        return (HashSet_##K){ \
+            .buckets = NULL, \
+            .capacity = 0, \
+            .len = 0, \
+            .tombstones = 0, \
+            .hash_fn = NULL, \
+            .equal_fn = _cyan_default_equal, \
+            .seeded_hash_fn = cyan_hash_wy_seeded, \
+            .seed = cyan_hash_process_seed(), \
+            .vt = &_hashset_##K##_vt \
+        }; \
+    } \
+    \
+    /** \
+     * @brief Create a hash set with room for at least cap keys \
+     * @param cap Number of keys to hold without resizing \
+     * @return A new HashSet_K with allocated storage \
+     */ \
+    static inline HashSet_##K hashset_##K##_with_capacity(size_t cap) { \
+        /* Size so that cap keys stay under the load factor */ \
+        size_t actual_cap = CYAN_HASHMAP_INITIAL_CAPACITY; \
+        while (cap * 100 / actual_cap > CYAN_HASHMAP_LOAD_FACTOR) actual_cap *= 2; \
+        \
+        HashSet_##K s = hashset_##K##_new(); \
+        s.buckets = (_SetEntry_##K *)calloc(actual_cap, sizeof(_SetEntry_##K)); \
+        if (!s.buckets) CYAN_PANIC("allocation failed"); \
+        s.capacity = actual_cap; \
+        return s; \
+    } \
+    \
+    /** \
+     * @brief Find the bucket index for a key \
+     * @param s Pointer to the set \
+     * @param key The key to find \
+     * @param for_insert If true, returns first available slot; if false, returns exact match only \
+     * @return Bucket index, or capacity if not found (when for_insert is false) \
+     */ \
+    static inline size_t _hashset_##K##_find_bucket( \
+        const HashSet_##K *s, K key, bool for_insert \
+    ) { \
+        if (s->capacity == 0) return 0; \
+        \
+        size_t mask = s->capacity - 1; \
+        size_t idx = _hashset_##K##_hash(s, key) & mask; \
+        size_t first_deleted = s->capacity; \
+        \
+        for (size_t i = 0; i < s->capacity; i++) { \
+            size_t probe_idx = (idx + i) & mask; \
+            const _SetEntry_##K *entry = &s->buckets[probe_idx]; \
+            \
+            if (entry->state == _CYAN_ENTRY_EMPTY) { \
+                if (for_insert) { \
+                    return (first_deleted < s->capacity) ? first_deleted : probe_idx; \
+                } \
+                return s->capacity; \
+            } \
+            \
+            if (entry->state == _CYAN_ENTRY_DELETED) { \
+                if (for_insert && first_deleted == s->capacity) { \
+                    first_deleted = probe_idx; \
+                } \
+                continue; \
+            } \
+            \
+            if (_hashset_##K##_eq(s, entry->key, key)) { \
+                return probe_idx; \
+            } \
+        } \
+        \
+        if (for_insert && first_deleted < s->capacity) { \
+            return first_deleted; \
+        } \
+        return s->capacity; \
+    } \
+    \
+    /** \
+     * @brief Resize the hash set \
+     * @param s Pointer to the set \
+     * @param new_cap New capacity (must be power of 2) \
+     */ \
+    static inline void _hashset_##K##_resize(HashSet_##K *s, size_t new_cap) { \
+        _SetEntry_##K *old_buckets = s->buckets; \
+        size_t old_cap = s->capacity; \
+        \
+        s->buckets = (_SetEntry_##K *)calloc(new_cap, sizeof(_SetEntry_##K)); \
+        if (!s->buckets) { \
+            s->buckets = old_buckets; \
+            CYAN_PANIC("allocation failed"); \
+        } \
+        s->capacity = new_cap; \
+        s->tombstones = 0; \
+        \
+        size_t mask = new_cap - 1; \
+        for (size_t i = 0; i < old_cap; i++) { \
+            if (old_buckets[i].state != _CYAN_ENTRY_OCCUPIED) continue; \
+            /* Keys are unique, so the first empty slot is the target */ \
+            size_t idx = _hashset_##K##_hash(s, old_buckets[i].key) & mask; \
+            while (s->buckets[idx].state != _CYAN_ENTRY_EMPTY) idx = (idx + 1) & mask; \
+            s->buckets[idx] = old_buckets[i]; \
+        } \
+        \
+        free(old_buckets); \
+    } \
+    \
+    /** \
+     * @brief Make room for additional keys without further resizing \
+     * @param s Pointer to the set \
+     * @param additional Number of keys about to be inserted \
+     * \
+     * Tombstones lengthen probe chains just like live keys, so they count \
+     * toward the load factor. When they alone push the table over it, the \
+     * table is rebuilt at the same capacity to clear them, unless the live \
+     * keys fill more than half the load factor. \
+     */ \
+    static inline void hashset_##K##_reserve(HashSet_##K *s, size_t additional) { \
+        if (s->capacity && \
+            (s->len + s->tombstones + additional) * 100 / s->capacity <= CYAN_HASHMAP_LOAD_FACTOR) { \
+            return; \
+        } \
+        size_t new_cap = s->capacity ? s->capacity : CYAN_HASHMAP_INITIAL_CAPACITY; \
+        if (s->capacity && (s->len + additional) * 100 / new_cap > CYAN_HASHMAP_LOAD_FACTOR / 2) new_cap *= 2; \
+        while ((s->len + additional) * 100 / new_cap > CYAN_HASHMAP_LOAD_FACTOR) new_cap *= 2; \
+        _hashset_##K##_resize(s, new_cap); \
+    } \
+    \
+    /** \
+     * @brief Insert a key \
+     * @param s Pointer to the set \
+     * @param key The key \
+     * @return true if the key was added, false if it was already present \
+     */ \
+    static inline bool hashset_##K##_insert(HashSet_##K *s, K key) { \
+        hashset_##K##_reserve(s, 1); \
+        \
+        size_t idx = _hashset_##K##_find_bucket(s, key, true); \
+        if (s->buckets[idx].state == _CYAN_ENTRY_OCCUPIED) return false; \
+        if (s->buckets[idx].state == _CYAN_ENTRY_DELETED) s->tombstones--; \
+        \
+        s->buckets[idx].state = _CYAN_ENTRY_OCCUPIED; \
+        s->buckets[idx].key = key; \
+        s->len++; \
+        return true; \
+    } \
+    \
+    /** \
+     * @brief Check if a key is in the set \
+     * @param s Pointer to the set \
+     * @param key The key \
+     * @return true if present, false otherwise \
+     */ \
+    static inline bool hashset_##K##_contains(const HashSet_##K *s, K key) { \
+        if (s->capacity == 0) return false; \
+        return _hashset_##K##_find_bucket(s, key, false) < s->capacity; \
+    } \
+    \
+    /** \
+     * @brief Remove a key from the set \
+     * @param s Pointer to the set \
+     * @param key The key \
+     * @return true if the key was removed, false if it was not present \
+     */ \
+    static inline bool hashset_##K##_remove(HashSet_##K *s, K key) { \
+        if (s->capacity == 0) return false; \
+        \
+        size_t idx = _hashset_##K##_find_bucket(s, key, false); \
+        if (idx >= s->capacity) return false; \
+        \
+        s->buckets[idx].state = _CYAN_ENTRY_DELETED; \
+        s->len--; \
+        s->tombstones++; \
+        return true; \
+    } \
+    \
+    /** \
+     * @brief Insert every key of a slice \
+     * @param s Pointer to the set \
+     * @param keys Slice of keys (duplicates are allowed) \
+     * @return Number of keys that were newly added \
+     * @note Resizes at most once up front \
+     */ \
+    static inline size_t hashset_##K##_extend(HashSet_##K *s, Slice_##K keys) { \
+        hashset_##K##_reserve(s, keys.len); \
+        \
+        size_t added = 0; \
+        for (size_t i = 0; i < keys.len; i++) { \
+            size_t idx = _hashset_##K##_find_bucket(s, keys.data[i], true); \
+            if (s->buckets[idx].state == _CYAN_ENTRY_OCCUPIED) continue; \
+            if (s->buckets[idx].state == _CYAN_ENTRY_DELETED) s->tombstones--; \
+            s->buckets[idx].state = _CYAN_ENTRY_OCCUPIED; \
+            s->buckets[idx].key = keys.data[i]; \
+            s->len++; \
+            added++; \
+        } \
+        return added; \
+    } \
+    \
+    /** \
+     * @brief Get the number of keys in the set \
+     * @param s Pointer to the set \
+     * @return Number of keys \
+     */ \
+    static inline size_t hashset_##K##_len(const HashSet_##K *s) { \
+        return s->len; \
+    } \
+    \
+    /** \
+     * @brief Create an iterator over the set's keys \
+     * @param s Pointer to the set \
+     * @return Iterator positioned before the first key \
+     */ \
+    static inline HashSetIter_##K hashset_##K##_iter(const HashSet_##K *s) { \
+        return (HashSetIter_##K){ .set = s, .index = 0 }; \
+    } \
+    \
+    /** \
+     * @brief Get the next key from the iterator \
+     * @param it Pointer to the iterator \
+     * @return Option containing the key, or None if iteration complete \
+     */ \
+    static inline Option_##K hashset_##K##_iter_next(HashSetIter_##K *it) { \
+        while (it->index < it->set->capacity) { \
+            const _SetEntry_##K *entry = &it->set->buckets[it->index]; \
+            it->index++; \
+            if (entry->state == _CYAN_ENTRY_OCCUPIED) return Some(K, entry->key); \
+        } \
+        return None(K); \
+    } \
+    \
+    /** \
+     * @brief Create a set containing every key in a or b \
+     * @param a Pointer to the first set \
+     * @param b Pointer to the second set \
+     * @return A new HashSet_K (uses a's hash and equality functions) \
+     */ \
+    static inline HashSet_##K hashset_##K##_union(const HashSet_##K *a, const HashSet_##K *b) { \
+        HashSet_##K r = hashset_##K##_with_capacity(a->len + b->len); \
+        r.hash_fn = a->hash_fn; \
+        r.equal_fn = a->equal_fn; \
+        r.seeded_hash_fn = a->seeded_hash_fn; \
+        r.seed = a->seed; \
+        \
+        const HashSet_##K *srcs[2] = { a, b }; \
+        for (int s = 0; s < 2; s++) { \
+            for (size_t i = 0; i < srcs[s]->capacity; i++) { \
+                if (srcs[s]->buckets[i].state != _CYAN_ENTRY_OCCUPIED) continue; \
+                K key = srcs[s]->buckets[i].key; \
+                size_t idx = _hashset_##K##_find_bucket(&r, key, true); \
+                if (r.buckets[idx].state == _CYAN_ENTRY_OCCUPIED) continue; \
+                r.buckets[idx].state = _CYAN_ENTRY_OCCUPIED; \
+                r.buckets[idx].key = key; \
+                r.len++; \
+            } \
+        } \
+        return r; \
+    } \
+    \
+    /** \
+     * @brief Create a set containing every key in both a and b \
+     * @param a Pointer to the first set \
+     * @param b Pointer to the second set \
+     * @return A new HashSet_K (uses a's hash and equality functions) \
+     * @note Iterates the smaller set and probes the larger one \
+     */ \
+    static inline HashSet_##K hashset_##K##_intersection(const HashSet_##K *a, const HashSet_##K *b) { \
+        const HashSet_##K *small = a->len <= b->len ? a : b; \
+        const HashSet_##K *large = a->len <= b->len ? b : a; \
+        \
+        HashSet_##K r = hashset_##K##_with_capacity(small->len); \
+        r.hash_fn = a->hash_fn; \
+        r.equal_fn = a->equal_fn; \
+        r.seeded_hash_fn = a->seeded_hash_fn; \
+        r.seed = a->seed; \
+        \
+        for (size_t i = 0; i < small->capacity; i++) { \
+            if (small->buckets[i].state != _CYAN_ENTRY_OCCUPIED) continue; \
+            K key = small->buckets[i].key; \
+            if (!hashset_##K##_contains(large, key)) continue; \
+            /* Keys from one set are unique, so no duplicate check is needed */ \
+            size_t idx = _hashset_##K##_find_bucket(&r, key, true); \
+            r.buckets[idx].state = _CYAN_ENTRY_OCCUPIED; \
+            r.buckets[idx].key = key; \
+            r.len++; \
+        } \
+        return r; \
+    } \
+    \
+    /** \
+     * @brief Create a set containing every key in a that is not in b \
+     * @param a Pointer to the first set \
+     * @param b Pointer to the second set \
+     * @return A new HashSet_K (uses a's hash and equality functions) \
+     */ \
+    static inline HashSet_##K hashset_##K##_difference(const HashSet_##K *a, const HashSet_##K *b) { \
+        HashSet_##K r = hashset_##K##_with_capacity(a->len); \
+        r.hash_fn = a->hash_fn; \
+        r.equal_fn = a->equal_fn; \
+        r.seeded_hash_fn = a->seeded_hash_fn; \
+        r.seed = a->seed; \
+        \
+        for (size_t i = 0; i < a->capacity; i++) { \
+            if (a->buckets[i].state != _CYAN_ENTRY_OCCUPIED) continue; \
+            K key = a->buckets[i].key; \
+            if (hashset_##K##_contains(b, key)) continue; \
+            size_t idx = _hashset_##K##_find_bucket(&r, key, true); \
+            r.buckets[idx].state = _CYAN_ENTRY_OCCUPIED; \
+            r.buckets[idx].key = key; \
+            r.len++; \
+        } \
+        return r; \
+    } \
+    \
+    /** \
+     * @brief Free all memory associated with the set \
+     * @param s Pointer to the set \
+     */ \
+    static inline void hashset_##K##_free(HashSet_##K *s) { \
+        free(s->buckets); \
+        s->buckets = NULL; \
+        s->capacity = 0; \
+        s->len = 0; \
+        s->tombstones = 0; \
+    } \
+    \
+    /** \
+     * @brief Static const vtable instance shared by all HashSet_K instances \
+     */ \
+    static const HashSetVT_##K _hashset_##K##_vt = { \
+        .insert = hashset_##K##_insert, \
+        .contains = hashset_##K##_contains, \
+        .remove = hashset_##K##_remove, \
+        .len = hashset_##K##_len, \
+        .free = hashset_##K##_free \
+    }
+
+/**
+ * @brief Generate a HashSet type for a given key type
+ * @param K The key type
+ *
+ * Creates:
+ * - HashSet_K: The hash set structure
+ * - HashSetVT_K: Vtable structure with function pointers
+ * - hashset_K_new() / hashset_K_with_capacity(cap): Constructors
+ * - hashset_K_insert(s, key): Add key, returns true if newly added
+ * - hashset_K_contains(s, key): Check membership
+ * - hashset_K_remove(s, key): Remove key, returns true if it was present
+ * - hashset_K_extend(s, slice): Insert every key of a Slice_K
+ * - hashset_K_reserve(s, n): Pre-size for n more keys
+ * - hashset_K_union/intersection/difference(a, b): Set algebra into a new set
+ * - hashset_K_iter(s) / hashset_K_iter_next(it): Iterate keys
+ * - hashset_K_len(s), hashset_K_free(s)
+ *
+ * Also generates convenience macros SET_INSERT, SET_CONTAINS, SET_REMOVE,
+ * SET_LEN and SET_FREE. Keys are hashed like HashMap keys: through
+ * seeded_hash_fn under the set's random seed, or through hash_fn if one is
+ * assigned; see HASHSET_DEFINE_WITH for compile-time hashing.
+ *
+ * Requires: SLICE_DEFINE(K) (and therefore OPTION_DEFINE(K) and
+ * VECTOR_DEFINE(K)) must be called before HASHSET_DEFINE(K)
+ */
+#define HASHSET_DEFINE(K) \
+    _HASHSET_DEFINE_TYPES(K); \
+    \
+    /* Hash a key through the set's hash function pointers */ \
+    static inline size_t _hashset_##K##_hash(const HashSet_##K *s, K key) { \
+        return s->hash_fn ? s->hash_fn(&key, sizeof(K)) \
+                          : s->seeded_hash_fn(&key, sizeof(K), s->seed); \
+    } \
+    \
+    /* Compare two keys through the set's equality function pointer */ \
+    static inline bool _hashset_##K##_eq(const HashSet_##K *s, K a, K b) { \
+        return s->equal_fn(&a, &b, sizeof(K)); \
+    } \
+    \
+    _HASHSET_DEFINE_OPS(K); \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef HashSet_##K HashSet_##K##_defined
+
+/**
+ * @brief Generate a HashSet type with compile-time hash and equality
+ * @param K The key type
+ * @param hash_expr Function or function-like macro called as hash_expr(key)
+ * @param eq_expr Function or function-like macro called as eq_expr(a, b)
+ *
+ * Same API as HASHSET_DEFINE; see HASHMAP_DEFINE_WITH for details.
+ *
+ * Requires: SLICE_DEFINE(K) must be called before HASHSET_DEFINE_WITH(K, ...)
+ */
+#define HASHSET_DEFINE_WITH(K, hash_expr, eq_expr) \
+    _HASHSET_DEFINE_TYPES(K); \
+    \
+    /* Hash a key with the compile-time hash expression */ \
+    static inline size_t _hashset_##K##_hash(const HashSet_##K *s, K key) { \
+        (void)s; \
+        return (size_t)(hash_expr(key)); \
+    } \
+    \
+    /* Compare two keys with the compile-time equality expression */ \
+    static inline bool _hashset_##K##_eq(const HashSet_##K *s, K a, K b) { \
+        (void)s; \
+        return (eq_expr(a, b)); \
+    } \
+    \
+    _HASHSET_DEFINE_OPS(K); \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef HashSet_##K HashSet_##K##_defined
+
+/**
+ * @brief Generate a HashSet type for integer, enum or pointer keys
+ * @param K The key type
+ *
+ * Shorthand for HASHSET_DEFINE_WITH(K, CYAN_HASH_SCALAR, CYAN_EQ_SCALAR).
+ */
+#define HASHSET_DEFINE_SCALAR(K) \
+    HASHSET_DEFINE_WITH(K, CYAN_HASH_SCALAR, CYAN_EQ_SCALAR)
+
+/*============================================================================
+ * HashSet Convenience Macros
+ *============================================================================*/
+
+/**
+ * @brief Insert a key into the set via vtable
+ * @param s The set (not a pointer)
+ * @param k The key
+ * @return true if the key was newly added
+ */
+#define SET_INSERT(s, k) ((s).vt->insert(&(s), (k)))
+
+/**
+ * @brief Check if a key is in the set via vtable
+ * @param s The set (not a pointer)
+ * @param k The key
+ * @return true if present
+ */
+#define SET_CONTAINS(s, k) ((s).vt->contains(&(s), (k)))
+
+/**
+ * @brief Remove a key from the set via vtable
+ * @param s The set (not a pointer)
+ * @param k The key
+ * @return true if the key was present
+ */
+#define SET_REMOVE(s, k) ((s).vt->remove(&(s), (k)))
+
+/**
+ * @brief Get the number of keys via vtable
+ * @param s The set (not a pointer)
+ * @return Number of keys
+ */
+#define SET_LEN(s) ((s).vt->len(&(s)))
+
+/**
+ * @brief Free all memory associated with the set via vtable
+ * @param s The set (not a pointer)
+ */
+#define SET_FREE(s) ((s).vt->free(&(s)))
+
+#endif /* CYAN_HASHSET_H */
@@ -0,0 +1,487 @@
+/**
+ * @file indexmap.h
+ * @brief Insertion-ordered hash map for the Cyan library
+ *
+ * This header provides a hash map that keeps its entries in a dense vector,
+ * in insertion order, next to a compact table of u32 positions into that
+ * vector. Iteration is a plain walk over contiguous memory and entries can
+ * be addressed by position, which suits maps that are read far more often
+ * than they are modified (configuration, symbol tables).
+ *
+ * Compared to HashMap:
+ * - Iteration visits exactly len entries, in insertion order
+ * - indexmap_K_V_get_index gives O(1) access by position
+ * - Removal is swap_remove: the last entry moves into the hole, so order
+ *   is kept except for that one entry
+ * - At most UINT32_MAX - 1 entries
+ *
+ * Usage:
+ *   OPTION_DEFINE(int);              // Required for Option_int
+ *   INDEXMAP_DEFINE(int, int);       // Define IndexMap_int_int type
+ *
+ *   IndexMap_int_int m = indexmap_int_int_new();
+ *   indexmap_int_int_insert(&m, 42, 100);
+ *   Slice_IndexMapEntry_int_int all = indexmap_int_int_entries(&m);
+ *   for (size_t i = 0; i < all.len; i++) use(all.data[i].key, all.data[i].value);
+ *   indexmap_int_int_free(&m);
+ */
+
+#ifndef CYAN_INDEXMAP_H
+#define CYAN_INDEXMAP_H
+
+#include "common.h"
+#include "option.h"
+#include "vector.h"
+#include "slice.h"
+#include "hash.h"
+#include "hashmap.h"
+#include <stdint.h>
+#include <string.h>
+
+/* Index table slot that holds no position */
+#define _CYAN_INDEXMAP_EMPTY UINT32_MAX
+
+/*============================================================================
+ * IndexMap Type Definition Macro
+ *============================================================================*/
+
+/**
+ * @brief Internal: generate the entry, vtable and map structures (do not use directly)
+ * @param K The key type
+ * @param V The value type
+ */
+#define _INDEXMAP_DEFINE_TYPES(K, V) \
+    /** \
+     * @brief Entry stored in insertion order \
+     * @note key and hash must not be modified through entry pointers or slices \
+     */ \
+    typedef struct { \
+        K key; \
+        V value; \
+        size_t hash;            /* Cached hash of key, used when the index grows */ \
+    } IndexMapEntry_##K##_##V; \
+    \
+    OPTION_DEFINE(IndexMapEntry_##K##_##V); \
+    VECTOR_DEFINE(IndexMapEntry_##K##_##V); \
+    SLICE_DEFINE(IndexMapEntry_##K##_##V); \
+    \
+    /* Forward declare IndexMap_K_V for use in vtable */ \
+    typedef struct IndexMap_##K##_##V IndexMap_##K##_##V; \
+    \
+    /** \
+     * @brief Vtable structure for IndexMap_K_V, laid out like HashMapVT_K_V \
+     */ \
+    typedef struct { \
+        void (*insert)(IndexMap_##K##_##V *m, K key, V value); \
+        Option_##V (*get)(IndexMap_##K##_##V *m, K key); \
+        bool (*contains)(IndexMap_##K##_##V *m, K key); \
+        Option_##V (*remove)(IndexMap_##K##_##V *m, K key); \
+        size_t (*len)(IndexMap_##K##_##V *m); \
+        void (*free)(IndexMap_##K##_##V *m); \
+    } IndexMapVT_##K##_##V; \
+    \
+    /** \
+     * @brief IndexMap structure with vtable pointer \
+     */ \
+    struct IndexMap_##K##_##V { \
+        Vec_IndexMapEntry_##K##_##V entries; /* Dense, in insertion order */ \
+        uint32_t *indices;      /* Positions into entries, or _CYAN_INDEXMAP_EMPTY */ \
+        size_t index_cap;       /* Slots in indices (power of 2, or 0) */ \
+        HashFn hash_fn;         /* Unseeded override; NULL to use seeded_hash_fn */ \
+        EqualFn equal_fn; \
+        SeededHashFn seeded_hash_fn; \
+        uint64_t seed;          /* Change only while the map is empty */ \
+        const IndexMapVT_##K##_##V *vt; \
+    }
+
+/**
+ * @brief Internal: generate the map operations (do not use directly)
+ * @param K The key type
+ * @param V The value type
+ *
+ * Expects _indexmap_K_V_hash(m, key) and _indexmap_K_V_eq(m, a, b) to be
+ * defined beforehand.
+ */
+#define _INDEXMAP_DEFINE_OPS(K, V) \
+    /* Forward declare vtable instance */ \
+    static const IndexMapVT_##K##_##V _indexmap_##K##_##V##_vt; \
+    \
+    /** \
+     * @brief Create an empty index map \
+     * @return A new empty IndexMap_K_V with no allocated storage \
+     */ \
+    static inline IndexMap_##K##_##V indexmap_##K##_##V##_new(void) { \
+        return (IndexMap_##K##_##V){ \
+            .entries = vec_IndexMapEntry_##K##_##V##_new(), \
+            .indices = NULL, \
+            .index_cap = 0, \
+            .hash_fn = NULL, \
+            .equal_fn = _cyan_default_equal, \
+            .seeded_hash_fn = cyan_hash_wy_seeded, \
+            .seed = cyan_hash_process_seed(), \
+            .vt = &_indexmap_##K##_##V##_vt \
+        }; \
+    } \
+    \
+    /** \
+     * @brief Rebuild the index table with a given number of slots \
+     * @param m Pointer to the map \
+     * @param cap New slot count (power of 2, above len) \
+     * @note Uses the cached hashes; never calls the hash function \
+     */ \
+    static inline void _indexmap_##K##_##V##_reindex(IndexMap_##K##_##V *m, size_t cap) { \
+        uint32_t *indices = (uint32_t *)malloc(cap * sizeof(uint32_t)); \
+        if (!indices) CYAN_PANIC("allocation failed"); \
+        memset(indices, 0xFF, cap * sizeof(uint32_t)); /* All _CYAN_INDEXMAP_EMPTY */ \
+        \
+        size_t mask = cap - 1; \
+        for (size_t pos = 0; pos < m->entries.len; pos++) { \
+            size_t slot = m->entries.data[pos].hash & mask; \
+            while (indices[slot] != _CYAN_INDEXMAP_EMPTY) slot = (slot + 1) & mask; \
+            indices[slot] = (uint32_t)pos; \
+        } \
+        \
+        free(m->indices); \
+        m->indices = indices; \
+        m->index_cap = cap; \
+    } \
+    \
+    /** \
+     * @brief Create an index map with room for at least cap entries \
+     * @param cap Number of entries to hold without resizing \
+     * @return A new IndexMap_K_V with allocated storage \
+     */ \
+    static inline IndexMap_##K##_##V indexmap_##K##_##V##_with_capacity(size_t cap) { \
+        /* Size so that cap entries stay under the load factor */ \
+        size_t index_cap = CYAN_HASHMAP_INITIAL_CAPACITY; \
+        while (cap * 100 / index_cap > CYAN_HASHMAP_LOAD_FACTOR) index_cap *= 2; \
+        \
+        IndexMap_##K##_##V m = indexmap_##K##_##V##_new(); \
+        m.entries = vec_IndexMapEntry_##K##_##V##_with_capacity(cap); \
+        _indexmap_##K##_##V##_reindex(&m, index_cap); \
+        return m; \
+    } \
+    \
+    /** \
+     * @brief Find the index slot holding a key \
+     * @param m Pointer to the map \
+     * @param key The key to find \
+     * @param hash Hash of the key \
+     * @return Slot in indices holding the key's position, or index_cap if absent \
+     */ \
+    static inline size_t _indexmap_##K##_##V##_find_slot( \
+        const IndexMap_##K##_##V *m, K key, size_t hash \
+    ) { \
+        if (m->index_cap == 0) return 0; \
+        \
+        size_t mask = m->index_cap - 1; \
+        /* The load factor keeps an empty slot, so the probe terminates */ \
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) { \
+            uint32_t pos = m->indices[slot]; \
+            if (pos == _CYAN_INDEXMAP_EMPTY) return m->index_cap; \
+            \
+            const IndexMapEntry_##K##_##V *e = &m->entries.data[pos]; \
+            if (e->hash == hash && _indexmap_##K##_##V##_eq(m, e->key, key)) return slot; \
+        } \
+    } \
+    \
+    /** \
+     * @brief Find the position of a key's entry \
+     * @param m Pointer to the map \
+     * @param key The key to find \
+     * @param index Set to the entry's position when found (may be NULL) \
+     * @return true if the key is present \
+     */ \
+    static inline bool indexmap_##K##_##V##_index_of( \
+        const IndexMap_##K##_##V *m, K key, size_t *index \
+    ) { \
+        size_t slot = _indexmap_##K##_##V##_find_slot(m, key, _indexmap_##K##_##V##_hash(m, key)); \
+        if (slot >= m->index_cap) return false; \
+        \
+        if (index) *index = m->indices[slot]; \
+        return true; \
+    } \
+    \
+    /** \
+     * @brief Insert or update a key-value pair \
+     * @param m Pointer to the map \
+     * @param key The key \
+     * @param value The value \
+     * @note An existing key keeps its position; a new key is appended \
+     * @note Panics if the map would exceed UINT32_MAX - 1 entries \
+     */ \
+    static inline void indexmap_##K##_##V##_insert(IndexMap_##K##_##V *m, K key, V value) { \
+        size_t hash = _indexmap_##K##_##V##_hash(m, key); \
+        size_t slot = _indexmap_##K##_##V##_find_slot(m, key, hash); \
+        if (slot < m->index_cap) { \
+            m->entries.data[m->indices[slot]].value = value; \
+            return; \
+        } \
+        \
+        size_t len = m->entries.len; \
+        if (len >= _CYAN_INDEXMAP_EMPTY - 1) CYAN_PANIC("IndexMap capacity exceeded"); \
+        if (m->index_cap == 0 || (len + 1) * 100 / m->index_cap > CYAN_HASHMAP_LOAD_FACTOR) { \
+            _indexmap_##K##_##V##_reindex( \
+                m, m->index_cap == 0 ? CYAN_HASHMAP_INITIAL_CAPACITY : m->index_cap * 2); \
+        } \
+        \
+        size_t mask = m->index_cap - 1; \
+        slot = hash & mask; \
+        while (m->indices[slot] != _CYAN_INDEXMAP_EMPTY) slot = (slot + 1) & mask; \
+        m->indices[slot] = (uint32_t)len; \
+        \
+        IndexMapEntry_##K##_##V e = { .key = key, .value = value, .hash = hash }; \
+        vec_IndexMapEntry_##K##_##V##_push(&m->entries, e); \
+    } \
+    \
+    /** \
+     * @brief Get a copy of the value for a key \
+     * @param m Pointer to the map \
+     * @param key The key \
+     * @return Option_V containing the value, or None if not found \
+     */ \
+    static inline Option_##V indexmap_##K##_##V##_get(IndexMap_##K##_##V *m, K key) { \
+        size_t pos; \
+        if (!indexmap_##K##_##V##_index_of(m, key, &pos)) return None(V); \
+        \
+        return Some(V, m->entries.data[pos].value); \
+    } \
+    \
+    /** \
+     * @brief Get a pointer to the value for a key \
+     * @param m Pointer to the map \
+     * @param key The key \
+     * @return Pointer to the stored value, or NULL if not found \
+     * @note The pointer is invalidated by any insert or remove \
+     */ \
+    static inline V *indexmap_##K##_##V##_get_ptr(IndexMap_##K##_##V *m, K key) { \
+        size_t pos; \
+        return indexmap_##K##_##V##_index_of(m, key, &pos) ? &m->entries.data[pos].value : NULL; \
+    } \
+    \
+    /** \
+     * @brief Check if a key exists in the map \
+     * @param m Pointer to the map \
+     * @param key The key \
+     * @return true if the key exists \
+     */ \
+    static inline bool indexmap_##K##_##V##_contains(IndexMap_##K##_##V *m, K key) { \
+        return indexmap_##K##_##V##_index_of(m, key, NULL); \
+    } \
+    \
+    /** \
+     * @brief Get the entry at a position \
+     * @param m Pointer to the map \
+     * @param index Position in insertion order \
+     * @return Pointer to the entry, or NULL if index >= len \
+     * @note Only the value may be modified through the pointer \
+     */ \
+    static inline IndexMapEntry_##K##_##V *indexmap_##K##_##V##_get_index( \
+        IndexMap_##K##_##V *m, size_t index \
+    ) { \
+        return index < m->entries.len ? &m->entries.data[index] : NULL; \
+    } \
+    \
+    /** \
+     * @brief Empty an index slot, shifting later probe-chain members back \
+     * @param m Pointer to the map \
+     * @param slot The slot to empty \
+     * @note Backward shifting leaves no tombstones, so lookups stay short \
+     */ \
+    static inline void _indexmap_##K##_##V##_erase_slot(IndexMap_##K##_##V *m, size_t slot) { \
+        size_t mask = m->index_cap - 1; \
+        size_t hole = slot; \
+        \
+        for (size_t j = (hole + 1) & mask; m->indices[j] != _CYAN_INDEXMAP_EMPTY; j = (j + 1) & mask) { \
+            size_t home = m->entries.data[m->indices[j]].hash & mask; \
+            /* Move j into the hole unless its home lies cyclically in (hole, j] */ \
+            bool stays = hole <= j ? (hole < home && home <= j) : (hole < home || home <= j); \
+            if (!stays) { \
+                m->indices[hole] = m->indices[j]; \
+                hole = j; \
+            } \
+        } \
+        m->indices[hole] = _CYAN_INDEXMAP_EMPTY; \
+    } \
+    \
+    /** \
+     * @brief Remove the entry at a position, moving the last entry into its place \
+     * @param m Pointer to the map \
+     * @param index Position in insertion order \
+     * @return Option_V containing the removed value, or None if index >= len \
+     */ \
+    static inline Option_##V indexmap_##K##_##V##_swap_remove_index( \
+        IndexMap_##K##_##V *m, size_t index \
+    ) { \
+        if (index >= m->entries.len) return None(V); \
+        \
+        size_t mask = m->index_cap - 1; \
+        IndexMapEntry_##K##_##V *data = m->entries.data; \
+        \
+        /* Find and free the removed entry's slot */ \
+        size_t slot = data[index].hash & mask; \
+        while (m->indices[slot] != (uint32_t)index) slot = (slot + 1) & mask; \
+        _indexmap_##K##_##V##_erase_slot(m, slot); \
+        \
+        V value = data[index].value; \
+        size_t last = m->entries.len - 1; \
+        if (index != last) { \
+            /* Point the last entry's slot at its new position */ \
+            slot = data[last].hash & mask; \
+            while (m->indices[slot] != (uint32_t)last) slot = (slot + 1) & mask; \
+            m->indices[slot] = (uint32_t)index; \
+            data[index] = data[last]; \
+        } \
+        m->entries.len = last; \
+        \
+        return Some(V, value); \
+    } \
+    \
+    /** \
+     * @brief Remove a key, moving the last entry into its place \
+     * @param m Pointer to the map \
+     * @param key The key \
+     * @return Option_V containing the removed value, or None if not found \
+     * @note O(1); the moved entry is the only one whose position changes \
+     */ \
+    static inline Option_##V indexmap_##K##_##V##_swap_remove(IndexMap_##K##_##V *m, K key) { \
+        size_t pos; \
+        if (!indexmap_##K##_##V##_index_of(m, key, &pos)) return None(V); \
+        \
+        return indexmap_##K##_##V##_swap_remove_index(m, pos); \
+    } \
+    \
+    /** \
+     * @brief View all entries in insertion order \
+     * @param m Pointer to the map \
+     * @return Slice over the entries \
+     * @note The slice becomes invalid if the map is modified or freed \
+     */ \
+    static inline Slice_IndexMapEntry_##K##_##V indexmap_##K##_##V##_entries( \
+        const IndexMap_##K##_##V *m \
+    ) { \
+        return slice_IndexMapEntry_##K##_##V##_from_vec(&m->entries); \
+    } \
+    \
+    /** \
+     * @brief Get the number of entries \
+     * @param m Pointer to the map \
+     * @return Number of key-value pairs \
+     */ \
+    static inline size_t indexmap_##K##_##V##_len(IndexMap_##K##_##V *m) { \
+        return m->entries.len; \
+    } \
+    \
+    /** \
+     * @brief Remove all entries, keeping the allocated storage \
+     * @param m Pointer to the map \
+     */ \
+    static inline void indexmap_##K##_##V##_clear(IndexMap_##K##_##V *m) { \
+        m->entries.len = 0; \
+        if (m->indices) memset(m->indices, 0xFF, m->index_cap * sizeof(uint32_t)); \
+    } \
+    \
+    /** \
+     * @brief Free all memory associated with the map \
+     * @param m Pointer to the map \
+     * @note After calling, the map is empty and can be reused \
+     */ \
+    static inline void indexmap_##K##_##V##_free(IndexMap_##K##_##V *m) { \
+        vec_IndexMapEntry_##K##_##V##_free(&m->entries); \
+        free(m->indices); \
+        m->indices = NULL; \
+        m->index_cap = 0; \
+    } \
+    \
+    /* Static const vtable instance */ \
+    static const IndexMapVT_##K##_##V _indexmap_##K##_##V##_vt = { \
+        .insert = indexmap_##K##_##V##_insert, \
+        .get = indexmap_##K##_##V##_get, \
+        .contains = indexmap_##K##_##V##_contains, \
+        .remove = indexmap_##K##_##V##_swap_remove, \
+        .len = indexmap_##K##_##V##_len, \
+        .free = indexmap_##K##_##V##_free \
+    }
+
+/**
+ * @brief Generate an IndexMap type for given key and value types
+ * @param K The key type
+ * @param V The value type
+ *
+ * Creates:
+ * - IndexMapEntry_K_V: entry struct {key, value, hash}
+ * - Option_/Vec_/Slice_IndexMapEntry_K_V for the entry type
+ * - IndexMapVT_K_V: vtable with the same layout as HashMapVT_K_V, so the
+ *   MAP_* convenience macros work on IndexMap_K_V too
+ * - IndexMap_K_V: the map structure
+ * - indexmap_K_V_new(), indexmap_K_V_with_capacity()
+ * - indexmap_K_V_insert(), indexmap_K_V_get(), indexmap_K_V_get_ptr()
+ * - indexmap_K_V_contains(), indexmap_K_V_index_of(), indexmap_K_V_get_index()
+ * - indexmap_K_V_swap_remove(), indexmap_K_V_swap_remove_index()
+ * - indexmap_K_V_entries(), indexmap_K_V_len(), indexmap_K_V_clear()
+ * - indexmap_K_V_free()
+ *
+ * Keys are hashed like HashMap keys, through seeded_hash_fn under the
+ * map's random seed unless hash_fn is assigned.
+ *
+ * Requires: OPTION_DEFINE(V) must be called before INDEXMAP_DEFINE(K, V)
+ */
+#define INDEXMAP_DEFINE(K, V) \
+    _INDEXMAP_DEFINE_TYPES(K, V); \
+    \
+    /* Hash a key through the map's hash function pointers */ \
+    static inline size_t _indexmap_##K##_##V##_hash(const IndexMap_##K##_##V *m, K key) { \
+        return m->hash_fn ? m->hash_fn(&key, sizeof(K)) \
+                          : m->seeded_hash_fn(&key, sizeof(K), m->seed); \
+    } \
+    \
+    /* Compare two keys through the map's equality function pointer */ \
+    static inline bool _indexmap_##K##_##V##_eq(const IndexMap_##K##_##V *m, K a, K b) { \
+        return m->equal_fn(&a, &b, sizeof(K)); \
+    } \
+    \
+    _INDEXMAP_DEFINE_OPS(K, V); \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef IndexMap_##K##_##V IndexMap_##K##_##V##_defined
+
+/**
+ * @brief Generate an IndexMap type with compile-time hash and equality
+ * @param K The key type
+ * @param V The value type
+ * @param hash_expr Function or function-like macro called as hash_expr(key)
+ * @param eq_expr Function or function-like macro called as eq_expr(a, b)
+ *
+ * Same API as INDEXMAP_DEFINE; see HASHMAP_DEFINE_WITH for details.
+ *
+ * Requires: OPTION_DEFINE(V) must be called before INDEXMAP_DEFINE_WITH(K, V, ...)
+ */
+#define INDEXMAP_DEFINE_WITH(K, V, hash_expr, eq_expr) \
+    _INDEXMAP_DEFINE_TYPES(K, V); \
+    \
+    /* Hash a key with the compile-time hash expression */ \
+    static inline size_t _indexmap_##K##_##V##_hash(const IndexMap_##K##_##V *m, K key) { \
+        (void)m; \
+        return (size_t)(hash_expr(key)); \
+    } \
+    \
+    /* Compare two keys with the compile-time equality expression */ \
+    static inline bool _indexmap_##K##_##V##_eq(const IndexMap_##K##_##V *m, K a, K b) { \
+        (void)m; \
+        return (eq_expr(a, b)); \
+    } \
+    \
+    _INDEXMAP_DEFINE_OPS(K, V); \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef IndexMap_##K##_##V IndexMap_##K##_##V##_defined
+
+/**
+ * @brief Generate an IndexMap type for integer, enum or pointer keys
+ * @param K The key type
+ * @param V The value type
+ *
+ * Shorthand for INDEXMAP_DEFINE_WITH(K, V, CYAN_HASH_SCALAR, CYAN_EQ_SCALAR).
+ */
+#define INDEXMAP_DEFINE_SCALAR(K, V) \
+    INDEXMAP_DEFINE_WITH(K, V, CYAN_HASH_SCALAR, CYAN_EQ_SCALAR)
+
+#endif /* CYAN_INDEXMAP_H */
@@ -0,0 +1,468 @@
+/**
+ * @file intern.h
+ * @brief Thread-safe string interning with pointer-equality atoms
+ *
+ * An interner stores one copy of each distinct byte string and hands out
+ * an Atom, a stable pointer to that copy. Two atoms from the same interner
+ * are equal exactly when their strings are, so comparing them is a single
+ * pointer comparison, and every atom carries the hash of its bytes:
+ * - atom_eq is O(1); atom_hash reads the precomputed hash
+ * - ATOM_HASHMAP_DEFINE(V) makes a HashMap keyed by atoms that neither
+ *   rehashes nor compares bytes
+ * - Looking up an already interned string takes no lock: readers probe a
+ *   published table with acquire loads, and only threads adding a new
+ *   string serialize on a mutex
+ *
+ * Usage:
+ *   Atom get = atom_intern("GET");               // Process-wide interner
+ *   Atom method = atom_intern_slice(token);      // Same atom for "GET" bytes
+ *   if (atom_eq(method, get)) { ... }
+ *
+ *   ATOM_HASHMAP_DEFINE(int);                    // HashMap_Atom_int
+ *   HashMap_Atom_int counts = hashmap_Atom_int_new();
+ *   hashmap_Atom_int_insert(&counts, get, 1);
+ *
+ * Atoms and their bytes stay valid until their interner is freed; atoms
+ * of the process-wide interner live for the whole process.
+ *
+ * Requires POSIX threads (compile with -std=gnu11 or define _POSIX_C_SOURCE
+ * and link with -lpthread).
+ */
+
+#ifndef CYAN_INTERN_H
+#define CYAN_INTERN_H
+
+#include "common.h"
+#include "option.h"
+#include "slice.h"
+#include "hash.h"
+#include "strmap.h"
+#include <pthread.h>
+#include <string.h>
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+/**
+ * @brief Initial slot count of an interner's table (must be a power of 2)
+ */
+#ifndef CYAN_INTERN_INITIAL_CAPACITY
+#define CYAN_INTERN_INITIAL_CAPACITY 256
+#endif
+
+/*============================================================================
+ * Atoms
+ *============================================================================*/
+
+/**
+ * @brief Interned string record, stored once in the interner's arena
+ */
+typedef struct _CyanAtomRec {
+    size_t hash;     /* Seeded wyhash of the bytes */
+    size_t len;      /* Length excluding null terminator */
+    char str[];      /* Null-terminated bytes */
+} _CyanAtomRec;
+
+/**
+ * @brief Handle to an interned string; equal strings share one handle
+ */
+typedef const _CyanAtomRec *Atom;
+
+/* Define Option_Atom for lookups that do not intern */
+OPTION_DEFINE(Atom);
+
+/**
+ * @brief Get the null-terminated bytes of an atom
+ * @param a The atom
+ * @return Pointer valid for the life of the interner
+ */
+static inline const char *atom_cstr(Atom a) {
+    return a->str;
+}
+
+/**
+ * @brief Get the length of an atom's string
+ * @param a The atom
+ * @return Number of bytes (excluding null terminator)
+ */
+static inline size_t atom_len(Atom a) {
+    return a->len;
+}
+
+/**
+ * @brief Get the precomputed hash of an atom's string
+ * @param a The atom
+ * @return Hash computed once when the string was interned
+ */
+static inline size_t atom_hash(Atom a) {
+    return a->hash;
+}
+
+/**
+ * @brief View an atom's bytes as a slice
+ * @param a The atom
+ * @return Slice_char over the atom's bytes
+ */
+static inline Slice_char atom_slice(Atom a) {
+    return (Slice_char){ .data = a->str, .len = a->len, .vt = &_slice_char_vt };
+}
+
+/**
+ * @brief Compare two atoms of the same interner
+ * @param a First atom
+ * @param b Second atom
+ * @return true if both name the same string
+ */
+static inline bool atom_eq(Atom a, Atom b) {
+    return a == b;
+}
+
+/**
+ * @brief Hash an atom key by its precomputed hash (for HASHMAP_DEFINE_WITH)
+ */
+#define CYAN_HASH_ATOM(k) ((k)->hash)
+
+/**
+ * @brief Compare atom keys by identity (for HASHMAP_DEFINE_WITH)
+ */
+#define CYAN_EQ_ATOM(a, b) ((a) == (b))
+
+/**
+ * @brief Generate a HashMap keyed by atoms
+ * @param V The value type
+ *
+ * Shorthand for HASHMAP_DEFINE_WITH(Atom, V, CYAN_HASH_ATOM, CYAN_EQ_ATOM),
+ * creating HashMap_Atom_V and the hashmap_Atom_V_* functions. All keys of
+ * one map must come from the same interner.
+ *
+ * Requires: OPTION_DEFINE(V) must be called before ATOM_HASHMAP_DEFINE(V)
+ */
+#define ATOM_HASHMAP_DEFINE(V) \
+    HASHMAP_DEFINE_WITH(Atom, V, CYAN_HASH_ATOM, CYAN_EQ_ATOM)
+
+/*============================================================================
+ * Interner
+ *============================================================================*/
+
+/**
+ * @brief Open-addressed table of atom pointers
+ *
+ * Slots are written once, from NULL to an atom, with release stores, so
+ * readers can probe without a lock. A full table is replaced rather than
+ * resized in place; replaced tables stay allocated (on the retired list)
+ * until the interner is freed because readers may still be probing them.
+ */
+typedef struct _CyanInternTable {
+    struct _CyanInternTable *retired;  /* Next older replaced table */
+    size_t cap;                        /* Slot count, a power of 2 */
+    Atom slots[];
+} _CyanInternTable;
+
+/**
+ * @brief Shared state of an interner
+ */
+typedef struct {
+    _CyanInternTable *table;   /* Current table; loaded with acquire */
+    _CyanInternTable *retired; /* Replaced tables, newest first */
+    size_t len;                /* Distinct strings interned */
+    uint64_t seed;             /* Hash seed for every atom */
+    _CyanArena arena;          /* Atom records */
+    pthread_mutex_t lock;      /* Serializes writers */
+} _CyanInternState;
+
+/* Forward declare Interner for use in vtable */
+typedef struct Interner Interner;
+
+/**
+ * @brief Vtable structure for Interner containing function pointers
+ */
+typedef struct {
+    Atom (*intern)(Interner *in, const char *cstr);
+    Option_Atom (*lookup)(const Interner *in, const char *cstr);
+    size_t (*len)(const Interner *in);
+    void (*free)(Interner *in);
+} InternerVT;
+
+/**
+ * @brief Thread-safe string interner
+ *
+ * A handle to heap-allocated state; copies of the handle share it. Any
+ * thread may intern or look up concurrently. Free only after every other
+ * thread is done with it.
+ */
+struct Interner {
+    _CyanInternState *state;
+    const InternerVT *vt;
+};
+
+/* Forward declare vtable instance */
+static const InternerVT _interner_vt;
+
+/**
+ * @brief Allocate an empty table
+ * @param cap Slot count, a power of 2
+ * @return Table with every slot NULL
+ * @note Panics if allocation fails
+ */
+static inline _CyanInternTable *_cyan_intern_table_new(size_t cap) {
+    _CyanInternTable *t = (_CyanInternTable *)calloc(1, sizeof(_CyanInternTable) + cap * sizeof(Atom));
+    if (!t) CYAN_PANIC("allocation failed");
+    t->cap = cap;
+    return t;
+}
+
+/**
+ * @brief Create an interner sized for an expected number of strings
+ * @param capacity Expected distinct strings (0 selects the default)
+ * @return A new empty Interner
+ * @note Panics if allocation fails
+ */
+static inline Interner interner_with_capacity(size_t capacity) {
+    _CyanInternState *s = (_CyanInternState *)calloc(1, sizeof(_CyanInternState));
+    if (!s) CYAN_PANIC("allocation failed");
+    size_t cap = CYAN_INTERN_INITIAL_CAPACITY;
+    while (cap < capacity * 2) cap *= 2;   /* Keep the table at most half full */
+    s->table = _cyan_intern_table_new(cap);
+    s->seed = cyan_hash_process_seed();
+    if (pthread_mutex_init(&s->lock, NULL) != 0) CYAN_PANIC("mutex init failed");
+    return (Interner){ .state = s, .vt = &_interner_vt };
+}
+
+/**
+ * @brief Create an empty interner
+ * @return A new empty Interner
+ */
+static inline Interner interner_new(void) {
+    return interner_with_capacity(0);
+}
+
+/**
+ * @brief Probe a table for a string without locking
+ * @return The atom, or NULL if the table does not hold the string
+ */
+static inline Atom _cyan_intern_probe(const _CyanInternTable *t, const char *p, size_t len, size_t hash) {
+    size_t mask = t->cap - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        Atom a = __atomic_load_n(&t->slots[i], __ATOMIC_ACQUIRE);
+        if (!a) return NULL;
+        if (a->hash == hash && a->len == len && (len == 0 || memcmp(a->str, p, len) == 0)) return a;
+    }
+}
+
+/**
+ * @brief Store an atom in the first free slot of its probe sequence
+ */
+static inline void _cyan_intern_place(_CyanInternTable *t, Atom a) {
+    size_t mask = t->cap - 1;
+    size_t i = a->hash & mask;
+    while (t->slots[i]) i = (i + 1) & mask;
+    __atomic_store_n(&t->slots[i], a, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Intern a byte range
+ * @param in Pointer to the interner
+ * @param p Bytes of the string
+ * @param len Number of bytes
+ * @return The atom for the string, created on first use
+ * @note Lock-free when the string is already interned
+ * @note Panics if allocation fails
+ */
+static inline Atom interner_intern_bytes(Interner *in, const char *p, size_t len) {
+    _CyanInternState *s = in->state;
+    size_t hash = cyan_hash_wy_seeded(p, len, s->seed);
+    Atom a = _cyan_intern_probe(__atomic_load_n(&s->table, __ATOMIC_ACQUIRE), p, len, hash);
+    if (a) return a;
+
+    pthread_mutex_lock(&s->lock);
+    _CyanInternTable *t = s->table;
+    a = _cyan_intern_probe(t, p, len, hash);   /* Another writer may have won */
+    if (!a) {
+        /* Records are padded to keep every record in the arena aligned */
+        size_t size = (sizeof(_CyanAtomRec) + len + 1 + 7) & ~(size_t)7;
+        _CyanAtomRec *r = (_CyanAtomRec *)_cyan_arena_alloc(&s->arena, size);
+        r->hash = hash;
+        r->len = len;
+        if (len > 0) memcpy(r->str, p, len);
+        r->str[len] = '\0';
+
+        if ((s->len + 1) * 2 > t->cap) {
+            /* Fill a larger table privately, then publish it */
+            _CyanInternTable *nt = _cyan_intern_table_new(t->cap * 2);
+            for (size_t i = 0; i < t->cap; i++) {
+                if (t->slots[i]) _cyan_intern_place(nt, t->slots[i]);
+            }
+            t->retired = s->retired;
+            s->retired = t;
+            __atomic_store_n(&s->table, nt, __ATOMIC_RELEASE);
+            t = nt;
+        }
+        _cyan_intern_place(t, r);
+        __atomic_store_n(&s->len, s->len + 1, __ATOMIC_RELAXED);
+        a = r;
+    }
+    pthread_mutex_unlock(&s->lock);
+    return a;
+}
+
+/**
+ * @brief Intern a C string
+ * @param in Pointer to the interner
+ * @param cstr Null-terminated string
+ * @return The atom for the string
+ */
+static inline Atom interner_intern(Interner *in, const char *cstr) {
+    return interner_intern_bytes(in, cstr, strlen(cstr));
+}
+
+/**
+ * @brief Intern the bytes viewed by a slice
+ * @param in Pointer to the interner
+ * @param s Bytes of the string (need not be null-terminated)
+ * @return The atom for the string
+ */
+static inline Atom interner_intern_slice(Interner *in, Slice_char s) {
+    return interner_intern_bytes(in, s.data, s.len);
+}
+
+/**
+ * @brief Find the atom of a byte range without interning it
+ * @param in Pointer to the interner
+ * @param p Bytes of the string
+ * @param len Number of bytes
+ * @return Some(atom) if the string was interned, None otherwise
+ * @note Never takes a lock
+ */
+static inline Option_Atom interner_lookup_bytes(const Interner *in, const char *p, size_t len) {
+    const _CyanInternState *s = in->state;
+    size_t hash = cyan_hash_wy_seeded(p, len, s->seed);
+    Atom a = _cyan_intern_probe(__atomic_load_n(&s->table, __ATOMIC_ACQUIRE), p, len, hash);
+    return a ? Some(Atom, a) : None(Atom);
+}
+
+/**
+ * @brief Find the atom of a C string without interning it
+ * @param in Pointer to the interner
+ * @param cstr Null-terminated string
+ * @return Some(atom) if the string was interned, None otherwise
+ */
+static inline Option_Atom interner_lookup(const Interner *in, const char *cstr) {
+    return interner_lookup_bytes(in, cstr, strlen(cstr));
+}
+
+/**
+ * @brief Find the atom of a slice's bytes without interning them
+ * @param in Pointer to the interner
+ * @param s Bytes of the string
+ * @return Some(atom) if the string was interned, None otherwise
+ */
+static inline Option_Atom interner_lookup_slice(const Interner *in, Slice_char s) {
+    return interner_lookup_bytes(in, s.data, s.len);
+}
+
+/**
+ * @brief Get the number of distinct strings interned
+ * @param in Pointer to the interner
+ * @return Atom count
+ */
+static inline size_t interner_len(const Interner *in) {
+    return __atomic_load_n(&in->state->len, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Free the interner, its tables and every atom
+ * @param in Pointer to the interner
+ * @note Atoms from this interner must not be used afterwards
+ */
+static inline void interner_free(Interner *in) {
+    _CyanInternState *s = in->state;
+    if (!s) return;
+    free(s->table);
+    _CyanInternTable *t = s->retired;
+    while (t) {
+        _CyanInternTable *next = t->retired;
+        free(t);
+        t = next;
+    }
+    _cyan_arena_free(&s->arena);
+    pthread_mutex_destroy(&s->lock);
+    free(s);
+    in->state = NULL;
+}
+
+/**
+ * @brief Static const vtable instance shared by all Interner instances
+ */
+static const InternerVT _interner_vt = {
+    .intern = interner_intern,
+    .lookup = interner_lookup,
+    .len = interner_len,
+    .free = interner_free
+};
+
+/*============================================================================
+ * Process-Wide Interner
+ *============================================================================*/
+
+/* Process-wide interner state shared by every translation unit; NULL until first use */
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((weak)) _CyanInternState *_cyan_intern_global_state;
+#else
+static _CyanInternState *_cyan_intern_global_state;  /* One per translation unit */
+#endif
+
+/**
+ * @brief Get the process-wide interner
+ * @return Handle to an interner created on first use and never freed
+ *
+ * Every translation unit shares the same interner, so atoms from
+ * atom_intern compare equal across the program. Compilers without weak
+ * symbols get one interner per translation unit instead.
+ */
+static inline Interner cyan_interner_global(void) {
+    _CyanInternState *s = __atomic_load_n(&_cyan_intern_global_state, __ATOMIC_ACQUIRE);
+    if (!s) {
+        Interner fresh = interner_new();
+        /* The first thread to publish wins; losers free theirs */
+        if (__atomic_compare_exchange_n(&_cyan_intern_global_state, &s, fresh.state, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            s = fresh.state;
+        } else {
+            interner_free(&fresh);
+        }
+    }
+    return (Interner){ .state = s, .vt = &_interner_vt };
+}
+
+/**
+ * @brief Intern a C string in the process-wide interner
+ * @param cstr Null-terminated string
+ * @return The atom for the string, valid for the life of the process
+ */
+static inline Atom atom_intern(const char *cstr) {
+    Interner in = cyan_interner_global();
+    return interner_intern(&in, cstr);
+}
+
+/**
+ * @brief Intern a slice's bytes in the process-wide interner
+ * @param s Bytes of the string
+ * @return The atom for the string, valid for the life of the process
+ */
+static inline Atom atom_intern_slice(Slice_char s) {
+    Interner in = cyan_interner_global();
+    return interner_intern_slice(&in, s);
+}
+
+/**
+ * @brief Find a C string in the process-wide interner without interning it
+ * @param cstr Null-terminated string
+ * @return Some(atom) if the string was interned, None otherwise
+ */
+static inline Option_Atom atom_lookup(const char *cstr) {
+    Interner in = cyan_interner_global();
+    return interner_lookup(&in, cstr);
+}
+
+#endif /* CYAN_INTERN_H */
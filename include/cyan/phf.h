@@ -0,0 +1,556 @@
+/**
+ * @file phf.h
+ * @brief Static perfect-hash maps for the Cyan library
+ *
+ * This header freezes a fixed key set into a minimal perfect hash table:
+ * n keys in exactly n slots, each key at a slot of its own. Lookup is one
+ * hash, one read of the key's bucket displacement, one read of the slot
+ * and one key compare; there is no probing and no empty slot to skip.
+ * This suits tables that are built once and only read (keywords, opcode
+ * names, configuration schemas, country codes).
+ *
+ * Construction follows hash-and-displace (CHD): keys are grouped into
+ * n / CYAN_PHF_LAMBDA buckets by one part of their hash, and buckets are
+ * placed largest first, each searching for a displacement pair that moves
+ * all of its keys into free slots. Single-key buckets, which make up the
+ * tail, are placed directly into the remaining slots.
+ *
+ * Usage:
+ *   OPTION_DEFINE(int);
+ *   PHF_DEFINE(u32, int);                 // Define Phf_u32_int type
+ *
+ *   u32 keys[] = { 7, 42, 1000 };
+ *   int values[] = { 1, 2, 3 };
+ *   Result_Phf_u32_int_PhfError r = phf_u32_int_build(keys, values, 3);
+ *   Phf_u32_int p = unwrap_ok(r);
+ *   Option_int v = phf_u32_int_get(&p, 42);   // Some(2)
+ *   phf_u32_int_free(&p);
+ *
+ * PHF_FROM_HASHMAP_DEFINE(K, V) adds phf_K_V_from_hashmap, which freezes
+ * the current contents of a HashMap_K_V.
+ *
+ * phf_K_V_emit writes a built table as C source: static const arrays and a
+ * Phf_K_V initializer that reference each other, so a generated file
+ * compiled after PHF_DEFINE(K, V) gives a ready table with no startup
+ * work and no allocation. Builds are deterministic, so regenerating the
+ * same keys yields the same file.
+ */
+
+#ifndef CYAN_PHF_H
+#define CYAN_PHF_H
+
+#include "common.h"
+#include "option.h"
+#include "result.h"
+#include "hash.h"
+#include "hashmap.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+/**
+ * @brief Average keys per bucket
+ *
+ * Larger values shrink the displacement array (8 bytes per bucket) at the
+ * cost of a longer build.
+ */
+#ifndef CYAN_PHF_LAMBDA
+#define CYAN_PHF_LAMBDA 4
+#endif
+
+/** @brief Displacement pairs tried per bucket before the build restarts with a new seed */
+#ifndef CYAN_PHF_MAX_TRIES
+#define CYAN_PHF_MAX_TRIES (1u << 20)
+#endif
+
+/** @brief Seeds tried before the build gives up */
+#ifndef CYAN_PHF_MAX_ATTEMPTS
+#define CYAN_PHF_MAX_ATTEMPTS 16
+#endif
+
+/*============================================================================
+ * Hash and Displace
+ *============================================================================*/
+
+/* Step applied per unit of the second displacement (odd), and its inverse mod 2^32 */
+#define _CYAN_PHF_STEP 0x9E3779B9u
+#define _CYAN_PHF_STEP_INV 0x144CBC89u
+
+/* Slot owner marker for a free slot */
+#define _CYAN_PHF_FREE UINT32_MAX
+
+/** @brief Error type for PHF builds: a static message */
+typedef const char *PhfError;
+
+/* Outcome of one placement attempt */
+typedef enum {
+    _CYAN_PHF_PLACED,       /* Every key has a slot */
+    _CYAN_PHF_RETRY,        /* A bucket found no displacement; try another seed */
+    _CYAN_PHF_SAME_HASH     /* Two keys share a 64-bit hash; equal keys or a real collision */
+} _CyanPhfStatus;
+
+/* Map a 32-bit value onto [0, n) by multiply-shift */
+static inline uint32_t _cyan_phf_reduce(uint32_t x, size_t n) {
+    return (uint32_t)(((uint64_t)x * (uint64_t)n) >> 32);
+}
+
+/* Bucket of a key hash: its high half */
+static inline uint32_t _cyan_phf_bucket(uint64_t h, size_t buckets) {
+    return _cyan_phf_reduce((uint32_t)(h >> 32), buckets);
+}
+
+/* Slot of a key hash under displacement (d1, d2): f1 + d1 * f2 + d2 * step */
+static inline uint32_t _cyan_phf_slot(uint64_t h, uint32_t d1, uint32_t d2, size_t n) {
+    uint32_t f1 = (uint32_t)h;
+    uint32_t f2 = (uint32_t)((h * 0x9E3779B97F4A7C15ull) >> 32);
+    return _cyan_phf_reduce(f1 + d1 * f2 + d2 * _CYAN_PHF_STEP, n);
+}
+
+/* calloc that panics on failure */
+static inline void *_cyan_phf_alloc(size_t count, size_t size) {
+    void *p = calloc(count ? count : 1, size);
+    if (!p) CYAN_PANIC("allocation failed");
+    return p;
+}
+
+/**
+ * @brief Find displacements that give every hash its own slot
+ * @param hashes Key hashes under the current seed
+ * @param n Number of keys (and slots), 1 to UINT32_MAX - 1
+ * @param buckets Number of buckets
+ * @param disps Output: two displacements per bucket
+ * @param owner Output: index into hashes of the key in each slot
+ * @param dup_a, dup_b Output on _CYAN_PHF_SAME_HASH: the two keys sharing a hash
+ * @return The outcome of the attempt
+ */
+static inline _CyanPhfStatus _cyan_phf_place(
+    const uint64_t *hashes, size_t n, size_t buckets,
+    uint32_t *disps, uint32_t *owner, size_t *dup_a, size_t *dup_b
+) {
+    /* Group keys by bucket (counting sort) */
+    uint32_t *start = (uint32_t *)_cyan_phf_alloc(buckets + 1, sizeof(uint32_t));
+    uint32_t *members = (uint32_t *)_cyan_phf_alloc(n, sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++) start[_cyan_phf_bucket(hashes[i], buckets) + 1]++;
+    uint32_t max_size = 0;
+    for (size_t b = 0; b < buckets; b++) {
+        if (start[b + 1] > max_size) max_size = start[b + 1];
+        start[b + 1] += start[b];
+    }
+    uint32_t *fill = (uint32_t *)_cyan_phf_alloc(buckets, sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++) {
+        uint32_t b = _cyan_phf_bucket(hashes[i], buckets);
+        members[start[b] + fill[b]++] = (uint32_t)i;
+    }
+
+    /* Order buckets largest first (counting sort on size) */
+    uint32_t *by_size = (uint32_t *)_cyan_phf_alloc((size_t)max_size + 2, sizeof(uint32_t));
+    for (size_t b = 0; b < buckets; b++) by_size[max_size - (start[b + 1] - start[b]) + 1]++;
+    for (uint32_t s = 0; s <= max_size; s++) by_size[s + 1] += by_size[s];
+    uint32_t *order = fill;     /* fill is no longer needed */
+    for (size_t b = 0; b < buckets; b++) {
+        order[by_size[max_size - (start[b + 1] - start[b])]++] = (uint32_t)b;
+    }
+    free(by_size);
+
+    for (size_t i = 0; i < n; i++) owner[i] = _CYAN_PHF_FREE;
+    memset(disps, 0, 2 * buckets * sizeof(uint32_t));
+
+    /* Per-try marks, so a bucket's keys cannot claim the same slot twice */
+    uint32_t *stamp = (uint32_t *)_cyan_phf_alloc(n, sizeof(uint32_t));
+    uint32_t gen = 0;
+    size_t next_free = 0;
+    _CyanPhfStatus status = _CYAN_PHF_PLACED;
+
+    for (size_t k = 0; k < buckets && status == _CYAN_PHF_PLACED; k++) {
+        uint32_t b = order[k];
+        const uint32_t *mem = members + start[b];
+        uint32_t size = start[b + 1] - start[b];
+        if (size == 0) break;   /* Only empty buckets remain */
+
+        if (size == 1) {
+            /* Solve for d2 (with d1 = 0) that lands the key on the next free slot */
+            while (owner[next_free] != _CYAN_PHF_FREE) next_free++;
+            uint32_t x = (uint32_t)((((uint64_t)next_free << 32) + n - 1) / n);
+            disps[2 * b + 1] = (x - (uint32_t)hashes[mem[0]]) * _CYAN_PHF_STEP_INV;
+            owner[next_free] = mem[0];
+            continue;
+        }
+
+        for (uint32_t i = 1; i < size; i++) {
+            for (uint32_t j = 0; j < i; j++) {
+                if (hashes[mem[i]] == hashes[mem[j]]) {
+                    *dup_a = mem[j];
+                    *dup_b = mem[i];
+                    status = _CYAN_PHF_SAME_HASH;
+                }
+            }
+        }
+        if (status != _CYAN_PHF_PLACED) break;
+
+        /* d2 shifts the whole bucket; d1 changes the spacing between its keys */
+        bool found = false;
+        uint32_t tries = 0;
+        for (uint32_t d1 = 0; !found && tries < CYAN_PHF_MAX_TRIES; d1++) {
+            for (uint32_t d2 = 0; !found && d2 < 256 && tries < CYAN_PHF_MAX_TRIES; d2++, tries++) {
+                if (++gen == 0) {
+                    memset(stamp, 0, n * sizeof(uint32_t));
+                    gen = 1;
+                }
+                uint32_t i = 0;
+                for (; i < size; i++) {
+                    uint32_t slot = _cyan_phf_slot(hashes[mem[i]], d1, d2, n);
+                    if (owner[slot] != _CYAN_PHF_FREE || stamp[slot] == gen) break;
+                    stamp[slot] = gen;
+                }
+                if (i < size) continue;
+                for (i = 0; i < size; i++) owner[_cyan_phf_slot(hashes[mem[i]], d1, d2, n)] = mem[i];
+                disps[2 * b] = d1;
+                disps[2 * b + 1] = d2;
+                found = true;
+            }
+        }
+        if (!found) status = _CYAN_PHF_RETRY;
+    }
+
+    free(stamp);
+    free(order);
+    free(members);
+    free(start);
+    return status;
+}
+
+/**
+ * @brief Write a C string literal for s, escaping as needed
+ * @param out Destination stream
+ * @param s String to write (NULL writes NULL)
+ *
+ * A ready-made key or value writer for phf_K_V_emit on string tables.
+ */
+static inline void cyan_phf_emit_cstr(FILE *out, const char *s) {
+    if (!s) {
+        fputs("NULL", out);
+        return;
+    }
+    fputc('"', out);
+    for (const unsigned char *p = (const unsigned char *)s; *p; p++) {
+        if (*p == '"' || *p == '\\') fprintf(out, "\\%c", *p);
+        else if (*p >= 0x20 && *p < 0x7F) fputc(*p, out);
+        else fprintf(out, "\\%03o", *p);    /* Octal escapes never swallow a following digit past 3 */
+    }
+    fputc('"', out);
+}
+
+/*============================================================================
+ * PHF Type Definition Macro
+ *============================================================================*/
+
+/**
+ * @brief Internal: generate the PHF type and functions (do not use directly)
+ * @param K The key type
+ * @param V The value type
+ *
+ * Expects _phf_K_V_hash(key, seed) and _phf_K_V_eq(a, b) to be defined
+ * by the caller.
+ */
+#define _PHF_DEFINE_OPS(K, V) \
+    /** \
+     * @brief Key and value, stored at the key's perfect-hash slot \
+     */ \
+    typedef struct { \
+        K key; \
+        V value; \
+    } PhfEntry_##K##_##V; \
+    \
+    /* Forward declare Phf_K_V for use in vtable */ \
+    typedef struct Phf_##K##_##V Phf_##K##_##V; \
+    \
+    /** \
+     * @brief Vtable structure for Phf_K_V: the read side of HashMapVT_K_V \
+     */ \
+    typedef struct { \
+        Option_##V (*get)(const Phf_##K##_##V *p, K key); \
+        bool (*contains)(const Phf_##K##_##V *p, K key); \
+        size_t (*len)(const Phf_##K##_##V *p); \
+        void (*free)(Phf_##K##_##V *p); \
+    } PhfVT_##K##_##V; \
+    \
+    /** \
+     * @brief Frozen perfect-hash table \
+     * \
+     * The arrays are const: a table is either built (owned, released by \
+     * free) or points at static data written by phf_K_V_emit. \
+     */ \
+    struct Phf_##K##_##V { \
+        const PhfEntry_##K##_##V *entries;  /* len entries, one per slot */ \
+        const uint32_t *disps;              /* Two displacements per bucket */ \
+        size_t len; \
+        size_t buckets; \
+        uint64_t seed; \
+        bool owned;                         /* Arrays were allocated by a build */ \
+        const PhfVT_##K##_##V *vt; \
+    }; \
+    \
+    RESULT_DEFINE(Phf_##K##_##V, PhfError); \
+    \
+    /** \
+     * @brief Writer for one key or value as a C initializer expression \
+     */ \
+    typedef void (*PhfEmitKeyFn_##K##_##V)(FILE *out, K key); \
+    typedef void (*PhfEmitValueFn_##K##_##V)(FILE *out, V value); \
+    \
+    /** \
+     * @brief Look up a key \
+     * @param p Pointer to the table \
+     * @param key Key to find \
+     * @return Some(value) if key is in the table, None otherwise \
+     */ \
+    static inline Option_##V phf_##K##_##V##_get(const Phf_##K##_##V *p, K key) { \
+        if (p->len == 0) return None(V); \
+        uint64_t h = _phf_##K##_##V##_hash(key, p->seed); \
+        const uint32_t *d = &p->disps[2 * (size_t)_cyan_phf_bucket(h, p->buckets)]; \
+        const PhfEntry_##K##_##V *e = &p->entries[_cyan_phf_slot(h, d[0], d[1], p->len)]; \
+        if (_phf_##K##_##V##_eq(e->key, key)) return Some(V, e->value); \
+        return None(V); \
+    } \
+    \
+    /** \
+     * @brief Check whether a key is in the table \
+     * @param p Pointer to the table \
+     * @param key Key to find \
+     * @return true if key is in the table \
+     */ \
+    static inline bool phf_##K##_##V##_contains(const Phf_##K##_##V *p, K key) { \
+        return phf_##K##_##V##_get(p, key).has_value; \
+    } \
+    \
+    /** \
+     * @brief Get the number of keys \
+     * @param p Pointer to the table \
+     * @return Number of keys \
+     */ \
+    static inline size_t phf_##K##_##V##_len(const Phf_##K##_##V *p) { \
+        return p->len; \
+    } \
+    \
+    /** \
+     * @brief Free a built table \
+     * @param p Pointer to the table \
+     * @note Does nothing for tables written by phf_K_V_emit \
+     */ \
+    static inline void phf_##K##_##V##_free(Phf_##K##_##V *p) { \
+        if (p->owned) { \
+            free((void *)p->entries); \
+            free((void *)p->disps); \
+        } \
+        p->entries = NULL; \
+        p->disps = NULL; \
+        p->len = 0; \
+        p->buckets = 0; \
+    } \
+    \
+    /* Static vtable instance for Phf_K_V */ \
+    static const PhfVT_##K##_##V _phf_##K##_##V##_vt = { \
+        .get = phf_##K##_##V##_get, \
+        .contains = phf_##K##_##V##_contains, \
+        .len = phf_##K##_##V##_len, \
+        .free = phf_##K##_##V##_free, \
+    }; \
+    \
+    /** \
+     * @brief Build a table from parallel key and value arrays \
+     * @param keys Keys, all distinct \
+     * @param values values[i] is stored for keys[i] \
+     * @param n Number of keys, below UINT32_MAX \
+     * @return Ok with the table, or Err on duplicate keys or when no \
+     *         perfect hash was found \
+     * @note The seeds tried are fixed, so equal inputs give equal tables \
+     */ \
+    static inline Result_Phf_##K##_##V##_PhfError phf_##K##_##V##_build( \
+        const K *keys, const V *values, size_t n \
+    ) { \
+        Phf_##K##_##V p = { NULL, NULL, 0, 0, 0, true, &_phf_##K##_##V##_vt }; \
+        if (n >= _CYAN_PHF_FREE) return Err(Phf_##K##_##V, PhfError, "too many keys"); \
+        if (n == 0) return Ok(Phf_##K##_##V, PhfError, p); \
+        size_t buckets = (n + CYAN_PHF_LAMBDA - 1) / CYAN_PHF_LAMBDA; \
+        uint64_t *hashes = (uint64_t *)_cyan_phf_alloc(n, sizeof(uint64_t)); \
+        uint32_t *owner = (uint32_t *)_cyan_phf_alloc(n, sizeof(uint32_t)); \
+        uint32_t *disps = (uint32_t *)_cyan_phf_alloc(2 * buckets, sizeof(uint32_t)); \
+        PhfError err = "no perfect hash found"; \
+        for (uint64_t attempt = 1; attempt <= CYAN_PHF_MAX_ATTEMPTS; attempt++) { \
+            uint64_t seed = _cyan_hash_u64(attempt * 0x9E3779B97F4A7C15ull); \
+            for (size_t i = 0; i < n; i++) hashes[i] = _phf_##K##_##V##_hash(keys[i], seed); \
+            size_t a = 0, b = 0; \
+            _CyanPhfStatus st = _cyan_phf_place(hashes, n, buckets, disps, owner, &a, &b); \
+            if (st == _CYAN_PHF_SAME_HASH && _phf_##K##_##V##_eq(keys[a], keys[b])) { \
+                err = "duplicate key"; \
+                break; \
+            } \
+            if (st != _CYAN_PHF_PLACED) continue; \
+            PhfEntry_##K##_##V *entries = \
+                (PhfEntry_##K##_##V *)_cyan_phf_alloc(n, sizeof(PhfEntry_##K##_##V)); \
+            for (size_t s = 0; s < n; s++) { \
+                entries[s].key = keys[owner[s]]; \
+                entries[s].value = values[owner[s]]; \
+            } \
+            p.entries = entries; \
+            p.disps = disps; \
+            p.len = n; \
+            p.buckets = buckets; \
+            p.seed = seed; \
+            err = NULL; \
+            break; \
+        } \
+        free(hashes); \
+        free(owner); \
+        if (err) { \
+            free(disps); \
+            return Err(Phf_##K##_##V, PhfError, err); \
+        } \
+        return Ok(Phf_##K##_##V, PhfError, p); \
+    } \
+    \
+    /** \
+     * @brief Write a table as C source \
+     * @param p Pointer to the table \
+     * @param out Destination stream \
+     * @param name Identifier for the generated Phf_K_V; the arrays get \
+     *             name_entries and name_disps \
+     * @param emit_key Writes one key as a C initializer expression \
+     * @param emit_value Writes one value as a C initializer expression \
+     * @return true if everything was written \
+     * \
+     * The output defines static const data only; compile it in a \
+     * translation unit that has PHF_DEFINE(K, V) (with the same hash and \
+     * equality, for the _WITH variant) before it. \
+     */ \
+    static inline bool phf_##K##_##V##_emit( \
+        const Phf_##K##_##V *p, FILE *out, const char *name, \
+        PhfEmitKeyFn_##K##_##V emit_key, PhfEmitValueFn_##K##_##V emit_value \
+    ) { \
+        fprintf(out, "/* Generated by phf_" #K "_" #V "_emit: %zu keys. Do not edit. */\n\n", p->len); \
+        if (p->len > 0) { \
+            fprintf(out, "static const PhfEntry_" #K "_" #V " %s_entries[%zu] = {\n", name, p->len); \
+            for (size_t i = 0; i < p->len; i++) { \
+                fputs("    { ", out); \
+                emit_key(out, p->entries[i].key); \
+                fputs(", ", out); \
+                emit_value(out, p->entries[i].value); \
+                fputs(" },\n", out); \
+            } \
+            fprintf(out, "};\n\nstatic const uint32_t %s_disps[%zu] = {", name, 2 * p->buckets); \
+            for (size_t i = 0; i < 2 * p->buckets; i++) { \
+                fprintf(out, "%s0x%08xu,", i % 6 == 0 ? "\n    " : " ", (unsigned)p->disps[i]); \
+            } \
+            fputs("\n};\n\n", out); \
+        } \
+        fprintf(out, "static const Phf_" #K "_" #V " %s = {\n", name); \
+        if (p->len > 0) { \
+            fprintf(out, "    .entries = %s_entries,\n    .disps = %s_disps,\n", name, name); \
+        } else { \
+            fputs("    .entries = NULL,\n    .disps = NULL,\n", out); \
+        } \
+        fprintf(out, "    .len = %zu,\n    .buckets = %zu,\n", p->len, p->buckets); \
+        fprintf(out, "    .seed = 0x%016llxull,\n", (unsigned long long)p->seed); \
+        fputs("    .owned = false,\n    .vt = &_phf_" #K "_" #V "_vt,\n};\n", out); \
+        return !ferror(out); \
+    }
+
+/**
+ * @brief Generate a perfect-hash table type for keys hashed and compared as raw bytes
+ * @param K The key type (plain old data; padding bytes must be zeroed, as for HashMap)
+ * @param V The value type
+ *
+ * Creates:
+ * - PhfEntry_K_V, Phf_K_V, PhfVT_K_V and Result_Phf_K_V_PhfError
+ * - phf_K_V_build(keys, values, n): Build from arrays
+ * - phf_K_V_get(p, key) / phf_K_V_contains(p, key) / phf_K_V_len(p)
+ * - phf_K_V_emit(p, out, name, emit_key, emit_value): Write as C source
+ * - phf_K_V_free(p): Free a built table
+ *
+ * Requires: OPTION_DEFINE(V)
+ */
+#define PHF_DEFINE(K, V) \
+    /* Seeded wyhash of the key's bytes */ \
+    static inline uint64_t _phf_##K##_##V##_hash(K key, uint64_t seed) { \
+        return _cyan_wyhash(&key, sizeof(K), seed); \
+    } \
+    \
+    static inline bool _phf_##K##_##V##_eq(K a, K b) { \
+        return memcmp(&a, &b, sizeof(K)) == 0; \
+    } \
+    \
+    _PHF_DEFINE_OPS(K, V) \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef Phf_##K##_##V Phf_##K##_##V##_defined
+
+/**
+ * @brief Generate a perfect-hash table type with compile-time hash and equality
+ * @param K The key type
+ * @param V The value type
+ * @param hash_expr Function or function-like macro called as hash_expr(key), yielding the hash
+ * @param eq_expr Function or function-like macro called as eq_expr(a, b), yielding true if equal
+ *
+ * The seed is mixed into hash_expr's result, so keys that hash_expr maps
+ * to the same value cannot be told apart and make the build fail.
+ *
+ * Example (string keys):
+ *   typedef const char *cstr;
+ *   PHF_DEFINE_WITH(cstr, int, CYAN_HASH_CSTR, CYAN_EQ_CSTR);
+ */
+#define PHF_DEFINE_WITH(K, V, hash_expr, eq_expr) \
+    /* Compile-time hash, finalized with the seed */ \
+    static inline uint64_t _phf_##K##_##V##_hash(K key, uint64_t seed) { \
+        return _cyan_hash_u64((uint64_t)(hash_expr(key)) ^ seed); \
+    } \
+    \
+    static inline bool _phf_##K##_##V##_eq(K a, K b) { \
+        return (eq_expr(a, b)); \
+    } \
+    \
+    _PHF_DEFINE_OPS(K, V) \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef Phf_##K##_##V Phf_##K##_##V##_defined
+
+/**
+ * @brief Generate phf_K_V_from_hashmap for a PHF and HashMap of the same K and V
+ * @param K The key type
+ * @param V The value type
+ *
+ * Creates:
+ * - phf_K_V_from_hashmap(m): Build a table from a HashMap_K_V's entries
+ *
+ * Requires: PHF_DEFINE(K, V) (or PHF_DEFINE_WITH) and HASHMAP_DEFINE(K, V)
+ * (or a variant)
+ */
+#define PHF_FROM_HASHMAP_DEFINE(K, V) \
+    /** \
+     * @brief Build a table from the contents of a HashMap \
+     * @param m Pointer to a populated map (any pending resize is finished) \
+     * @return Ok with the table, or Err when no perfect hash was found \
+     * @note The map is left unchanged and still owned by the caller \
+     */ \
+    static inline Result_Phf_##K##_##V##_PhfError phf_##K##_##V##_from_hashmap(HashMap_##K##_##V *m) { \
+        hashmap_##K##_##V##_finish_resize(m); \
+        K *keys = (K *)_cyan_phf_alloc(m->len, sizeof(K)); \
+        V *values = (V *)_cyan_phf_alloc(m->len, sizeof(V)); \
+        size_t n = 0; \
+        for (size_t i = 0; i < m->capacity; i++) { \
+            if (!_CYAN_TAG_IS_FULL(m->buckets[i].tag)) continue; \
+            keys[n] = m->buckets[i].key; \
+            values[n] = *_CYAN_MAP_VAL(V, m->buckets, m->capacity, i); \
+            n++; \
+        } \
+        Result_Phf_##K##_##V##_PhfError r = phf_##K##_##V##_build(keys, values, n); \
+        free(keys); \
+        free(values); \
+        return r; \
+    } \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef Phf_##K##_##V Phf_##K##_##V##_from_hashmap_defined
+
+#endif /* CYAN_PHF_H */
@@ -27,6 +27,7 @@
 
 #include "common.h"
 #include "result.h"
+#include "numfmt.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -72,10 +73,9 @@ RESULT_DEFINE(ParsedString, ParseError);
  *   free(s);
  */
 static inline char *serialize_int(int val) {
-    /* Max int string: "-2147483648" = 11 chars + null */
-    char *buf = (char *)malloc(16);
+    char *buf = (char *)malloc(CYAN_FMT_INT_MAX + 1);
     if (!buf) CYAN_PANIC("allocation failed");
-    snprintf(buf, 16, "%d", val);
+    buf[cyan_fmt_i64(buf, val)] = '\0';
     return buf;
 }
 
@@ -84,26 +84,16 @@ static inline char *serialize_int(int val) {
  * @param val The double value to serialize
  * @return Newly allocated string (caller must free)
  * 
- * Uses enough precision to round-trip the value.
+ * Writes the shortest digits that round-trip the value (see cyan_fmt_f64).
  * 
  * Example:
  *   char *s = serialize_double(3.14);  // Returns "3.14"
  *   free(s);
  */
 static inline char *serialize_double(double val) {
-    /* Use enough buffer for full precision double */
-    char *buf = (char *)malloc(32);
+    char *buf = (char *)malloc(CYAN_FMT_F64_MAX + 1);
     if (!buf) CYAN_PANIC("allocation failed");
-    
-    /* Handle special cases */
-    if (isnan(val)) {
-        strcpy(buf, "nan");
-    } else if (isinf(val)) {
-        strcpy(buf, val > 0 ? "inf" : "-inf");
-    } else {
-        /* Use %.17g for full double precision round-trip */
-        snprintf(buf, 32, "%.17g", val);
-    }
+    buf[cyan_fmt_f64(buf, val)] = '\0';
     return buf;
 }
 
@@ -403,9 +393,9 @@ static inline Result_ParsedString_ParseError parse_string(const char *input, con
  * @return Newly allocated string (caller must free)
  */
 static inline char *serialize_long(long val) {
-    char *buf = (char *)malloc(24);
+    char *buf = (char *)malloc(CYAN_FMT_INT_MAX + 1);
     if (!buf) CYAN_PANIC("allocation failed");
-    snprintf(buf, 24, "%ld", val);
+    buf[cyan_fmt_i64(buf, val)] = '\0';
     return buf;
 }
 
@@ -0,0 +1,336 @@
+/**
+ * @file shared_string.h
+ * @brief Immutable reference-counted strings with O(1) clone and substrings
+ *
+ * A SharedString is a handle to bytes that are never modified. The
+ * reference count, length and bytes live in one allocation, so creating a
+ * SharedString costs one malloc and one copy, and every clone after that
+ * costs a count increment. Substrings are views into the same allocation;
+ * they hold a reference too, so they stay valid after the handle they were
+ * taken from is released.
+ *
+ * Converting back to a mutable String is copy-on-write: the last handle to
+ * an allocation hands it over to the String without copying to a new
+ * buffer, and shared handles copy.
+ *
+ * Usage:
+ *   SharedString body = shared_string_from_str(&payload);
+ *   SharedString for_log = shared_string_clone(&body);        // No copy
+ *   SharedString head = shared_string_substr(&body, 0, 64);   // No copy
+ *   ...
+ *   String mine = shared_string_into_string(&body);          // Copies only if shared
+ *   shared_string_release(&for_log);
+ *   shared_string_release(&head);
+ *
+ * Thread Safety:
+ *   Define CYAN_SHARED_STRING_ATOMIC before including this header to count
+ *   references with atomic operations, so handles to one string can be
+ *   cloned and released on different threads (or sent through channels).
+ *   Define it the same way in every file that shares strings.
+ */
+
+#ifndef CYAN_SHARED_STRING_H
+#define CYAN_SHARED_STRING_H
+
+#include "common.h"
+#include "option.h"
+#include "slice.h"
+#include "string.h"
+#include <string.h>
+
+/*============================================================================
+ * Reference Counting
+ *============================================================================*/
+
+#ifdef CYAN_SHARED_STRING_ATOMIC
+#define _CYAN_SHARED_STRING_INC(p) ((void)__atomic_fetch_add((p), 1, __ATOMIC_RELAXED))
+#define _CYAN_SHARED_STRING_DEC(p) __atomic_sub_fetch((p), 1, __ATOMIC_ACQ_REL)
+#define _CYAN_SHARED_STRING_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#else
+#define _CYAN_SHARED_STRING_INC(p) ((void)++*(p))
+#define _CYAN_SHARED_STRING_DEC(p) (--*(p))
+#define _CYAN_SHARED_STRING_LOAD(p) (*(p))
+#endif
+
+/*============================================================================
+ * Type Definitions
+ *============================================================================*/
+
+/**
+ * @brief Header and bytes of a shared string, in one allocation
+ */
+typedef struct {
+    size_t refs;   /* Handles referring to this block */
+    size_t len;    /* Bytes stored, excluding the null terminator */
+    char data[];   /* Bytes followed by a null terminator */
+} _SharedStringBlock;
+
+/* Forward declare SharedString for use in vtable */
+typedef struct SharedString SharedString;
+
+/**
+ * @brief Vtable structure for SharedString containing function pointers
+ */
+typedef struct {
+    SharedString (*clone)(const SharedString *s);
+    size_t (*len)(const SharedString *s);
+    Slice_char (*as_slice)(const SharedString *s);
+    void (*release)(SharedString *s);
+} SharedStringVT;
+
+/**
+ * @brief Handle to an immutable, reference-counted byte string
+ *
+ * - block: shared allocation, NULL for the empty string
+ * - data: first byte of this handle's view inside the block
+ * - len: bytes in the view
+ * - vt: pointer to shared vtable
+ *
+ * Handles are plain values: copying the struct does not add a reference,
+ * so use shared_string_clone for each owner and release each clone once.
+ */
+struct SharedString {
+    _SharedStringBlock *block;
+    const char *data;
+    size_t len;
+    const SharedStringVT *vt;
+};
+
+/* Forward declare vtable instance */
+static const SharedStringVT _shared_string_vt;
+
+/*============================================================================
+ * Creation
+ *============================================================================*/
+
+/**
+ * @brief Create an empty shared string
+ * @return Empty SharedString (no allocation)
+ */
+static inline SharedString shared_string_new(void) {
+    return (SharedString){ .block = NULL, .data = "", .len = 0, .vt = &_shared_string_vt };
+}
+
+/**
+ * @brief Create a shared string from a byte range
+ * @param p Bytes to copy
+ * @param n Number of bytes
+ * @return SharedString holding the only reference to a new block
+ */
+static inline SharedString shared_string_from_bytes(const char *p, size_t n) {
+    if (n == 0) return shared_string_new();
+    if (n > SIZE_MAX - sizeof(_SharedStringBlock) - 1) CYAN_PANIC("allocation failed");
+    _SharedStringBlock *b = (_SharedStringBlock *)malloc(sizeof(_SharedStringBlock) + n + 1);
+    if (!b) CYAN_PANIC("allocation failed");
+    b->refs = 1;
+    b->len = n;
+    memcpy(b->data, p, n);
+    b->data[n] = '\0';
+    return (SharedString){ .block = b, .data = b->data, .len = n, .vt = &_shared_string_vt };
+}
+
+/**
+ * @brief Create a shared string from a C string
+ * @param cstr Null-terminated source string
+ * @return SharedString holding a copy of cstr
+ */
+static inline SharedString shared_string_from(const char *cstr) {
+    return shared_string_from_bytes(cstr, strlen(cstr));
+}
+
+/**
+ * @brief Create a shared string from a slice
+ * @param s Slice to copy
+ * @return SharedString holding a copy of the slice
+ */
+static inline SharedString shared_string_from_slice(Slice_char s) {
+    return shared_string_from_bytes(s.data, s.len);
+}
+
+/**
+ * @brief Create a shared string from a String
+ * @param s Pointer to the source string
+ * @return SharedString holding a copy of the contents
+ */
+static inline SharedString shared_string_from_str(const String *s) {
+    return shared_string_from_bytes(_string_buf(s), _string_len(s));
+}
+
+/*============================================================================
+ * Sharing
+ *============================================================================*/
+
+/**
+ * @brief Add an owner to a shared string
+ * @param s Pointer to the shared string
+ * @return New handle to the same bytes; release it separately
+ */
+static inline SharedString shared_string_clone(const SharedString *s) {
+    if (s->block) _CYAN_SHARED_STRING_INC(&s->block->refs);
+    return *s;
+}
+
+/**
+ * @brief Take a substring without copying
+ * @param s Pointer to the shared string
+ * @param start Start index (inclusive)
+ * @param end End index (exclusive)
+ * @return New handle viewing bytes [start, end) of s; release it separately
+ * @note Indices are clamped to valid bounds, as in string_slice
+ */
+static inline SharedString shared_string_substr(const SharedString *s, size_t start, size_t end) {
+    if (end > s->len) end = s->len;
+    if (start > end) start = end;
+    if (start == end) return shared_string_new();
+    SharedString view = shared_string_clone(s);
+    view.data += start;
+    view.len = end - start;
+    return view;
+}
+
+/**
+ * @brief Get the number of handles sharing the allocation
+ * @param s Pointer to the shared string
+ * @return Reference count, 0 for the empty string
+ * @note With CYAN_SHARED_STRING_ATOMIC this is a snapshot
+ */
+static inline size_t shared_string_ref_count(const SharedString *s) {
+    return s->block ? _CYAN_SHARED_STRING_LOAD(&s->block->refs) : 0;
+}
+
+/**
+ * @brief Check whether this handle is the only owner of its allocation
+ * @param s Pointer to the shared string
+ * @return true if no other handle refers to the same bytes
+ */
+static inline bool shared_string_is_unique(const SharedString *s) {
+    return shared_string_ref_count(s) <= 1;
+}
+
+/*============================================================================
+ * Access
+ *============================================================================*/
+
+/**
+ * @brief Get the length of the shared string
+ * @param s Pointer to the shared string
+ * @return Number of bytes in this handle's view
+ */
+static inline size_t shared_string_len(const SharedString *s) {
+    return s->len;
+}
+
+/**
+ * @brief Get a pointer to the bytes
+ * @param s Pointer to the shared string
+ * @return Pointer to len bytes
+ * @note Substrings are not null-terminated; use "%.*s" to print them
+ */
+static inline const char *shared_string_data(const SharedString *s) {
+    return s->data;
+}
+
+/**
+ * @brief Create a slice view of the shared string
+ * @param s Pointer to the shared string
+ * @return Slice_char viewing the bytes
+ * @note The slice stays valid while any handle to the allocation is held
+ */
+static inline Slice_char shared_string_as_slice(const SharedString *s) {
+    return (Slice_char){ .data = s->data, .len = s->len, .vt = &_slice_char_vt };
+}
+
+/**
+ * @brief Compare two shared strings for equality
+ * @param a Pointer to the first shared string
+ * @param b Pointer to the second shared string
+ * @return true if both contain the same bytes
+ */
+static inline bool shared_string_eq(const SharedString *a, const SharedString *b) {
+    if (a->len != b->len) return false;
+    return a->data == b->data || memcmp(a->data, b->data, a->len) == 0;
+}
+
+/*============================================================================
+ * Conversion
+ *============================================================================*/
+
+/**
+ * @brief Copy a shared string into a new String
+ * @param s Pointer to the shared string
+ * @return New String with the same bytes; s is unchanged
+ */
+static inline String shared_string_to_string(const SharedString *s) {
+    String out = _string_alloc(s->len);
+    memcpy(_string_buf(&out), s->data, s->len);
+    return out;
+}
+
+/**
+ * @brief Release a shared string (decrement reference count)
+ * @param s Pointer to the shared string
+ * @note Frees the allocation when the last handle is released; s is
+ *       reset to the empty string
+ */
+static inline void shared_string_release(SharedString *s) {
+    if (s->block && _CYAN_SHARED_STRING_DEC(&s->block->refs) == 0) {
+        free(s->block);
+    }
+    *s = shared_string_new();
+}
+
+/**
+ * @brief Convert a shared string into a mutable String (copy-on-write)
+ * @param s Pointer to the shared string (released by this call)
+ * @return String with the same bytes
+ * @note When s is the last handle to its allocation, the allocation
+ *       becomes the String's buffer and no new buffer is allocated;
+ *       otherwise the bytes are copied. Views short enough for the
+ *       String's inline buffer are always copied there.
+ */
+static inline String shared_string_into_string(SharedString *s) {
+    _SharedStringBlock *b = s->block;
+    if (!b || s->len <= CYAN_STRING_INLINE_CAP || !shared_string_is_unique(s)) {
+        String out = shared_string_to_string(s);
+        shared_string_release(s);
+        return out;
+    }
+    /* Sole owner: slide the view to the front of the allocation */
+    size_t cap = sizeof(_SharedStringBlock) + b->len + 1;
+    size_t len = s->len;
+    char *buf = (char *)b;
+    memmove(buf, s->data, len);
+    buf[len] = '\0';
+    String out = string_new();
+    _string_set_heap(&out, buf, len, cap);
+    *s = shared_string_new();
+    return out;
+}
+
+/*============================================================================
+ * Auto-Cleanup Macro
+ *============================================================================*/
+
+/**
+ * @brief Declare a shared string that is released on scope exit
+ * @param name Variable name
+ * @param init Initializer expression (e.g., shared_string_clone(&body))
+ */
+#define shared_string_auto(name, init) \
+    __attribute__((cleanup(shared_string_release))) SharedString name = (init)
+
+/*============================================================================
+ * Vtable Instance
+ *============================================================================*/
+
+/**
+ * @brief Static const vtable instance shared by all SharedString handles
+ */
+static const SharedStringVT _shared_string_vt = {
+    .clone = shared_string_clone,
+    .len = shared_string_len,
+    .as_slice = shared_string_as_slice,
+    .release = shared_string_release,
+};
+
+#endif /* CYAN_SHARED_STRING_H */
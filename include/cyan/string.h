@@ -58,40 +58,164 @@ typedef struct {
 } StringVT;
 
 /**
- * @brief Dynamic string type
+ * @brief Size of the inline (small string) buffer in bytes
+ *
+ * The inline buffer overlays the heap representation (data, len, cap), so
+ * it is 24 bytes on LP64 targets. The last byte holds the inline length
+ * and the heap flag, leaving room for 22 characters plus a terminator.
+ */
+#define _CYAN_STRING_SSO_SIZE (sizeof(char *) + 2 * sizeof(size_t))
+
+/**
+ * @brief Maximum number of characters stored inline without allocating
+ */
+#define CYAN_STRING_INLINE_CAP (_CYAN_STRING_SSO_SIZE - 2)
+
+/**
+ * @brief Dynamic string type with small string optimization
+ * 
+ * Strings of up to CYAN_STRING_INLINE_CAP characters live inline in the
+ * struct itself; longer strings spill to a heap buffer transparently.
+ * Heap mode is marked by the top bit of the last inline byte, which in
+ * heap mode overlays the encoded cap. A zero-initialized String is a
+ * valid empty inline string (apart from its vtable pointer).
  * 
- * A heap-allocated, growable string with:
- * - data: null-terminated character buffer
- * - len: length excluding null terminator
- * - cap: capacity including null terminator
+ * - data: null-terminated heap buffer (heap mode only)
+ * - len: length excluding null terminator (heap mode only)
+ * - cap: encoded capacity including null terminator (heap mode only)
  * - vt: pointer to shared vtable
+ * 
+ * Use the string_* accessors rather than the fields directly.
  */
 struct String {
-    char *data;      /* Null-terminated buffer */
-    size_t len;      /* Length excluding null terminator */
-    size_t cap;      /* Capacity including null terminator */
+    union {
+        struct {
+            char *data;      /* Null-terminated heap buffer */
+            size_t len;      /* Length excluding null terminator */
+            size_t cap;      /* Encoded capacity including null terminator */
+        };
+        char _sso[_CYAN_STRING_SSO_SIZE];  /* Inline buffer; last byte is the tag */
+    };
     const StringVT *vt;  /* Pointer to shared vtable */
 };
 
 /* Forward declare vtable instance */
 static const StringVT _string_vt;
 
+/*============================================================================
+ * Representation Helpers
+ *============================================================================*/
+
+/* Heap flag: top bit of the last inline byte, expressed as a cap encoding */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define _CYAN_STRING_CAP_ENCODE(c) (((size_t)(c) << 8) | (size_t)0x80)
+#define _CYAN_STRING_CAP_DECODE(w) ((size_t)(w) >> 8)
+#else
+#define _CYAN_STRING_HEAP_BIT ((size_t)1 << (sizeof(size_t) * 8 - 1))
+#define _CYAN_STRING_CAP_ENCODE(c) ((size_t)(c) | _CYAN_STRING_HEAP_BIT)
+#define _CYAN_STRING_CAP_DECODE(w) ((size_t)(w) & ~_CYAN_STRING_HEAP_BIT)
+#endif
+
+/**
+ * @brief Check whether the string's characters live on the heap
+ * @param s Pointer to the string
+ * @return true in heap mode, false in inline mode
+ */
+static inline bool _string_is_heap(const String *s) {
+    return ((unsigned char)s->_sso[_CYAN_STRING_SSO_SIZE - 1] & 0x80) != 0;
+}
+
+/**
+ * @brief Get the character buffer for either representation
+ * @param s Pointer to the string
+ * @return Pointer to the null-terminated buffer
+ */
+static inline char *_string_buf(const String *s) {
+    return _string_is_heap(s) ? s->data : (char *)s->_sso;
+}
+
+/**
+ * @brief Get the length for either representation
+ * @param s Pointer to the string
+ * @return Number of characters (excluding null terminator)
+ */
+static inline size_t _string_len(const String *s) {
+    return _string_is_heap(s) ? s->len
+                              : (unsigned char)s->_sso[_CYAN_STRING_SSO_SIZE - 1];
+}
+
+/**
+ * @brief Set the length and write the null terminator
+ * @param s Pointer to the string
+ * @param len New length (must fit the current capacity)
+ */
+static inline void _string_set_len(String *s, size_t len) {
+    if (_string_is_heap(s)) {
+        s->len = len;
+        s->data[len] = '\0';
+    } else {
+#if defined(__GNUC__) || defined(__clang__)
+        /* The contract above; stated so the compiler drops impossible paths */
+        if (len > CYAN_STRING_INLINE_CAP) __builtin_unreachable();
+#endif
+        s->_sso[_CYAN_STRING_SSO_SIZE - 1] = (char)len;
+        s->_sso[len] = '\0';
+    }
+}
+
+/**
+ * @brief Switch a string to heap mode with the given buffer
+ * @param s Pointer to the string
+ * @param data Heap buffer (ownership is taken)
+ * @param len Length of the content already in data
+ * @param cap Capacity of data including null terminator
+ */
+static inline void _string_set_heap(String *s, char *data, size_t len, size_t cap) {
+    s->data = data;
+    s->len = len;
+    s->cap = _CYAN_STRING_CAP_ENCODE(cap);
+    /* Already set by the store above; repeating it on the tag byte lets the
+     * compiler see the mode change and drop the inline paths after it */
+    s->_sso[_CYAN_STRING_SSO_SIZE - 1] |= (char)0x80;
+}
+
+/**
+ * @brief Create an empty string with room for len characters
+ * @param len Number of characters the caller will write
+ * @return A String of length len whose buffer is ready to be filled
+ * @note The terminator is written; the content bytes are uninitialized
+ * @note Panics if allocation fails
+ */
+static inline String _string_alloc(size_t len) {
+    String s;
+    memset(s._sso, 0, sizeof(s._sso));
+    s.vt = &_string_vt;
+    if (len > CYAN_STRING_INLINE_CAP) {
+        char *data = (char *)malloc(len + 1);
+        if (!data) CYAN_PANIC("allocation failed");
+        _string_set_heap(&s, data, len, len + 1);
+    }
+    _string_set_len(&s, len);
+    return s;
+}
+
 /*============================================================================
  * Constructors
  *============================================================================*/
 
 /**
  * @brief Create an empty string
- * @return A new empty String
+ * @return A new empty String (inline, no allocation)
  */
 static inline String string_new(void) {
-    return (String){ .data = NULL, .len = 0, .cap = 0, .vt = &_string_vt };
+    return _string_alloc(0);
 }
 
 /**
  * @brief Create a string from a C string
  * @param cstr The source C string (null-terminated)
  * @return A new String containing a copy of cstr
+ * @note Strings up to CYAN_STRING_INLINE_CAP characters do not allocate
  * @note Panics if allocation fails
  */
 static inline String string_from(const char *cstr) {
@@ -99,28 +223,22 @@ static inline String string_from(const char *cstr) {
         return string_new();
     }
     size_t len = strlen(cstr);
-    size_t cap = len + 1;
-    char *data = (char *)malloc(cap);
-    if (!data) CYAN_PANIC("allocation failed");
-    memcpy(data, cstr, cap);  /* Includes null terminator */
-    return (String){ .data = data, .len = len, .cap = cap, .vt = &_string_vt };
+    String s = _string_alloc(len);
+    memcpy(_string_buf(&s), cstr, len);
+    return s;
 }
 
 /**
  * @brief Create a string with pre-allocated capacity
  * @param cap Initial capacity (excluding null terminator)
  * @return A new empty String with allocated storage
+ * @note Capacities up to CYAN_STRING_INLINE_CAP do not allocate
  * @note Panics if allocation fails
  */
 static inline String string_with_capacity(size_t cap) {
-    if (cap == 0) {
-        return string_new();
-    }
-    size_t actual_cap = cap + 1;  /* +1 for null terminator */
-    char *data = (char *)malloc(actual_cap);
-    if (!data) CYAN_PANIC("allocation failed");
-    data[0] = '\0';
-    return (String){ .data = data, .len = 0, .cap = actual_cap, .vt = &_string_vt };
+    String s = _string_alloc(cap);
+    _string_set_len(&s, 0);
+    return s;
 }
 
 /*============================================================================
@@ -131,20 +249,30 @@ static inline String string_with_capacity(size_t cap) {
  * @brief Check that string has enough capacity for additional bytes
  * @param s Pointer to the string
  * @param additional Number of additional bytes needed
+ * @note Moves an inline string to the heap once it outgrows the inline buffer
  */
 static inline void _string_check_capacity(String *s, size_t additional) {
-    size_t required = s->len + additional + 1;  /* +1 for null terminator */
-    if (required <= s->cap) return;
+    bool heap = _string_is_heap(s);
+    size_t len = _string_len(s);
+    size_t cap = heap ? _CYAN_STRING_CAP_DECODE(s->cap) : CYAN_STRING_INLINE_CAP + 1;
+    size_t required = len + additional + 1;  /* +1 for null terminator */
+    if (required <= cap) return;
     
-    size_t new_cap = s->cap == 0 ? CYAN_DEFAULT_CAPACITY : s->cap;
+    size_t new_cap = cap < CYAN_DEFAULT_CAPACITY ? CYAN_DEFAULT_CAPACITY : cap;
     while (new_cap < required) {
         new_cap *= CYAN_GROWTH_FACTOR;
     }
     
-    char *new_data = (char *)realloc(s->data, new_cap);
-    if (!new_data) CYAN_PANIC("allocation failed");
-    s->data = new_data;
-    s->cap = new_cap;
+    if (heap) {
+        char *new_data = (char *)realloc(s->data, new_cap);
+        if (!new_data) CYAN_PANIC("allocation failed");
+        _string_set_heap(s, new_data, len, new_cap);
+    } else {
+        char *new_data = (char *)malloc(new_cap);
+        if (!new_data) CYAN_PANIC("allocation failed");
+        memcpy(new_data, s->_sso, len + 1);
+        _string_set_heap(s, new_data, len, new_cap);
+    }
 }
 
 /*============================================================================
@@ -157,9 +285,17 @@ static inline void _string_check_capacity(String *s, size_t additional) {
  * @param c Character to append
  */
 static inline void string_push(String *s, char c) {
+    size_t len = _string_len(s);
+    if (len < CYAN_STRING_INLINE_CAP && !_string_is_heap(s)) {
+        /* Inline fast path: no capacity check or buffer selection */
+        s->_sso[len] = c;
+        s->_sso[len + 1] = '\0';
+        s->_sso[_CYAN_STRING_SSO_SIZE - 1] = (char)(len + 1);
+        return;
+    }
     _string_check_capacity(s, 1);
-    s->data[s->len++] = c;
-    s->data[s->len] = '\0';
+    _string_buf(s)[len] = c;
+    _string_set_len(s, len + 1);
 }
 
 /**
@@ -173,21 +309,26 @@ static inline void string_append(String *s, const char *cstr) {
     if (add_len == 0) return;
     
     _string_check_capacity(s, add_len);
-    memcpy(s->data + s->len, cstr, add_len + 1);  /* Includes null terminator */
-    s->len += add_len;
+    size_t len = _string_len(s);
+    memcpy(_string_buf(s) + len, cstr, add_len);
+    _string_set_len(s, len + add_len);
 }
 
 /**
  * @brief Append another String to this string
  * @param s Pointer to the destination string
  * @param other Pointer to the source string
+ * @note s and other may be the same string
  */
 static inline void string_append_str(String *s, const String *other) {
-    if (!other || other->len == 0) return;
+    if (!other) return;
+    size_t add_len = _string_len(other);
+    if (add_len == 0) return;
     
-    _string_check_capacity(s, other->len);
-    memcpy(s->data + s->len, other->data, other->len + 1);
-    s->len += other->len;
+    _string_check_capacity(s, add_len);
+    size_t len = _string_len(s);
+    memmove(_string_buf(s) + len, _string_buf(other), add_len);
+    _string_set_len(s, len + add_len);
 }
 
 /**
@@ -195,10 +336,7 @@ static inline void string_append_str(String *s, const String *other) {
  * @param s Pointer to the string
  */
 static inline void string_clear(String *s) {
-    s->len = 0;
-    if (s->data) {
-        s->data[0] = '\0';
-    }
+    _string_set_len(s, 0);
 }
 
 /*============================================================================
@@ -206,33 +344,51 @@ static inline void string_clear(String *s) {
  *============================================================================*/
 
 /**
- * @brief Format and append to string (like sprintf)
+ * @brief Format and append to string with a va_list (like vsprintf)
  * @param s Pointer to the string
  * @param fmt Format string
- * @param ... Format arguments
- * @note Automatically grows buffer as needed
+ * @param args Format arguments
+ * @note Formats straight into the spare capacity and formats a second time
+ *       only when the output did not fit
  */
-static inline void string_format(String *s, const char *fmt, ...) {
-    va_list args, args_copy;
-    va_start(args, fmt);
+static inline void string_vformat(String *s, const char *fmt, va_list args) {
+    va_list args_copy;
     va_copy(args_copy, args);
     
-    /* First, determine required size */
-    int needed = vsnprintf(NULL, 0, fmt, args);
-    va_end(args);
+    size_t len = _string_len(s);
+    size_t cap = _string_is_heap(s) ? _CYAN_STRING_CAP_DECODE(s->cap) : CYAN_STRING_INLINE_CAP + 1;
+    size_t spare = cap - len;  /* Includes room for the terminator */
+    int needed = vsnprintf(_string_buf(s) + len, spare, fmt, args_copy);
+    va_end(args_copy);
     
     if (needed < 0) {
-        va_end(args_copy);
-        return;  /* Format error */
+        _string_set_len(s, len);  /* Format error: drop any partial output */
+        return;
     }
     
-    _string_check_capacity(s, (size_t)needed);
-    
-    /* Now format into the buffer */
-    vsnprintf(s->data + s->len, (size_t)needed + 1, fmt, args_copy);
-    va_end(args_copy);
+    if ((size_t)needed >= spare) {
+        /* Output was truncated: grow to the exact size and format again */
+        _string_check_capacity(s, (size_t)needed);
+        va_copy(args_copy, args);
+        vsnprintf(_string_buf(s) + len, (size_t)needed + 1, fmt, args_copy);
+        va_end(args_copy);
+    }
     
-    s->len += (size_t)needed;
+    _string_set_len(s, len + (size_t)needed);
+}
+
+/**
+ * @brief Format and append to string (like sprintf)
+ * @param s Pointer to the string
+ * @param fmt Format string
+ * @param ... Format arguments
+ * @note Automatically grows buffer as needed
+ */
+static inline void string_format(String *s, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    string_vformat(s, fmt, args);
+    va_end(args);
 }
 
 /**
@@ -240,26 +396,14 @@ static inline void string_format(String *s, const char *fmt, ...) {
  * @param fmt Format string
  * @param ... Format arguments
  * @return A new String containing the formatted output
+ * @note Output that fits the inline buffer is formatted once, without allocating
  */
 static inline String string_formatted(const char *fmt, ...) {
-    va_list args, args_copy;
+    String s = string_new();
+    va_list args;
     va_start(args, fmt);
-    va_copy(args_copy, args);
-    
-    /* First, determine required size */
-    int needed = vsnprintf(NULL, 0, fmt, args);
+    string_vformat(&s, fmt, args);
     va_end(args);
-    
-    if (needed < 0) {
-        va_end(args_copy);
-        return string_new();  /* Format error */
-    }
-    
-    String s = string_with_capacity((size_t)needed);
-    vsnprintf(s.data, (size_t)needed + 1, fmt, args_copy);
-    va_end(args_copy);
-    
-    s.len = (size_t)needed;
     return s;
 }
 
@@ -271,10 +415,11 @@ static inline String string_formatted(const char *fmt, ...) {
  * @brief Get the null-terminated C string
  * @param s Pointer to the string
  * @return Pointer to null-terminated character array
- * @note Returns empty string "" for uninitialized strings
+ * @note For inline strings the pointer refers into *s itself, so it is
+ *       invalidated by moving or copying the String as well as by modifying it
  */
 static inline const char *string_cstr(const String *s) {
-    return s->data ? s->data : "";
+    return _string_buf(s);
 }
 
 /**
@@ -283,7 +428,25 @@ static inline const char *string_cstr(const String *s) {
  * @return Number of characters (excluding null terminator)
  */
 static inline size_t string_len(const String *s) {
-    return s->len;
+    return _string_len(s);
+}
+
+/**
+ * @brief Get the number of characters the string can hold without growing
+ * @param s Pointer to the string
+ * @return Capacity excluding null terminator
+ */
+static inline size_t string_capacity(const String *s) {
+    return _string_is_heap(s) ? _CYAN_STRING_CAP_DECODE(s->cap) - 1 : CYAN_STRING_INLINE_CAP;
+}
+
+/**
+ * @brief Check whether the string is stored inline (without a heap buffer)
+ * @param s Pointer to the string
+ * @return true if no heap buffer is owned
+ */
+static inline bool string_is_inline(const String *s) {
+    return !_string_is_heap(s);
 }
 
 /**
@@ -293,8 +456,8 @@ static inline size_t string_len(const String *s) {
  * @return Option_char containing the character, or None if out of bounds
  */
 static inline Option_char string_get(const String *s, size_t idx) {
-    if (idx >= s->len) return None(char);
-    return Some(char, s->data[idx]);
+    if (idx >= _string_len(s)) return None(char);
+    return Some(char, _string_buf(s)[idx]);
 }
 
 /*============================================================================
@@ -308,28 +471,27 @@ static inline Option_char string_get(const String *s, size_t idx) {
  * @param end End index (exclusive)
  * @return Slice_char viewing the specified range
  * @note Indices are clamped to valid bounds
- * @note The slice becomes invalid if the string is modified or freed
+ * @note The slice becomes invalid if the string is modified, moved or freed
  */
 static inline Slice_char string_slice(const String *s, size_t start, size_t end) {
-    if (!s->data || s->len == 0) {
+    size_t len = _string_len(s);
+    if (len == 0) {
         return (Slice_char){ .data = NULL, .len = 0, .vt = &_slice_char_vt };
     }
-    if (start > s->len) start = s->len;
-    if (end > s->len) end = s->len;
+    if (start > len) start = len;
+    if (end > len) end = len;
     if (start > end) start = end;
-    return (Slice_char){ .data = s->data + start, .len = end - start, .vt = &_slice_char_vt };
+    return (Slice_char){ .data = _string_buf(s) + start, .len = end - start, .vt = &_slice_char_vt };
 }
 
 /**
  * @brief Create a slice view of the entire string
  * @param s Pointer to the string
  * @return Slice_char viewing the entire string
+ * @note The slice becomes invalid if the string is modified, moved or freed
  */
 static inline Slice_char string_as_slice(const String *s) {
-    if (!s->data) {
-        return (Slice_char){ .data = NULL, .len = 0, .vt = &_slice_char_vt };
-    }
-    return (Slice_char){ .data = s->data, .len = s->len, .vt = &_slice_char_vt };
+    return (Slice_char){ .data = _string_buf(s), .len = _string_len(s), .vt = &_slice_char_vt };
 }
 
 /*============================================================================
@@ -343,23 +505,13 @@ static inline Slice_char string_as_slice(const String *s) {
  * @return A new String containing a's content followed by b's content
  */
 static inline String string_concat(const String *a, const String *b) {
-    size_t total_len = a->len + b->len;
+    size_t a_len = _string_len(a);
+    size_t b_len = _string_len(b);
     
-    /* Handle empty result case */
-    if (total_len == 0) {
-        return string_new();
-    }
-    
-    String result = string_with_capacity(total_len);
-    
-    if (a->data && a->len > 0) {
-        memcpy(result.data, a->data, a->len);
-    }
-    if (b->data && b->len > 0) {
-        memcpy(result.data + a->len, b->data, b->len);
-    }
-    result.data[total_len] = '\0';
-    result.len = total_len;
+    String result = _string_alloc(a_len + b_len);
+    char *out = _string_buf(&result);
+    memcpy(out, _string_buf(a), a_len);
+    memcpy(out + a_len, _string_buf(b), b_len);
     
     return result;
 }
@@ -371,13 +523,13 @@ static inline String string_concat(const String *a, const String *b) {
 /**
  * @brief Free all memory associated with the string
  * @param s Pointer to the string
- * @note Resets the string to empty state
+ * @note Resets the string to empty inline state
  */
 static inline void string_free(String *s) {
-    free(s->data);
-    s->data = NULL;
-    s->len = 0;
-    s->cap = 0;
+    if (_string_is_heap(s)) {
+        free(s->data);
+    }
+    memset(s->_sso, 0, sizeof(s->_sso));
 }
 
 /*============================================================================
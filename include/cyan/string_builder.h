@@ -0,0 +1,496 @@
+/**
+ * @file string_builder.h
+ * @brief Chunked string builder for large outputs
+ *
+ * A String grows by reallocating, so building a large output with
+ * string_append copies every byte about twice and needs 1.5x-2x the final
+ * size at peak. StringBuilder appends into a chain of fixed-size chunks
+ * instead:
+ * - Appends never move bytes that were already written
+ * - The chunks can be walked as Slice_char views, exported as an iovec
+ *   array or written with writev, without ever joining them
+ * - string_builder_join copies everything once into an exactly sized String
+ *
+ * Usage:
+ *   StringBuilder sb = string_builder_new();
+ *   for (int i = 0; i < rows; i++) {
+ *       string_builder_format(&sb, "%d,%s\n", i, names[i]);
+ *   }
+ *   string_builder_writev(&sb, fd);          // or:
+ *   String out = string_builder_join(&sb);   // one copy, exact size
+ *   string_builder_free(&sb);
+ */
+
+#ifndef CYAN_STRING_BUILDER_H
+#define CYAN_STRING_BUILDER_H
+
+#include "common.h"
+#include "slice.h"
+#include "string.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L
+#include <errno.h>
+#include <sys/uio.h>
+#include <unistd.h>
+/** @brief Defined when the iovec export and writev are available */
+#define CYAN_HAS_STRING_BUILDER_IOVEC 1
+#else
+#define CYAN_HAS_STRING_BUILDER_IOVEC 0
+#endif
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+/**
+ * @brief Default payload bytes per chunk
+ * Override per builder with string_builder_with_chunk_size.
+ */
+#ifndef CYAN_STRING_BUILDER_CHUNK
+#define CYAN_STRING_BUILDER_CHUNK 65536
+#endif
+
+/*============================================================================
+ * Type Definitions
+ *============================================================================*/
+
+/**
+ * @brief One chunk of builder storage
+ */
+typedef struct _CyanStrChunk {
+    struct _CyanStrChunk *next;  /* Following chunk, NULL for the tail */
+    size_t len;                  /* Bytes written to data */
+    size_t cap;                  /* Usable bytes in data */
+    char data[];
+} _CyanStrChunk;
+
+/* Forward declare StringBuilder for use in vtable */
+typedef struct StringBuilder StringBuilder;
+
+/**
+ * @brief Vtable structure for StringBuilder containing function pointers
+ */
+typedef struct {
+    void (*push)(StringBuilder *sb, char c);
+    void (*append)(StringBuilder *sb, const char *cstr);
+    size_t (*len)(const StringBuilder *sb);
+    String (*join)(const StringBuilder *sb);
+    void (*free)(StringBuilder *sb);
+} StringBuilderVT;
+
+/**
+ * @brief Chunked string builder
+ *
+ * - head/tail: chunk chain in write order; bytes are appended to tail
+ * - len: total bytes across all chunks
+ * - chunks: number of chunks in the chain
+ * - chunk_size: payload bytes per newly allocated chunk
+ * - vt: pointer to shared vtable
+ */
+struct StringBuilder {
+    _CyanStrChunk *head;
+    _CyanStrChunk *tail;
+    size_t len;
+    size_t chunks;
+    size_t chunk_size;
+    const StringBuilderVT *vt;
+};
+
+/**
+ * @brief Iterator over the non-empty chunks of a builder
+ */
+typedef struct {
+    const _CyanStrChunk *chunk;  /* Next chunk to visit */
+} StringBuilderIter;
+
+/* Forward declare vtable instance */
+static const StringBuilderVT _string_builder_vt;
+
+/*============================================================================
+ * Constructors
+ *============================================================================*/
+
+/**
+ * @brief Create an empty builder with a given chunk size
+ * @param chunk_size Payload bytes per chunk (0 selects CYAN_STRING_BUILDER_CHUNK)
+ * @return A new empty StringBuilder (no allocation until the first append)
+ */
+static inline StringBuilder string_builder_with_chunk_size(size_t chunk_size) {
+    return (StringBuilder){
+        .head = NULL,
+        .tail = NULL,
+        .len = 0,
+        .chunks = 0,
+        .chunk_size = chunk_size ? chunk_size : CYAN_STRING_BUILDER_CHUNK,
+        .vt = &_string_builder_vt
+    };
+}
+
+/**
+ * @brief Create an empty builder with the default chunk size
+ * @return A new empty StringBuilder (no allocation until the first append)
+ */
+static inline StringBuilder string_builder_new(void) {
+    return string_builder_with_chunk_size(0);
+}
+
+/*============================================================================
+ * Internal Helpers
+ *============================================================================*/
+
+/**
+ * @brief Link a new empty chunk behind the tail
+ * @param sb Pointer to the builder
+ * @param min Minimum payload bytes; larger than chunk_size only for reserve
+ * @return The new tail chunk
+ * @note Panics if allocation fails
+ */
+static inline _CyanStrChunk *_string_builder_grow(StringBuilder *sb, size_t min) {
+    size_t cap = min > sb->chunk_size ? min : sb->chunk_size;
+    _CyanStrChunk *c = (_CyanStrChunk *)malloc(sizeof(_CyanStrChunk) + cap);
+    if (!c) CYAN_PANIC("allocation failed");
+    c->next = NULL;
+    c->len = 0;
+    c->cap = cap;
+    if (sb->tail) {
+        sb->tail->next = c;
+    } else {
+        sb->head = c;
+    }
+    sb->tail = c;
+    sb->chunks++;
+    return c;
+}
+
+/*============================================================================
+ * Appending
+ *============================================================================*/
+
+/**
+ * @brief Append a byte range
+ * @param sb Pointer to the builder
+ * @param p Bytes to copy
+ * @param n Number of bytes
+ * @note Fills the tail chunk, then continues in new chunks
+ */
+static inline void string_builder_append_bytes(StringBuilder *sb, const char *p, size_t n) {
+    sb->len += n;
+    while (n > 0) {
+        _CyanStrChunk *c = sb->tail;
+        if (!c || c->len == c->cap) c = _string_builder_grow(sb, 0);
+        size_t take = c->cap - c->len;
+        if (take > n) take = n;
+        memcpy(c->data + c->len, p, take);
+        c->len += take;
+        p += take;
+        n -= take;
+    }
+}
+
+/**
+ * @brief Append a single character
+ * @param sb Pointer to the builder
+ * @param ch Character to append
+ */
+static inline void string_builder_push(StringBuilder *sb, char ch) {
+    _CyanStrChunk *c = sb->tail;
+    if (!c || c->len == c->cap) c = _string_builder_grow(sb, 0);
+    c->data[c->len++] = ch;
+    sb->len++;
+}
+
+/**
+ * @brief Append a C string
+ * @param sb Pointer to the builder
+ * @param cstr Null-terminated string (NULL appends nothing)
+ */
+static inline void string_builder_append(StringBuilder *sb, const char *cstr) {
+    if (!cstr) return;
+    string_builder_append_bytes(sb, cstr, strlen(cstr));
+}
+
+/**
+ * @brief Append the contents of a String
+ * @param sb Pointer to the builder
+ * @param s Pointer to the string
+ */
+static inline void string_builder_append_str(StringBuilder *sb, const String *s) {
+    string_builder_append_bytes(sb, string_cstr(s), string_len(s));
+}
+
+/**
+ * @brief Append the bytes viewed by a slice
+ * @param sb Pointer to the builder
+ * @param slice Bytes to copy
+ */
+static inline void string_builder_append_slice(StringBuilder *sb, Slice_char slice) {
+    string_builder_append_bytes(sb, slice.data, slice.len);
+}
+
+/**
+ * @brief Get contiguous space for writing in place
+ * @param sb Pointer to the builder
+ * @param n Number of bytes the caller may write
+ * @return Pointer to at least n writable bytes at the end of the builder
+ * @note Starts a new chunk when the tail has less than n bytes left; n
+ *       larger than chunk_size gets a chunk of its own
+ * @note Follow with string_builder_commit to keep the bytes written
+ */
+static inline char *string_builder_reserve(StringBuilder *sb, size_t n) {
+    _CyanStrChunk *c = sb->tail;
+    if (!c || c->cap - c->len < n) c = _string_builder_grow(sb, n);
+    return c->data + c->len;
+}
+
+/**
+ * @brief Keep bytes written into space from string_builder_reserve
+ * @param sb Pointer to the builder
+ * @param n Number of bytes written, at most the amount reserved
+ */
+static inline void string_builder_commit(StringBuilder *sb, size_t n) {
+    sb->tail->len += n;
+    sb->len += n;
+}
+
+/**
+ * @brief Format and append (like sprintf)
+ * @param sb Pointer to the builder
+ * @param fmt Format string
+ * @param ... Format arguments
+ * @note Formats straight into the tail chunk; only output that does not
+ *       fit is formatted a second time, into a fresh chunk. Empty output
+ *       allocates nothing
+ */
+static inline void string_builder_format(StringBuilder *sb, const char *fmt, ...) {
+    va_list args, args_copy;
+    va_start(args, fmt);
+    va_copy(args_copy, args);
+
+    _CyanStrChunk *c = sb->tail;
+    size_t room = c ? c->cap - c->len : 0;
+    int needed = vsnprintf(c ? c->data + c->len : NULL, room, fmt, args);
+    va_end(args);
+
+    if (needed <= 0) {
+        va_end(args_copy);
+        return;  /* Format error, or nothing to append */
+    }
+
+    /* vsnprintf writes a terminator, so output that fills room exactly
+     * was cut short by one byte */
+    if ((size_t)needed < room) {
+        string_builder_commit(sb, (size_t)needed);
+    } else {
+        char *dst = string_builder_reserve(sb, (size_t)needed + 1);
+        vsnprintf(dst, (size_t)needed + 1, fmt, args_copy);
+        string_builder_commit(sb, (size_t)needed);
+    }
+    va_end(args_copy);
+}
+
+/*============================================================================
+ * Access
+ *============================================================================*/
+
+/**
+ * @brief Get the total number of bytes appended
+ * @param sb Pointer to the builder
+ * @return Length in bytes
+ */
+static inline size_t string_builder_len(const StringBuilder *sb) {
+    return sb->len;
+}
+
+/**
+ * @brief Get the number of chunks in the chain
+ * @param sb Pointer to the builder
+ * @return Chunk count, an upper bound on the entries of an iovec export
+ */
+static inline size_t string_builder_chunk_count(const StringBuilder *sb) {
+    return sb->chunks;
+}
+
+/**
+ * @brief Create an iterator over the builder's chunks
+ * @param sb Pointer to the builder
+ * @return Iterator positioned before the first chunk
+ * @note The iterator is invalidated by clearing or freeing the builder;
+ *       appends only add chunks behind it
+ */
+static inline StringBuilderIter string_builder_iter(const StringBuilder *sb) {
+    return (StringBuilderIter){ .chunk = sb->head };
+}
+
+/**
+ * @brief Advance to the next non-empty chunk
+ * @param it Pointer to the iterator
+ * @param out Receives a slice viewing the chunk's bytes
+ * @return true if a chunk was produced, false when exhausted
+ */
+static inline bool string_builder_iter_next(StringBuilderIter *it, Slice_char *out) {
+    while (it->chunk && it->chunk->len == 0) it->chunk = it->chunk->next;
+    if (!it->chunk) return false;
+    *out = (Slice_char){ .data = it->chunk->data, .len = it->chunk->len, .vt = &_slice_char_vt };
+    it->chunk = it->chunk->next;
+    return true;
+}
+
+/**
+ * @brief Copy the builder's contents into a new String
+ * @param sb Pointer to the builder
+ * @return A String of exactly string_builder_len bytes
+ * @note Panics if allocation fails
+ */
+static inline String string_builder_join(const StringBuilder *sb) {
+    String s = _string_alloc(sb->len);
+    char *out = _string_buf(&s);
+    for (const _CyanStrChunk *c = sb->head; c; c = c->next) {
+        memcpy(out, c->data, c->len);
+        out += c->len;
+    }
+    return s;
+}
+
+#if CYAN_HAS_STRING_BUILDER_IOVEC
+
+/**
+ * @brief Describe the builder's chunks as an iovec array
+ * @param sb Pointer to the builder
+ * @param iov Array to fill
+ * @param max Capacity of iov (string_builder_chunk_count always suffices)
+ * @return Number of entries written; empty chunks are skipped
+ * @note Entries point into the builder and are valid until it is cleared or freed
+ */
+static inline size_t string_builder_to_iovec(const StringBuilder *sb, struct iovec *iov, size_t max) {
+    size_t n = 0;
+    for (const _CyanStrChunk *c = sb->head; c && n < max; c = c->next) {
+        if (c->len == 0) continue;
+        iov[n].iov_base = (void *)c->data;
+        iov[n].iov_len = c->len;
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Write the builder's contents to a file descriptor
+ * @param sb Pointer to the builder
+ * @param fd Destination file descriptor
+ * @return Number of bytes written (string_builder_len on success), or -1
+ *         with errno set if a write failed (EIO if writev wrote nothing)
+ * @note Issues writev calls over batches of chunks and resumes after
+ *       partial writes and EINTR
+ */
+static inline ssize_t string_builder_writev(const StringBuilder *sb, int fd) {
+    enum { BATCH = 64 };
+    struct iovec iov[BATCH];
+    const _CyanStrChunk *c = sb->head;
+    size_t offset = 0;   /* Bytes of c already written */
+    size_t total = 0;
+
+    while (c) {
+        /* Gather up to BATCH chunks starting at the resume point */
+        int n = 0;
+        for (const _CyanStrChunk *g = c; g && n < BATCH; g = g->next) {
+            size_t skip = g == c ? offset : 0;
+            if (g->len == skip) continue;
+            iov[n].iov_base = (void *)(g->data + skip);
+            iov[n].iov_len = g->len - skip;
+            n++;
+        }
+        if (n == 0) break;
+
+        ssize_t w = writev(fd, iov, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (w == 0) {
+            /* No progress with bytes left; retrying would spin forever */
+            errno = EIO;
+            return -1;
+        }
+        total += (size_t)w;
+
+        /* Advance past the bytes the kernel accepted */
+        size_t left = (size_t)w;
+        while (c && left >= c->len - offset) {
+            left -= c->len - offset;
+            offset = 0;
+            c = c->next;
+        }
+        offset += left;
+    }
+    return (ssize_t)total;
+}
+
+#endif /* CYAN_HAS_STRING_BUILDER_IOVEC */
+
+/*============================================================================
+ * Cleanup
+ *============================================================================*/
+
+/**
+ * @brief Remove all content, keeping the first chunk for reuse
+ * @param sb Pointer to the builder
+ */
+static inline void string_builder_clear(StringBuilder *sb) {
+    if (!sb->head) return;
+    _CyanStrChunk *c = sb->head->next;
+    while (c) {
+        _CyanStrChunk *next = c->next;
+        free(c);
+        c = next;
+    }
+    sb->head->next = NULL;
+    sb->head->len = 0;
+    sb->tail = sb->head;
+    sb->chunks = 1;
+    sb->len = 0;
+}
+
+/**
+ * @brief Free every chunk owned by the builder
+ * @param sb Pointer to the builder
+ * @note Resets the builder to empty state; chunk_size is kept
+ */
+static inline void string_builder_free(StringBuilder *sb) {
+    _CyanStrChunk *c = sb->head;
+    while (c) {
+        _CyanStrChunk *next = c->next;
+        free(c);
+        c = next;
+    }
+    sb->head = NULL;
+    sb->tail = NULL;
+    sb->chunks = 0;
+    sb->len = 0;
+}
+
+/**
+ * @brief Declare a builder with automatic cleanup on scope exit
+ * @param name Variable name
+ * @param init Initializer expression (e.g., string_builder_new())
+ */
+#define string_builder_auto(name, init) \
+    __attribute__((cleanup(string_builder_free))) StringBuilder name = (init)
+
+/*============================================================================
+ * Vtable Instance
+ *============================================================================*/
+
+/**
+ * @brief Static const vtable instance shared by all StringBuilder instances
+ */
+static const StringBuilderVT _string_builder_vt = {
+    .push = string_builder_push,
+    .append = string_builder_append,
+    .len = string_builder_len,
+    .join = string_builder_join,
+    .free = string_builder_free
+};
+
+#endif /* CYAN_STRING_BUILDER_H */
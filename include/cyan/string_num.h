@@ -0,0 +1,228 @@
+/**
+ * @file string_num.h
+ * @brief Fast integer and floating-point formatting into String
+ *
+ * Appends numbers to a String without going through printf, using the
+ * formatters of numfmt.h:
+ * - string_append_u64 / string_append_i64 size the output from the bit
+ *   length and write digit pairs straight into the spare capacity
+ * - string_append_hex writes lowercase hex digits without a prefix
+ * - string_append_f64 / string_append_f32 write the shortest decimal that
+ *   reads back as the same double or float
+ * - string_fmt appends a list of values, picking the appender for each
+ *   argument's type at compile time, so there is no format string to parse
+ *
+ * Usage:
+ *   String line = string_new();
+ *   string_append(&line, "latency_us=");
+ *   string_append_u64(&line, 1250);
+ *   string_append(&line, " ratio=");
+ *   string_append_f64(&line, 0.1);      // "0.1", not "0.10000000000000001"
+ *   string_append(&line, " id=");
+ *   string_append_hex(&line, 0xbeef);   // "beef"
+ *
+ *   // Same line in one call
+ *   string_fmt(&line, "latency_us=", 1250, " ratio=", 0.1, " id=", string_fmt_hex(0xbeef));
+ */
+
+#ifndef CYAN_STRING_NUM_H
+#define CYAN_STRING_NUM_H
+
+#include "common.h"
+#include "numfmt.h"
+#include "string.h"
+#include <string.h>
+
+/*============================================================================
+ * Appending to String
+ *============================================================================*/
+
+/**
+ * @brief Append an unsigned integer in decimal
+ * @param s Pointer to the string
+ * @param v Value to append
+ */
+static inline void string_append_u64(String *s, u64 v) {
+    size_t n = _cyan_u64_digits(v);
+    _string_check_capacity(s, n);
+    size_t len = _string_len(s);
+    _cyan_write_digits(_string_buf(s) + len, v, n);
+    _string_set_len(s, len + n);
+}
+
+/**
+ * @brief Append a signed integer in decimal
+ * @param s Pointer to the string
+ * @param v Value to append
+ */
+static inline void string_append_i64(String *s, i64 v) {
+    u64 mag = v < 0 ? 0 - (u64)v : (u64)v;
+    size_t neg = v < 0;
+    size_t n = _cyan_u64_digits(mag);
+    _string_check_capacity(s, neg + n);
+    size_t len = _string_len(s);
+    char *p = _string_buf(s) + len;
+    *p = '-';
+    _cyan_write_digits(p + neg, mag, n);
+    _string_set_len(s, len + neg + n);
+}
+
+/**
+ * @brief Append an unsigned integer in lowercase hexadecimal, without "0x"
+ * @param s Pointer to the string
+ * @param v Value to append
+ */
+static inline void string_append_hex(String *s, u64 v) {
+    size_t n = ((size_t)(64 - __builtin_clzll(v | 1)) + 3) / 4;
+    _string_check_capacity(s, n);
+    size_t len = _string_len(s);
+    cyan_fmt_hex(_string_buf(s) + len, v);
+    _string_set_len(s, len + n);
+}
+
+/**
+ * @brief Append the shortest decimal that reads back as the same double
+ * @param s Pointer to the string
+ * @param v Value to append
+ * @see cyan_fmt_f64 for the layout
+ * @note Writes in place when the spare capacity can hold any double;
+ *       otherwise formats on the stack first so short numbers can stay inline
+ */
+static inline void string_append_f64(String *s, double v) {
+    size_t len = _string_len(s);
+    if (string_capacity(s) - len >= CYAN_FMT_F64_MAX) {
+        _string_set_len(s, len + cyan_fmt_f64(_string_buf(s) + len, v));
+        return;
+    }
+    char tmp[CYAN_FMT_F64_MAX];
+    size_t n = cyan_fmt_f64(tmp, v);
+    _string_check_capacity(s, n);
+    memcpy(_string_buf(s) + len, tmp, n);
+    _string_set_len(s, len + n);
+}
+
+/**
+ * @brief Append the shortest decimal that reads back as the same float
+ * @param s Pointer to the string
+ * @param v Value to append
+ * @see cyan_fmt_f32 for the layout
+ */
+static inline void string_append_f32(String *s, float v) {
+    size_t len = _string_len(s);
+    if (string_capacity(s) - len >= CYAN_FMT_F64_MAX) {
+        _string_set_len(s, len + cyan_fmt_f32(_string_buf(s) + len, v));
+        return;
+    }
+    char tmp[CYAN_FMT_F64_MAX];
+    size_t n = cyan_fmt_f32(tmp, v);
+    _string_check_capacity(s, n);
+    memcpy(_string_buf(s) + len, tmp, n);
+    _string_set_len(s, len + n);
+}
+
+/*============================================================================
+ * Typed Formatting
+ *============================================================================*/
+
+/**
+ * @brief Marks a value for hexadecimal output in string_fmt
+ */
+typedef struct {
+    u64 value;
+} StringFmtHex;
+
+/**
+ * @brief Wrap an unsigned value so string_fmt appends it in lowercase hex
+ * @param v Value (converted to u64)
+ */
+#define string_fmt_hex(v) ((StringFmtHex){ (u64)(v) })
+
+/* string_fmt appenders for argument types without a public appender */
+static inline void _string_fmt_bool(String *s, bool v) {
+    string_append(s, v ? "true" : "false");
+}
+
+static inline void _string_fmt_slice(String *s, Slice_char v) {
+    if (v.len == 0) return;
+    _string_check_capacity(s, v.len);
+    size_t len = _string_len(s);
+    memcpy(_string_buf(s) + len, v.data, v.len);
+    _string_set_len(s, len + v.len);
+}
+
+static inline void _string_fmt_hex(String *s, StringFmtHex v) {
+    string_append_hex(s, v.value);
+}
+
+/**
+ * @brief Append one argument using the appender for its type
+ */
+#define _CYAN_FMT_ARG(s, x) _Generic((x), \
+    char *: string_append, \
+    const char *: string_append, \
+    char: string_push, \
+    signed char: string_append_i64, \
+    short: string_append_i64, \
+    int: string_append_i64, \
+    long: string_append_i64, \
+    long long: string_append_i64, \
+    unsigned char: string_append_u64, \
+    unsigned short: string_append_u64, \
+    unsigned int: string_append_u64, \
+    unsigned long: string_append_u64, \
+    unsigned long long: string_append_u64, \
+    bool: _string_fmt_bool, \
+    float: string_append_f32, \
+    double: string_append_f64, \
+    String *: string_append_str, \
+    const String *: string_append_str, \
+    Slice_char: _string_fmt_slice, \
+    StringFmtHex: _string_fmt_hex \
+)((s), (x))
+
+/* Argument counting and per-argument expansion, up to 16 arguments */
+#define _CYAN_FMT_NARGS(...) _CYAN_FMT_NARGS_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define _CYAN_FMT_NARGS_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, N, ...) N
+#define _CYAN_FMT_CAT(a, b) _CYAN_FMT_CAT_(a, b)
+#define _CYAN_FMT_CAT_(a, b) a##b
+#define _CYAN_FMT_1(s, x) _CYAN_FMT_ARG(s, x);
+#define _CYAN_FMT_2(s, x, ...) _CYAN_FMT_ARG(s, x); _CYAN_FMT_1(s, __VA_ARGS__)
+#define _CYAN_FMT_3(s, x, ...) _CYAN_FMT_ARG(s, x); _CYAN_FMT_2(s, __VA_ARGS__)
+#define _CYAN_FMT_4(s, x, ...) _CYAN_FMT_ARG(s, x); _CYAN_FMT_3(s, __VA_ARGS__)
+#define _CYAN_FMT_5(s, x, ...) _CYAN_FMT_ARG(s, x); _CYAN_FMT_4(s, __VA_ARGS__)
+#define _CYAN_FMT_6(s, x, ...) _CYAN_FMT_ARG(s, x); _CYAN_FMT_5(s, __VA_ARGS__)
+#define _CYAN_FMT_7(s, x, ...) _CYAN_FMT_ARG(s, x); _CYAN_FMT_6(s, __VA_ARGS__)
+#define _CYAN_FMT_8(s, x, ...) _CYAN_FMT_ARG(s, x); _CYAN_FMT_7(s, __VA_ARGS__)
+#define _CYAN_FMT_9(s, x, ...) _CYAN_FMT_ARG(s, x); _CYAN_FMT_8(s, __VA_ARGS__)
+#define _CYAN_FMT_10(s, x, ...) _CYAN_FMT_ARG(s, x); _CYAN_FMT_9(s, __VA_ARGS__)
+#define _CYAN_FMT_11(s, x, ...) _CYAN_FMT_ARG(s, x); _CYAN_FMT_10(s, __VA_ARGS__)
+#define _CYAN_FMT_12(s, x, ...) _CYAN_FMT_ARG(s, x); _CYAN_FMT_11(s, __VA_ARGS__)
+#define _CYAN_FMT_13(s, x, ...) _CYAN_FMT_ARG(s, x); _CYAN_FMT_12(s, __VA_ARGS__)
+#define _CYAN_FMT_14(s, x, ...) _CYAN_FMT_ARG(s, x); _CYAN_FMT_13(s, __VA_ARGS__)
+#define _CYAN_FMT_15(s, x, ...) _CYAN_FMT_ARG(s, x); _CYAN_FMT_14(s, __VA_ARGS__)
+#define _CYAN_FMT_16(s, x, ...) _CYAN_FMT_ARG(s, x); _CYAN_FMT_15(s, __VA_ARGS__)
+
+/**
+ * @brief Append each argument to a String using the appender for its type
+ * @param s Pointer to the string (evaluated once)
+ * @param ... 1 to 16 values
+ *
+ * Dispatch happens at compile time with _Generic, so nothing is parsed at
+ * run time and an unsupported argument type is a compile error:
+ * - char * / const char *: appended as text
+ * - char: appended as one character (character literals have type int)
+ * - signed and unsigned integers: decimal; bool: "true" / "false"
+ * - float / double: shortest round-trip decimal
+ * - String * / const String *: appended contents
+ * - Slice_char: appended bytes
+ * - string_fmt_hex(v): lowercase hex
+ *
+ * Example:
+ *   string_fmt(&log, ip, " - - \"", method, " ", &path, "\" ", status, " ", bytes, "\n");
+ */
+#define string_fmt(s, ...) do { \
+    String *_cyan_fmt_dst = (s); \
+    _CYAN_FMT_CAT(_CYAN_FMT_, _CYAN_FMT_NARGS(__VA_ARGS__))(_cyan_fmt_dst, __VA_ARGS__) \
+} while (0)
+
+#endif /* CYAN_STRING_NUM_H */
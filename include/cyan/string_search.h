@@ -0,0 +1,426 @@
+/**
+ * @file string_search.h
+ * @brief Substring search and splitting over String and Slice_char
+ *
+ * Search functions work on byte ranges and never allocate:
+ * - find / rfind / contains / count locate a needle in a haystack
+ * - find_byte / rfind_byte locate a single byte
+ * - split iterators yield Slice_char views of the pieces between separators
+ *
+ * Needles of two or more bytes use a SIMD first-and-last-byte filter on
+ * x86: a block of 16 (SSE2) or 32 (AVX2, when the running CPU supports it)
+ * candidate positions is compared against the needle's first and last
+ * byte at once, and only positions matching both are checked with memcmp.
+ * Other targets use memchr on the first byte followed by memcmp.
+ *
+ * Usage:
+ *   String line = string_from("GET /index.html HTTP/1.1");
+ *   Option_size_t at = string_find(&line, "HTTP/");   // Some(16)
+ *
+ *   SplitIter it = string_split_iter(&line, " ");
+ *   Slice_char word;
+ *   while (split_iter_next(&it, &word)) {
+ *       printf("%.*s\n", (int)word.len, word.data);
+ *   }
+ *
+ * Defines Option_size_t for search results.
+ */
+
+#ifndef CYAN_STRING_SEARCH_H
+#define CYAN_STRING_SEARCH_H
+
+#include "common.h"
+#include "option.h"
+#include "slice.h"
+#include "string.h"
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__) && \
+    (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define _CYAN_STR_HAS_X86_SIMD 1
+#else
+#define _CYAN_STR_HAS_X86_SIMD 0
+#endif
+
+/*============================================================================
+ * Type Definitions
+ *============================================================================*/
+
+/* Define Option_size_t for search results */
+OPTION_DEFINE(size_t);
+
+/**
+ * @brief Iterator over the pieces of a byte range between separators
+ *
+ * Splitting "a,,b" on "," yields "a", "" and "b"; an input with no
+ * separator yields itself once, including the empty input.
+ */
+typedef struct {
+    const char *rest;     /* Start of the unsplit remainder */
+    size_t rest_len;      /* Bytes in the remainder */
+    Slice_char sep;       /* Separator bytes */
+    bool done;            /* Set once the final piece was produced */
+} SplitIter;
+
+/*============================================================================
+ * SIMD Kernels
+ *============================================================================*/
+
+#if _CYAN_STR_HAS_X86_SIMD
+
+/* Index of the lowest / highest set bit of a non-zero mask */
+#define _CYAN_STR_CTZ(x) ((size_t)__builtin_ctz(x))
+#define _CYAN_STR_HIGH(x) ((size_t)(31 - __builtin_clz(x)))
+
+/**
+ * @brief First occurrence of needle (m >= 2), 16 candidates per step
+ */
+static inline size_t _cyan_str_find_sse2(const char *h, size_t n, const char *nd, size_t m) {
+    const __m128i first = _mm_set1_epi8(nd[0]);
+    const __m128i last = _mm_set1_epi8(nd[m - 1]);
+    size_t i = 0;
+    for (; i + m - 1 + 16 <= n; i += 16) {
+        __m128i bf = _mm_loadu_si128((const __m128i *)(h + i));
+        __m128i bl = _mm_loadu_si128((const __m128i *)(h + i + m - 1));
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, bf), _mm_cmpeq_epi8(last, bl)));
+        while (mask) {
+            size_t at = i + _CYAN_STR_CTZ(mask);
+            if (memcmp(h + at + 1, nd + 1, m - 2) == 0) return at;
+            mask &= mask - 1;
+        }
+    }
+    for (; i + m <= n; i++) {
+        if (h[i] == nd[0] && memcmp(h + i + 1, nd + 1, m - 1) == 0) return i;
+    }
+    return SIZE_MAX;
+}
+
+/**
+ * @brief First occurrence of needle (m >= 2), 32 candidates per step
+ */
+__attribute__((target("avx2")))
+static inline size_t _cyan_str_find_avx2(const char *h, size_t n, const char *nd, size_t m) {
+    const __m256i first = _mm256_set1_epi8(nd[0]);
+    const __m256i last = _mm256_set1_epi8(nd[m - 1]);
+    size_t i = 0;
+    /* Two blocks per step; a single test skips 64 candidates with no match */
+    for (; i + m - 1 + 64 <= n; i += 64) {
+        __m256i e0 = _mm256_and_si256(
+            _mm256_cmpeq_epi8(first, _mm256_loadu_si256((const __m256i *)(h + i))),
+            _mm256_cmpeq_epi8(last, _mm256_loadu_si256((const __m256i *)(h + i + m - 1))));
+        __m256i e1 = _mm256_and_si256(
+            _mm256_cmpeq_epi8(first, _mm256_loadu_si256((const __m256i *)(h + i + 32))),
+            _mm256_cmpeq_epi8(last, _mm256_loadu_si256((const __m256i *)(h + i + 32 + m - 1))));
+        if (_mm256_testz_si256(_mm256_or_si256(e0, e1), _mm256_or_si256(e0, e1))) continue;
+        uint64_t mask = (uint64_t)(uint32_t)_mm256_movemask_epi8(e0) |
+                        ((uint64_t)(uint32_t)_mm256_movemask_epi8(e1) << 32);
+        while (mask) {
+            size_t at = i + (size_t)__builtin_ctzll(mask);
+            if (memcmp(h + at + 1, nd + 1, m - 2) == 0) return at;
+            mask &= mask - 1;
+        }
+    }
+    size_t rest = _cyan_str_find_sse2(h + i, n - i, nd, m);
+    return rest == SIZE_MAX ? SIZE_MAX : i + rest;
+}
+
+/**
+ * @brief Last occurrence of needle (m >= 2), 16 candidates per step
+ */
+static inline size_t _cyan_str_rfind_sse2(const char *h, size_t n, const char *nd, size_t m) {
+    const __m128i first = _mm_set1_epi8(nd[0]);
+    const __m128i last = _mm_set1_epi8(nd[m - 1]);
+    size_t end = n - m + 1;   /* One past the last candidate start */
+    while (end >= 16) {
+        size_t i = end - 16;
+        __m128i bf = _mm_loadu_si128((const __m128i *)(h + i));
+        __m128i bl = _mm_loadu_si128((const __m128i *)(h + i + m - 1));
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, bf), _mm_cmpeq_epi8(last, bl)));
+        while (mask) {
+            size_t bit = _CYAN_STR_HIGH(mask);
+            if (memcmp(h + i + bit + 1, nd + 1, m - 2) == 0) return i + bit;
+            mask &= ~(1u << bit);
+        }
+        end = i;
+    }
+    while (end > 0) {
+        end--;
+        if (h[end] == nd[0] && memcmp(h + end + 1, nd + 1, m - 1) == 0) return end;
+    }
+    return SIZE_MAX;
+}
+
+/**
+ * @brief Last occurrence of a byte, 16 bytes per step
+ */
+static inline size_t _cyan_str_rfind_byte_sse2(const char *h, size_t n, char c) {
+    const __m128i v = _mm_set1_epi8(c);
+    while (n >= 16) {
+        n -= 16;
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_cmpeq_epi8(v, _mm_loadu_si128((const __m128i *)(h + n))));
+        if (mask) return n + _CYAN_STR_HIGH(mask);
+    }
+    while (n > 0) {
+        n--;
+        if (h[n] == c) return n;
+    }
+    return SIZE_MAX;
+}
+
+#endif /* _CYAN_STR_HAS_X86_SIMD */
+
+/*============================================================================
+ * Byte-Range Search
+ *============================================================================*/
+
+/**
+ * @brief Position of the first occurrence of needle in hay
+ * @return Byte offset, or SIZE_MAX if not found
+ */
+static inline size_t _cyan_str_find(const char *h, size_t n, const char *nd, size_t m) {
+    if (m == 0) return 0;
+    if (m > n) return SIZE_MAX;
+    if (m == 1) {
+        const char *p = (const char *)memchr(h, nd[0], n);
+        return p ? (size_t)(p - h) : SIZE_MAX;
+    }
+#if _CYAN_STR_HAS_X86_SIMD
+    if (n >= 64 && __builtin_cpu_supports("avx2")) {
+        return _cyan_str_find_avx2(h, n, nd, m);
+    }
+    return _cyan_str_find_sse2(h, n, nd, m);
+#else
+    const char *p = h;
+    const char *stop = h + (n - m) + 1;
+    while (p < stop) {
+        p = (const char *)memchr(p, nd[0], (size_t)(stop - p));
+        if (!p) return SIZE_MAX;
+        if (memcmp(p + 1, nd + 1, m - 1) == 0) return (size_t)(p - h);
+        p++;
+    }
+    return SIZE_MAX;
+#endif
+}
+
+/**
+ * @brief Position of the last occurrence of a byte in hay
+ * @return Byte offset, or SIZE_MAX if not found
+ */
+static inline size_t _cyan_str_rfind_byte(const char *h, size_t n, char c) {
+#if _CYAN_STR_HAS_X86_SIMD
+    return _cyan_str_rfind_byte_sse2(h, n, c);
+#else
+    while (n > 0) {
+        n--;
+        if (h[n] == c) return n;
+    }
+    return SIZE_MAX;
+#endif
+}
+
+/**
+ * @brief Position of the last occurrence of needle in hay
+ * @return Byte offset, or SIZE_MAX if not found
+ */
+static inline size_t _cyan_str_rfind(const char *h, size_t n, const char *nd, size_t m) {
+    if (m == 0) return n;
+    if (m > n) return SIZE_MAX;
+    if (m == 1) return _cyan_str_rfind_byte(h, n, nd[0]);
+#if _CYAN_STR_HAS_X86_SIMD
+    return _cyan_str_rfind_sse2(h, n, nd, m);
+#else
+    for (size_t i = n - m + 1; i-- > 0;) {
+        if (h[i] == nd[0] && memcmp(h + i + 1, nd + 1, m - 1) == 0) return i;
+    }
+    return SIZE_MAX;
+#endif
+}
+
+/* Wrap a byte offset from the search helpers as an Option */
+static inline Option_size_t _cyan_str_pos(size_t pos) {
+    return pos == SIZE_MAX ? None(size_t) : Some(size_t, pos);
+}
+
+/*============================================================================
+ * Slice Search
+ *============================================================================*/
+
+/**
+ * @brief Find the first occurrence of a needle
+ * @param hay Slice to search
+ * @param needle Bytes to find
+ * @return Some(offset) of the first match, or None
+ * @note An empty needle matches at offset 0
+ */
+static inline Option_size_t slice_char_find(Slice_char hay, Slice_char needle) {
+    return _cyan_str_pos(_cyan_str_find(hay.data, hay.len, needle.data, needle.len));
+}
+
+/**
+ * @brief Find the last occurrence of a needle
+ * @param hay Slice to search
+ * @param needle Bytes to find
+ * @return Some(offset) of the last match, or None
+ * @note An empty needle matches at offset hay.len
+ */
+static inline Option_size_t slice_char_rfind(Slice_char hay, Slice_char needle) {
+    return _cyan_str_pos(_cyan_str_rfind(hay.data, hay.len, needle.data, needle.len));
+}
+
+/**
+ * @brief Find the first occurrence of a byte
+ * @param hay Slice to search
+ * @param c Byte to find
+ * @return Some(offset), or None
+ */
+static inline Option_size_t slice_char_find_byte(Slice_char hay, char c) {
+    const char *p = hay.len ? (const char *)memchr(hay.data, c, hay.len) : NULL;
+    return p ? Some(size_t, (size_t)(p - hay.data)) : None(size_t);
+}
+
+/**
+ * @brief Find the last occurrence of a byte
+ * @param hay Slice to search
+ * @param c Byte to find
+ * @return Some(offset), or None
+ */
+static inline Option_size_t slice_char_rfind_byte(Slice_char hay, char c) {
+    return _cyan_str_pos(_cyan_str_rfind_byte(hay.data, hay.len, c));
+}
+
+/**
+ * @brief Check whether a needle occurs in a slice
+ * @param hay Slice to search
+ * @param needle Bytes to find
+ * @return true if needle occurs (always true for an empty needle)
+ */
+static inline bool slice_char_contains(Slice_char hay, Slice_char needle) {
+    return _cyan_str_find(hay.data, hay.len, needle.data, needle.len) != SIZE_MAX;
+}
+
+/**
+ * @brief Count non-overlapping occurrences of a needle
+ * @param hay Slice to search
+ * @param needle Bytes to count
+ * @return Number of matches, scanning left to right; an empty needle
+ *         matches hay.len + 1 times (before every byte and at the end)
+ */
+static inline size_t slice_char_count(Slice_char hay, Slice_char needle) {
+    if (needle.len == 0) return hay.len + 1;
+    size_t count = 0;
+    size_t pos = 0;
+    while (pos + needle.len <= hay.len) {
+        size_t at = _cyan_str_find(hay.data + pos, hay.len - pos, needle.data, needle.len);
+        if (at == SIZE_MAX) break;
+        count++;
+        pos += at + needle.len;
+    }
+    return count;
+}
+
+/*============================================================================
+ * String Search
+ *============================================================================*/
+
+/**
+ * @brief Find the first occurrence of a C string
+ * @param s Pointer to the string
+ * @param needle Null-terminated needle
+ * @return Some(offset) of the first match, or None
+ */
+static inline Option_size_t string_find(const String *s, const char *needle) {
+    return _cyan_str_pos(_cyan_str_find(string_cstr(s), string_len(s), needle, strlen(needle)));
+}
+
+/**
+ * @brief Find the last occurrence of a C string
+ * @param s Pointer to the string
+ * @param needle Null-terminated needle
+ * @return Some(offset) of the last match, or None
+ */
+static inline Option_size_t string_rfind(const String *s, const char *needle) {
+    return _cyan_str_pos(_cyan_str_rfind(string_cstr(s), string_len(s), needle, strlen(needle)));
+}
+
+/**
+ * @brief Find the first occurrence of a byte
+ * @param s Pointer to the string
+ * @param c Byte to find
+ * @return Some(offset), or None
+ */
+static inline Option_size_t string_find_byte(const String *s, char c) {
+    return slice_char_find_byte(string_as_slice(s), c);
+}
+
+/**
+ * @brief Check whether a C string occurs in the string
+ * @param s Pointer to the string
+ * @param needle Null-terminated needle
+ * @return true if needle occurs
+ */
+static inline bool string_contains(const String *s, const char *needle) {
+    return _cyan_str_find(string_cstr(s), string_len(s), needle, strlen(needle)) != SIZE_MAX;
+}
+
+/**
+ * @brief Count non-overlapping occurrences of a C string
+ * @param s Pointer to the string
+ * @param needle Null-terminated needle
+ * @return Number of matches (see slice_char_count)
+ */
+static inline size_t string_count(const String *s, const char *needle) {
+    return slice_char_count(string_as_slice(s), slice_char_from_array(needle, strlen(needle)));
+}
+
+/*============================================================================
+ * Splitting
+ *============================================================================*/
+
+/**
+ * @brief Create an iterator over the pieces of a slice between separators
+ * @param s Slice to split
+ * @param sep Separator bytes; an empty separator yields s unsplit
+ * @return Iterator positioned before the first piece
+ * @note Pieces view s's bytes; the separator bytes must outlive the iterator
+ */
+static inline SplitIter slice_char_split_iter(Slice_char s, Slice_char sep) {
+    return (SplitIter){ .rest = s.data, .rest_len = s.len, .sep = sep, .done = false };
+}
+
+/**
+ * @brief Create an iterator over the pieces of a string between separators
+ * @param s Pointer to the string
+ * @param sep Null-terminated separator; "" yields the string unsplit
+ * @return Iterator positioned before the first piece
+ * @note Pieces are invalidated if the string is modified, moved or freed
+ */
+static inline SplitIter string_split_iter(const String *s, const char *sep) {
+    return slice_char_split_iter(string_as_slice(s), slice_char_from_array(sep, strlen(sep)));
+}
+
+/**
+ * @brief Produce the next piece
+ * @param it Pointer to the iterator
+ * @param out Receives a slice viewing the piece (possibly empty)
+ * @return true if a piece was produced, false when exhausted
+ */
+static inline bool split_iter_next(SplitIter *it, Slice_char *out) {
+    if (it->done) return false;
+    size_t at = it->sep.len == 0 ? SIZE_MAX
+              : _cyan_str_find(it->rest, it->rest_len, it->sep.data, it->sep.len);
+    if (at == SIZE_MAX) {
+        *out = (Slice_char){ .data = it->rest, .len = it->rest_len, .vt = &_slice_char_vt };
+        it->done = true;
+        return true;
+    }
+    *out = (Slice_char){ .data = it->rest, .len = at, .vt = &_slice_char_vt };
+    it->rest += at + it->sep.len;
+    it->rest_len -= at + it->sep.len;
+    return true;
+}
+
+#endif /* CYAN_STRING_SEARCH_H */
@@ -0,0 +1,593 @@
+/**
+ * @file strmap.h
+ * @brief String-keyed hash map for the Cyan library
+ *
+ * HASHMAP_DEFINE(K, V) hashes the sizeof(K) bytes of its key, so a
+ * `const char *` key hashes the pointer rather than the text. This header
+ * provides a map keyed by string contents instead:
+ * - Key bytes are copied into an arena owned by the map, so callers may
+ *   reuse or free their key buffers after inserting
+ * - Each entry caches its full hash, so most mismatching probes are
+ *   rejected without touching the key bytes
+ * - Lookups accept a `const char *`, a `String *` or a `Slice_char` and
+ *   never allocate
+ *
+ * Usage:
+ *   OPTION_DEFINE(int);    // Required for Option_int
+ *   STRMAP_DEFINE(int);    // Define StrMap_int type
+ *
+ *   StrMap_int m = strmap_int_new();
+ *   strmap_int_insert(&m, "content-length", 42);
+ *   Option_int val = strmap_int_get(&m, "content-length");
+ *   strmap_int_free(&m);
+ */
+
+#ifndef CYAN_STRMAP_H
+#define CYAN_STRMAP_H
+
+#include "common.h"
+#include "option.h"
+#include "hash.h"
+#include "hashmap.h"
+#include "string.h"
+#include <string.h>
+
+/*============================================================================
+ * Configuration
+ *============================================================================*/
+
+/**
+ * @brief Size of each key arena block in bytes
+ * Keys longer than a block get a dedicated block of their own.
+ */
+#ifndef CYAN_STRMAP_ARENA_BLOCK
+#define CYAN_STRMAP_ARENA_BLOCK 4096
+#endif
+
+/*============================================================================
+ * Key Arena
+ *============================================================================*/
+
+/**
+ * @brief One block of arena storage
+ */
+typedef struct _CyanArenaBlock {
+    struct _CyanArenaBlock *next;  /* Previously filled block */
+    size_t used;                   /* Bytes handed out from data */
+    size_t cap;                    /* Usable bytes in data */
+    char data[];
+} _CyanArenaBlock;
+
+/**
+ * @brief Bump allocator for key bytes
+ *
+ * Memory is only returned to the system all at once by _cyan_arena_free.
+ */
+typedef struct {
+    _CyanArenaBlock *head;  /* Block currently being filled */
+} _CyanArena;
+
+/**
+ * @brief Allocate n bytes from the arena
+ * @param a Pointer to the arena
+ * @param n Number of bytes
+ * @return Pointer to n bytes valid until the arena is freed
+ * @note Panics if allocation fails
+ */
+static inline char *_cyan_arena_alloc(_CyanArena *a, size_t n) {
+    _CyanArenaBlock *b = a->head;
+    if (!b || b->cap - b->used < n) {
+        size_t cap = n > CYAN_STRMAP_ARENA_BLOCK ? n : CYAN_STRMAP_ARENA_BLOCK;
+        _CyanArenaBlock *nb = (_CyanArenaBlock *)malloc(sizeof(_CyanArenaBlock) + cap);
+        if (!nb) CYAN_PANIC("allocation failed");
+        nb->used = 0;
+        nb->cap = cap;
+        if (b && n > CYAN_STRMAP_ARENA_BLOCK) {
+            /* Oversized block: link it behind the current one so the
+             * remaining space in the current block is not abandoned */
+            nb->next = b->next;
+            b->next = nb;
+            nb->used = n;
+            return nb->data;
+        }
+        nb->next = b;
+        a->head = b = nb;
+    }
+    char *p = b->data + b->used;
+    b->used += n;
+    return p;
+}
+
+/**
+ * @brief Copy a byte range into the arena as a null-terminated string
+ * @param a Pointer to the arena
+ * @param p Bytes to copy
+ * @param len Number of bytes
+ * @return Pointer to the copy
+ */
+static inline const char *_cyan_arena_strdup(_CyanArena *a, const char *p, size_t len) {
+    char *dst = _cyan_arena_alloc(a, len + 1);
+    if (len > 0) memcpy(dst, p, len);
+    dst[len] = '\0';
+    return dst;
+}
+
+/**
+ * @brief Release every block owned by the arena
+ * @param a Pointer to the arena
+ */
+static inline void _cyan_arena_free(_CyanArena *a) {
+    _CyanArenaBlock *b = a->head;
+    while (b) {
+        _CyanArenaBlock *next = b->next;
+        free(b);
+        b = next;
+    }
+    a->head = NULL;
+}
+
+/*============================================================================
+ * String Hashing
+ *============================================================================*/
+
+/**
+ * @brief Hash the contents of a string key under a map's seed
+ */
+static inline size_t _cyan_strmap_hash(const char *p, size_t len, uint64_t seed) {
+    return cyan_hash_wy_seeded(p, len, seed);
+}
+
+/*============================================================================
+ * StrMap Type Definition Macro
+ *============================================================================*/
+
+/**
+ * @brief Generate a string-keyed map type for a given value type
+ * @param V The value type
+ *
+ * Creates:
+ * - StrMap_V: The map structure
+ * - StrMapVT_V: Vtable structure with function pointers
+ * - StrMapEntry_V: Key-value view yielded by iteration
+ * - strmap_V_new() / strmap_V_with_capacity(cap): Constructors
+ * - strmap_V_insert(m, cstr, value): Insert or update (also _slice, _str)
+ * - strmap_V_get(m, cstr): Get value as Option (also _slice, _str)
+ * - strmap_V_contains(m, cstr): Check if key exists (also _slice, _str)
+ * - strmap_V_remove(m, cstr): Remove entry (also _slice, _str)
+ * - strmap_V_len(m): Get number of entries
+ * - strmap_V_iter(m) / strmap_V_iter_next(it): Iterate entries
+ * - strmap_V_free(m): Free map memory, including all key bytes
+ *
+ * The vtable has the same layout as HashMapVT, so MAP_INSERT, MAP_GET,
+ * MAP_CONTAINS, MAP_REMOVE, MAP_LEN and MAP_FREE work on a StrMap_V with
+ * `const char *` keys.
+ *
+ * Key bytes of removed entries stay in the arena until the map is next
+ * resized or freed. Keys are hashed with seeded wyhash under the map's
+ * seed field, which defaults to cyan_hash_process_seed.
+ *
+ * Requires: OPTION_DEFINE(V) must be called before STRMAP_DEFINE(V)
+ */
+#define STRMAP_DEFINE(V) \
+    /* Entry structure */ \
+    typedef struct { \
+        size_t hash;            /* Cached full hash of the key */ \
+        const char *key;        /* Null-terminated key bytes in the arena */ \
+        uint32_t key_len;       /* Key length excluding null terminator */ \
+        _CyanEntryState state; \
+        V value; \
+    } _StrMapEntry_##V; \
+    \
+    /* Forward declare StrMap_V for use in vtable */ \
+    typedef struct StrMap_##V StrMap_##V; \
+    \
+    /** \
+     * @brief Vtable structure for StrMap_V containing function pointers \
+     */ \
+    typedef struct { \
+        void (*insert)(StrMap_##V *m, const char *key, V value); \
+        Option_##V (*get)(StrMap_##V *m, const char *key); \
+        bool (*contains)(StrMap_##V *m, const char *key); \
+        Option_##V (*remove)(StrMap_##V *m, const char *key); \
+        size_t (*len)(StrMap_##V *m); \
+        void (*free)(StrMap_##V *m); \
+    } StrMapVT_##V; \
+    \
+    /** \
+     * @brief String-keyed map structure with vtable pointer \
+     */ \
+    struct StrMap_##V { \
+        _StrMapEntry_##V *buckets; \
+        size_t capacity; \
+        size_t len; \
+        size_t tombstones;      /* Deleted slots still in the probe chains */ \
+        _CyanArena arena;       /* Owns all key bytes */ \
+        uint64_t seed;          /* Hash seed; change only while the map is empty */ \
+        const StrMapVT_##V *vt; \
+    }; \
+    \
+    /** \
+     * @brief Key-value view yielded by iteration \
+     */ \
+    typedef struct { \
+        const char *key;        /* Null-terminated, owned by the map */ \
+        size_t key_len; \
+        V value; \
+    } StrMapEntry_##V; \
+    \
+    typedef struct { \
+        bool has_value; \
+        StrMapEntry_##V value; \
+    } Option_StrMapEntry_##V; \
+    \
+    /* Iterator structure */ \
+    typedef struct { \
+        StrMap_##V *map; \
+        size_t index; \
+    } StrMapIter_##V; \
+    \
+    /* Forward declare vtable instance */ \
+    static const StrMapVT_##V _strmap_##V##_vt; \
+    \
+    /** \
+     * @brief Create an empty string-keyed map \
+     * @return A new empty StrMap_V \
+     */ \
+    static inline StrMap_##V strmap_##V##_new(void) { \
+        return (StrMap_##V){ \
+            .buckets = NULL, \
+            .capacity = 0, \
+            .len = 0, \
+            .tombstones = 0, \
+            .arena = { NULL }, \
+            .seed = cyan_hash_process_seed(), \
+            .vt = &_strmap_##V##_vt \
+        }; \
+    } \
+    \
+    /** \
+     * @brief Create a string-keyed map with pre-allocated capacity \
+     * @param cap Initial capacity (will be rounded up to power of 2) \
+     * @return A new StrMap_V with allocated storage \
+     */ \
+    static inline StrMap_##V strmap_##V##_with_capacity(size_t cap) { \
+        size_t actual_cap = CYAN_HASHMAP_INITIAL_CAPACITY; \
+        while (actual_cap < cap) actual_cap *= 2; \
+        \
+        StrMap_##V m = strmap_##V##_new(); \
+        m.buckets = (_StrMapEntry_##V *)calloc(actual_cap, sizeof(_StrMapEntry_##V)); \
+        if (!m.buckets) CYAN_PANIC("allocation failed"); \
+        m.capacity = actual_cap; \
+        return m; \
+    } \
+    \
+    /** \
+     * @brief Find the bucket index for a key \
+     * @param m Pointer to the map \
+     * @param p Key bytes \
+     * @param len Key length \
+     * @param hash Hash of the key bytes \
+     * @param for_insert If true, returns first available slot; if false, returns exact match only \
+     * @return Bucket index, or capacity if not found (when for_insert is false) \
+     */ \
+    static inline size_t _strmap_##V##_find_bucket( \
+        const StrMap_##V *m, const char *p, size_t len, size_t hash, bool for_insert \
+    ) { \
+        if (m->capacity == 0) return 0; \
+        \
+        size_t mask = m->capacity - 1; \
+        size_t first_deleted = m->capacity; \
+        \
+        for (size_t i = 0; i < m->capacity; i++) { \
+            size_t probe_idx = (hash + i) & mask; \
+            const _StrMapEntry_##V *entry = &m->buckets[probe_idx]; \
+            \
+            if (entry->state == _CYAN_ENTRY_EMPTY) { \
+                if (for_insert) { \
+                    return (first_deleted < m->capacity) ? first_deleted : probe_idx; \
+                } \
+                return m->capacity; \
+            } \
+            \
+            if (entry->state == _CYAN_ENTRY_DELETED) { \
+                if (for_insert && first_deleted == m->capacity) { \
+                    first_deleted = probe_idx; \
+                } \
+                continue; \
+            } \
+            \
+            /* Compare cached hash and length before touching key bytes */ \
+            if (entry->hash == hash && entry->key_len == len && \
+                (len == 0 || memcmp(entry->key, p, len) == 0)) { \
+                return probe_idx; \
+            } \
+        } \
+        \
+        if (for_insert && first_deleted < m->capacity) { \
+            return first_deleted; \
+        } \
+        return m->capacity; \
+    } \
+    \
+    /** \
+     * @brief Rebuild the table at a new capacity \
+     * @param m Pointer to the map \
+     * @param new_cap New capacity (must be power of 2) \
+     * \
+     * @return The old key arena, which the caller must free \
+     * \
+     * Rehashing uses the cached hashes. Live keys are copied into a fresh \
+     * arena so bytes of removed keys are released once the old arena is \
+     * freed; until then, slices into it stay readable. \
+     */ \
+    static inline _CyanArena _strmap_##V##_rehash(StrMap_##V *m, size_t new_cap) { \
+        _StrMapEntry_##V *old_buckets = m->buckets; \
+        size_t old_cap = m->capacity; \
+        _CyanArena old_arena = m->arena; \
+        \
+        m->buckets = (_StrMapEntry_##V *)calloc(new_cap, sizeof(_StrMapEntry_##V)); \
+        if (!m->buckets) { \
+            m->buckets = old_buckets; \
+            CYAN_PANIC("allocation failed"); \
+        } \
+        m->capacity = new_cap; \
+        m->tombstones = 0; \
+        m->arena.head = NULL; \
+        \
+        size_t mask = new_cap - 1; \
+        for (size_t i = 0; i < old_cap; i++) { \
+            _StrMapEntry_##V *old = &old_buckets[i]; \
+            if (old->state != _CYAN_ENTRY_OCCUPIED) continue; \
+            \
+            /* Keys are unique, so the first free slot is the target */ \
+            size_t idx = old->hash & mask; \
+            while (m->buckets[idx].state != _CYAN_ENTRY_EMPTY) { \
+                idx = (idx + 1) & mask; \
+            } \
+            m->buckets[idx] = *old; \
+            m->buckets[idx].key = _cyan_arena_strdup(&m->arena, old->key, old->key_len); \
+        } \
+        \
+        free(old_buckets); \
+        return old_arena; \
+    } \
+    \
+    /** \
+     * @brief Insert or update a key given as a byte range \
+     * @param m Pointer to the map \
+     * @param key Slice viewing the key bytes \
+     * @param value The value \
+     * @note The key bytes are copied; the caller keeps ownership of key \
+     */ \
+    static inline void strmap_##V##_insert_slice(StrMap_##V *m, Slice_char key, V value) { \
+        if (key.len > UINT32_MAX) CYAN_PANIC("strmap key too long"); \
+        if (m->capacity == 0) { \
+            uint64_t seed = m->seed; \
+            *m = strmap_##V##_with_capacity(CYAN_HASHMAP_INITIAL_CAPACITY); \
+            m->seed = seed; \
+        } \
+        \
+        size_t hash = _cyan_strmap_hash(key.data, key.len, m->seed); \
+        \
+        /* Tombstones lengthen probe chains just like live entries. Only a \
+         * new key may resize, so updating through a key slice into the \
+         * map's own arena is safe; the old arena is kept until the new key \
+         * is copied, in case it views bytes of a removed key */ \
+        _CyanArena old_arena = { NULL }; \
+        if ((m->len + m->tombstones + 1) * 100 / m->capacity > CYAN_HASHMAP_LOAD_FACTOR) { \
+            size_t found = _strmap_##V##_find_bucket(m, key.data, key.len, hash, false); \
+            if (found < m->capacity) { \
+                m->buckets[found].value = value; \
+                return; \
+            } \
+            size_t new_cap = m->capacity; \
+            if ((m->len + 1) * 100 / m->capacity > CYAN_HASHMAP_LOAD_FACTOR / 2) new_cap *= 2; \
+            old_arena = _strmap_##V##_rehash(m, new_cap); \
+        } \
+        \
+        size_t idx = _strmap_##V##_find_bucket(m, key.data, key.len, hash, true); \
+        _StrMapEntry_##V *entry = &m->buckets[idx]; \
+        \
+        if (entry->state != _CYAN_ENTRY_OCCUPIED) { \
+            if (entry->state == _CYAN_ENTRY_DELETED) m->tombstones--; \
+            entry->hash = hash; \
+            entry->key = _cyan_arena_strdup(&m->arena, key.data, key.len); \
+            entry->key_len = (uint32_t)key.len; \
+            entry->state = _CYAN_ENTRY_OCCUPIED; \
+            m->len++; \
+        } \
+        entry->value = value; \
+        _cyan_arena_free(&old_arena); \
+    } \
+    \
+    /** \
+     * @brief Insert or update a key given as a C string \
+     * @param m Pointer to the map \
+     * @param key Null-terminated key \
+     * @param value The value \
+     */ \
+    static inline void strmap_##V##_insert(StrMap_##V *m, const char *key, V value) { \
+        strmap_##V##_insert_slice(m, slice_char_from_array(key, strlen(key)), value); \
+    } \
+    \
+    /** \
+     * @brief Insert or update a key given as a String \
+     * @param m Pointer to the map \
+     * @param key Pointer to the key string \
+     * @param value The value \
+     */ \
+    static inline void strmap_##V##_insert_str(StrMap_##V *m, const String *key, V value) { \
+        strmap_##V##_insert_slice(m, string_as_slice(key), value); \
+    } \
+    \
+    /* Internal: locate an occupied bucket for a byte range, or capacity */ \
+    static inline size_t _strmap_##V##_lookup(const StrMap_##V *m, const char *p, size_t len) { \
+        if (m->capacity == 0) return 0; \
+        return _strmap_##V##_find_bucket(m, p, len, _cyan_strmap_hash(p, len, m->seed), false); \
+    } \
+    \
+    /** \
+     * @brief Get value by key given as a byte range \
+     * @param m Pointer to the map \
+     * @param key Slice viewing the key bytes \
+     * @return Option_V containing the value if found, None otherwise \
+     */ \
+    static inline Option_##V strmap_##V##_get_slice(StrMap_##V *m, Slice_char key) { \
+        size_t idx = _strmap_##V##_lookup(m, key.data, key.len); \
+        if (idx >= m->capacity) return None(V); \
+        return Some(V, m->buckets[idx].value); \
+    } \
+    \
+    /** \
+     * @brief Get value by key given as a C string \
+     * @param m Pointer to the map \
+     * @param key Null-terminated key \
+     * @return Option_V containing the value if found, None otherwise \
+     */ \
+    static inline Option_##V strmap_##V##_get(StrMap_##V *m, const char *key) { \
+        return strmap_##V##_get_slice(m, slice_char_from_array(key, strlen(key))); \
+    } \
+    \
+    /** \
+     * @brief Get value by key given as a String \
+     * @param m Pointer to the map \
+     * @param key Pointer to the key string \
+     * @return Option_V containing the value if found, None otherwise \
+     */ \
+    static inline Option_##V strmap_##V##_get_str(StrMap_##V *m, const String *key) { \
+        return strmap_##V##_get_slice(m, string_as_slice(key)); \
+    } \
+    \
+    /** \
+     * @brief Check if a key given as a byte range exists \
+     * @param m Pointer to the map \
+     * @param key Slice viewing the key bytes \
+     * @return true if key exists, false otherwise \
+     */ \
+    static inline bool strmap_##V##_contains_slice(StrMap_##V *m, Slice_char key) { \
+        return _strmap_##V##_lookup(m, key.data, key.len) < m->capacity; \
+    } \
+    \
+    /** \
+     * @brief Check if a key given as a C string exists \
+     * @param m Pointer to the map \
+     * @param key Null-terminated key \
+     * @return true if key exists, false otherwise \
+     */ \
+    static inline bool strmap_##V##_contains(StrMap_##V *m, const char *key) { \
+        return strmap_##V##_contains_slice(m, slice_char_from_array(key, strlen(key))); \
+    } \
+    \
+    /** \
+     * @brief Check if a key given as a String exists \
+     * @param m Pointer to the map \
+     * @param key Pointer to the key string \
+     * @return true if key exists, false otherwise \
+     */ \
+    static inline bool strmap_##V##_contains_str(StrMap_##V *m, const String *key) { \
+        return strmap_##V##_contains_slice(m, string_as_slice(key)); \
+    } \
+    \
+    /** \
+     * @brief Remove a key given as a byte range \
+     * @param m Pointer to the map \
+     * @param key Slice viewing the key bytes \
+     * @return Option_V containing the removed value if found, None otherwise \
+     */ \
+    static inline Option_##V strmap_##V##_remove_slice(StrMap_##V *m, Slice_char key) { \
+        size_t idx = _strmap_##V##_lookup(m, key.data, key.len); \
+        if (idx >= m->capacity) return None(V); \
+        \
+        V value = m->buckets[idx].value; \
+        m->buckets[idx].state = _CYAN_ENTRY_DELETED; \
+        m->len--; \
+        m->tombstones++; \
+        return Some(V, value); \
+    } \
+    \
+    /** \
+     * @brief Remove a key given as a C string \
+     * @param m Pointer to the map \
+     * @param key Null-terminated key \
+     * @return Option_V containing the removed value if found, None otherwise \
+     */ \
+    static inline Option_##V strmap_##V##_remove(StrMap_##V *m, const char *key) { \
+        return strmap_##V##_remove_slice(m, slice_char_from_array(key, strlen(key))); \
+    } \
+    \
+    /** \
+     * @brief Remove a key given as a String \
+     * @param m Pointer to the map \
+     * @param key Pointer to the key string \
+     * @return Option_V containing the removed value if found, None otherwise \
+     */ \
+    static inline Option_##V strmap_##V##_remove_str(StrMap_##V *m, const String *key) { \
+        return strmap_##V##_remove_slice(m, string_as_slice(key)); \
+    } \
+    \
+    /** \
+     * @brief Get the number of entries in the map \
+     * @param m Pointer to the map \
+     * @return Number of entries \
+     */ \
+    static inline size_t strmap_##V##_len(StrMap_##V *m) { \
+        return m->len; \
+    } \
+    \
+    /** \
+     * @brief Create an iterator over the map's entries \
+     * @param m Pointer to the map \
+     * @return Iterator positioned before the first entry \
+     */ \
+    static inline StrMapIter_##V strmap_##V##_iter(StrMap_##V *m) { \
+        return (StrMapIter_##V){ .map = m, .index = 0 }; \
+    } \
+    \
+    /** \
+     * @brief Get the next entry from the iterator \
+     * @param it Pointer to the iterator \
+     * @return Option containing the entry, or None if iteration complete \
+     * @note Yielded key pointers stay valid until the map is resized or \
+     *       freed; only inserting a new key resizes \
+     */ \
+    static inline Option_StrMapEntry_##V strmap_##V##_iter_next(StrMapIter_##V *it) { \
+        while (it->index < it->map->capacity) { \
+            _StrMapEntry_##V *entry = &it->map->buckets[it->index]; \
+            it->index++; \
+            \
+            if (entry->state == _CYAN_ENTRY_OCCUPIED) { \
+                StrMapEntry_##V e = { .key = entry->key, .key_len = entry->key_len, .value = entry->value }; \
+                return (Option_StrMapEntry_##V){ .has_value = true, .value = e }; \
+            } \
+        } \
+        return (Option_StrMapEntry_##V){ .has_value = false }; \
+    } \
+    \
+    /** \
+     * @brief Free all memory associated with the map, including key bytes \
+     * @param m Pointer to the map \
+     */ \
+    static inline void strmap_##V##_free(StrMap_##V *m) { \
+        free(m->buckets); \
+        _cyan_arena_free(&m->arena); \
+        m->buckets = NULL; \
+        m->capacity = 0; \
+        m->len = 0; \
+        m->tombstones = 0; \
+    } \
+    \
+    /** \
+     * @brief Static const vtable instance shared by all StrMap_V instances \
+     */ \
+    static const StrMapVT_##V _strmap_##V##_vt = { \
+        .insert = strmap_##V##_insert, \
+        .get = strmap_##V##_get, \
+        .contains = strmap_##V##_contains, \
+        .remove = strmap_##V##_remove, \
+        .len = strmap_##V##_len, \
+        .free = strmap_##V##_free \
+    }; \
+    /* Dummy typedef to absorb trailing semicolon */ \
+    typedef StrMap_##V StrMap_##V##_defined
+
+#endif /* CYAN_STRMAP_H */
@@ -0,0 +1,637 @@
+/**
+ * @file utf8.h
+ * @brief UTF-8 validation, counting, iteration and transcoding
+ *
+ * String stores raw bytes; these functions read them as UTF-8:
+ * - validate checks a byte range against the Unicode well-formedness rules
+ *   (no overlongs, surrogates, values above U+10FFFF or truncated sequences)
+ * - count returns the number of code points in valid UTF-8
+ * - Utf8Iter decodes one code point at a time
+ * - to_utf16 / to_utf32 and string_append_utf16 / _utf32 transcode
+ *
+ * Validation on x86 uses the lookup-table algorithm of Keiser and Lemire:
+ * each byte and its predecessor index three 16-entry tables (high nibble
+ * of the previous byte, low nibble of the previous byte, high nibble of
+ * the current byte) whose AND is non-zero exactly for an invalid pair.
+ * A second check requires continuation bytes two and three positions
+ * after 3- and 4-byte leads. With AVX2 (when the running CPU supports it)
+ * this checks 32 bytes per step with no branches; all-ASCII blocks skip
+ * the tables. Counting and the ASCII runs of transcoding use SSE2. Other
+ * targets use a scalar decoder that skips ASCII eight bytes at a time.
+ *
+ * Usage:
+ *   Slice_char body = slice_char_from_array(buf, n);
+ *   if (!slice_char_utf8_validate(body)) return reject(400);
+ *   size_t chars = slice_char_utf8_count(body);
+ *
+ *   Utf8Iter it = slice_char_utf8_iter(body);
+ *   u32 cp;
+ *   while (utf8_iter_next(&it, &cp)) {
+ *       ...
+ *   }
+ */
+
+#ifndef CYAN_UTF8_H
+#define CYAN_UTF8_H
+
+#include "common.h"
+#include "option.h"
+#include "slice.h"
+#include "string.h"
+#include "string_search.h"
+#include <string.h>
+
+/*============================================================================
+ * Type Definitions
+ *============================================================================*/
+
+/** @brief Replacement character yielded for invalid bytes */
+#define UTF8_REPLACEMENT 0xFFFDu
+
+/**
+ * @brief Iterator over the code points of a byte range
+ *
+ * Invalid input yields U+FFFD once per maximal invalid subpart (a lead byte
+ * and the continuation bytes that fit it before the sequence breaks), the
+ * replacement policy recommended by the Unicode standard.
+ */
+typedef struct {
+    const char *pos;   /* Next undecoded byte */
+    const char *end;   /* One past the last byte */
+} Utf8Iter;
+
+/*============================================================================
+ * Scalar Decoding
+ *============================================================================*/
+
+/**
+ * @brief Decode the sequence starting at p (p < end)
+ * @param cp Receives the code point when valid
+ * @return Sequence length (1..4), or minus the length of the maximal
+ *         invalid subpart to skip
+ */
+static inline int _cyan_utf8_decode(const unsigned char *p, const unsigned char *end, u32 *cp) {
+    unsigned char b = p[0];
+    if (b < 0x80) {
+        *cp = b;
+        return 1;
+    }
+    /* Allowed range of the second byte per lead (Unicode Table 3-7) */
+    unsigned char lo = 0x80, hi = 0xBF;
+    int need;
+    u32 c;
+    if (b < 0xC2) {
+        return -1;
+    } else if (b < 0xE0) {
+        need = 1;
+        c = b & 0x1F;
+    } else if (b < 0xF0) {
+        need = 2;
+        c = b & 0x0F;
+        if (b == 0xE0) lo = 0xA0;
+        else if (b == 0xED) hi = 0x9F;
+    } else if (b < 0xF5) {
+        need = 3;
+        c = b & 0x07;
+        if (b == 0xF0) lo = 0x90;
+        else if (b == 0xF4) hi = 0x8F;
+    } else {
+        return -1;
+    }
+    for (int i = 1; i <= need; i++) {
+        if (p + i >= end || p[i] < lo || p[i] > hi) return -i;
+        c = (c << 6) | (p[i] & 0x3F);
+        lo = 0x80;
+        hi = 0xBF;
+    }
+    *cp = c;
+    return need + 1;
+}
+
+/**
+ * @brief Validate a byte range one sequence at a time
+ */
+static inline bool _cyan_utf8_validate_scalar(const unsigned char *p, size_t n) {
+    const unsigned char *end = p + n;
+    while (p < end) {
+        if (*p < 0x80) {
+            /* Skip the rest of an ASCII run a word at a time */
+            p++;
+            while ((size_t)(end - p) >= 8) {
+                u64 w;
+                memcpy(&w, p, 8);
+                if (w & 0x8080808080808080ULL) break;
+                p += 8;
+            }
+            continue;
+        }
+        u32 cp;
+        int len = _cyan_utf8_decode(p, end, &cp);
+        if (len < 0) return false;
+        p += len;
+    }
+    return true;
+}
+
+/*============================================================================
+ * SIMD Kernels
+ *============================================================================*/
+
+#if _CYAN_STR_HAS_X86_SIMD
+
+/* Error classes of a byte and its predecessor; a pair is invalid when the
+ * three table lookups share a class */
+#define _CYAN_UTF8_TOO_SHORT   0x01  /* Lead not followed by a continuation */
+#define _CYAN_UTF8_TOO_LONG    0x02  /* ASCII followed by a continuation */
+#define _CYAN_UTF8_OVERLONG_3  0x04  /* E0 80..9F */
+#define _CYAN_UTF8_TOO_LARGE   0x08  /* F4 90..BF, F5..FF 90..BF */
+#define _CYAN_UTF8_SURROGATE   0x10  /* ED A0..BF */
+#define _CYAN_UTF8_OVERLONG_2  0x20  /* C0..C1 80..BF */
+#define _CYAN_UTF8_LARGE_1000  0x40  /* F5..FF 80..8F */
+#define _CYAN_UTF8_OVERLONG_4  0x40  /* F0 80..8F */
+#define _CYAN_UTF8_TWO_CONTS   0x80  /* Continuation followed by a continuation */
+#define _CYAN_UTF8_CARRY (_CYAN_UTF8_TOO_SHORT | _CYAN_UTF8_TOO_LONG | _CYAN_UTF8_TWO_CONTS)
+
+/* Indexed by the high nibble of the previous byte */
+static const unsigned char _cyan_utf8_prev_high[16] = {
+    _CYAN_UTF8_TOO_LONG, _CYAN_UTF8_TOO_LONG, _CYAN_UTF8_TOO_LONG, _CYAN_UTF8_TOO_LONG,
+    _CYAN_UTF8_TOO_LONG, _CYAN_UTF8_TOO_LONG, _CYAN_UTF8_TOO_LONG, _CYAN_UTF8_TOO_LONG,
+    _CYAN_UTF8_TWO_CONTS, _CYAN_UTF8_TWO_CONTS, _CYAN_UTF8_TWO_CONTS, _CYAN_UTF8_TWO_CONTS,
+    _CYAN_UTF8_TOO_SHORT | _CYAN_UTF8_OVERLONG_2,
+    _CYAN_UTF8_TOO_SHORT,
+    _CYAN_UTF8_TOO_SHORT | _CYAN_UTF8_OVERLONG_3 | _CYAN_UTF8_SURROGATE,
+    _CYAN_UTF8_TOO_SHORT | _CYAN_UTF8_TOO_LARGE | _CYAN_UTF8_LARGE_1000 | _CYAN_UTF8_OVERLONG_4,
+};
+
+/* Indexed by the low nibble of the previous byte */
+static const unsigned char _cyan_utf8_prev_low[16] = {
+    _CYAN_UTF8_CARRY | _CYAN_UTF8_OVERLONG_3 | _CYAN_UTF8_OVERLONG_2 | _CYAN_UTF8_OVERLONG_4,
+    _CYAN_UTF8_CARRY | _CYAN_UTF8_OVERLONG_2,
+    _CYAN_UTF8_CARRY,
+    _CYAN_UTF8_CARRY,
+    _CYAN_UTF8_CARRY | _CYAN_UTF8_TOO_LARGE,
+    _CYAN_UTF8_CARRY | _CYAN_UTF8_TOO_LARGE | _CYAN_UTF8_LARGE_1000,
+    _CYAN_UTF8_CARRY | _CYAN_UTF8_TOO_LARGE | _CYAN_UTF8_LARGE_1000,
+    _CYAN_UTF8_CARRY | _CYAN_UTF8_TOO_LARGE | _CYAN_UTF8_LARGE_1000,
+    _CYAN_UTF8_CARRY | _CYAN_UTF8_TOO_LARGE | _CYAN_UTF8_LARGE_1000,
+    _CYAN_UTF8_CARRY | _CYAN_UTF8_TOO_LARGE | _CYAN_UTF8_LARGE_1000,
+    _CYAN_UTF8_CARRY | _CYAN_UTF8_TOO_LARGE | _CYAN_UTF8_LARGE_1000,
+    _CYAN_UTF8_CARRY | _CYAN_UTF8_TOO_LARGE | _CYAN_UTF8_LARGE_1000,
+    _CYAN_UTF8_CARRY | _CYAN_UTF8_TOO_LARGE | _CYAN_UTF8_LARGE_1000,
+    _CYAN_UTF8_CARRY | _CYAN_UTF8_TOO_LARGE | _CYAN_UTF8_LARGE_1000 | _CYAN_UTF8_SURROGATE,
+    _CYAN_UTF8_CARRY | _CYAN_UTF8_TOO_LARGE | _CYAN_UTF8_LARGE_1000,
+    _CYAN_UTF8_CARRY | _CYAN_UTF8_TOO_LARGE | _CYAN_UTF8_LARGE_1000,
+};
+
+/* Indexed by the high nibble of the current byte */
+static const unsigned char _cyan_utf8_cur_high[16] = {
+    _CYAN_UTF8_TOO_SHORT, _CYAN_UTF8_TOO_SHORT, _CYAN_UTF8_TOO_SHORT, _CYAN_UTF8_TOO_SHORT,
+    _CYAN_UTF8_TOO_SHORT, _CYAN_UTF8_TOO_SHORT, _CYAN_UTF8_TOO_SHORT, _CYAN_UTF8_TOO_SHORT,
+    _CYAN_UTF8_TOO_LONG | _CYAN_UTF8_OVERLONG_2 | _CYAN_UTF8_TWO_CONTS |
+        _CYAN_UTF8_OVERLONG_3 | _CYAN_UTF8_LARGE_1000 | _CYAN_UTF8_OVERLONG_4,
+    _CYAN_UTF8_TOO_LONG | _CYAN_UTF8_OVERLONG_2 | _CYAN_UTF8_TWO_CONTS |
+        _CYAN_UTF8_OVERLONG_3 | _CYAN_UTF8_TOO_LARGE,
+    _CYAN_UTF8_TOO_LONG | _CYAN_UTF8_OVERLONG_2 | _CYAN_UTF8_TWO_CONTS |
+        _CYAN_UTF8_SURROGATE | _CYAN_UTF8_TOO_LARGE,
+    _CYAN_UTF8_TOO_LONG | _CYAN_UTF8_OVERLONG_2 | _CYAN_UTF8_TWO_CONTS |
+        _CYAN_UTF8_SURROGATE | _CYAN_UTF8_TOO_LARGE,
+    _CYAN_UTF8_TOO_SHORT, _CYAN_UTF8_TOO_SHORT, _CYAN_UTF8_TOO_SHORT, _CYAN_UTF8_TOO_SHORT,
+};
+
+/* Per-position limits past which the last three bytes start an unfinished sequence */
+static const unsigned char _cyan_utf8_incomplete_max[32] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1,
+};
+
+/**
+ * @brief Error bits of a 32-byte block given the block before it
+ */
+__attribute__((target("avx2")))
+static inline __m256i _cyan_utf8_block_avx2(__m256i in, __m256i prev_in) {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i prev_high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)_cyan_utf8_prev_high));
+    const __m256i prev_low = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)_cyan_utf8_prev_low));
+    const __m256i cur_high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)_cyan_utf8_cur_high));
+
+    /* Bytes 1, 2 and 3 positions back, across the block boundary */
+    __m256i carry = _mm256_permute2x128_si256(prev_in, in, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(in, carry, 15);
+    __m256i prev2 = _mm256_alignr_epi8(in, carry, 14);
+    __m256i prev3 = _mm256_alignr_epi8(in, carry, 13);
+
+    __m256i special = _mm256_and_si256(
+        _mm256_and_si256(
+            _mm256_shuffle_epi8(prev_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+            _mm256_shuffle_epi8(prev_low, _mm256_and_si256(prev1, nibble))),
+        _mm256_shuffle_epi8(cur_high, _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble)));
+
+    /* Two continuations in a row are only valid after a 3- or 4-byte lead */
+    __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xE0 - 0x80)));
+    __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xF0 - 0x80)));
+    __m256i must_cont = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8((char)0x80));
+    return _mm256_xor_si256(must_cont, special);
+}
+
+/**
+ * @brief Validate a byte range, 32 bytes per step
+ */
+__attribute__((target("avx2")))
+static inline bool _cyan_utf8_validate_avx2(const unsigned char *p, size_t n) {
+    const __m256i max = _mm256_loadu_si256((const __m256i *)_cyan_utf8_incomplete_max);
+    __m256i error = _mm256_setzero_si256();
+    __m256i prev_in = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    unsigned char tail[32];
+    size_t i = 0;
+    while (i < n) {
+        __m256i in;
+        if (n - i >= 32) {
+            in = _mm256_loadu_si256((const __m256i *)(p + i));
+        } else {
+            /* Zero padding is ASCII, so a sequence cut off by the end fails */
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, p + i, n - i);
+            in = _mm256_loadu_si256((const __m256i *)tail);
+        }
+        i += 32;
+        if (!_mm256_movemask_epi8(in)) {
+            /* ASCII block: only a sequence left open by the last block can fail */
+            error = _mm256_or_si256(error, incomplete);
+            continue;
+        }
+        error = _mm256_or_si256(error, _cyan_utf8_block_avx2(in, prev_in));
+        incomplete = _mm256_subs_epu8(in, max);
+        prev_in = in;
+    }
+    error = _mm256_or_si256(error, incomplete);
+    return _mm256_testz_si256(error, error);
+}
+
+/**
+ * @brief Count bytes that start a code point, plus 4-byte leads if asked
+ */
+static inline size_t _cyan_utf8_count_sse2(const unsigned char *p, size_t n, bool count_4byte) {
+    /* As signed bytes, continuations are -128..-65 */
+    const __m128i not_cont = _mm_set1_epi8(-65);
+    const __m128i lead4 = _mm_set1_epi8((char)0xF0);
+    const __m128i zero = _mm_setzero_si128();
+    size_t count = 0;
+    size_t i = 0;
+    while (n - i >= 16) {
+        /* Byte lanes add at most 2 per step; flush before they overflow */
+        size_t stop = n - i >= 16 * 127 ? i + 16 * 127 : n;
+        __m128i acc = zero;
+        for (; i + 16 <= stop; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+            acc = _mm_sub_epi8(acc, _mm_cmpgt_epi8(v, not_cont));
+            /* Unsigned v >= 0xF0 */
+            if (count_4byte) acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(_mm_max_epu8(v, lead4), v));
+        }
+        __m128i sums = _mm_sad_epu8(acc, zero);
+        count += (size_t)_mm_extract_epi16(sums, 0) + (size_t)_mm_extract_epi16(sums, 4);
+    }
+    for (; i < n; i++) {
+        count += (p[i] & 0xC0) != 0x80;
+        if (count_4byte) count += p[i] >= 0xF0;
+    }
+    return count;
+}
+
+#endif /* _CYAN_STR_HAS_X86_SIMD */
+
+/*============================================================================
+ * Byte-Range Helpers
+ *============================================================================*/
+
+/**
+ * @brief Check that a byte range is well-formed UTF-8
+ */
+static inline bool _cyan_utf8_validate(const char *data, size_t n) {
+    const unsigned char *p = (const unsigned char *)data;
+#if _CYAN_STR_HAS_X86_SIMD
+    if (n >= 64 && __builtin_cpu_supports("avx2")) {
+        return _cyan_utf8_validate_avx2(p, n);
+    }
+#endif
+    return _cyan_utf8_validate_scalar(p, n);
+}
+
+/**
+ * @brief Count non-continuation bytes, plus one per 4-byte lead if asked
+ */
+static inline size_t _cyan_utf8_count(const char *data, size_t n, bool count_4byte) {
+    const unsigned char *p = (const unsigned char *)data;
+#if _CYAN_STR_HAS_X86_SIMD
+    return _cyan_utf8_count_sse2(p, n, count_4byte);
+#else
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        count += (p[i] & 0xC0) != 0x80;
+        if (count_4byte) count += p[i] >= 0xF0;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Length of a run of ASCII bytes at p, in whole 16-byte blocks
+ */
+static inline size_t _cyan_utf8_ascii_blocks(const unsigned char *p, size_t n) {
+    size_t i = 0;
+#if _CYAN_STR_HAS_X86_SIMD
+    while (n - i >= 16 && !_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(p + i)))) i += 16;
+#else
+    (void)p;
+    (void)n;
+#endif
+    return i;
+}
+
+/*============================================================================
+ * Slice Functions
+ *============================================================================*/
+
+/**
+ * @brief Check that a slice is well-formed UTF-8
+ * @param s Slice to check
+ * @return true if every byte belongs to a valid sequence
+ * @note Overlong forms, surrogates (U+D800..U+DFFF), values above
+ *       U+10FFFF and sequences cut off by the end are invalid
+ */
+static inline bool slice_char_utf8_validate(Slice_char s) {
+    return _cyan_utf8_validate(s.data, s.len);
+}
+
+/**
+ * @brief Count the code points of valid UTF-8
+ * @param s Slice of valid UTF-8
+ * @return Number of code points
+ * @note Counts bytes that are not continuation bytes; for invalid input
+ *       the result is not meaningful
+ */
+static inline size_t slice_char_utf8_count(Slice_char s) {
+    return _cyan_utf8_count(s.data, s.len, false);
+}
+
+/**
+ * @brief Count the UTF-16 code units needed for valid UTF-8
+ * @param s Slice of valid UTF-8
+ * @return Number of u16 units slice_char_utf8_to_utf16 writes
+ * @note Bounds the output for any input, valid or not
+ */
+static inline size_t slice_char_utf16_len(Slice_char s) {
+    return _cyan_utf8_count(s.data, s.len, true);
+}
+
+/**
+ * @brief Create an iterator over the code points of a slice
+ * @param s Slice to decode
+ * @return Iterator positioned before the first code point
+ */
+static inline Utf8Iter slice_char_utf8_iter(Slice_char s) {
+    return (Utf8Iter){ .pos = s.data, .end = s.data + s.len };
+}
+
+/**
+ * @brief Decode the next code point
+ * @param it Pointer to the iterator
+ * @param cp Receives the code point, or UTF8_REPLACEMENT for invalid bytes
+ * @return true if a code point was produced, false when exhausted
+ */
+static inline bool utf8_iter_next(Utf8Iter *it, u32 *cp) {
+    if (it->pos >= it->end) return false;
+    const unsigned char *p = (const unsigned char *)it->pos;
+    if (*p < 0x80) {
+        *cp = *p;
+        it->pos++;
+        return true;
+    }
+    int len = _cyan_utf8_decode(p, (const unsigned char *)it->end, cp);
+    if (len < 0) {
+        *cp = UTF8_REPLACEMENT;
+        len = -len;
+    }
+    it->pos += len;
+    return true;
+}
+
+/**
+ * @brief Transcode UTF-8 to UTF-16
+ * @param s Slice of UTF-8
+ * @param out Buffer of at least slice_char_utf16_len(s) units
+ * @return Some(units written), or None if s is not valid UTF-8
+ * @note Code points above U+FFFF become surrogate pairs; on None the
+ *       contents of out are unspecified
+ */
+static inline Option_size_t slice_char_utf8_to_utf16(Slice_char s, u16 *out) {
+    const unsigned char *p = (const unsigned char *)s.data;
+    const unsigned char *end = p + s.len;
+    u16 *o = out;
+    while (p < end) {
+        size_t run = *p < 0x80 ? _cyan_utf8_ascii_blocks(p, (size_t)(end - p)) : 0;
+        if (run) {
+#if _CYAN_STR_HAS_X86_SIMD
+            const __m128i zero = _mm_setzero_si128();
+            for (size_t i = 0; i < run; i += 16) {
+                __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+                _mm_storeu_si128((__m128i *)(o + i), _mm_unpacklo_epi8(v, zero));
+                _mm_storeu_si128((__m128i *)(o + i + 8), _mm_unpackhi_epi8(v, zero));
+            }
+#endif
+            p += run;
+            o += run;
+            continue;
+        }
+        u32 cp;
+        int len = _cyan_utf8_decode(p, end, &cp);
+        if (len < 0) return None(size_t);
+        if (cp < 0x10000) {
+            *o++ = (u16)cp;
+        } else {
+            cp -= 0x10000;
+            *o++ = (u16)(0xD800 | (cp >> 10));
+            *o++ = (u16)(0xDC00 | (cp & 0x3FF));
+        }
+        p += len;
+    }
+    return Some(size_t, (size_t)(o - out));
+}
+
+/**
+ * @brief Transcode UTF-8 to UTF-32
+ * @param s Slice of UTF-8
+ * @param out Buffer of at least slice_char_utf8_count(s) code points
+ * @return Some(code points written), or None if s is not valid UTF-8
+ * @note On None the contents of out are unspecified
+ */
+static inline Option_size_t slice_char_utf8_to_utf32(Slice_char s, u32 *out) {
+    const unsigned char *p = (const unsigned char *)s.data;
+    const unsigned char *end = p + s.len;
+    u32 *o = out;
+    while (p < end) {
+        size_t run = *p < 0x80 ? _cyan_utf8_ascii_blocks(p, (size_t)(end - p)) : 0;
+        if (run) {
+#if _CYAN_STR_HAS_X86_SIMD
+            const __m128i zero = _mm_setzero_si128();
+            for (size_t i = 0; i < run; i += 16) {
+                __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+                __m128i lo = _mm_unpacklo_epi8(v, zero);
+                __m128i hi = _mm_unpackhi_epi8(v, zero);
+                _mm_storeu_si128((__m128i *)(o + i), _mm_unpacklo_epi16(lo, zero));
+                _mm_storeu_si128((__m128i *)(o + i + 4), _mm_unpackhi_epi16(lo, zero));
+                _mm_storeu_si128((__m128i *)(o + i + 8), _mm_unpacklo_epi16(hi, zero));
+                _mm_storeu_si128((__m128i *)(o + i + 12), _mm_unpackhi_epi16(hi, zero));
+            }
+#endif
+            p += run;
+            o += run;
+            continue;
+        }
+        int len = _cyan_utf8_decode(p, end, o);
+        if (len < 0) return None(size_t);
+        o++;
+        p += len;
+    }
+    return Some(size_t, (size_t)(o - out));
+}
+
+/*============================================================================
+ * String Functions
+ *============================================================================*/
+
+/**
+ * @brief Check that a string is well-formed UTF-8
+ * @param s Pointer to the string
+ * @return true if the contents are valid UTF-8
+ */
+static inline bool string_utf8_validate(const String *s) {
+    return _cyan_utf8_validate(_string_buf(s), _string_len(s));
+}
+
+/**
+ * @brief Count the code points of a string of valid UTF-8
+ * @param s Pointer to the string
+ * @return Number of code points
+ */
+static inline size_t string_utf8_count(const String *s) {
+    return _cyan_utf8_count(_string_buf(s), _string_len(s), false);
+}
+
+/**
+ * @brief Create an iterator over the code points of a string
+ * @param s Pointer to the string
+ * @return Iterator positioned before the first code point
+ * @note The iterator is invalidated if the string is modified, moved or freed
+ */
+static inline Utf8Iter string_utf8_iter(const String *s) {
+    return slice_char_utf8_iter(string_as_slice(s));
+}
+
+/* Write the UTF-8 encoding of a valid code point; returns its length */
+static inline size_t _cyan_utf8_encode(u32 cp, char *out) {
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+/**
+ * @brief Append UTF-16 text as UTF-8
+ * @param s Pointer to the string
+ * @param in UTF-16 code units
+ * @param n Number of code units
+ * @return true on success, false if in has an unpaired surrogate
+ * @note On failure the string is left unchanged
+ */
+static inline bool string_append_utf16(String *s, const u16 *in, size_t n) {
+    if (n > SIZE_MAX / 4) CYAN_PANIC("allocation failed");
+    /* A unit becomes at most 3 bytes; a surrogate pair 4 */
+    _string_check_capacity(s, n * 3);
+    size_t len = _string_len(s);
+    char *out = _string_buf(s) + len;
+    char *o = out;
+    size_t i = 0;
+    while (i < n) {
+#if _CYAN_STR_HAS_X86_SIMD
+        const __m128i high = _mm_set1_epi16((short)0xFF80);
+        while (n - i >= 8 && in[i] < 0x80) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, high), _mm_setzero_si128())) != 0xFFFF) break;
+            _mm_storel_epi64((__m128i *)o, _mm_packus_epi16(v, v));
+            o += 8;
+            i += 8;
+        }
+        if (i == n) break;
+#endif
+        u32 cp = in[i++];
+        if (cp >= 0xD800 && cp <= 0xDFFF) {
+            if (cp > 0xDBFF || i == n || in[i] < 0xDC00 || in[i] > 0xDFFF) {
+                _string_set_len(s, len);
+                return false;
+            }
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (u32)(in[i++] - 0xDC00);
+        }
+        o += _cyan_utf8_encode(cp, o);
+    }
+    _string_set_len(s, len + (size_t)(o - out));
+    return true;
+}
+
+/**
+ * @brief Append UTF-32 text as UTF-8
+ * @param s Pointer to the string
+ * @param in Code points
+ * @param n Number of code points
+ * @return true on success, false if in has a surrogate or a value above U+10FFFF
+ * @note On failure the string is left unchanged
+ */
+static inline bool string_append_utf32(String *s, const u32 *in, size_t n) {
+    if (n > SIZE_MAX / 4) CYAN_PANIC("allocation failed");
+    _string_check_capacity(s, n * 4);
+    size_t len = _string_len(s);
+    char *out = _string_buf(s) + len;
+    char *o = out;
+    size_t i = 0;
+    while (i < n) {
+#if _CYAN_STR_HAS_X86_SIMD
+        const __m128i high = _mm_set1_epi32(~0x7F);
+        while (n - i >= 4 && in[i] < 0x80) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(v, high), _mm_setzero_si128())) != 0xFFFF) break;
+            __m128i packed = _mm_packus_epi16(_mm_packs_epi32(v, v), v);
+            int bytes = _mm_cvtsi128_si32(packed);
+            memcpy(o, &bytes, 4);
+            o += 4;
+            i += 4;
+        }
+        if (i == n) break;
+#endif
+        u32 cp = in[i++];
+        if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+            _string_set_len(s, len);
+            return false;
+        }
+        o += _cyan_utf8_encode(cp, o);
+    }
+    _string_set_len(s, len + (size_t)(o - out));
+    return true;
+}
+
+#endif /* CYAN_UTF8_H */
@@ -0,0 +1,336 @@
+/**
+ * @file test_cache.c
+ * @brief Property-based tests for the LRU and CLOCK caches
+ * 
+ * Tests validate correctness properties:
+ * - Property 89: LruCache matches a reference LRU list
+ * - Property 90: ClockCache stays bounded and gives hit keys a second chance
+ * - Property 91: Sharded caches stay bounded and consistent under concurrent use
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "theft.h"
+#include "test_util.h"
+#include <cyan/option.h>
+#include <cyan/cache.h>
+#include <cyan/concurrent_cache.h>
+
+/* Define Option and cache types for testing */
+OPTION_DEFINE(int);
+LRU_CACHE_DEFINE(int, int);
+CLOCK_CACHE_DEFINE(int, int);
+CONCURRENT_LRU_CACHE_DEFINE(int, int);
+CONCURRENT_CLOCK_CACHE_DEFINE(int, int);
+
+#define KEY_RANGE 64
+#define MAX_CAPACITY 16
+#define NUM_THREADS 4
+#define OPS_PER_THREAD 20000
+
+/* Eviction callback: record the evicted pair */
+typedef struct {
+    int count;
+    int key;
+    int value;
+} EvictLog;
+
+static void log_evict(int key, int value, void *ctx) {
+    EvictLog *log = (EvictLog *)ctx;
+    log->count++;
+    log->key = key;
+    log->value = value;
+}
+
+/*============================================================================
+ * Property 89: LruCache matches a reference LRU list
+ * For any capacity and sequence of gets, peeks, puts and removes, the cache
+ * returns the same values as an array kept in recency order, and evicts
+ * exactly the entry at the array's tail
+ *============================================================================*/
+
+static enum theft_trial_res prop_lru_model(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    size_t cap = 1 + next_rand(&state) % MAX_CAPACITY;
+    bool ok = true;
+    
+    LruCache_int_int c = lrucache_int_int_new(cap);
+    EvictLog log = { 0 };
+    c.on_evict = log_evict;
+    c.evict_ctx = &log;
+    
+    /* Reference: keys[0] is most recent */
+    int keys[MAX_CAPACITY], values[MAX_CAPACITY];
+    size_t n = 0;
+    
+    for (int round = 0; ok && round < 2000; round++) {
+        int key = (int)(next_rand(&state) % KEY_RANGE);
+        int op = (int)(next_rand(&state) % 4);
+        size_t pos = 0;
+        while (pos < n && keys[pos] != key) pos++;
+        bool present = pos < n;
+        
+        if (op == 0 || op == 1) {
+            Option_int v = op == 0 ? lrucache_int_int_get(&c, key) : lrucache_int_int_peek(&c, key);
+            if (is_some(v) != present || (present && unwrap(v) != values[pos])) ok = false;
+            if (present && op == 0) {
+                int k = keys[pos], val = values[pos];
+                memmove(&keys[1], &keys[0], pos * sizeof(int));
+                memmove(&values[1], &values[0], pos * sizeof(int));
+                keys[0] = k;
+                values[0] = val;
+            }
+        } else if (op == 2) {
+            int value = round;
+            int evictions = log.count;
+            lrucache_int_int_put(&c, key, value);
+            if (!present && n == cap) {
+                if (log.count != evictions + 1 || log.key != keys[n - 1] || log.value != values[n - 1]) ok = false;
+                n--;
+                pos = n;
+            } else if (log.count != evictions) {
+                ok = false;
+            }
+            if (!present) pos = n++;
+            memmove(&keys[1], &keys[0], pos * sizeof(int));
+            memmove(&values[1], &values[0], pos * sizeof(int));
+            keys[0] = key;
+            values[0] = value;
+        } else {
+            Option_int v = lrucache_int_int_remove(&c, key);
+            if (is_some(v) != present || (present && unwrap(v) != values[pos])) ok = false;
+            if (present) {
+                memmove(&keys[pos], &keys[pos + 1], (n - pos - 1) * sizeof(int));
+                memmove(&values[pos], &values[pos + 1], (n - pos - 1) * sizeof(int));
+                n--;
+            }
+        }
+        
+        if (lrucache_int_int_len(&c) != n || c.map.len != n) ok = false;
+        if (round == 1000) {
+            lrucache_int_int_clear(&c);
+            n = 0;
+        }
+    }
+    
+    /* Removes and evictions must not leave the key map full of tombstones;
+     * trailing removes are only cleared up by the next put */
+    lrucache_int_int_put(&c, KEY_RANGE, 0);
+    if (hashmap_int_LruSlot_int_int_stats(&c.map).tombstones > c.map.capacity / 4 + 1) ok = false;
+    
+    lrucache_int_int_free(&c);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 90: ClockCache stays bounded and gives hit keys a second chance
+ * For any sequence of operations, every cached key holds its last put value,
+ * len never exceeds capacity, and each put of a new key into a full cache
+ * evicts exactly one entry. In a full cache, a key read since the last
+ * eviction outlives an unread one
+ *============================================================================*/
+
+static enum theft_trial_res prop_clock_bounded(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    size_t cap = 2 + next_rand(&state) % (MAX_CAPACITY - 1);
+    bool ok = true;
+    
+    ClockCache_int_int c = clockcache_int_int_new(cap);
+    EvictLog log = { 0 };
+    c.on_evict = log_evict;
+    c.evict_ctx = &log;
+    
+    /* Last value put per key, or -1 once it is removed or evicted */
+    int last[KEY_RANGE];
+    for (int k = 0; k < KEY_RANGE; k++) last[k] = -1;
+    size_t n = 0;
+    
+    for (int round = 0; ok && round < 2000; round++) {
+        int key = (int)(next_rand(&state) % KEY_RANGE);
+        int op = (int)(next_rand(&state) % 4);
+        
+        if (op == 0) {
+            Option_int v = clockcache_int_int_get(&c, key);
+            if (is_some(v) != (last[key] >= 0) || (is_some(v) && unwrap(v) != last[key])) ok = false;
+        } else if (op == 1 || op == 2) {
+            int evictions = log.count;
+            bool present = last[key] >= 0;
+            clockcache_int_int_put(&c, key, round);
+            last[key] = round;
+            if (!present && n == cap) {
+                if (log.count != evictions + 1 || log.key == key || last[log.key] != log.value) ok = false;
+                last[log.key] = -1;
+            } else {
+                if (log.count != evictions) ok = false;
+                if (!present) n++;
+            }
+        } else {
+            Option_int v = clockcache_int_int_remove(&c, key);
+            if (is_some(v) != (last[key] >= 0) || (is_some(v) && unwrap(v) != last[key])) ok = false;
+            if (is_some(v)) n--;
+            last[key] = -1;
+        }
+        
+        if (clockcache_int_int_len(&c) != n || n > cap) ok = false;
+    }
+    
+    /* Second chance: fill with fresh keys, read one, then push one more in */
+    clockcache_int_int_clear(&c);
+    for (int k = 0; k < (int)cap; k++) clockcache_int_int_put(&c, k, k);
+    int hot = (int)(next_rand(&state) % cap);
+    clockcache_int_int_get(&c, hot);
+    clockcache_int_int_put(&c, KEY_RANGE, 0);
+    if (!clockcache_int_int_contains(&c, hot) || clockcache_int_int_len(&c) != cap) ok = false;
+    
+    clockcache_int_int_free(&c);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 91: Sharded caches stay bounded and consistent under concurrent use
+ * With several threads getting and putting overlapping keys, every value
+ * read belongs to its key, and the cache never holds more than its
+ * capacity, for both LRU and CLOCK shards
+ *============================================================================*/
+
+typedef struct {
+    ConcurrentLruCache_int_int *lru;
+    ConcurrentClockCache_int_int *clock;
+    uint32_t seed;
+    bool ok;
+} CacheWorker;
+
+/* Values encode their key, so a torn or misplaced read is detectable */
+static void *cache_worker(void *arg) {
+    CacheWorker *w = (CacheWorker *)arg;
+    uint32_t state = w->seed;
+    for (int i = 0; i < OPS_PER_THREAD; i++) {
+        int key = (int)(next_rand(&state) % (KEY_RANGE * 8));
+        int value = key * 1000 + (int)(next_rand(&state) % 1000);
+        if (next_rand(&state) % 4 == 0) {
+            clrucache_int_int_put(w->lru, key, value);
+            cclockcache_int_int_put(w->clock, key, value);
+        } else {
+            Option_int a = clrucache_int_int_get(w->lru, key);
+            Option_int b = cclockcache_int_int_get(w->clock, key);
+            if (is_some(a) && unwrap(a) / 1000 != key) w->ok = false;
+            if (is_some(b) && unwrap(b) / 1000 != key) w->ok = false;
+        }
+    }
+    return NULL;
+}
+
+static enum theft_trial_res prop_concurrent_cache(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t seed = (uint32_t)(*val_ptr);
+    size_t cap = 16 + seed % 200;
+    size_t shards = 1 + seed % 8;
+    bool ok = true;
+    
+    ConcurrentLruCache_int_int lru = clrucache_int_int_with_shards(cap, shards);
+    ConcurrentClockCache_int_int clock = cclockcache_int_int_with_shards(cap, shards);
+    size_t limit = lru.shard_count * lru.shards[0].cache.capacity;
+    
+    pthread_t threads[NUM_THREADS];
+    CacheWorker workers[NUM_THREADS];
+    for (int i = 0; i < NUM_THREADS; i++) {
+        workers[i] = (CacheWorker){ &lru, &clock, seed * 31u + (uint32_t)i, true };
+        pthread_create(&threads[i], NULL, cache_worker, &workers[i]);
+    }
+    for (int i = 0; i < NUM_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        if (!workers[i].ok) ok = false;
+    }
+    
+    if (clrucache_int_int_len(&lru) > limit || cclockcache_int_int_len(&clock) > limit) ok = false;
+    if (limit < cap) ok = false;
+    
+    /* Quiescent: a put is visible to the next get */
+    clrucache_int_int_put(&lru, 7, 7007);
+    cclockcache_int_int_put(&clock, 7, 7007);
+    Option_int a = clrucache_int_int_get(&lru, 7);
+    Option_int b = MAP_GET(clock, 7);
+    if (!is_some(a) || unwrap(a) != 7007 || !is_some(b) || unwrap(b) != 7007) ok = false;
+    
+    clrucache_int_int_free(&lru);
+    MAP_FREE(clock);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+/* Minimum iterations for property tests */
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} CacheTest;
+
+static CacheTest cache_tests[] = {
+    {
+        "Property 89: LruCache matches a reference LRU list",
+        prop_lru_model,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 90: ClockCache stays bounded and gives hit keys a second chance",
+        prop_clock_bounded,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 91: Sharded caches stay bounded and consistent under concurrent use",
+        prop_concurrent_cache,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_CACHE_TESTS (sizeof(cache_tests) / sizeof(cache_tests[0]))
+
+int run_cache_tests(theft_seed seed) {
+    int failures = 0;
+    
+    printf("\nCache Tests:\n");
+    
+    for (size_t i = 0; i < NUM_CACHE_TESTS; i++) {
+        CacheTest *test = &cache_tests[i];
+        
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+        
+        enum theft_run_res res = theft_run(&config);
+        
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+    
+    return failures;
+}
@@ -0,0 +1,229 @@
+/**
+ * @file test_concurrent_hashmap.c
+ * @brief Property-based tests for the sharded ConcurrentHashMap type
+ * 
+ * Tests validate correctness properties:
+ * - Property 77: ConcurrentHashMap matches HashMap for single-threaded use
+ * - Property 78: ConcurrentHashMap keeps every update under concurrent writers
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "theft.h"
+#include <cyan/option.h>
+#include <cyan/hashmap.h>
+#include <cyan/concurrent_hashmap.h>
+
+/* Define Option, HashMap and ConcurrentHashMap types for testing */
+OPTION_DEFINE(int);
+HASHMAP_DEFINE(int, int);
+CONCURRENT_HASHMAP_DEFINE(int, int);
+
+#define NUM_THREADS 4
+#define KEYS_PER_THREAD 512
+#define SHARED_COUNTERS 8
+
+/* compute callback: add *ctx to the value, dropping it when it reaches zero */
+static bool add_or_drop(int key, int *value, bool present, void *ctx) {
+    (void)key;
+    (void)present;
+    *value += *(int *)ctx;
+    return *value != 0;
+}
+
+/*============================================================================
+ * Property 77: ConcurrentHashMap matches HashMap for single-threaded use
+ * For any sequence of inserts, removes and computes, the sharded map agrees
+ * with a plain HashMap on every key, for several shard counts
+ *============================================================================*/
+
+static enum theft_trial_res prop_chashmap_model(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    
+    size_t shard_counts[] = { 1, 3, 16 };
+    for (int sc = 0; sc < 3; sc++) {
+        ConcurrentHashMap_int_int cm = chashmap_int_int_with_shards(shard_counts[sc]);
+        HashMap_int_int ref = hashmap_int_int_new();
+        bool ok = true;
+        
+        /* Shard counts are rounded up to a power of 2 */
+        if (cm.shard_count & (cm.shard_count - 1)) ok = false;
+        
+        for (int round = 0; ok && round < 300; round++) {
+            state = state * 1664525u + 1013904223u;
+            int key = (int)((state >> 8) % 128);
+            int op = (int)((state >> 20) % 3);
+            
+            if (op == 0) {
+                chashmap_int_int_insert(&cm, key, round);
+                hashmap_int_int_insert(&ref, key, round);
+            } else if (op == 1) {
+                Option_int a = chashmap_int_int_remove(&cm, key);
+                Option_int b = hashmap_int_int_remove(&ref, key);
+                if (is_some(a) != is_some(b) || (is_some(a) && unwrap(a) != unwrap(b))) ok = false;
+            } else {
+                int delta = (round % 2) ? 1 : -1;
+                bool kept = chashmap_int_int_compute(&cm, key, add_or_drop, &delta);
+                int *slot = hashmap_int_int_get_or_insert(&ref, key, 0);
+                *slot += delta;
+                if (*slot == 0) hashmap_int_int_remove(&ref, key);
+                if (kept != hashmap_int_int_contains(&ref, key)) ok = false;
+            }
+        }
+        
+        for (int key = 0; ok && key < 128; key++) {
+            Option_int a = chashmap_int_int_get(&cm, key);
+            Option_int b = hashmap_int_int_get(&ref, key);
+            if (is_some(a) != is_some(b) || (is_some(a) && unwrap(a) != unwrap(b))) ok = false;
+            if (chashmap_int_int_contains(&cm, key) != is_some(b)) ok = false;
+        }
+        if (chashmap_int_int_len(&cm) != hashmap_int_int_len(&ref)) ok = false;
+        
+        /* The vtable macros dispatch to the same operations */
+        MAP_INSERT(cm, 1000, 7);
+        if (!is_some(MAP_GET(cm, 1000)) || unwrap(MAP_GET(cm, 1000)) != 7) ok = false;
+        
+        MAP_FREE(cm);
+        hashmap_int_int_free(&ref);
+        if (!ok) return THEFT_TRIAL_FAIL;
+    }
+    
+    return THEFT_TRIAL_PASS;
+}
+
+/*============================================================================
+ * Property 78: ConcurrentHashMap keeps every update under concurrent writers
+ * For any key offset, threads inserting disjoint keys while incrementing
+ * shared counters through compute lose no inserts and no increments
+ *============================================================================*/
+
+typedef struct {
+    ConcurrentHashMap_int_int *map;
+    int base;
+    int id;
+} WorkerArg;
+
+static void *chashmap_worker(void *p) {
+    WorkerArg *arg = (WorkerArg *)p;
+    int one = 1;
+    
+    for (int i = 0; i < KEYS_PER_THREAD; i++) {
+        int key = arg->base + arg->id * KEYS_PER_THREAD + i;
+        chashmap_int_int_insert(arg->map, key, key);
+        
+        /* Shared counters live below base and are hit by every thread */
+        chashmap_int_int_compute(arg->map, i % SHARED_COUNTERS, add_or_drop, &one);
+        
+        /* Readers interleave with writers on other shards */
+        Option_int v = chashmap_int_int_get(arg->map, key);
+        if (!is_some(v) || unwrap(v) != key) return (void *)1;
+    }
+    return NULL;
+}
+
+static enum theft_trial_res prop_chashmap_threads(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    int base = SHARED_COUNTERS + (int)((uint64_t)*val_ptr % 100000u);
+    
+    ConcurrentHashMap_int_int m = chashmap_int_int_new();
+    pthread_t threads[NUM_THREADS];
+    WorkerArg args[NUM_THREADS];
+    bool ok = true;
+    
+    for (int i = 0; i < NUM_THREADS; i++) {
+        args[i] = (WorkerArg){ .map = &m, .base = base, .id = i };
+        pthread_create(&threads[i], NULL, chashmap_worker, &args[i]);
+    }
+    for (int i = 0; i < NUM_THREADS; i++) {
+        void *res;
+        pthread_join(threads[i], &res);
+        if (res != NULL) ok = false;
+    }
+    
+    if (chashmap_int_int_len(&m) != (size_t)(NUM_THREADS * KEYS_PER_THREAD + SHARED_COUNTERS)) ok = false;
+    
+    int expected = NUM_THREADS * KEYS_PER_THREAD / SHARED_COUNTERS;
+    for (int c = 0; c < SHARED_COUNTERS; c++) {
+        Option_int v = chashmap_int_int_get(&m, c);
+        if (!is_some(v) || unwrap(v) != expected) ok = false;
+    }
+    
+    for (int k = base; k < base + NUM_THREADS * KEYS_PER_THREAD; k++) {
+        Option_int v = chashmap_int_int_get(&m, k);
+        if (!is_some(v) || unwrap(v) != k) ok = false;
+    }
+    
+    chashmap_int_int_free(&m);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+/* Minimum iterations for property tests */
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} ConcurrentHashMapTest;
+
+static ConcurrentHashMapTest chashmap_tests[] = {
+    {
+        "Property 77: ConcurrentHashMap matches HashMap for single-threaded use",
+        prop_chashmap_model,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 78: ConcurrentHashMap keeps every update under concurrent writers",
+        prop_chashmap_threads,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_CHASHMAP_TESTS (sizeof(chashmap_tests) / sizeof(chashmap_tests[0]))
+
+int run_chashmap_tests(theft_seed seed) {
+    int failures = 0;
+    
+    printf("\nConcurrentHashMap Tests:\n");
+    
+    for (size_t i = 0; i < NUM_CHASHMAP_TESTS; i++) {
+        ConcurrentHashMapTest *test = &chashmap_tests[i];
+        
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+        
+        enum theft_run_res res = theft_run(&config);
+        
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+    
+    return failures;
+}
@@ -0,0 +1,297 @@
+/**
+ * @file test_hash.c
+ * @brief Property-based tests for the hash function suite
+ * 
+ * Tests validate correctness properties:
+ * - Property 67: Hash functions are deterministic over key bytes
+ * - Property 68: CRC32C matches the reference and is incremental
+ * - Property 69: Every hash function works as a HashMap hash_fn
+ * - Property 88: Seeds decide the layout and nothing else
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "theft.h"
+#include <cyan/option.h>
+#include <cyan/hash.h>
+#include <cyan/hashmap.h>
+
+/* Define Option and HashMap types for testing */
+OPTION_DEFINE(u64);
+HASHMAP_DEFINE(u64, u64);
+HASHMAP_DEFINE_SCALAR(u32, u64);
+
+/* Compile-time hashes ignore the seed, so HASHMAP_DEFINE_SCALAR must not
+ * generate with_seed; if it did, this declaration would not compile */
+typedef int hashmap_u32_u64_with_seed;
+
+static const HashFn hash_fns[] = {
+    cyan_hash_fnv1a,
+    cyan_hash_wy,
+    cyan_hash_crc32c,
+    cyan_hash_int,
+};
+
+#define NUM_HASH_FNS (sizeof(hash_fns) / sizeof(hash_fns[0]))
+
+/* Fill a buffer with bytes derived from a seed */
+static void fill_bytes(unsigned char *buf, size_t len, uint64_t seed) {
+    for (size_t i = 0; i < len; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        buf[i] = (unsigned char)(seed >> 56);
+    }
+}
+
+/*============================================================================
+ * Property 67: Hash functions are deterministic over key bytes
+ * For any key of 0-200 bytes, hashing two separate copies gives the same
+ * value, and flipping one byte changes the wyhash and CRC32C results
+ *============================================================================*/
+
+static enum theft_trial_res prop_hash_deterministic(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint64_t seed = (uint64_t)(*val_ptr);
+    
+    unsigned char a[200], b[201];
+    
+    for (size_t len = 0; len <= 200; len += 1 + len / 8) {
+        fill_bytes(a, len, seed);
+        /* Unaligned copy to catch alignment-dependent reads */
+        memcpy(b + 1, a, len);
+        
+        for (size_t f = 0; f < NUM_HASH_FNS; f++) {
+            if (hash_fns[f](a, len) != hash_fns[f](b + 1, len)) {
+                return THEFT_TRIAL_FAIL;
+            }
+        }
+        
+        if (len == 0) continue;
+        
+        b[1 + len / 2] ^= 0x01;
+        if (cyan_hash_wy(a, len) == cyan_hash_wy(b + 1, len)) {
+            return THEFT_TRIAL_FAIL;
+        }
+        if (cyan_hash_crc32c(a, len) == cyan_hash_crc32c(b + 1, len)) {
+            return THEFT_TRIAL_FAIL;
+        }
+    }
+    
+    return THEFT_TRIAL_PASS;
+}
+
+/*============================================================================
+ * Property 68: CRC32C matches the reference and is incremental
+ * The standard check value holds, and for any buffer and split point,
+ * feeding the two halves in sequence equals one pass over the whole buffer
+ *============================================================================*/
+
+static enum theft_trial_res prop_crc32c_reference(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint64_t seed = (uint64_t)(*val_ptr);
+    
+    /* Standard CRC-32C check value */
+    if (cyan_crc32c("123456789", 9, 0) != 0xe3069283U) {
+        return THEFT_TRIAL_FAIL;
+    }
+    
+    unsigned char buf[300];
+    size_t len = 1 + (size_t)(seed % 299);
+    size_t split = (size_t)((seed >> 16) % len);
+    fill_bytes(buf, len, seed);
+    
+    uint32_t whole = cyan_crc32c(buf, len, 0);
+    uint32_t parts = cyan_crc32c(buf + split, len - split, cyan_crc32c(buf, split, 0));
+    if (whole != parts) {
+        return THEFT_TRIAL_FAIL;
+    }
+    
+    /* Portable path must agree with whichever path was dispatched */
+    if (whole != ~_cyan_crc32c_sw(~0U, buf, len)) {
+        return THEFT_TRIAL_FAIL;
+    }
+    
+    return THEFT_TRIAL_PASS;
+}
+
+/*============================================================================
+ * Property 69: Every hash function works as a HashMap hash_fn
+ * For any set of keys, a map using each hash function returns every
+ * inserted value and nothing else
+ *============================================================================*/
+
+static enum theft_trial_res prop_hash_fn_in_map(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u64 seed = (u64)(*val_ptr);
+    
+    for (size_t f = 0; f < NUM_HASH_FNS; f++) {
+        HashMap_u64_u64 m = hashmap_u64_u64_new();
+        m.hash_fn = hash_fns[f];
+        
+        for (u64 i = 0; i < 200; i++) {
+            hashmap_u64_u64_insert(&m, seed + i * 4096, i);
+        }
+        
+        for (u64 i = 0; i < 200; i++) {
+            Option_u64 opt = hashmap_u64_u64_get(&m, seed + i * 4096);
+            if (!is_some(opt) || unwrap(opt) != i) {
+                hashmap_u64_u64_free(&m);
+                return THEFT_TRIAL_FAIL;
+            }
+            if (hashmap_u64_u64_contains(&m, seed + i * 4096 + 1)) {
+                hashmap_u64_u64_free(&m);
+                return THEFT_TRIAL_FAIL;
+            }
+        }
+        
+        hashmap_u64_u64_free(&m);
+    }
+    
+    return THEFT_TRIAL_PASS;
+}
+
+/*============================================================================
+ * Property 88: Seeds decide the layout and nothing else
+ * For any seed, maps built with that seed have identical layouts and find
+ * every key; a different seed moves the keys, the seeded hashes depend on
+ * the seed, and the process seed never changes. Maps with compile-time
+ * hashes ignore the seed
+ *============================================================================*/
+
+static enum theft_trial_res prop_hash_seeded(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint64_t seed = (uint64_t)(*val_ptr);
+    bool ok = true;
+    
+    uint64_t process_seed = cyan_hash_process_seed();
+    if (process_seed == 0 || cyan_hash_process_seed() != process_seed) return THEFT_TRIAL_FAIL;
+    if (hashmap_u64_u64_new().seed != process_seed) return THEFT_TRIAL_FAIL;
+    
+    HashMap_u64_u64 a = hashmap_u64_u64_with_seed(seed);
+    HashMap_u64_u64 b = hashmap_u64_u64_with_seed(seed);
+    HashMap_u64_u64 c = hashmap_u64_u64_with_seed(seed ^ 0x5555555555555555ULL);
+    for (u64 i = 0; i < 200; i++) {
+        hashmap_u64_u64_insert(&a, i, i * 3);
+        hashmap_u64_u64_insert(&b, i, i * 3);
+        hashmap_u64_u64_insert(&c, i, i * 3);
+    }
+    
+    size_t moved = 0;
+    for (size_t i = 0; i < a.capacity; i++) {
+        if (a.buckets[i].tag != b.buckets[i].tag || a.buckets[i].key != b.buckets[i].key) ok = false;
+        if (a.buckets[i].tag != c.buckets[i].tag) moved++;
+    }
+    if (moved == 0) ok = false;
+    
+    size_t differ = 0;
+    for (u64 i = 0; i < 200 && ok; i++) {
+        Option_u64 va = hashmap_u64_u64_get(&a, i);
+        Option_u64 vc = hashmap_u64_u64_get(&c, i);
+        if (!is_some(va) || unwrap(va) != i * 3 || !is_some(vc) || unwrap(vc) != i * 3) ok = false;
+        
+        u64 key = seed + i;
+        if (cyan_hash_wy_seeded(&key, sizeof(key), seed) != cyan_hash_wy_seeded(&key, sizeof(key), seed)) ok = false;
+        if (cyan_hash_wy_seeded(&key, sizeof(key), seed) != cyan_hash_wy_seeded(&key, sizeof(key), ~seed)) differ++;
+        if (cyan_hash_int_seeded(&key, sizeof(key), seed) != cyan_hash_int_seeded(&key, sizeof(key), ~seed)) differ++;
+    }
+    if (ok && differ < 390) ok = false;
+    
+    HashMap_u32_u64 sa = hashmap_u32_u64_new();
+    HashMap_u32_u64 sc = hashmap_u32_u64_new();
+    sa.seed = seed;
+    sc.seed = seed ^ 0x5555555555555555ULL;
+    for (u32 i = 0; i < 200; i++) {
+        hashmap_u32_u64_insert(&sa, i, i);
+        hashmap_u32_u64_insert(&sc, i, i);
+    }
+    for (size_t i = 0; i < sa.capacity; i++) {
+        if (sa.buckets[i].tag != sc.buckets[i].tag || sa.buckets[i].key != sc.buckets[i].key) ok = false;
+    }
+    
+    hashmap_u64_u64_free(&a);
+    hashmap_u64_u64_free(&b);
+    hashmap_u64_u64_free(&c);
+    hashmap_u32_u64_free(&sa);
+    hashmap_u32_u64_free(&sc);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+/* Minimum iterations for property tests */
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} HashTest;
+
+static HashTest hash_tests[] = {
+    {
+        "Property 67: Hash functions are deterministic over key bytes",
+        prop_hash_deterministic,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 68: CRC32C matches the reference and is incremental",
+        prop_crc32c_reference,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 69: Every hash function works as a HashMap hash_fn",
+        prop_hash_fn_in_map,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 88: Seeds decide the layout and nothing else",
+        prop_hash_seeded,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_HASH_TESTS (sizeof(hash_tests) / sizeof(hash_tests[0]))
+
+int run_hash_tests(theft_seed seed) {
+    int failures = 0;
+    
+    printf("\nHash Function Tests:\n");
+    
+    for (size_t i = 0; i < NUM_HASH_TESTS; i++) {
+        HashTest *test = &hash_tests[i];
+        
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+        
+        enum theft_run_res res = theft_run(&config);
+        
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+    
+    return failures;
+}
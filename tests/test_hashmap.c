@@ -7,6 +7,13 @@
  * - Property 43: HashMap get on missing key returns None
  * - Property 44: HashMap iteration visits all entries
  * - Property 45: HashMap remove then get returns None
+ * - Property 66: Compile-time specialized HashMap matches default HashMap
+ * - Property 73: HashMap in-place access matches get-then-insert
+ * - Property 79: Incremental resize is invisible to map operations
+ * - Property 80: Batch lookups match one-at-a-time lookups
+ * - Property 84: HashMap stats match a direct scan of the table
+ * - Property 95: The occupancy bitmap tracks the tags and drives iteration
+ * - Property 96: retain and iter_remove remove exactly the rejected entries
  */
 
 #include <stdio.h>
@@ -21,6 +28,9 @@ OPTION_DEFINE(int);
 HASHMAP_DEFINE(int, int);
 HASHMAP_ITER_DEFINE(int, int);
 
+/* Compile-time specialized map with inlined hash and equality */
+HASHMAP_DEFINE_SCALAR(i64, int);
+
 /*============================================================================
  * Property 42: HashMap insert-get round-trip
  * For any sequence of key-value insertions, getting each key returns Some with the most recently inserted value
@@ -459,6 +469,553 @@ static enum theft_trial_res prop_vtable_behavioral_equivalence(struct theft *t,
     return THEFT_TRIAL_PASS;
 }
 
+/*============================================================================
+ * Property 66: Compile-time specialized HashMap matches default HashMap
+ * For any sequence of inserts and removes, a map defined with
+ * HASHMAP_DEFINE_SCALAR holds exactly the same entries as one defined with
+ * HASHMAP_DEFINE
+ *============================================================================*/
+
+static enum theft_trial_res prop_specialized_equivalence(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    int seed = (int)(*val_ptr);
+    
+    HashMap_int_int m_default = hashmap_int_int_new();
+    HashMap_i64_int m_scalar = hashmap_i64_int_new();
+    
+    /* Insert enough entries to force several resizes */
+    for (int i = 0; i < 100; i++) {
+        int key = seed + i * 3;
+        hashmap_int_int_insert(&m_default, key, i);
+        hashmap_i64_int_insert(&m_scalar, key, i);
+    }
+    
+    /* Remove every fourth key */
+    for (int i = 0; i < 100; i += 4) {
+        int key = seed + i * 3;
+        Option_int r1 = hashmap_int_int_remove(&m_default, key);
+        Option_int r2 = hashmap_i64_int_remove(&m_scalar, key);
+        if (is_some(r1) != is_some(r2) || unwrap(r1) != unwrap(r2)) {
+            hashmap_int_int_free(&m_default);
+            hashmap_i64_int_free(&m_scalar);
+            return THEFT_TRIAL_FAIL;
+        }
+    }
+    
+    if (hashmap_int_int_len(&m_default) != hashmap_i64_int_len(&m_scalar)) {
+        hashmap_int_int_free(&m_default);
+        hashmap_i64_int_free(&m_scalar);
+        return THEFT_TRIAL_FAIL;
+    }
+    
+    /* Every key, present or not, must agree between the two maps */
+    for (int i = 0; i < 300; i++) {
+        int key = seed + i;
+        Option_int g1 = hashmap_int_int_get(&m_default, key);
+        Option_int g2 = hashmap_i64_int_get(&m_scalar, key);
+        if (is_some(g1) != is_some(g2)) {
+            hashmap_int_int_free(&m_default);
+            hashmap_i64_int_free(&m_scalar);
+            return THEFT_TRIAL_FAIL;
+        }
+        if (is_some(g1) && unwrap(g1) != unwrap(g2)) {
+            hashmap_int_int_free(&m_default);
+            hashmap_i64_int_free(&m_scalar);
+            return THEFT_TRIAL_FAIL;
+        }
+    }
+    
+    hashmap_int_int_free(&m_default);
+    hashmap_i64_int_free(&m_scalar);
+    return THEFT_TRIAL_PASS;
+}
+
+/*============================================================================
+ * Property 73: HashMap in-place access matches get-then-insert
+ * For any sequence of keys, counting occurrences with get_or_insert and
+ * with the entry API yields the same map as get followed by insert,
+ * get_ptr points at the stored value, and updating existing keys never
+ * resizes or moves other values
+ *============================================================================*/
+
+static enum theft_trial_res prop_entry_api(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    unsigned seed = (unsigned)(*val_ptr);
+    
+    HashMap_int_int m_ref = hashmap_int_int_new();
+    HashMap_int_int m_goi = hashmap_int_int_new();
+    HashMap_int_int m_entry = hashmap_int_int_new();
+    
+    for (unsigned i = 0; i < 500; i++) {
+        int key = (int)((seed + i * 2654435761u) % 97u);
+        
+        Option_int cur = hashmap_int_int_get(&m_ref, key);
+        hashmap_int_int_insert(&m_ref, key, unwrap_or(cur, 0) + 1);
+        
+        (*hashmap_int_int_get_or_insert(&m_goi, key, 0))++;
+        
+        HashMapEntry_int_int e = hashmap_int_int_entry(&m_entry, key);
+        if (hashmap_int_int_entry_is_occupied(&e)) {
+            (*hashmap_int_int_entry_get(&e))++;
+        } else {
+            hashmap_int_int_entry_insert(&e, 1);
+        }
+    }
+    
+    bool ok = hashmap_int_int_len(&m_ref) == hashmap_int_int_len(&m_goi) &&
+              hashmap_int_int_len(&m_ref) == hashmap_int_int_len(&m_entry);
+    
+    for (int key = 0; ok && key < 97; key++) {
+        Option_int expected = hashmap_int_int_get(&m_ref, key);
+        int *p_goi = hashmap_int_int_get_ptr(&m_goi, key);
+        int *p_entry = hashmap_int_int_get_ptr(&m_entry, key);
+        if (is_none(expected)) {
+            ok = p_goi == NULL && p_entry == NULL;
+        } else {
+            ok = p_goi && p_entry && *p_goi == unwrap(expected) && *p_entry == unwrap(expected);
+        }
+    }
+    
+    /* Writes through get_ptr are visible to get */
+    if (ok) {
+        int *p = hashmap_int_int_get_ptr(&m_goi, (int)(seed % 97u));
+        *p = -5;
+        ok = unwrap(hashmap_int_int_get(&m_goi, (int)(seed % 97u))) == -5;
+    }
+    
+    /* Removing through an entry, then or_insert on a vacant entry */
+    if (ok) {
+        int key = (int)(seed % 97u);
+        HashMapEntry_int_int e = hashmap_int_int_entry(&m_entry, key);
+        size_t before = hashmap_int_int_len(&m_entry);
+        ok = is_some(hashmap_int_int_entry_remove(&e)) &&
+             !hashmap_int_int_contains(&m_entry, key) &&
+             hashmap_int_int_len(&m_entry) == before - 1;
+        
+        HashMapEntry_int_int v = hashmap_int_int_entry(&m_entry, key);
+        ok = ok && !hashmap_int_int_entry_is_occupied(&v) &&
+             hashmap_int_int_entry_get(&v) == NULL &&
+             *hashmap_int_int_entry_or_insert(&v, 77) == 77 &&
+             *hashmap_int_int_entry_or_insert(&v, 88) == 77 &&
+             unwrap(hashmap_int_int_get(&m_entry, key)) == 77;
+    }
+    
+    /* At the resize threshold, and in the middle of an incremental resize,
+     * hits on existing keys neither resize nor move other values */
+    for (int incremental = 0; ok && incremental < 2; incremental++) {
+        HashMap_int_int m = hashmap_int_int_new();
+        hashmap_int_int_set_incremental(&m, incremental);
+        int n = 0;
+        while (m.capacity == 0 || (incremental ? m.old_buckets == NULL :
+               (m.len + 1) * 100 / m.capacity <= CYAN_HASHMAP_LOAD_FACTOR)) {
+            hashmap_int_int_insert(&m, n, n);
+            n++;
+        }
+        int held_key = (int)(seed % (unsigned)n);
+        int *held = hashmap_int_int_get_ptr(&m, held_key);
+        size_t cap = m.capacity, pos = m.migrate_pos;
+        for (int key = 0; key < n; key++) {
+            (*hashmap_int_int_get_or_insert(&m, key, -1))++;
+            HashMapEntry_int_int e = hashmap_int_int_entry(&m, key);
+            if (!hashmap_int_int_entry_is_occupied(&e)) ok = false;
+            else (*hashmap_int_int_entry_get(&e))++;
+            hashmap_int_int_insert(&m, key, *hashmap_int_int_get_ptr(&m, key));
+            if (key != held_key && hashmap_int_int_get_ptr(&m, held_key) != held) ok = false;
+            if (key == held_key) held = hashmap_int_int_get_ptr(&m, held_key);
+        }
+        if (m.capacity != cap || m.migrate_pos != pos || hashmap_int_int_len(&m) != (size_t)n) ok = false;
+        for (int key = 0; ok && key < n; key++) {
+            if (unwrap(hashmap_int_int_get(&m, key)) != key + 2) ok = false;
+        }
+        hashmap_int_int_free(&m);
+    }
+    
+    hashmap_int_int_free(&m_ref);
+    hashmap_int_int_free(&m_goi);
+    hashmap_int_int_free(&m_entry);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 79: Incremental resize is invisible to map operations
+ * For any sequence of inserts, removes and in-place updates that grows the
+ * map several times, an incrementally resizing map agrees with a regular
+ * map on every lookup, including while old and new tables coexist
+ *============================================================================*/
+
+static enum theft_trial_res prop_incremental_resize(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    
+    HashMap_int_int inc = hashmap_int_int_new();
+    HashMap_int_int ref = hashmap_int_int_new();
+    hashmap_int_int_set_incremental(&inc, true);
+    
+    bool ok = true;
+    bool saw_both_tables = false;
+    
+    for (int round = 0; ok && round < 3000; round++) {
+        state = state * 1664525u + 1013904223u;
+        int key = (int)((state >> 8) % 2048);
+        int op = (int)((state >> 24) % 8);
+        
+        if (op < 5) {
+            hashmap_int_int_insert(&inc, key, round);
+            hashmap_int_int_insert(&ref, key, round);
+        } else if (op == 5) {
+            Option_int a = hashmap_int_int_remove(&inc, key);
+            Option_int b = hashmap_int_int_remove(&ref, key);
+            if (is_some(a) != is_some(b) || (is_some(a) && unwrap(a) != unwrap(b))) ok = false;
+        } else if (op == 6) {
+            (*hashmap_int_int_get_or_insert(&inc, key, 0))++;
+            (*hashmap_int_int_get_or_insert(&ref, key, 0))++;
+        } else {
+            HashMapEntry_int_int e = hashmap_int_int_entry(&inc, key);
+            *hashmap_int_int_entry_or_insert(&e, 0) += 2;
+            (*hashmap_int_int_get_or_insert(&ref, key, 0)) += 2;
+        }
+        
+        if (inc.old_buckets != NULL) {
+            saw_both_tables = true;
+            /* Lookups see keys in either table and leave the tables alone */
+            size_t pos = inc.migrate_pos;
+            int probe = (int)((state >> 4) % 2048);
+            int *p = hashmap_int_int_get_ptr(&inc, probe);
+            Option_int a = hashmap_int_int_get(&inc, probe);
+            Option_int b = hashmap_int_int_get(&ref, probe);
+            if (is_some(a) != is_some(b) || (is_some(a) && unwrap(a) != unwrap(b))) ok = false;
+            if ((p != NULL) != is_some(b) || (p && *p != unwrap(b))) ok = false;
+            if (hashmap_int_int_contains(&inc, probe) != is_some(b)) ok = false;
+            if (inc.migrate_pos != pos) ok = false;
+        }
+        if (hashmap_int_int_len(&inc) != hashmap_int_int_len(&ref)) ok = false;
+    }
+    
+    /* Iteration covers both tables while a resize is in progress */
+    {
+        size_t count = 0;
+        HashMapIter_int_int it = hashmap_int_int_iter(&inc);
+        Option_MapPair_int_int e;
+        while ((e = hashmap_int_int_iter_next(&it)).has_value) {
+            Option_int b = hashmap_int_int_get(&ref, e.value.key);
+            if (!is_some(b) || unwrap(b) != e.value.value) ok = false;
+            count++;
+        }
+        if (count != hashmap_int_int_len(&ref)) ok = false;
+    }
+    
+    hashmap_int_int_finish_resize(&inc);
+    if (inc.old_buckets != NULL) ok = false;
+    for (int key = 0; ok && key < 2048; key++) {
+        Option_int a = hashmap_int_int_get(&inc, key);
+        Option_int b = hashmap_int_int_get(&ref, key);
+        if (is_some(a) != is_some(b) || (is_some(a) && unwrap(a) != unwrap(b))) ok = false;
+    }
+    
+    hashmap_int_int_free(&inc);
+    hashmap_int_int_free(&ref);
+    return (ok && saw_both_tables) ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 80: Batch lookups match one-at-a-time lookups
+ * For any key set and query list whose length is not a multiple of the
+ * batch size, get_batch and contains_batch agree with get and contains,
+ * on an empty map, a regular map and a map in the middle of a resize
+ *============================================================================*/
+
+static bool batch_matches(HashMap_int_int *m, const int *queries, size_t n) {
+    int out[300];
+    bool found[300];
+    bool found2[300];
+    for (size_t i = 0; i < n; i++) out[i] = -12345;
+    
+    size_t hits = hashmap_int_int_get_batch(m, queries, n, out, found);
+    size_t hits2 = hashmap_int_int_contains_batch(m, queries, n, found2);
+    size_t hits3 = hashmap_int_int_contains_batch(m, queries, n, NULL);
+    if (hits != hits2 || hits != hits3) return false;
+    
+    size_t expected = 0;
+    for (size_t i = 0; i < n; i++) {
+        Option_int v = hashmap_int_int_get(m, queries[i]);
+        if (found[i] != is_some(v) || found2[i] != is_some(v)) return false;
+        /* Missing keys leave their output slot untouched */
+        if (is_some(v) ? out[i] != unwrap(v) : out[i] != -12345) return false;
+        if (is_some(v)) expected++;
+    }
+    return hits == expected;
+}
+
+static enum theft_trial_res prop_batch_lookup(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    
+    int queries[300];
+    size_t n = 1 + (state % 299);
+    for (size_t i = 0; i < n; i++) {
+        state = state * 1664525u + 1013904223u;
+        queries[i] = (int)((state >> 8) % 1024);
+    }
+    
+    HashMap_int_int m = hashmap_int_int_new();
+    bool ok = batch_matches(&m, queries, n);
+    
+    /* Half the key space present */
+    for (int k = 0; k < 1024; k += 2) hashmap_int_int_insert(&m, k, k * 3);
+    ok = ok && batch_matches(&m, queries, n);
+    
+    /* Same again while old and new tables coexist */
+    HashMap_int_int inc = hashmap_int_int_new();
+    hashmap_int_int_set_incremental(&inc, true);
+    bool saw_resize = false;
+    for (int k = 0; ok && k < 1024; k++) {
+        hashmap_int_int_insert(&inc, (k * 37) % 1024, k);
+        if (inc.old_buckets != NULL && k % 16 == 0) {
+            saw_resize = true;
+            ok = batch_matches(&inc, queries, n);
+        }
+    }
+    
+    hashmap_int_int_free(&m);
+    hashmap_int_int_free(&inc);
+    return (ok && saw_resize) ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 84: HashMap stats match a direct scan of the table
+ * For any mix of inserts and removes, hashmap_int_int_stats reports the
+ * same tombstones and per-key probe lengths as walking each key's probe
+ * sequence by hand, counts one resize per doubling, and times the rehash
+ * done by finish_resize
+ *============================================================================*/
+
+static size_t constant_hash(const void *key, size_t key_size) {
+    (void)key;
+    (void)key_size;
+    return 42;
+}
+
+static enum theft_trial_res prop_stats(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    bool ok = true;
+    
+    HashMap_int_int m = hashmap_int_int_new();
+    for (int round = 0; round < 1500; round++) {
+        state = state * 1664525u + 1013904223u;
+        int key = (int)((state >> 8) % 4096);
+        if ((state >> 28) < 11) hashmap_int_int_insert(&m, key, round);
+        else hashmap_int_int_remove(&m, key);
+    }
+    
+    HashMapStats st = hashmap_int_int_stats(&m);
+    size_t mask = m.capacity - 1;
+    size_t tombstones = 0, max_probe = 0, total = 0;
+    size_t histogram[CYAN_HASHMAP_STATS_BUCKETS] = { 0 };
+    for (size_t i = 0; i < m.capacity; i++) {
+        if (m.buckets[i].tag == _CYAN_TAG_DELETED) tombstones++;
+        if (!_CYAN_TAG_IS_FULL(m.buckets[i].tag)) continue;
+        
+        /* Count the slots a lookup of this key walks through */
+        int key = m.buckets[i].key;
+        size_t idx = _hashmap_int_int_hash(&m, key) & mask;
+        size_t probe = 1;
+        while (idx != i) { idx = (idx + 1) & mask; probe++; }
+        histogram[probe < CYAN_HASHMAP_STATS_BUCKETS ? probe - 1 : CYAN_HASHMAP_STATS_BUCKETS - 1]++;
+        if (probe > max_probe) max_probe = probe;
+        total += probe;
+    }
+    
+    if (st.len != m.len || st.capacity != m.capacity || st.tombstones != tombstones) ok = false;
+    if (st.max_probe != max_probe || memcmp(st.probe_histogram, histogram, sizeof(histogram)) != 0) ok = false;
+    if (st.mean_probe * (double)st.len < (double)total - 0.5 || st.mean_probe * (double)st.len > (double)total + 0.5) ok = false;
+    if (st.load_factor != (double)m.len / (double)m.capacity) ok = false;
+    if (m.capacity != (size_t)CYAN_HASHMAP_INITIAL_CAPACITY << st.resizes) ok = false;
+    
+    /* A constant hash puts every key in one cluster */
+    HashMap_int_int bad = hashmap_int_int_new();
+    bad.hash_fn = constant_hash;
+    size_t n = 20 + (state >> 8) % 40;
+    for (size_t k = 0; k < n; k++) hashmap_int_int_insert(&bad, (int)k, 0);
+    HashMapStats bs = hashmap_int_int_stats(&bad);
+    if (bs.max_probe != n || bs.mean_probe != (double)(n + 1) / 2.0) ok = false;
+    if (bs.probe_histogram[CYAN_HASHMAP_STATS_BUCKETS - 1] != n - (CYAN_HASHMAP_STATS_BUCKETS - 1)) ok = false;
+    
+    /* Finishing an incremental resize is a blocking rehash, so it is timed */
+    HashMap_int_int inc = hashmap_int_int_new();
+    hashmap_int_int_set_incremental(&inc, true);
+    for (int k = 0; inc.old_capacity < 1024 && k < 4096; k++) hashmap_int_int_insert(&inc, k, k);
+    uint64_t before = hashmap_int_int_stats(&inc).rehash_ns;
+    hashmap_int_int_finish_resize(&inc);
+    if (inc.old_buckets != NULL || hashmap_int_int_stats(&inc).rehash_ns <= before) ok = false;
+    hashmap_int_int_free(&inc);
+    
+    /* An empty map reports zeros */
+    HashMap_int_int empty = hashmap_int_int_new();
+    HashMapStats es = hashmap_int_int_stats(&empty);
+    if (es.len != 0 || es.max_probe != 0 || es.mean_probe != 0.0 || es.resizes != 0) ok = false;
+    
+    hashmap_int_int_free(&m);
+    hashmap_int_int_free(&bad);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 95: The occupancy bitmap tracks the tags and drives iteration
+ * For any mix of inserts, removes and entry calls, in regular or incremental
+ * mode, each table's bitmap bit is set exactly for its full slots, and
+ * iter_next_ptr visits every entry once, with values writable in place
+ *============================================================================*/
+
+/* Every bitmap bit of a table matches its slot's tag */
+static bool occ_matches_tags(_MapEntry_int_int *buckets, size_t cap) {
+    uint64_t *occ = _hashmap_int_int_occ(buckets, cap);
+    for (size_t i = 0; i < cap; i++) {
+        bool bit = (occ[i / 64] >> (i % 64)) & 1;
+        if (bit != _CYAN_TAG_IS_FULL(buckets[i].tag)) return false;
+    }
+    return true;
+}
+
+static enum theft_trial_res prop_occupancy_iteration(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    bool ok = true;
+    
+    HashMap_int_int m = hashmap_int_int_new();
+    hashmap_int_int_set_incremental(&m, state & 1);
+    static int present[4096];
+    memset(present, 0, sizeof(present));
+    size_t rounds = 200 + (state >> 4) % 3000;
+    for (size_t round = 0; round < rounds; round++) {
+        state = state * 1664525u + 1013904223u;
+        int key = (int)((state >> 8) % 4096);
+        switch (state >> 29) {
+            case 0: case 1: case 2:
+                hashmap_int_int_insert(&m, key, key);
+                present[key] = 1;
+                break;
+            case 3:
+                *hashmap_int_int_get_or_insert(&m, key, key) = key;
+                present[key] = 1;
+                break;
+            case 4: {
+                HashMapEntry_int_int e = hashmap_int_int_entry(&m, key);
+                hashmap_int_int_entry_insert(&e, key);
+                present[key] = 1;
+                break;
+            }
+            case 5: {
+                HashMapEntry_int_int e = hashmap_int_int_entry(&m, key);
+                hashmap_int_int_entry_remove(&e);
+                present[key] = 0;
+                break;
+            }
+            default:
+                hashmap_int_int_remove(&m, key);
+                present[key] = 0;
+                break;
+        }
+    }
+    
+    if (m.capacity > 0 && !occ_matches_tags(m.buckets, m.capacity)) ok = false;
+    if (m.old_buckets && !occ_matches_tags(m.old_buckets, m.old_capacity)) ok = false;
+    
+    /* Visit every entry once through pointers, doubling values in place */
+    static int seen[4096];
+    memset(seen, 0, sizeof(seen));
+    size_t count = 0;
+    const int *k;
+    int *v;
+    HashMapIter_int_int it = hashmap_int_int_iter(&m);
+    while (hashmap_int_int_iter_next_ptr(&it, &k, &v)) {
+        if (*k < 0 || *k >= 4096 || !present[*k] || seen[*k]++ || *v != *k) ok = false;
+        *v *= 2;
+        count++;
+    }
+    if (count != hashmap_int_int_len(&m) || hashmap_int_int_iter_next_ptr(&it, &k, &v)) ok = false;
+    
+    /* The updates landed in the map */
+    for (int key = 0; key < 4096 && ok; key++) {
+        Option_int got = hashmap_int_int_get(&m, key);
+        if (got.has_value != (bool)present[key]) ok = false;
+        if (got.has_value && got.value != key * 2) ok = false;
+    }
+    
+    hashmap_int_int_free(&m);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 96: retain and iter_remove remove exactly the rejected entries
+ * For any map and any predicate, retain removes the entries it rejects,
+ * keeps the rest with their in-place updates and returns the count removed;
+ * removing through the iterator mid-walk gives the same map
+ *============================================================================*/
+
+/* Keep keys not divisible by *ctx, bumping the values of those kept */
+static bool keep_indivisible(const int *key, int *value, void *ctx) {
+    if (*key % *(int *)ctx == 0) return false;
+    (*value)++;
+    return true;
+}
+
+static enum theft_trial_res prop_retain(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    int divisor = 2 + (int)(state % 5);
+    bool ok = true;
+    
+    HashMap_int_int a = hashmap_int_int_new();
+    HashMap_int_int b = hashmap_int_int_new();
+    hashmap_int_int_set_incremental(&a, (state >> 3) & 1);
+    hashmap_int_int_set_incremental(&b, (state >> 3) & 1);
+    size_t n = (state >> 4) % 2000;
+    for (size_t i = 0; i < n; i++) {
+        state = state * 1664525u + 1013904223u;
+        int key = (int)((state >> 8) % 10000);
+        hashmap_int_int_insert(&a, key, key);
+        hashmap_int_int_insert(&b, key, key);
+    }
+    size_t before = hashmap_int_int_len(&a);
+    
+    size_t removed = hashmap_int_int_retain(&a, keep_indivisible, &divisor);
+    
+    /* Same filter while iterating */
+    size_t removed_it = 0;
+    const int *k;
+    int *v;
+    HashMapIter_int_int it = hashmap_int_int_iter(&b);
+    if (hashmap_int_int_iter_remove(&it)) ok = false;   /* Nothing returned yet */
+    while (hashmap_int_int_iter_next_ptr(&it, &k, &v)) {
+        if (keep_indivisible(k, v, &divisor)) continue;
+        if (!hashmap_int_int_iter_remove(&it) || hashmap_int_int_iter_remove(&it)) ok = false;
+        removed_it++;
+    }
+    
+    if (removed != removed_it || hashmap_int_int_len(&a) != before - removed) ok = false;
+    if (hashmap_int_int_len(&b) != hashmap_int_int_len(&a)) ok = false;
+    for (int key = 0; key < 10000 && ok; key++) {
+        Option_int ga = hashmap_int_int_get(&a, key);
+        Option_int gb = hashmap_int_int_get(&b, key);
+        if (ga.has_value != gb.has_value) ok = false;
+        if (ga.has_value && (key % divisor == 0 || ga.value != key + 1 || gb.value != key + 1)) ok = false;
+    }
+    if (a.capacity > 0 && !occ_matches_tags(a.buckets, a.capacity)) ok = false;
+    if (a.old_buckets && !occ_matches_tags(a.old_buckets, a.old_capacity)) ok = false;
+    
+    hashmap_int_int_free(&a);
+    hashmap_int_int_free(&b);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
 /*============================================================================
  * Test Registration
  *============================================================================*/
@@ -503,6 +1060,41 @@ static HashMapTest hashmap_tests[] = {
         prop_vtable_behavioral_equivalence,
         THEFT_BUILTIN_int64_t
     },
+    {
+        "Property 66: Compile-time specialized HashMap matches default HashMap",
+        prop_specialized_equivalence,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 73: HashMap in-place access matches get-then-insert",
+        prop_entry_api,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 79: Incremental resize is invisible to map operations",
+        prop_incremental_resize,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 80: Batch lookups match one-at-a-time lookups",
+        prop_batch_lookup,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 84: HashMap stats match a direct scan of the table",
+        prop_stats,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 95: The occupancy bitmap tracks the tags and drives iteration",
+        prop_occupancy_iteration,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 96: retain and iter_remove remove exactly the rejected entries",
+        prop_retain,
+        THEFT_BUILTIN_int64_t
+    },
 };
 
 #define NUM_HASHMAP_TESTS (sizeof(hashmap_tests) / sizeof(hashmap_tests[0]))
@@ -0,0 +1,235 @@
+/**
+ * @file test_hashmap_mmap.c
+ * @brief Property-based tests for memory-mapped HashMap snapshots
+ * 
+ * Tests validate correctness properties:
+ * - Property 86: A mapped snapshot answers every lookup like the saved map
+ * - Property 87: Mismatched, corrupt or missing snapshots are rejected
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "theft.h"
+#include "test_util.h"
+#include <cyan/option.h>
+#include <cyan/hashmap.h>
+#include <cyan/hashmap_mmap.h>
+
+typedef int64_t i64;
+
+/* Define Option, HashMap and snapshot functions for testing */
+OPTION_DEFINE(int);
+HASHMAP_DEFINE(int, int);
+HASHMAP_ITER_DEFINE(int, int);
+HASHMAP_MMAP_DEFINE(int, int);
+
+OPTION_DEFINE(i64);
+HASHMAP_DEFINE_SCALAR(int, i64);
+HASHMAP_MMAP_DEFINE(int, i64);
+
+/* Keys are drawn from [0, KEY_RANGE) so sequences contain duplicates */
+#define KEY_RANGE 4096
+
+/* Per-process scratch file so parallel test runs do not collide */
+static void snapshot_path(char *buf, size_t size) {
+    snprintf(buf, size, "/tmp/cyan_test_%ld.map", (long)getpid());
+}
+
+/*============================================================================
+ * Property 86: A mapped snapshot answers every lookup like the saved map
+ * For any map built with inserts and removes under any hash seed, possibly
+ * mid incremental resize, the mapped copy has the same len and finds the same value for
+ * every key, through get, get_ptr, get_batch and iteration
+ *============================================================================*/
+
+static enum theft_trial_res prop_mmap_roundtrip(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    char path[64];
+    snapshot_path(path, sizeof(path));
+    bool ok = true;
+    
+    HashMap_int_int m = hashmap_int_int_with_seed((uint64_t)state * 0x9E3779B97F4A7C15ULL);
+    hashmap_int_int_set_incremental(&m, state & 1);
+    size_t rounds = state % 3000;
+    for (size_t i = 0; i < rounds; i++) {
+        int key = (int)(next_rand(&state) % KEY_RANGE);
+        if ((int)(next_rand(&state) % 4) == 0) hashmap_int_int_remove(&m, key);
+        else hashmap_int_int_insert(&m, key, (int)i);
+    }
+    
+    Result_size_t_MapFileError saved = hashmap_int_int_save(&m, path);
+    if (!is_ok(saved)) {
+        hashmap_int_int_free(&m);
+        return THEFT_TRIAL_FAIL;
+    }
+    
+    Result_HashMap_int_int_MapFileError r = hashmap_int_int_open_mmap(path);
+    unlink(path); /* The mapping stays valid after the name is gone */
+    if (!is_ok(r)) {
+        hashmap_int_int_free(&m);
+        return THEFT_TRIAL_FAIL;
+    }
+    HashMap_int_int mapped = unwrap_ok(r);
+    
+    if (hashmap_int_int_len(&mapped) != hashmap_int_int_len(&m)) ok = false;
+    if (mapped.seed != m.seed) ok = false;
+    
+    static int keys[KEY_RANGE];
+    static int out[KEY_RANGE];
+    static bool found[KEY_RANGE];
+    for (int k = 0; k < KEY_RANGE; k++) keys[k] = k;
+    hashmap_int_int_get_batch(&mapped, keys, KEY_RANGE, out, found);
+    
+    for (int k = 0; k < KEY_RANGE && ok; k++) {
+        Option_int a = hashmap_int_int_get(&m, k);
+        Option_int b = hashmap_int_int_get(&mapped, k);
+        int *p = hashmap_int_int_get_ptr(&mapped, k);
+        if (is_some(a) != is_some(b) || (is_some(a) && unwrap(a) != unwrap(b))) ok = false;
+        if ((p != NULL) != is_some(a) || (p && *p != unwrap(a))) ok = false;
+        if (found[k] != is_some(a) || (found[k] && out[k] != unwrap(a))) ok = false;
+    }
+    
+    size_t count = 0;
+    HashMapIter_int_int it = hashmap_int_int_iter(&mapped);
+    Option_MapPair_int_int e;
+    while ((e = hashmap_int_int_iter_next(&it)).has_value) {
+        Option_int a = hashmap_int_int_get(&m, e.value.key);
+        if (!is_some(a) || unwrap(a) != e.value.value) ok = false;
+        count++;
+    }
+    if (count != hashmap_int_int_len(&m)) ok = false;
+    
+    hashmap_int_int_close_mmap(&mapped);
+    if (mapped.buckets != NULL || hashmap_int_int_len(&mapped) != 0) ok = false;
+    hashmap_int_int_free(&m);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 87: Mismatched, corrupt or missing snapshots are rejected
+ * For any saved map, opening it as a map with a different value size,
+ * under a different hash function, after truncation, or after the file is
+ * removed returns Err instead of a map
+ *============================================================================*/
+
+static size_t other_hash(const void *key, size_t key_size) {
+    return _cyan_fnv1a_hash(key, key_size) * 31 + 7;
+}
+
+static enum theft_trial_res prop_mmap_rejects(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    char path[64];
+    snapshot_path(path, sizeof(path));
+    bool ok = true;
+    
+    HashMap_int_int m = hashmap_int_int_new();
+    size_t n = 1 + state % 500;
+    for (size_t i = 0; i < n; i++) hashmap_int_int_insert(&m, (int)(next_rand(&state) % KEY_RANGE), (int)i);
+    if (!is_ok(hashmap_int_int_save(&m, path))) ok = false;
+    
+    /* Same key type, wider value type */
+    if (is_ok(hashmap_int_i64_open_mmap(path))) ok = false;
+    
+    /* Keys stored under FNV-1a do not match their tags under another hash */
+    Result_HashMap_int_int_MapFileError r =
+        hashmap_int_int_open_mmap_with(path, other_hash, _cyan_default_equal);
+    if (is_ok(r)) ok = false;
+    
+    /* Cut the table short */
+    if (truncate(path, 64 + (off_t)(state % 64)) != 0) ok = false;
+    if (is_ok(hashmap_int_int_open_mmap(path))) ok = false;
+    
+    /* Missing file */
+    unlink(path);
+    r = hashmap_int_int_open_mmap(path);
+    if (is_ok(r) || unwrap_err(r) == NULL) ok = false;
+    
+    /* An empty map round-trips without a mapping */
+    HashMap_int_int empty = hashmap_int_int_new();
+    if (!is_ok(hashmap_int_int_save(&empty, path))) ok = false;
+    r = hashmap_int_int_open_mmap(path);
+    unlink(path);
+    if (!is_ok(r)) {
+        ok = false;
+    } else {
+        HashMap_int_int mapped = unwrap_ok(r);
+        if (hashmap_int_int_len(&mapped) != 0 || hashmap_int_int_contains(&mapped, 1)) ok = false;
+        hashmap_int_int_close_mmap(&mapped);
+    }
+    
+    hashmap_int_int_free(&m);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+/* Minimum iterations for property tests */
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} HashMapMmapTest;
+
+static HashMapMmapTest hashmap_mmap_tests[] = {
+    {
+        "Property 86: A mapped snapshot answers every lookup like the saved map",
+        prop_mmap_roundtrip,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 87: Mismatched, corrupt or missing snapshots are rejected",
+        prop_mmap_rejects,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_HASHMAP_MMAP_TESTS (sizeof(hashmap_mmap_tests) / sizeof(hashmap_mmap_tests[0]))
+
+int run_hashmap_mmap_tests(theft_seed seed) {
+    int failures = 0;
+    
+    printf("\nHashMap Snapshot Tests:\n");
+    
+    for (size_t i = 0; i < NUM_HASHMAP_MMAP_TESTS; i++) {
+        HashMapMmapTest *test = &hashmap_mmap_tests[i];
+        
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+        
+        enum theft_run_res res = theft_run(&config);
+        
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+    
+    return failures;
+}
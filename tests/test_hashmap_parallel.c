@@ -0,0 +1,200 @@
+/**
+ * @file test_hashmap_parallel.c
+ * @brief Property-based tests for multi-threaded HashMap construction
+ * 
+ * Tests validate correctness properties:
+ * - Property 97: A parallel build equals inserting the pairs in order
+ * - Property 98: Keys that probe past their region are still found
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "theft.h"
+#include "test_util.h"
+#include <cyan/option.h>
+#include <cyan/hashmap.h>
+#include <cyan/hashmap_parallel.h>
+
+/* Define Option, HashMap and parallel build functions for testing */
+OPTION_DEFINE(u32);
+HASHMAP_DEFINE(u32, u32);
+HASHMAP_ITER_DEFINE(u32, u32);
+HASHMAP_PARALLEL_DEFINE(u32, u32);
+
+/*
+ * Runs of 8 consecutive keys share a home bucket, and homes count down from
+ * the last slot, so clusters cross region boundaries and wrap past the end
+ */
+#define CLUSTERED_HASH(k) (SIZE_MAX - (size_t)((k) >> 3))
+typedef u32 ckey;
+HASHMAP_DEFINE_WITH(ckey, u32, CLUSTERED_HASH, CYAN_EQ_SCALAR);
+HASHMAP_ITER_DEFINE(ckey, u32);
+HASHMAP_PARALLEL_DEFINE(ckey, u32);
+
+#define MAX_PAIRS 60000
+
+/* The bitmap bit of every slot matches its tag */
+#define OCC_MATCHES_TAGS(m, ok) do { \
+    uint64_t *occ_ = (uint64_t *)((char *)(m).buckets + \
+        _cyan_map_occ_offset((m).capacity, sizeof((m).buckets[0]))); \
+    for (size_t i_ = 0; i_ < (m).capacity; i_++) { \
+        bool bit_ = (occ_[i_ / 64] >> (i_ % 64)) & 1; \
+        if (bit_ != _CYAN_TAG_IS_FULL((m).buckets[i_].tag)) (ok) = false; \
+    } \
+} while (0)
+
+/*============================================================================
+ * Property 97: A parallel build equals inserting the pairs in order
+ * For any key and value arrays (with repeated keys) and any thread count,
+ * from_slices_parallel gives a map with the same len as inserting each
+ * pair in turn, every key maps to its last value, and the occupancy bitmap
+ * matches the table
+ *============================================================================*/
+
+static enum theft_trial_res prop_parallel_matches_serial(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u32 state = (u32)(*val_ptr);
+    static u32 keys[MAX_PAIRS], values[MAX_PAIRS];
+    size_t n = next_rand(&state) % MAX_PAIRS;
+    u32 range = 1 + next_rand(&state) % (2 * MAX_PAIRS);
+    size_t threads = next_rand(&state) % 9;     /* 0 picks one per CPU */
+    bool ok = true;
+    
+    HashMap_u32_u32 serial = hashmap_u32_u32_new();
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = next_rand(&state) % range;
+        values[i] = (u32)i;
+        hashmap_u32_u32_insert(&serial, keys[i], values[i]);
+    }
+    
+    HashMap_u32_u32 m = hashmap_u32_u32_from_slices_parallel(keys, values, n, threads);
+    if (hashmap_u32_u32_len(&m) != hashmap_u32_u32_len(&serial)) ok = false;
+    
+    size_t count = 0;
+    const u32 *k;
+    u32 *v;
+    HashMapIter_u32_u32 it = hashmap_u32_u32_iter(&m);
+    while (hashmap_u32_u32_iter_next_ptr(&it, &k, &v)) {
+        Option_u32 want = hashmap_u32_u32_get(&serial, *k);
+        if (!is_some(want) || unwrap(want) != *v) ok = false;
+        count++;
+    }
+    if (count != hashmap_u32_u32_len(&m)) ok = false;
+    for (size_t i = 0; i < n && ok; i++) {
+        if (unwrap(hashmap_u32_u32_get(&m, keys[i])) != unwrap(hashmap_u32_u32_get(&serial, keys[i]))) ok = false;
+    }
+    OCC_MATCHES_TAGS(m, ok);
+    
+    /* The result is an ordinary map */
+    hashmap_u32_u32_insert(&m, UINT32_MAX, 1);
+    if (!hashmap_u32_u32_contains(&m, UINT32_MAX)) ok = false;
+    
+    hashmap_u32_u32_free(&m);
+    hashmap_u32_u32_free(&serial);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 98: Keys that probe past their region are still found
+ * For keys whose hashes pile into long clusters that cross region
+ * boundaries and wrap around the table, the parallel build finds every
+ * key with its last value and agrees with inserting in order
+ *============================================================================*/
+
+static enum theft_trial_res prop_parallel_spills(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u32 state = (u32)(*val_ptr);
+    static u32 keys[MAX_PAIRS], values[MAX_PAIRS];
+    size_t n = CYAN_HASHMAP_PARALLEL_MIN + next_rand(&state) % (MAX_PAIRS - CYAN_HASHMAP_PARALLEL_MIN);
+    size_t threads = 2 + next_rand(&state) % 7;
+    bool ok = true;
+    
+    HashMap_ckey_u32 serial = hashmap_ckey_u32_new();
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = next_rand(&state) % (u32)n;
+        values[i] = (u32)i;
+        hashmap_ckey_u32_insert(&serial, keys[i], values[i]);
+    }
+    
+    HashMap_ckey_u32 m = hashmap_ckey_u32_from_slices_parallel(keys, values, n, threads);
+    if (hashmap_ckey_u32_len(&m) != hashmap_ckey_u32_len(&serial)) ok = false;
+    for (size_t i = 0; i < n && ok; i++) {
+        Option_u32 got = hashmap_ckey_u32_get(&m, keys[i]);
+        if (!is_some(got) || unwrap(got) != unwrap(hashmap_ckey_u32_get(&serial, keys[i]))) ok = false;
+    }
+    OCC_MATCHES_TAGS(m, ok);
+    
+    hashmap_ckey_u32_free(&m);
+    hashmap_ckey_u32_free(&serial);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+/* Minimum iterations for property tests */
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} HashMapParallelTest;
+
+static HashMapParallelTest hashmap_parallel_tests[] = {
+    {
+        "Property 97: A parallel build equals inserting the pairs in order",
+        prop_parallel_matches_serial,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 98: Keys that probe past their region are still found",
+        prop_parallel_spills,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_HASHMAP_PARALLEL_TESTS (sizeof(hashmap_parallel_tests) / sizeof(hashmap_parallel_tests[0]))
+
+int run_hashmap_parallel_tests(theft_seed seed) {
+    int failures = 0;
+    
+    printf("\nHashMap Parallel Build Tests:\n");
+    
+    for (size_t i = 0; i < NUM_HASHMAP_PARALLEL_TESTS; i++) {
+        HashMapParallelTest *test = &hashmap_parallel_tests[i];
+        
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+        
+        enum theft_run_res res = theft_run(&config);
+        
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+    
+    return failures;
+}
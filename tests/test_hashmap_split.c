@@ -0,0 +1,266 @@
+/**
+ * @file test_hashmap_split.c
+ * @brief Property-based tests for the HashMap slot layout
+ * 
+ * This file builds its maps with CYAN_HASHMAP_SPLIT_VALUES, so keys and
+ * values are stored in separate arrays, and with CYAN_HASHMAP_PROFILE, so
+ * they count probes. Its types are private to this file.
+ * 
+ * Tests validate correctness properties:
+ * - Property 81: Split-value maps with colliding hash tags match a reference model
+ * - Property 85: Profile counters add up to the probe lengths in stats
+ */
+
+#define CYAN_HASHMAP_SPLIT_VALUES
+#define CYAN_HASHMAP_PROFILE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "theft.h"
+#include "test_util.h"
+#include <cyan/option.h>
+#include <cyan/hashmap.h>
+
+/* A value much larger than its key, the case split values are meant for */
+typedef struct {
+    int id;
+    int pad[15];
+} Payload;
+
+OPTION_DEFINE(Payload);
+HASHMAP_DEFINE(int, Payload);
+HASHMAP_ITER_DEFINE(int, Payload);
+
+/* Keys are drawn from [0, KEY_RANGE) so sequences contain duplicates */
+#define KEY_RANGE 512
+
+static Payload make_payload(int id) {
+    Payload p;
+    p.id = id;
+    for (int i = 0; i < 15; i++) p.pad[i] = id ^ i;
+    return p;
+}
+
+static bool payload_ok(Payload p, int id) {
+    if (p.id != id) return false;
+    for (int i = 0; i < 15; i++) {
+        if (p.pad[i] != (id ^ i)) return false;
+    }
+    return true;
+}
+
+/* Counts calls so the test can check that resizing never rehashes */
+static size_t g_hash_calls;
+
+static size_t counting_hash(const void *key, size_t key_size) {
+    g_hash_calls++;
+    return _cyan_fnv1a_hash(key, key_size);
+}
+
+/* Every key gets one of four hashes, two of which collide with the slot markers */
+static size_t colliding_hash(const void *key, size_t key_size) {
+    (void)key_size;
+    return (size_t)(*(const int *)key & 3);
+}
+
+/*============================================================================
+ * Property 81: Split-value maps with colliding hash tags match a reference model
+ * For any sequence of inserts, removes and entry updates, in either resize
+ * mode and even when many keys share a hash tag, lookups and iteration agree
+ * with an array model, and growing the table never calls the hash function
+ *============================================================================*/
+
+static bool check_model(HashMap_int_Payload *m, const int *model, size_t model_len) {
+    if (hashmap_int_Payload_len(m) != model_len) return false;
+    for (int k = 0; k < KEY_RANGE; k++) {
+        Option_Payload v = hashmap_int_Payload_get(m, k);
+        if (is_some(v) != (model[k] >= 0)) return false;
+        if (is_some(v) && !payload_ok(unwrap(v), model[k])) return false;
+    }
+    
+    /* Iteration visits every entry once with its own value */
+    bool visited[KEY_RANGE] = { false };
+    size_t count = 0;
+    HashMapIter_int_Payload it = hashmap_int_Payload_iter(m);
+    Option_MapPair_int_Payload p;
+    while ((p = hashmap_int_Payload_iter_next(&it)).has_value) {
+        int key = p.value.key;
+        if (key < 0 || key >= KEY_RANGE || model[key] < 0 || visited[key]) return false;
+        if (!payload_ok(p.value.value, model[key])) return false;
+        visited[key] = true;
+        count++;
+    }
+    return count == model_len;
+}
+
+static enum theft_trial_res prop_split_tagged_model(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    bool ok = true;
+    
+    for (int variant = 0; variant < 4 && ok; variant++) {
+        HashMap_int_Payload m = hashmap_int_Payload_new();
+        m.hash_fn = variant < 2 ? counting_hash : colliding_hash;
+        hashmap_int_Payload_set_incremental(&m, variant & 1);
+        
+        int model[KEY_RANGE];
+        size_t model_len = 0;
+        for (int k = 0; k < KEY_RANGE; k++) model[k] = -1;
+        
+        for (int round = 0; round < 600 && ok; round++) {
+            int key = (int)(next_rand(&state) % KEY_RANGE);
+            int op = (int)(next_rand(&state) % 4);
+            int id = (int)(next_rand(&state) % KEY_RANGE);
+            
+            if (op <= 1) {
+                size_t before = g_hash_calls;
+                hashmap_int_Payload_insert(&m, key, make_payload(id));
+                /* One hash per insert, however many slots a resize moved */
+                if (variant < 2 && g_hash_calls - before != 1) ok = false;
+                if (model[key] < 0) model_len++;
+                model[key] = id;
+            } else if (op == 2) {
+                Option_Payload v = hashmap_int_Payload_remove(&m, key);
+                if (is_some(v) != (model[key] >= 0)) ok = false;
+                if (is_some(v) && !payload_ok(unwrap(v), model[key])) ok = false;
+                if (model[key] >= 0) { model[key] = -1; model_len--; }
+            } else {
+                HashMapEntry_int_Payload e = hashmap_int_Payload_entry(&m, key);
+                Payload *slot = hashmap_int_Payload_entry_or_insert(&e, make_payload(id));
+                if (model[key] < 0) { model[key] = id; model_len++; }
+                if (!payload_ok(*slot, model[key])) ok = false;
+            }
+        }
+        
+        if (ok && !check_model(&m, model, model_len)) ok = false;
+        hashmap_int_Payload_finish_resize(&m);
+        if (ok && !check_model(&m, model, model_len)) ok = false;
+        hashmap_int_Payload_free(&m);
+    }
+    
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 85: Profile counters add up to the probe lengths in stats
+ * For any set of distinct keys, looking each one up once adds exactly the
+ * sum of the stats probe lengths to lookup_probes, and every insert and
+ * lookup, hit or miss, is counted once in its category
+ *============================================================================*/
+
+static enum theft_trial_res prop_profile_counters(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    bool ok = true;
+    
+    HashMap_int_Payload m = hashmap_int_Payload_new();
+    bool present[KEY_RANGE] = { false };
+    size_t inserts = 0;
+    for (int k = 0; k < KEY_RANGE; k++) {
+        if ((int)(next_rand(&state) % 3) == 0) continue;
+        hashmap_int_Payload_insert(&m, k, make_payload(k));
+        present[k] = true;
+        inserts++;
+    }
+    
+    HashMapStats s0 = hashmap_int_Payload_stats(&m);
+    if (s0.profile.inserts != inserts || s0.profile.lookups != 0) ok = false;
+    if (s0.profile.insert_probes < inserts || s0.profile.probes != s0.profile.insert_probes) ok = false;
+    
+    /* Finding every present key walks exactly the probe lengths in stats */
+    for (int k = 0; k < KEY_RANGE; k++) {
+        if (present[k] && !hashmap_int_Payload_contains(&m, k)) ok = false;
+    }
+    HashMapStats s1 = hashmap_int_Payload_stats(&m);
+    double expected = s1.mean_probe * (double)s1.len;
+    double walked = (double)(s1.profile.lookup_probes - s0.profile.lookup_probes);
+    if (s1.profile.lookups - s0.profile.lookups != inserts) ok = false;
+    if (walked < expected - 0.5 || walked > expected + 0.5) ok = false;
+    
+    /* Misses and removes count as lookups and examine at least one slot */
+    size_t misses = 0;
+    for (int k = 0; k < KEY_RANGE; k++) {
+        if (present[k]) continue;
+        (void)hashmap_int_Payload_get(&m, k);
+        misses++;
+    }
+    (void)hashmap_int_Payload_remove(&m, 0);
+    HashMapStats s2 = hashmap_int_Payload_stats(&m);
+    if (s2.profile.lookups - s1.profile.lookups != misses + 1) ok = false;
+    if (s2.profile.lookup_probes - s1.profile.lookup_probes < misses + 1) ok = false;
+    if (s2.profile.probes != s2.profile.lookup_probes + s2.profile.insert_probes) ok = false;
+    if (s2.resizes == 0 || s2.rehash_ns == 0) ok = false;
+    
+    hashmap_int_Payload_free(&m);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+/* Minimum iterations for property tests */
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} HashMapSplitTest;
+
+static HashMapSplitTest hashmap_split_tests[] = {
+    {
+        "Property 81: Split-value maps with colliding hash tags match a reference model",
+        prop_split_tagged_model,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 85: Profile counters add up to the probe lengths in stats",
+        prop_profile_counters,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_HASHMAP_SPLIT_TESTS (sizeof(hashmap_split_tests) / sizeof(hashmap_split_tests[0]))
+
+int run_hashmap_split_tests(theft_seed seed) {
+    int failures = 0;
+    
+    printf("\nHashMap Split Layout Tests:\n");
+    
+    for (size_t i = 0; i < NUM_HASHMAP_SPLIT_TESTS; i++) {
+        HashMapSplitTest *test = &hashmap_split_tests[i];
+        
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+        
+        enum theft_run_res res = theft_run(&config);
+        
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+    
+    return failures;
+}
@@ -0,0 +1,337 @@
+/**
+ * @file test_hashset.c
+ * @brief Property-based tests for the HashSet type
+ * 
+ * Tests validate correctness properties:
+ * - Property 74: HashSet membership matches a reference model
+ * - Property 75: HashSet union/intersection/difference match a reference model
+ * - Property 76: HASHSET_DEFINE_SCALAR works through the SET_* vtable macros
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "theft.h"
+#include "test_util.h"
+#include <cyan/option.h>
+#include <cyan/vector.h>
+#include <cyan/slice.h>
+#include <cyan/hashset.h>
+
+typedef int64_t i64;
+
+/* Define Option, Vec, Slice and HashSet types for testing */
+OPTION_DEFINE(int);
+VECTOR_DEFINE(int);
+SLICE_DEFINE(int);
+HASHSET_DEFINE(int);
+
+OPTION_DEFINE(i64);
+VECTOR_DEFINE(i64);
+SLICE_DEFINE(i64);
+HASHSET_DEFINE_SCALAR(i64);
+
+/* Keys are drawn from [0, KEY_RANGE) so sequences contain duplicates */
+#define KEY_RANGE 256
+
+/*============================================================================
+ * Property 74: HashSet membership matches a reference model
+ * For any sequence of inserts, removes and bulk extends, contains and len
+ * agree with a boolean array, iteration yields each member exactly once,
+ * and tombstones are counted and cleared before they fill the table
+ *============================================================================*/
+
+static enum theft_trial_res prop_hashset_model(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    
+    HashSet_int s = hashset_int_new();
+    bool model[KEY_RANGE] = { false };
+    size_t model_len = 0;
+    
+    for (int round = 0; round < 400; round++) {
+        int key = (int)(next_rand(&state) % KEY_RANGE);
+        int op = (int)(next_rand(&state) % 3);
+        
+        if (op == 0) {
+            bool added = hashset_int_insert(&s, key);
+            if (added != !model[key]) goto fail;
+            if (!model[key]) { model[key] = true; model_len++; }
+        } else if (op == 1) {
+            bool removed = hashset_int_remove(&s, key);
+            if (removed != model[key]) goto fail;
+            if (model[key]) { model[key] = false; model_len--; }
+        } else {
+            /* Bulk insert a short run that may contain duplicates */
+            int batch[8];
+            size_t expected = 0;
+            bool seen[KEY_RANGE] = { false };
+            for (int i = 0; i < 8; i++) {
+                batch[i] = (int)(next_rand(&state) % KEY_RANGE);
+                if (!model[batch[i]] && !seen[batch[i]]) expected++;
+                seen[batch[i]] = true;
+            }
+            size_t added = hashset_int_extend(&s, slice_int_from_array(batch, 8));
+            if (added != expected) goto fail;
+            for (int i = 0; i < 8; i++) {
+                if (!model[batch[i]]) { model[batch[i]] = true; model_len++; }
+            }
+        }
+        
+        if (hashset_int_len(&s) != model_len) goto fail;
+    }
+    
+    for (int k = 0; k < KEY_RANGE; k++) {
+        if (hashset_int_contains(&s, k) != model[k]) goto fail;
+    }
+    
+    /* Iteration visits every member once and nothing else */
+    {
+        bool visited[KEY_RANGE] = { false };
+        size_t count = 0;
+        HashSetIter_int it = hashset_int_iter(&s);
+        Option_int k;
+        while (is_some(k = hashset_int_iter_next(&it))) {
+            int key = unwrap(k);
+            if (key < 0 || key >= KEY_RANGE || !model[key] || visited[key]) goto fail;
+            visited[key] = true;
+            count++;
+        }
+        if (count != model_len) goto fail;
+    }
+    
+    /* Tombstones are counted and, with live keys, kept under the load factor */
+    {
+        size_t deleted = 0;
+        for (size_t i = 0; i < s.capacity; i++) deleted += s.buckets[i].state == _CYAN_ENTRY_DELETED;
+        if (s.tombstones != deleted) goto fail;
+        if (s.capacity && (s.len + s.tombstones) * 100 / s.capacity > CYAN_HASHMAP_LOAD_FACTOR) goto fail;
+    }
+    
+    /* Churn through fresh keys: the table is cleaned, not grown, and a
+     * miss still ends at an empty slot */
+    {
+        hashset_int_free(&s);
+        s = hashset_int_new();
+        for (int k = 0; k < 100; k++) hashset_int_insert(&s, k);
+        size_t cap = s.capacity;
+        int next = 100;
+        for (int cycle = 0; cycle < 5000; cycle++) {
+            hashset_int_remove(&s, next - 100);
+            hashset_int_insert(&s, next++);
+        }
+        if (s.capacity > 2 * cap || hashset_int_len(&s) != 100) goto fail;
+        if ((s.len + s.tombstones) * 100 / s.capacity > CYAN_HASHMAP_LOAD_FACTOR) goto fail;
+        if (hashset_int_contains(&s, -1) || !hashset_int_contains(&s, next - 1)) goto fail;
+    }
+    
+    hashset_int_free(&s);
+    return THEFT_TRIAL_PASS;
+
+fail:
+    hashset_int_free(&s);
+    return THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 75: HashSet union/intersection/difference match a reference model
+ * For any two sets of different sizes, the algebra results contain exactly
+ * the keys the boolean model predicts, in either argument order
+ *============================================================================*/
+
+static bool check_set(const HashSet_int *s, const bool *expected) {
+    size_t n = 0;
+    for (int k = 0; k < KEY_RANGE; k++) {
+        if (hashset_int_contains(s, k) != expected[k]) return false;
+        if (expected[k]) n++;
+    }
+    return hashset_int_len(s) == n;
+}
+
+static enum theft_trial_res prop_hashset_algebra(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    
+    HashSet_int a = hashset_int_new();
+    HashSet_int b = hashset_int_new();
+    bool in_a[KEY_RANGE] = { false };
+    bool in_b[KEY_RANGE] = { false };
+    
+    /* Make b noticeably smaller so intersection takes both branches */
+    for (int i = 0; i < 150; i++) {
+        int k = (int)(next_rand(&state) % KEY_RANGE);
+        hashset_int_insert(&a, k);
+        in_a[k] = true;
+    }
+    for (int i = 0; i < 30; i++) {
+        int k = (int)(next_rand(&state) % KEY_RANGE);
+        hashset_int_insert(&b, k);
+        in_b[k] = true;
+    }
+    /* Leave tombstones behind in a */
+    for (int i = 0; i < 20; i++) {
+        int k = (int)(next_rand(&state) % KEY_RANGE);
+        hashset_int_remove(&a, k);
+        in_a[k] = false;
+    }
+    
+    bool u[KEY_RANGE], n[KEY_RANGE], d_ab[KEY_RANGE], d_ba[KEY_RANGE];
+    for (int k = 0; k < KEY_RANGE; k++) {
+        u[k] = in_a[k] || in_b[k];
+        n[k] = in_a[k] && in_b[k];
+        d_ab[k] = in_a[k] && !in_b[k];
+        d_ba[k] = in_b[k] && !in_a[k];
+    }
+    
+    HashSet_int r[6] = {
+        hashset_int_union(&a, &b),
+        hashset_int_union(&b, &a),
+        hashset_int_intersection(&a, &b),
+        hashset_int_intersection(&b, &a),
+        hashset_int_difference(&a, &b),
+        hashset_int_difference(&b, &a)
+    };
+    const bool *expected[6] = { u, u, n, n, d_ab, d_ba };
+    
+    bool ok = true;
+    for (int i = 0; i < 6; i++) {
+        if (!check_set(&r[i], expected[i])) ok = false;
+        hashset_int_free(&r[i]);
+    }
+    
+    /* Algebra with an empty set */
+    HashSet_int empty = hashset_int_new();
+    HashSet_int e1 = hashset_int_intersection(&a, &empty);
+    HashSet_int e2 = hashset_int_difference(&a, &empty);
+    if (hashset_int_len(&e1) != 0 || !check_set(&e2, in_a)) ok = false;
+    hashset_int_free(&e1);
+    hashset_int_free(&e2);
+    
+    hashset_int_free(&a);
+    hashset_int_free(&b);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 76: HASHSET_DEFINE_SCALAR works through the SET_* vtable macros
+ * For any keys, including negative ones, the inlined-hash set behaves like
+ * the default set when driven through the vtable macros
+ *============================================================================*/
+
+static enum theft_trial_res prop_hashset_scalar(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    i64 seed = *val_ptr;
+    
+    HashSet_i64 s = hashset_i64_with_capacity(100);
+    size_t cap = s.capacity;
+    
+    for (i64 i = 0; i < 100; i++) {
+        /* Spread keys with a stride so both signs and large values appear */
+        i64 key = (i64)((uint64_t)seed + (uint64_t)i * 0x9E3779B97F4A7C15ull);
+        if (!SET_INSERT(s, key) || SET_INSERT(s, key)) {
+            SET_FREE(s);
+            return THEFT_TRIAL_FAIL;
+        }
+    }
+    
+    /* with_capacity sized the table for all 100 keys up front */
+    if (SET_LEN(s) != 100 || s.capacity != cap) {
+        SET_FREE(s);
+        return THEFT_TRIAL_FAIL;
+    }
+    
+    for (i64 i = 0; i < 100; i += 2) {
+        i64 key = (i64)((uint64_t)seed + (uint64_t)i * 0x9E3779B97F4A7C15ull);
+        if (!SET_REMOVE(s, key)) {
+            SET_FREE(s);
+            return THEFT_TRIAL_FAIL;
+        }
+    }
+    
+    for (i64 i = 0; i < 100; i++) {
+        i64 key = (i64)((uint64_t)seed + (uint64_t)i * 0x9E3779B97F4A7C15ull);
+        if (SET_CONTAINS(s, key) != (i % 2 == 1)) {
+            SET_FREE(s);
+            return THEFT_TRIAL_FAIL;
+        }
+    }
+    
+    bool ok = SET_LEN(s) == 50;
+    SET_FREE(s);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+/* Minimum iterations for property tests */
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} HashSetTest;
+
+static HashSetTest hashset_tests[] = {
+    {
+        "Property 74: HashSet membership matches a reference model",
+        prop_hashset_model,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 75: HashSet union/intersection/difference match a reference model",
+        prop_hashset_algebra,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 76: HASHSET_DEFINE_SCALAR works through the SET_* vtable macros",
+        prop_hashset_scalar,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_HASHSET_TESTS (sizeof(hashset_tests) / sizeof(hashset_tests[0]))
+
+int run_hashset_tests(theft_seed seed) {
+    int failures = 0;
+    
+    printf("\nHashSet Tests:\n");
+    
+    for (size_t i = 0; i < NUM_HASHSET_TESTS; i++) {
+        HashSetTest *test = &hashset_tests[i];
+        
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+        
+        enum theft_run_res res = theft_run(&config);
+        
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+    
+    return failures;
+}
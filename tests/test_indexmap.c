@@ -0,0 +1,231 @@
+/**
+ * @file test_indexmap.c
+ * @brief Property-based tests for the IndexMap type
+ * 
+ * Tests validate correctness properties:
+ * - Property 82: IndexMap entries match an ordered reference model
+ * - Property 83: INDEXMAP_DEFINE_SCALAR works through the MAP_* vtable macros
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "theft.h"
+#include "test_util.h"
+#include <cyan/option.h>
+#include <cyan/indexmap.h>
+
+typedef int64_t i64;
+
+/* Define Option and IndexMap types for testing */
+OPTION_DEFINE(int);
+INDEXMAP_DEFINE(int, int);
+INDEXMAP_DEFINE_SCALAR(i64, int);
+
+/* Keys are drawn from [0, KEY_RANGE) so sequences contain duplicates */
+#define KEY_RANGE 256
+
+/*============================================================================
+ * Property 82: IndexMap entries match an ordered reference model
+ * For any sequence of inserts, updates and swap removes (by key or by
+ * position), the entry slice equals a plain array maintained with the same
+ * append and swap-with-last rules, and every key is found at its position
+ *============================================================================*/
+
+typedef struct {
+    int key;
+    int value;
+} ModelEntry;
+
+static bool check_model(IndexMap_int_int *m, const ModelEntry *model, size_t n) {
+    if (indexmap_int_int_len(m) != n) return false;
+    
+    Slice_IndexMapEntry_int_int all = indexmap_int_int_entries(m);
+    if (all.len != n) return false;
+    for (size_t i = 0; i < n; i++) {
+        if (all.data[i].key != model[i].key || all.data[i].value != model[i].value) return false;
+        
+        size_t pos;
+        if (!indexmap_int_int_index_of(m, model[i].key, &pos) || pos != i) return false;
+        if (indexmap_int_int_get_index(m, i) != &all.data[i]) return false;
+    }
+    if (indexmap_int_int_get_index(m, n) != NULL) return false;
+    return true;
+}
+
+static enum theft_trial_res prop_indexmap_model(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    
+    IndexMap_int_int m = indexmap_int_int_new();
+    ModelEntry model[KEY_RANGE];
+    size_t n = 0;
+    bool ok = true;
+    
+    for (int round = 0; round < 600 && ok; round++) {
+        int key = (int)(next_rand(&state) % KEY_RANGE);
+        int op = (int)(next_rand(&state) % 4);
+        int value = (int)(next_rand(&state) % KEY_RANGE);
+        
+        size_t at = n;
+        for (size_t i = 0; i < n; i++) {
+            if (model[i].key == key) at = i;
+        }
+        
+        if (op <= 1) {
+            indexmap_int_int_insert(&m, key, value);
+            if (at == n) model[n++] = (ModelEntry){ key, value };
+            else model[at].value = value;
+        } else if (op == 2) {
+            Option_int v = indexmap_int_int_swap_remove(&m, key);
+            if (is_some(v) != (at < n)) ok = false;
+            if (at < n) {
+                if (unwrap_or(v, -1) != model[at].value) ok = false;
+                model[at] = model[--n];
+            }
+        } else {
+            /* Remove by position, sometimes out of range */
+            size_t pos = (size_t)value % (n + 2);
+            Option_int v = indexmap_int_int_swap_remove_index(&m, pos);
+            if (is_some(v) != (pos < n)) ok = false;
+            if (pos < n) {
+                if (unwrap_or(v, -1) != model[pos].value) ok = false;
+                model[pos] = model[--n];
+            }
+        }
+        
+        if (ok && round % 50 == 0) ok = check_model(&m, model, n);
+    }
+    
+    if (ok) ok = check_model(&m, model, n);
+    
+    /* Keys never inserted, or removed, are absent */
+    for (int k = 0; k < KEY_RANGE && ok; k++) {
+        bool expected = false;
+        for (size_t i = 0; i < n; i++) {
+            if (model[i].key == k) expected = true;
+        }
+        if (indexmap_int_int_contains(&m, k) != expected) ok = false;
+    }
+    
+    /* Clearing keeps the map usable */
+    indexmap_int_int_clear(&m);
+    if (indexmap_int_int_len(&m) != 0 || indexmap_int_int_contains(&m, model[0].key)) ok = false;
+    indexmap_int_int_insert(&m, 7, 70);
+    if (unwrap_or(indexmap_int_int_get(&m, 7), -1) != 70) ok = false;
+    
+    indexmap_int_int_free(&m);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 83: INDEXMAP_DEFINE_SCALAR works through the MAP_* vtable macros
+ * For any keys, including negative ones, a presized scalar IndexMap driven
+ * through the shared MAP_* macros stores, updates and removes like the
+ * direct API, and get_ptr writes are visible in the entry slice
+ *============================================================================*/
+
+static enum theft_trial_res prop_indexmap_vtable(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    bool ok = true;
+    
+    IndexMap_i64_int m = indexmap_i64_int_with_capacity(64);
+    i64 keys[64];
+    for (int i = 0; i < 64; i++) {
+        keys[i] = ((i64)(next_rand(&state) % KEY_RANGE) - KEY_RANGE / 2) * 1000003 + i;
+        MAP_INSERT(m, keys[i], i);
+    }
+    if (MAP_LEN(m) != 64) ok = false;
+    
+    for (int i = 0; i < 64 && ok; i++) {
+        if (!MAP_CONTAINS(m, keys[i]) || unwrap_or(MAP_GET(m, keys[i]), -1) != i) ok = false;
+        int *v = indexmap_i64_int_get_ptr(&m, keys[i]);
+        if (!v) { ok = false; break; }
+        *v += 1000;
+    }
+    
+    Slice_IndexMapEntry_i64_int all = indexmap_i64_int_entries(&m);
+    for (size_t i = 0; i < all.len && ok; i++) {
+        if (all.data[i].key != keys[i] || all.data[i].value != (int)i + 1000) ok = false;
+    }
+    
+    /* Removing the first key moves the last one to the front */
+    Option_int first = MAP_REMOVE(m, keys[0]);
+    if (unwrap_or(first, -1) != 1000 || MAP_CONTAINS(m, keys[0])) ok = false;
+    if (indexmap_i64_int_get_index(&m, 0)->key != keys[63]) ok = false;
+    if (is_some(MAP_REMOVE(m, keys[0]))) ok = false;
+    if (MAP_LEN(m) != 63) ok = false;
+    
+    MAP_FREE(m);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+/* Minimum iterations for property tests */
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} IndexMapTest;
+
+static IndexMapTest indexmap_tests[] = {
+    {
+        "Property 82: IndexMap entries match an ordered reference model",
+        prop_indexmap_model,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 83: INDEXMAP_DEFINE_SCALAR works through the MAP_* vtable macros",
+        prop_indexmap_vtable,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_INDEXMAP_TESTS (sizeof(indexmap_tests) / sizeof(indexmap_tests[0]))
+
+int run_indexmap_tests(theft_seed seed) {
+    int failures = 0;
+    
+    printf("\nIndexMap Tests:\n");
+    
+    for (size_t i = 0; i < NUM_INDEXMAP_TESTS; i++) {
+        IndexMapTest *test = &indexmap_tests[i];
+        
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+        
+        enum theft_run_res res = theft_run(&config);
+        
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+    
+    return failures;
+}
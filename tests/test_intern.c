@@ -0,0 +1,256 @@
+/**
+ * @file test_intern.c
+ * @brief Property-based tests for the string interner
+ *
+ * Tests validate correctness properties:
+ * - Property 104: Equal strings intern to one atom and distinct strings to distinct atoms
+ * - Property 105: Concurrent interning agrees on one atom per string
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "theft.h"
+#include "test_util.h"
+#include <cyan/option.h>
+#include <cyan/intern.h>
+
+/* Define an atom-keyed HashMap for testing */
+OPTION_DEFINE(u32);
+ATOM_HASHMAP_DEFINE(u32);
+
+#define MAX_WORDS 3000
+#define NUM_THREADS 4
+
+/* Word i of a trial: short words over a small alphabet, so many repeat */
+static size_t make_word(u32 seed, u32 i, char *buf) {
+    u32 state = seed ^ (i * 2654435761u);
+    size_t len = next_rand(&state) % 12;
+    for (size_t j = 0; j < len; j++) buf[j] = (char)('a' + next_rand(&state) % 3);
+    buf[len] = '\0';
+    return len;
+}
+
+/*============================================================================
+ * Property 104: Equal strings intern to one atom and distinct strings to distinct atoms
+ * For any list of words (with repeats and the empty word), interning by C
+ * string or slice returns the same atom exactly for equal bytes, the atom
+ * reproduces the bytes and their hash, lookup finds interned words only,
+ * len counts distinct words, and an atom-keyed HashMap counts each word
+ *============================================================================*/
+
+static enum theft_trial_res prop_intern_identity(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u32 seed = (u32)(*val_ptr);
+    u32 state = seed;
+    size_t n = next_rand(&state) % MAX_WORDS;
+    static Atom atoms[MAX_WORDS];
+    static char words[MAX_WORDS][16];
+    bool ok = true;
+
+    Interner in = interner_with_capacity(next_rand(&state) % 64);
+    HashMap_Atom_u32 counts = hashmap_Atom_u32_new();
+
+    for (size_t i = 0; i < n; i++) {
+        size_t len = make_word(seed, (u32)i, words[i]);
+        /* Alternate entry points; a copy in a padded buffer checks slices */
+        if (i % 2) {
+            char padded[24];
+            memcpy(padded, words[i], len);
+            padded[len] = 'X';
+            atoms[i] = interner_intern_slice(&in, slice_char_from_array(padded, len));
+        } else {
+            atoms[i] = in.vt->intern(&in, words[i]);
+        }
+        if (atom_len(atoms[i]) != len || strcmp(atom_cstr(atoms[i]), words[i]) != 0 ||
+            atom_hash(atoms[i]) != cyan_hash_wy_seeded(words[i], len, in.state->seed)) {
+            ok = false;
+        }
+        Option_u32 c = hashmap_Atom_u32_get(&counts, atoms[i]);
+        hashmap_Atom_u32_insert(&counts, atoms[i], c.has_value ? c.value + 1 : 1);
+    }
+
+    /* Atoms are equal exactly when the words are */
+    size_t distinct = 0;
+    for (size_t i = 0; i < n && ok; i++) {
+        size_t occurrences = 0;
+        bool first = true;
+        for (size_t j = 0; j < n; j++) {
+            bool same = strcmp(words[i], words[j]) == 0;
+            if (atom_eq(atoms[i], atoms[j]) != same) ok = false;
+            if (same) {
+                occurrences++;
+                if (j < i) first = false;
+            }
+        }
+        if (first) distinct++;
+        Option_u32 c = hashmap_Atom_u32_get(&counts, atoms[i]);
+        if (!c.has_value || c.value != occurrences) ok = false;
+    }
+    if (interner_len(&in) != distinct || hashmap_Atom_u32_len(&counts) != distinct) ok = false;
+
+    /* Lookup finds interned words and nothing else */
+    for (size_t i = 0; i < n && ok; i++) {
+        Option_Atom a = interner_lookup(&in, words[i]);
+        if (!a.has_value || a.value != atoms[i]) ok = false;
+    }
+    if (interner_lookup(&in, "not-a-word").has_value ||
+        interner_lookup_slice(&in, slice_char_from_array("aaaaaaaaaaaaZ", 13)).has_value) {
+        ok = false;
+    }
+
+    hashmap_Atom_u32_free(&counts);
+    in.vt->free(&in);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 105: Concurrent interning agrees on one atom per string
+ * For threads interning overlapping word lists into one interner (while
+ * its table grows) and into the process-wide interner, every thread gets
+ * the same atom for the same word, and len counts distinct words
+ *============================================================================*/
+
+typedef struct {
+    Interner *in;
+    u32 seed;
+    size_t n;
+    size_t offset;           /* First word this thread interns */
+    Atom atoms[MAX_WORDS];   /* Atom of word i, in word order */
+    Atom globals[MAX_WORDS]; /* Same words in the process-wide interner */
+} InternTask;
+
+static void *intern_worker(void *arg) {
+    InternTask *task = (InternTask *)arg;
+    char word[16];
+    for (size_t k = 0; k < task->n; k++) {
+        size_t i = (task->offset + k) % task->n;
+        make_word(task->seed, (u32)i, word);
+        task->atoms[i] = interner_intern(task->in, word);
+        task->globals[i] = atom_intern(word);
+        /* Reads race with other threads' inserts and table swaps */
+        Option_Atom again = interner_lookup(task->in, word);
+        if (!again.has_value || again.value != task->atoms[i]) task->atoms[i] = NULL;
+    }
+    return NULL;
+}
+
+static enum theft_trial_res prop_intern_concurrent(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u32 seed = (u32)(*val_ptr);
+    u32 state = seed;
+    size_t n = 1 + next_rand(&state) % MAX_WORDS;
+    static InternTask tasks[NUM_THREADS];
+    pthread_t threads[NUM_THREADS];
+    bool ok = true;
+
+    Interner in = interner_new();
+    for (int k = 0; k < NUM_THREADS; k++) {
+        tasks[k].in = &in;
+        tasks[k].seed = seed;
+        tasks[k].n = n;
+        tasks[k].offset = (size_t)k * n / NUM_THREADS;
+        if (pthread_create(&threads[k], NULL, intern_worker, &tasks[k]) != 0) {
+            intern_worker(&tasks[k]);
+            threads[k] = 0;
+        }
+    }
+    for (int k = 0; k < NUM_THREADS; k++) {
+        if (threads[k]) pthread_join(threads[k], NULL);
+    }
+
+    char wi[16], wj[16];
+    size_t distinct = 0;
+    for (size_t i = 0; i < n && ok; i++) {
+        for (int k = 0; k < NUM_THREADS; k++) {
+            if (!tasks[k].atoms[i] || tasks[k].atoms[i] != tasks[0].atoms[i] ||
+                tasks[k].globals[i] != tasks[0].globals[i]) {
+                ok = false;
+            }
+        }
+        make_word(seed, (u32)i, wi);
+        if (strcmp(atom_cstr(tasks[0].atoms[i]), wi) != 0 ||
+            strcmp(atom_cstr(tasks[0].globals[i]), wi) != 0) {
+            ok = false;
+        }
+        bool first = true;
+        for (size_t j = 0; j < i && first; j++) {
+            make_word(seed, (u32)j, wj);
+            if (strcmp(wi, wj) == 0) first = false;
+        }
+        if (first) distinct++;
+    }
+    if (interner_len(&in) != distinct) ok = false;
+
+    interner_free(&in);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} InternTest;
+
+static InternTest intern_tests[] = {
+    {
+        "Property 104: Equal strings intern to one atom and distinct strings to distinct atoms",
+        prop_intern_identity,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 105: Concurrent interning agrees on one atom per string",
+        prop_intern_concurrent,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_INTERN_TESTS (sizeof(intern_tests) / sizeof(intern_tests[0]))
+
+int run_intern_tests(theft_seed seed) {
+    int failures = 0;
+
+    printf("\nIntern Tests:\n");
+
+    for (size_t i = 0; i < NUM_INTERN_TESTS; i++) {
+        InternTest *test = &intern_tests[i];
+
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+
+        enum theft_run_res res = theft_run(&config);
+
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+
+    return failures;
+}
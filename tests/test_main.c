@@ -31,6 +31,22 @@ extern int run_match_tests(theft_seed seed);
 extern int run_channel_tests(theft_seed seed);
 extern int run_types_tests(theft_seed seed);
 extern int run_vtable_macro_tests(theft_seed seed);
+extern int run_phf_tests(theft_seed seed);
+extern int run_hashmap_parallel_tests(theft_seed seed);
+extern int run_string_builder_tests(theft_seed seed);
+extern int run_string_search_tests(theft_seed seed);
+extern int run_intern_tests(theft_seed seed);
+extern int run_string_num_tests(theft_seed seed);
+extern int run_utf8_tests(theft_seed seed);
+extern int run_shared_string_tests(theft_seed seed);
+extern int run_cache_tests(theft_seed seed);
+extern int run_hashmap_mmap_tests(theft_seed seed);
+extern int run_indexmap_tests(theft_seed seed);
+extern int run_hashmap_split_tests(theft_seed seed);
+extern int run_chashmap_tests(theft_seed seed);
+extern int run_hashset_tests(theft_seed seed);
+extern int run_strmap_tests(theft_seed seed);
+extern int run_hash_tests(theft_seed seed);
 
 /*============================================================================
  * Test Configuration
@@ -225,14 +241,14 @@ static void run_all_tests(void) {
     /* Hash map tests */
     int hashmap_failures = run_hashmap_tests(seed);
     g_results.failed += hashmap_failures;
-    g_results.passed += (6 - hashmap_failures);  /* 6 hashmap tests */
-    g_results.total += 6;
+    g_results.passed += (13 - hashmap_failures);  /* 13 hashmap tests */
+    g_results.total += 13;
 
     /* String tests */
     int string_failures = run_string_tests(seed);
     g_results.failed += string_failures;
-    g_results.passed += (5 - string_failures);  /* 5 string tests */
-    g_results.total += 5;
+    g_results.passed += (6 - string_failures);  /* 6 string tests */
+    g_results.total += 6;
 
     /* Pattern matching tests */
     int match_failures = run_match_tests(seed);
@@ -258,6 +274,102 @@ static void run_all_tests(void) {
     g_results.passed += (4 - vtable_macro_failures);  /* 4 vtable macro tests */
     g_results.total += 4;
 
+    /* Hash function tests */
+    int hash_failures = run_hash_tests(seed);
+    g_results.failed += hash_failures;
+    g_results.passed += (4 - hash_failures);  /* 4 hash tests */
+    g_results.total += 4;
+
+    /* String-keyed map tests */
+    int strmap_failures = run_strmap_tests(seed);
+    g_results.failed += strmap_failures;
+    g_results.passed += (3 - strmap_failures);  /* 3 strmap tests */
+    g_results.total += 3;
+
+    /* HashSet tests */
+    int hashset_failures = run_hashset_tests(seed);
+    g_results.failed += hashset_failures;
+    g_results.passed += (3 - hashset_failures);  /* 3 hashset tests */
+    g_results.total += 3;
+
+    /* ConcurrentHashMap tests */
+    int chashmap_failures = run_chashmap_tests(seed);
+    g_results.failed += chashmap_failures;
+    g_results.passed += (2 - chashmap_failures);  /* 2 chashmap tests */
+    g_results.total += 2;
+
+    /* HashMap split layout tests */
+    int hashmap_split_failures = run_hashmap_split_tests(seed);
+    g_results.failed += hashmap_split_failures;
+    g_results.passed += (2 - hashmap_split_failures);  /* 2 hashmap_split tests */
+    g_results.total += 2;
+
+    /* IndexMap tests */
+    int indexmap_failures = run_indexmap_tests(seed);
+    g_results.failed += indexmap_failures;
+    g_results.passed += (2 - indexmap_failures);  /* 2 indexmap tests */
+    g_results.total += 2;
+
+    /* HashMap snapshot tests */
+    int hashmap_mmap_failures = run_hashmap_mmap_tests(seed);
+    g_results.failed += hashmap_mmap_failures;
+    g_results.passed += (2 - hashmap_mmap_failures);  /* 2 hashmap_mmap tests */
+    g_results.total += 2;
+
+    /* LRU and CLOCK cache tests */
+    int cache_failures = run_cache_tests(seed);
+    g_results.failed += cache_failures;
+    g_results.passed += (3 - cache_failures);  /* 3 cache tests */
+    g_results.total += 3;
+
+    /* Perfect-hash map tests */
+    int phf_failures = run_phf_tests(seed);
+    g_results.failed += phf_failures;
+    g_results.passed += (3 - phf_failures);  /* 3 phf tests */
+    g_results.total += 3;
+
+    /* Parallel HashMap construction tests */
+    int hashmap_parallel_failures = run_hashmap_parallel_tests(seed);
+    g_results.failed += hashmap_parallel_failures;
+    g_results.passed += (2 - hashmap_parallel_failures);  /* 2 hashmap_parallel tests */
+    g_results.total += 2;
+
+    /* StringBuilder tests */
+    int string_builder_failures = run_string_builder_tests(seed);
+    g_results.failed += string_builder_failures;
+    g_results.passed += (2 - string_builder_failures);  /* 2 string_builder tests */
+    g_results.total += 2;
+
+    /* String search tests */
+    int string_search_failures = run_string_search_tests(seed);
+    g_results.failed += string_search_failures;
+    g_results.passed += (2 - string_search_failures);  /* 2 string_search tests */
+    g_results.total += 2;
+
+    /* Intern tests */
+    int intern_failures = run_intern_tests(seed);
+    g_results.failed += intern_failures;
+    g_results.passed += (2 - intern_failures);  /* 2 intern tests */
+    g_results.total += 2;
+
+    /* String number formatting tests */
+    int string_num_failures = run_string_num_tests(seed);
+    g_results.failed += string_num_failures;
+    g_results.passed += (3 - string_num_failures);  /* 3 string_num tests */
+    g_results.total += 3;
+
+    /* UTF-8 tests */
+    int utf8_failures = run_utf8_tests(seed);
+    g_results.failed += utf8_failures;
+    g_results.passed += (2 - utf8_failures);  /* 2 utf8 tests */
+    g_results.total += 2;
+
+    /* Shared string tests */
+    int shared_string_failures = run_shared_string_tests(seed);
+    g_results.failed += shared_string_failures;
+    g_results.passed += (2 - shared_string_failures);  /* 2 shared_string tests */
+    g_results.total += 2;
+
     printf("\n");
 }
 
@@ -0,0 +1,320 @@
+/**
+ * @file test_phf.c
+ * @brief Property-based tests for static perfect-hash maps
+ *
+ * Tests validate correctness properties:
+ * - Property 92: A PHF finds exactly its keys, each in a slot of its own
+ * - Property 93: Emitted C source describes the same table
+ * - Property 94: String-keyed PHFs find their keys by content
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "theft.h"
+#include "test_util.h"
+#include <cyan/option.h>
+#include <cyan/result.h>
+#include <cyan/hashmap.h>
+#include <cyan/phf.h>
+
+typedef const char *cstr;
+
+/* Define Option, HashMap and PHF types for testing */
+OPTION_DEFINE(int);
+HASHMAP_DEFINE(int, int);
+PHF_DEFINE(int, int);
+PHF_FROM_HASHMAP_DEFINE(int, int);
+PHF_DEFINE_WITH(cstr, int, CYAN_HASH_CSTR, CYAN_EQ_CSTR);
+
+#define MAX_KEYS 3000
+#define WORD_LEN 8
+
+/* Fill keys with n distinct ints from a sparse range, values with their negation */
+static size_t random_keys(uint32_t *state, int *keys, int *values) {
+    size_t n = next_rand(state) % MAX_KEYS;
+    HashMap_int_int seen = hashmap_int_int_new();
+    size_t len = 0;
+    while (len < n) {
+        int key = (int)(next_rand(state) % (MAX_KEYS * 8)) - MAX_KEYS;
+        if (hashmap_int_int_contains(&seen, key)) continue;
+        hashmap_int_int_insert(&seen, key, 0);
+        keys[len] = key;
+        values[len] = -key;
+        len++;
+    }
+    hashmap_int_int_free(&seen);
+    return len;
+}
+
+/* Every key maps to its value and every other key in range is absent */
+static bool finds_exactly(const Phf_int_int *p, const int *keys, const int *values, size_t n) {
+    if (phf_int_int_len(p) != n) return false;
+    for (size_t i = 0; i < n; i++) {
+        Option_int v = phf_int_int_get(p, keys[i]);
+        if (!is_some(v) || unwrap(v) != values[i]) return false;
+    }
+    size_t absent = 0;
+    for (int key = -MAX_KEYS; key < MAX_KEYS * 7; key++) {
+        if (!phf_int_int_contains(p, key)) absent++;
+    }
+    return absent == (size_t)MAX_KEYS * 8 - n;
+}
+
+/*============================================================================
+ * Property 92: A PHF finds exactly its keys, each in a slot of its own
+ * For any set of distinct keys, the table built from arrays and the table
+ * built from a HashMap with the same entries both hold n entries in n
+ * slots and answer every lookup like the map; a repeated key is rejected
+ *============================================================================*/
+
+static enum theft_trial_res prop_phf_exact(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    static int keys[MAX_KEYS + 1], values[MAX_KEYS + 1];
+    size_t n = random_keys(&state, keys, values);
+    bool ok = true;
+
+    Result_Phf_int_int_PhfError r = phf_int_int_build(keys, values, n);
+    if (!is_ok(r)) return THEFT_TRIAL_FAIL;
+    Phf_int_int p = unwrap_ok(r);
+    if (!finds_exactly(&p, keys, values, n)) ok = false;
+    if (n > 0 && p.buckets != (n + CYAN_PHF_LAMBDA - 1) / CYAN_PHF_LAMBDA) ok = false;
+
+    /* Same keys through a HashMap, via the vtable */
+    HashMap_int_int m = hashmap_int_int_new();
+    for (size_t i = 0; i < n; i++) hashmap_int_int_insert(&m, keys[i], values[i]);
+    Result_Phf_int_int_PhfError rm = phf_int_int_from_hashmap(&m);
+    if (is_ok(rm)) {
+        Phf_int_int q = unwrap_ok(rm);
+        if (!finds_exactly(&q, keys, values, n)) ok = false;
+        if (q.vt->len(&q) != n || (n > 0 && unwrap(q.vt->get(&q, keys[0])) != values[0])) ok = false;
+        q.vt->free(&q);
+    } else {
+        ok = false;
+    }
+    hashmap_int_int_free(&m);
+
+    /* Builds are deterministic */
+    Result_Phf_int_int_PhfError again = phf_int_int_build(keys, values, n);
+    if (is_ok(again)) {
+        Phf_int_int q = unwrap_ok(again);
+        if (q.seed != p.seed || (n > 0 && memcmp(q.disps, p.disps, 2 * p.buckets * sizeof(uint32_t)) != 0)) ok = false;
+        phf_int_int_free(&q);
+    } else {
+        ok = false;
+    }
+
+    /* A repeated key is an error, not a silently dropped value */
+    if (n > 0) {
+        keys[n] = keys[next_rand(&state) % n];
+        values[n] = 0;
+        Result_Phf_int_int_PhfError dup = phf_int_int_build(keys, values, n + 1);
+        if (is_ok(dup) || strcmp(unwrap_err(dup), "duplicate key") != 0) ok = false;
+    }
+
+    phf_int_int_free(&p);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 93: Emitted C source describes the same table
+ * For any table, the source written by phf_K_V_emit lists the entries in
+ * slot order with the table's displacements and seed, so a Phf_K_V over
+ * those arrays (what the generated initializer builds) answers like the
+ * original
+ *============================================================================*/
+
+static void emit_int(FILE *out, int v) {
+    fprintf(out, "%d", v);
+}
+
+static enum theft_trial_res prop_phf_emit(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    static int keys[MAX_KEYS + 1], values[MAX_KEYS + 1];
+    size_t n = random_keys(&state, keys, values);
+    bool ok = true;
+
+    Result_Phf_int_int_PhfError r = phf_int_int_build(keys, values, n);
+    if (!is_ok(r)) return THEFT_TRIAL_FAIL;
+    Phf_int_int p = unwrap_ok(r);
+    FILE *f = tmpfile();
+    if (!f) return THEFT_TRIAL_ERROR;
+    if (!phf_int_int_emit(&p, f, "table", emit_int, emit_int)) ok = false;
+    rewind(f);
+
+    /* Read back what the initializer would hold */
+    static PhfEntry_int_int entries[MAX_KEYS];
+    static uint32_t disps[2 * MAX_KEYS];
+    size_t n_entries = 0, n_disps = 0, len = 0, buckets = 0;
+    unsigned long long seed = 0;
+    bool in_disps = false, named = false;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        int k, v;
+        unsigned d;
+        if (sscanf(line, "    { %d, %d },", &k, &v) == 2 && n_entries < MAX_KEYS) {
+            entries[n_entries].key = k;
+            entries[n_entries].value = v;
+            n_entries++;
+        } else if (strstr(line, "uint32_t table_disps[")) {
+            in_disps = true;
+        } else if (in_disps && line[0] == '}') {
+            in_disps = false;
+        } else if (in_disps) {
+            for (char *s = strstr(line, "0x"); s && n_disps < 2 * MAX_KEYS; s = strstr(s + 2, "0x")) {
+                if (sscanf(s, "0x%xu", &d) == 1) disps[n_disps++] = d;
+            }
+        } else if (strstr(line, "static const Phf_int_int table = {")) {
+            named = true;
+        }
+        sscanf(line, "    .len = %zu,", &len);
+        sscanf(line, "    .buckets = %zu,", &buckets);
+        sscanf(line, "    .seed = 0x%llxull,", &seed);
+    }
+    fclose(f);
+
+    if (!named || n_entries != n || len != n || buckets != p.buckets || n_disps != 2 * p.buckets) ok = false;
+    if (seed != p.seed) ok = false;
+    if (ok) {
+        Phf_int_int q = { entries, disps, len, buckets, seed, false, &_phf_int_int_vt };
+        if (!finds_exactly(&q, keys, values, n)) ok = false;
+        phf_int_int_free(&q);   /* No-op on static data */
+    }
+
+    phf_int_int_free(&p);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 94: String-keyed PHFs find their keys by content
+ * For any set of distinct lowercase words, a PHF_DEFINE_WITH table over
+ * CYAN_HASH_CSTR finds each word through a different pointer to an equal
+ * string, and rejects the words with one letter changed that are not keys
+ *============================================================================*/
+
+static enum theft_trial_res prop_phf_strings(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    uint32_t state = (uint32_t)(*val_ptr);
+    size_t n = next_rand(&state) % 500;
+    bool ok = true;
+
+    /* Words are short, so the set is deduplicated through the int table of their codes */
+    static char words[500][WORD_LEN + 1];
+    static cstr keys[500];
+    static int values[500];
+    HashMap_int_int seen = hashmap_int_int_new();
+    size_t len = 0;
+    while (len < n) {
+        size_t wl = 1 + next_rand(&state) % 4;
+        int code = 0;
+        for (size_t i = 0; i < wl; i++) {
+            words[len][i] = (char)('a' + next_rand(&state) % 26);
+            code = code * 27 + (words[len][i] - 'a' + 1);
+        }
+        words[len][wl] = '\0';
+        if (hashmap_int_int_contains(&seen, code)) continue;
+        hashmap_int_int_insert(&seen, code, (int)len);
+        keys[len] = words[len];
+        values[len] = (int)len;
+        len++;
+    }
+
+    Result_Phf_cstr_int_PhfError r = phf_cstr_int_build(keys, values, n);
+    if (!is_ok(r)) {
+        hashmap_int_int_free(&seen);
+        return THEFT_TRIAL_FAIL;
+    }
+    Phf_cstr_int p = unwrap_ok(r);
+
+    char probe[WORD_LEN + 1];
+    for (size_t i = 0; i < n; i++) {
+        strcpy(probe, words[i]);
+        Option_int v = phf_cstr_int_get(&p, probe);
+        if (!is_some(v) || unwrap(v) != (int)i) ok = false;
+
+        probe[0] = probe[0] == 'z' ? 'a' : (char)(probe[0] + 1);
+        int code = 0;
+        for (size_t j = 0; probe[j]; j++) code = code * 27 + (probe[j] - 'a' + 1);
+        if (phf_cstr_int_contains(&p, probe) != hashmap_int_int_contains(&seen, code)) ok = false;
+    }
+
+    phf_cstr_int_free(&p);
+    hashmap_int_int_free(&seen);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+/* Minimum iterations for property tests */
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} PhfTest;
+
+static PhfTest phf_tests[] = {
+    {
+        "Property 92: A PHF finds exactly its keys, each in a slot of its own",
+        prop_phf_exact,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 93: Emitted C source describes the same table",
+        prop_phf_emit,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 94: String-keyed PHFs find their keys by content",
+        prop_phf_strings,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_PHF_TESTS (sizeof(phf_tests) / sizeof(phf_tests[0]))
+
+int run_phf_tests(theft_seed seed) {
+    int failures = 0;
+    
+    printf("\nPHF Tests:\n");
+    
+    for (size_t i = 0; i < NUM_PHF_TESTS; i++) {
+        PhfTest *test = &phf_tests[i];
+        
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+        
+        enum theft_run_res res = theft_run(&config);
+        
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+    
+    return failures;
+}
@@ -0,0 +1,310 @@
+/**
+ * @file test_shared_string.c
+ * @brief Property-based tests for reference-counted shared strings
+ *
+ * Tests validate correctness properties:
+ * - Property 111: Clones and substrings share one allocation and convert to String copy-on-write
+ * - Property 112: Atomic reference counts survive clones and releases across threads and channels
+ */
+
+#define CYAN_SHARED_STRING_ATOMIC
+#define CYAN_CHANNEL_THREADSAFE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "theft.h"
+#include "test_util.h"
+#include <cyan/shared_string.h>
+#include <cyan/channel.h>
+
+/* Define a channel of shared strings for testing */
+CHANNEL_DEFINE(SharedString);
+
+#define MAX_LEN 400
+#define MAX_HANDLES 32
+#define NUM_THREADS 4
+
+/* Random printable text of length n */
+static void make_text(u32 *state, char *buf, size_t n) {
+    for (size_t i = 0; i < n; i++) buf[i] = (char)('a' + next_rand(state) % 26);
+    buf[n] = '\0';
+}
+
+/*============================================================================
+ * Property 111: Clones and substrings share one allocation and convert to String copy-on-write
+ * For any text and any sequence of clones, substrings (of clones and of
+ * substrings) and releases, every handle views the expected bytes of the
+ * original without copying, the reference count equals the number of
+ * live non-empty handles, and into_string reuses the allocation for the
+ * last handle but copies while the bytes are shared
+ *============================================================================*/
+
+typedef struct {
+    size_t start;
+    size_t len;
+} Expect;
+
+static enum theft_trial_res prop_shared_string_views(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u32 state = (u32)(*val_ptr);
+    static char text[MAX_LEN + 1];
+    SharedString handles[MAX_HANDLES];
+    Expect expect[MAX_HANDLES];
+    size_t live = 0;
+    bool ok = true;
+
+    size_t n = next_rand(&state) % MAX_LEN;
+    make_text(&state, text, n);
+    String src = string_from(text);
+    handles[0] = next_rand(&state) % 2 ? shared_string_from_str(&src) : shared_string_from(text);
+    expect[0] = (Expect){ 0, n };
+    live = 1;
+    string_free(&src);
+    const char *base = shared_string_data(&handles[0]);
+    const void *block = handles[0].block;
+    if (n > 0 && base[n] != '\0') ok = false;
+
+    size_t steps = next_rand(&state) % 60;
+    for (size_t step = 0; step < steps && ok; step++) {
+        u32 op = next_rand(&state) % 4;
+        size_t from = next_rand(&state) % live;
+        if (op == 0 && live < MAX_HANDLES) {
+            handles[live] = handles[from].vt->clone(&handles[from]);
+            expect[live++] = expect[from];
+        } else if (op == 1 && live < MAX_HANDLES) {
+            /* Out-of-range bounds are clamped */
+            size_t a = next_rand(&state) % (expect[from].len + 3);
+            size_t b = next_rand(&state) % (expect[from].len + 3);
+            handles[live] = shared_string_substr(&handles[from], a, b);
+            size_t end = b > expect[from].len ? expect[from].len : b;
+            size_t start = a > end ? end : a;
+            expect[live++] = (Expect){ expect[from].start + start, end - start };
+        } else if (op == 2 && live > 1) {
+            handles[from].vt->release(&handles[from]);
+            if (handles[from].len != 0 || handles[from].block != NULL) ok = false;
+            handles[from] = handles[live - 1];
+            expect[from] = expect[--live];
+        }
+
+        /* Every view shows its range of the one allocation */
+        size_t owners = 0;
+        for (size_t k = 0; k < live; k++) {
+            Slice_char view = shared_string_as_slice(&handles[k]);
+            if (view.len != expect[k].len || shared_string_len(&handles[k]) != expect[k].len) ok = false;
+            if (view.len && (view.data != base + expect[k].start ||
+                             memcmp(view.data, text + expect[k].start, view.len) != 0)) {
+                ok = false;
+            }
+            if (handles[k].block) owners++;
+        }
+        for (size_t k = 0; k < live; k++) {
+            if (handles[k].block && shared_string_ref_count(&handles[k]) != owners) ok = false;
+        }
+    }
+
+    /* Equality by content, including across separate allocations */
+    SharedString copy = shared_string_from_bytes(text, n);
+    for (size_t k = 0; k < live; k++) {
+        if (shared_string_eq(&copy, &handles[k]) != (expect[k].len == n)) ok = false;
+    }
+    shared_string_release(&copy);
+
+    /* Convert in turn: shared handles copy, the last owner hands over its buffer */
+    for (size_t k = 0; k < live && ok; k++) {
+        bool last = handles[k].block && shared_string_ref_count(&handles[k]) == 1;
+        String out = shared_string_into_string(&handles[k]);
+        if (string_len(&out) != expect[k].len ||
+            memcmp(string_cstr(&out), text + expect[k].start, expect[k].len) != 0 ||
+            string_cstr(&out)[expect[k].len] != '\0') {
+            ok = false;
+        }
+        bool reused = block && (const void *)string_cstr(&out) == block;
+        if (reused != (last && expect[k].len > CYAN_STRING_INLINE_CAP)) ok = false;
+        /* The result is an ordinary String */
+        string_append(&out, "!");
+        if (string_cstr(&out)[expect[k].len] != '!') ok = false;
+        string_free(&out);
+        if (handles[k].block != NULL) ok = false;
+    }
+    for (size_t k = 0; k < live; k++) shared_string_release(&handles[k]);
+
+    /* Auto-release and the empty string */
+    {
+        shared_string_auto(empty, shared_string_new());
+        SharedString e2 = shared_string_substr(&empty, 0, 10);
+        if (shared_string_len(&e2) != 0 || shared_string_ref_count(&e2) != 0 || !shared_string_is_unique(&e2)) {
+            ok = false;
+        }
+        String s = shared_string_to_string(&e2);
+        if (string_len(&s) != 0) ok = false;
+        string_free(&s);
+    }
+
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 112: Atomic reference counts survive clones and releases across threads and channels
+ * For a string sent as clones and substrings through a channel to several
+ * consumer threads, which clone, compare and release them while the
+ * producer keeps its own handle, every received view has the expected
+ * bytes and the count returns to one when the consumers are done
+ *============================================================================*/
+
+typedef struct {
+    Channel_SharedString *ch;
+    const char *base;    /* Bytes of the producer's allocation */
+    const char *text;    /* Original text, for comparison */
+    size_t len;
+    size_t received;
+    bool ok;
+} Consumer;
+
+static void *consume(void *arg) {
+    Consumer *c = (Consumer *)arg;
+    while (1) {
+        Option_SharedString msg = chan_SharedString_recv(c->ch);
+        if (!msg.has_value) break;
+        SharedString s = msg.value;
+        /* Views carry their offset: the first byte names the start */
+        size_t start = (size_t)(shared_string_data(&s) - c->base);
+        if (start + shared_string_len(&s) > c->len ||
+            memcmp(shared_string_data(&s), c->text + start, shared_string_len(&s)) != 0) {
+            c->ok = false;
+        }
+        for (int k = 0; k < 8; k++) {
+            SharedString extra = shared_string_clone(&s);
+            SharedString part = shared_string_substr(&extra, 1, shared_string_len(&extra));
+            if (!shared_string_eq(&extra, &s)) c->ok = false;
+            shared_string_release(&part);
+            shared_string_release(&extra);
+        }
+        shared_string_release(&s);
+        c->received++;
+    }
+    return NULL;
+}
+
+static enum theft_trial_res prop_shared_string_threads(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u32 state = (u32)(*val_ptr);
+    static char text[MAX_LEN + 1];
+    bool ok = true;
+
+    size_t n = 2 + next_rand(&state) % (MAX_LEN - 2);
+    make_text(&state, text, n);
+    SharedString owner = shared_string_from(text);
+
+    size_t sent = 200 + next_rand(&state) % 200;
+    Channel_SharedString *ch = chan_SharedString_new(1 + next_rand(&state) % 8);
+    Consumer consumers[NUM_THREADS];
+    pthread_t threads[NUM_THREADS];
+    int started = 0;
+    for (int k = 0; k < NUM_THREADS; k++) {
+        consumers[k] = (Consumer){ ch, shared_string_data(&owner), text, n, 0, true };
+        if (pthread_create(&threads[k], NULL, consume, &consumers[k]) == 0) started++;
+        else threads[k] = 0;
+    }
+    /* Without consumer threads, buffer everything and drain below */
+    if (started == 0) {
+        chan_SharedString_free(ch);
+        ch = chan_SharedString_new(sent);
+    }
+
+    for (size_t i = 0; i < sent; i++) {
+        size_t a = next_rand(&state) % n;
+        SharedString msg = i % 2 ? shared_string_clone(&owner) : shared_string_substr(&owner, a, n);
+        chan_SharedString_send(ch, msg);
+    }
+    chan_SharedString_close(ch);
+
+    size_t received = 0;
+    for (int k = 0; k < NUM_THREADS; k++) {
+        if (!threads[k]) continue;
+        pthread_join(threads[k], NULL);
+        received += consumers[k].received;
+        if (!consumers[k].ok) ok = false;
+    }
+    if (started == 0) {
+        Consumer drain = { ch, shared_string_data(&owner), text, n, 0, true };
+        consume(&drain);
+        received += drain.received;
+        if (!drain.ok) ok = false;
+    }
+    if (received != sent) ok = false;
+    if (shared_string_ref_count(&owner) != 1 || memcmp(shared_string_data(&owner), text, n) != 0) ok = false;
+
+    chan_SharedString_free(ch);
+    shared_string_release(&owner);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} SharedStringTest;
+
+static SharedStringTest shared_string_tests[] = {
+    {
+        "Property 111: Clones and substrings share one allocation and convert to String copy-on-write",
+        prop_shared_string_views,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 112: Atomic reference counts survive clones and releases across threads and channels",
+        prop_shared_string_threads,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_SHARED_STRING_TESTS (sizeof(shared_string_tests) / sizeof(shared_string_tests[0]))
+
+int run_shared_string_tests(theft_seed seed) {
+    int failures = 0;
+
+    printf("\nShared String Tests:\n");
+
+    for (size_t i = 0; i < NUM_SHARED_STRING_TESTS; i++) {
+        SharedStringTest *test = &shared_string_tests[i];
+
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+
+        enum theft_run_res res = theft_run(&config);
+
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+
+    return failures;
+}
@@ -8,6 +8,7 @@
  * - Property 48: String slice matches substring
  * - Property 49: String cstr is null-terminated
  * - Property 50: String concat combines content
+ * - Property 99: String inline storage spills to the heap transparently
  */
 
 #include <stdio.h>
@@ -528,6 +529,81 @@ static enum theft_trial_res prop_string_vtable_behavioral_equivalence(struct the
     return THEFT_TRIAL_PASS;
 }
 
+/*============================================================================
+ * Property 99: String inline storage spills to the heap transparently
+ * For any string built by pushes, appends or string_from, strings of at most
+ * CYAN_STRING_INLINE_CAP characters SHALL stay inline, longer ones SHALL
+ * move to the heap, and the content, cstr and slices SHALL match the input
+ * in both representations.
+ *============================================================================*/
+
+static enum theft_trial_res prop_string_sso_transition(struct theft *t, void *arg1) {
+    (void)t;
+    const char *input = (const char *)arg1;
+    size_t input_len = strlen(input);
+    enum theft_trial_res res = THEFT_TRIAL_PASS;
+    
+    /* Grow one character at a time across the inline boundary */
+    String pushed = string_new();
+    for (size_t i = 0; i < input_len; i++) {
+        string_push(&pushed, input[i]);
+        size_t len = string_len(&pushed);
+        if (len != i + 1 ||
+            string_is_inline(&pushed) != (len <= CYAN_STRING_INLINE_CAP) ||
+            string_capacity(&pushed) < len ||
+            strncmp(string_cstr(&pushed), input, len) != 0 ||
+            string_cstr(&pushed)[len] != '\0') {
+            res = THEFT_TRIAL_FAIL;
+            break;
+        }
+    }
+    
+    /* string_from and string_with_capacity pick the representation by size */
+    String from = string_from(input);
+    String reserved = string_with_capacity(input_len);
+    string_append(&reserved, input);
+    if (string_is_inline(&from) != (input_len <= CYAN_STRING_INLINE_CAP) ||
+        string_is_inline(&reserved) != (input_len <= CYAN_STRING_INLINE_CAP) ||
+        strcmp(string_cstr(&from), input) != 0 ||
+        strcmp(string_cstr(&reserved), input) != 0 ||
+        STR_LEN(from) != input_len) {
+        res = THEFT_TRIAL_FAIL;
+    }
+    
+    /* Slices view the same bytes in either representation */
+    Slice_char whole = STR_SLICE(from, 0, input_len);
+    if (whole.len != input_len ||
+        (input_len > 0 && memcmp(whole.data, input, input_len) != 0)) {
+        res = THEFT_TRIAL_FAIL;
+    }
+    
+    /* Appending a string to itself doubles it, crossing the boundary */
+    string_append_str(&from, &from);
+    if (string_len(&from) != 2 * input_len ||
+        strncmp(string_cstr(&from), input, input_len) != 0 ||
+        strcmp(string_cstr(&from) + input_len, input) != 0) {
+        res = THEFT_TRIAL_FAIL;
+    }
+    
+    /* Clear keeps a heap buffer; free returns to an empty inline string */
+    bool was_inline = string_is_inline(&pushed);
+    string_clear(&pushed);
+    if (string_len(&pushed) != 0 || string_cstr(&pushed)[0] != '\0' ||
+        string_is_inline(&pushed) != was_inline) {
+        res = THEFT_TRIAL_FAIL;
+    }
+    string_free(&pushed);
+    if (!string_is_inline(&pushed) || string_len(&pushed) != 0 ||
+        string_cstr(&pushed)[0] != '\0') {
+        res = THEFT_TRIAL_FAIL;
+    }
+    
+    string_free(&pushed);
+    string_free(&from);
+    string_free(&reserved);
+    return res;
+}
+
 /*============================================================================
  * Test Registration
  *============================================================================*/
@@ -599,6 +675,14 @@ static StringTest string_tests[] = {
         0,
         false
     },
+    /* Property 99: Inline storage spills to the heap transparently */
+    {
+        "Property 99: String inline storage spills to the heap transparently",
+        prop_string_sso_transition,
+        &string_gen_type_info,
+        0,
+        false
+    },
 };
 
 #define NUM_STRING_TESTS (sizeof(string_tests) / sizeof(string_tests[0]))
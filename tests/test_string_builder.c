@@ -0,0 +1,260 @@
+/**
+ * @file test_string_builder.c
+ * @brief Property-based tests for the chunked StringBuilder
+ *
+ * Tests validate correctness properties:
+ * - Property 100: A builder holds the same bytes as appending to a String
+ * - Property 101: writev and the iovec export reproduce the joined bytes
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "theft.h"
+#include "test_util.h"
+#include <cyan/string.h>
+#include <cyan/string_builder.h>
+
+#define MAX_OPS 400
+
+/*
+ * Apply a random mix of appends to both a builder and a String. Chunk sizes
+ * are small so pieces regularly straddle chunk boundaries, and some pieces
+ * and formatted values are longer than a whole chunk.
+ */
+static void build_both(u32 *state, StringBuilder *sb, String *expect) {
+    static char piece[600];
+    size_t ops = next_rand(state) % MAX_OPS;
+    for (size_t i = 0; i < ops; i++) {
+        size_t n = next_rand(state) % (next_rand(state) % 8 == 0 ? sizeof(piece) - 1 : 24);
+        for (size_t j = 0; j < n; j++) piece[j] = (char)('a' + next_rand(state) % 26);
+        piece[n] = '\0';
+
+        switch (next_rand(state) % 6) {
+            case 0:
+                string_builder_push(sb, piece[0] ? piece[0] : '.');
+                string_push(expect, piece[0] ? piece[0] : '.');
+                break;
+            case 1:
+                string_builder_append(sb, piece);
+                string_append(expect, piece);
+                break;
+            case 2: {
+                String s = string_from(piece);
+                string_builder_append_str(sb, &s);
+                string_append_str(expect, &s);
+                string_free(&s);
+                break;
+            }
+            case 3:
+                string_builder_append_slice(sb, slice_char_from_array(piece, n));
+                string_append(expect, piece);
+                break;
+            case 4: {
+                u32 v = next_rand(state);
+                string_builder_format(sb, "[%u:%s]", v, piece);
+                string_format(expect, "[%u:%s]", v, piece);
+                break;
+            }
+            default: {
+                /* Write in place through reserve/commit */
+                char *dst = string_builder_reserve(sb, n + 8);
+                memcpy(dst, piece, n);
+                string_builder_commit(sb, n);
+                string_append(expect, piece);
+                break;
+            }
+        }
+    }
+}
+
+/*============================================================================
+ * Property 100: A builder holds the same bytes as appending to a String
+ * For any sequence of push, append, format and reserve/commit calls and any
+ * chunk size, the builder's len, its joined String and the concatenation of
+ * its chunk slices all equal the result of the same calls on a String,
+ * clearing leaves a reusable builder with at most one chunk, and empty
+ * formatted output adds no chunk
+ *============================================================================*/
+
+static enum theft_trial_res prop_builder_matches_string(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u32 state = (u32)(*val_ptr);
+    size_t chunk = 1 + next_rand(&state) % 96;
+    bool ok = true;
+
+    StringBuilder sb = string_builder_with_chunk_size(chunk);
+    String expect = string_new();
+    build_both(&state, &sb, &expect);
+    size_t len = string_len(&expect);
+
+    if (string_builder_len(&sb) != len) ok = false;
+
+    String joined = string_builder_join(&sb);
+    if (string_len(&joined) != len ||
+        memcmp(string_cstr(&joined), string_cstr(&expect), len) != 0 ||
+        string_cstr(&joined)[len] != '\0') {
+        ok = false;
+    }
+
+    /* Walk the chunks as slices */
+    StringBuilderIter it = string_builder_iter(&sb);
+    Slice_char part;
+    size_t pos = 0, parts = 0;
+    while (string_builder_iter_next(&it, &part)) {
+        if (part.len == 0 || pos + part.len > len ||
+            memcmp(part.data, string_cstr(&expect) + pos, part.len) != 0) {
+            ok = false;
+            break;
+        }
+        pos += part.len;
+        parts++;
+    }
+    if (pos != len || parts > string_builder_chunk_count(&sb)) ok = false;
+
+    /* Clear keeps one chunk and leaves the builder reusable */
+    string_builder_clear(&sb);
+    if (string_builder_len(&sb) != 0 || string_builder_chunk_count(&sb) > 1) ok = false;
+    sb.vt->append(&sb, "again");
+    String again = sb.vt->join(&sb);
+    if (strcmp(string_cstr(&again), "again") != 0) ok = false;
+
+    /* Formatting nothing allocates nothing */
+    size_t chunks = string_builder_chunk_count(&sb);
+    string_builder_format(&sb, "%s", "");
+    StringBuilder fresh = string_builder_with_chunk_size(chunk);
+    string_builder_format(&fresh, "%s", "");
+    if (string_builder_chunk_count(&sb) != chunks || string_builder_len(&sb) != 5 ||
+        string_builder_chunk_count(&fresh) != 0 || fresh.head != NULL) {
+        ok = false;
+    }
+    string_builder_free(&fresh);
+
+    string_free(&again);
+    string_free(&joined);
+    string_free(&expect);
+    sb.vt->free(&sb);
+    if (sb.head != NULL || string_builder_len(&sb) != 0) ok = false;
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 101: writev and the iovec export reproduce the joined bytes
+ * For any builder, the iovec entries cover the content in order with one
+ * entry per non-empty chunk, and string_builder_writev to a file writes
+ * exactly the joined bytes and returns their count
+ *============================================================================*/
+
+static enum theft_trial_res prop_builder_writev(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u32 state = (u32)(*val_ptr);
+    size_t chunk = 1 + next_rand(&state) % 64;
+    bool ok = true;
+
+    StringBuilder sb = string_builder_with_chunk_size(chunk);
+    String expect = string_new();
+    build_both(&state, &sb, &expect);
+    size_t len = string_len(&expect);
+
+    size_t max = string_builder_chunk_count(&sb);
+    struct iovec *iov = (struct iovec *)malloc((max + 1) * sizeof(struct iovec));
+    size_t n = string_builder_to_iovec(&sb, iov, max);
+    size_t pos = 0;
+    for (size_t i = 0; i < n && ok; i++) {
+        if (iov[i].iov_len == 0 || pos + iov[i].iov_len > len ||
+            memcmp(iov[i].iov_base, string_cstr(&expect) + pos, iov[i].iov_len) != 0) {
+            ok = false;
+        }
+        pos += iov[i].iov_len;
+    }
+    if (pos != len) ok = false;
+    free(iov);
+
+    FILE *f = tmpfile();
+    if (!f) {
+        string_builder_free(&sb);
+        string_free(&expect);
+        return THEFT_TRIAL_ERROR;
+    }
+    if (string_builder_writev(&sb, fileno(f)) != (ssize_t)len) ok = false;
+
+    char *back = (char *)malloc(len + 1);
+    rewind(f);
+    if (fread(back, 1, len + 1, f) != len || memcmp(back, string_cstr(&expect), len) != 0) {
+        ok = false;
+    }
+    free(back);
+    fclose(f);
+
+    string_builder_free(&sb);
+    string_free(&expect);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} StringBuilderTest;
+
+static StringBuilderTest string_builder_tests[] = {
+    {
+        "Property 100: A builder holds the same bytes as appending to a String",
+        prop_builder_matches_string,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 101: writev and the iovec export reproduce the joined bytes",
+        prop_builder_writev,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_STRING_BUILDER_TESTS (sizeof(string_builder_tests) / sizeof(string_builder_tests[0]))
+
+int run_string_builder_tests(theft_seed seed) {
+    int failures = 0;
+
+    printf("\nStringBuilder Tests:\n");
+
+    for (size_t i = 0; i < NUM_STRING_BUILDER_TESTS; i++) {
+        StringBuilderTest *test = &string_builder_tests[i];
+
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+
+        enum theft_run_res res = theft_run(&config);
+
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+
+    return failures;
+}
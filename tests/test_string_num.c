@@ -0,0 +1,316 @@
+/**
+ * @file test_string_num.c
+ * @brief Property-based tests for number formatting into String
+ *
+ * Tests validate correctness properties:
+ * - Property 106: Integer formatting matches printf
+ * - Property 107: Double formatting is the shortest round-trip decimal
+ * - Property 108: string_fmt and string_format match snprintf
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "theft.h"
+#include <cyan/string.h>
+#include <cyan/string_num.h>
+
+/* xorshift64 so each trial is deterministic in its seed */
+static u64 next_rand(u64 *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/* Random value with a random bit length, so every digit count occurs */
+static u64 rand_u64(u64 *state) {
+    u64 r = next_rand(state);
+    switch (r & 7) {
+        case 0: return _cyan_pow10_u64[(r >> 3) % 20] - ((r >> 8) & 1);  /* 10^k or 10^k - 1 */
+        case 1: return UINT64_MAX - ((r >> 3) & 3);
+        default: return next_rand(state) >> ((r >> 3) & 63);
+    }
+}
+
+/* Start from an empty, inline or heap string so every capacity path runs */
+static String prefixed(u64 *state, char *expect) {
+    static const char *prefixes[] = { "", "x=", "a prefix long enough to be stored on the heap: " };
+    const char *pre = prefixes[next_rand(state) % 3];
+    strcpy(expect, pre);
+    return string_from(pre);
+}
+
+/*============================================================================
+ * Property 106: Integer formatting matches printf
+ * For any u64 and i64 (including 0, powers of ten, INT64_MIN and
+ * UINT64_MAX), string_append_u64 / _i64 / _hex and cyan_fmt_u64 / _i64 /
+ * _hex produce the same text as %llu, %lld and %llx
+ *============================================================================*/
+
+static enum theft_trial_res prop_int_matches_printf(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u64 state = (u64)*val_ptr * 2654435761u + 1;
+    char expect[128], buf[CYAN_FMT_INT_MAX];
+    bool ok = true;
+
+    for (int round = 0; round < 50 && ok; round++) {
+        u64 u = round == 0 ? 0 : rand_u64(&state);
+        i64 i = round == 1 ? INT64_MIN : (i64)rand_u64(&state);
+        char ref_u[32], ref_i[32], ref_x[32];
+        snprintf(ref_u, sizeof(ref_u), "%llu", (unsigned long long)u);
+        snprintf(ref_i, sizeof(ref_i), "%lld", (long long)i);
+        snprintf(ref_x, sizeof(ref_x), "%llx", (unsigned long long)u);
+
+        size_t n = cyan_fmt_u64(buf, u);
+        if (n != strlen(ref_u) || memcmp(buf, ref_u, n) != 0) ok = false;
+        n = cyan_fmt_i64(buf, i);
+        if (n != strlen(ref_i) || memcmp(buf, ref_i, n) != 0) ok = false;
+        n = cyan_fmt_hex(buf, u);
+        if (n != strlen(ref_x) || memcmp(buf, ref_x, n) != 0) ok = false;
+
+        String s = prefixed(&state, expect);
+        string_append_u64(&s, u);
+        string_push(&s, ' ');
+        string_append_i64(&s, i);
+        string_push(&s, ' ');
+        string_append_hex(&s, u);
+        strcat(expect, ref_u);
+        strcat(expect, " ");
+        strcat(expect, ref_i);
+        strcat(expect, " ");
+        strcat(expect, ref_x);
+        if (strcmp(string_cstr(&s), expect) != 0 || string_len(&s) != strlen(expect)) ok = false;
+        string_free(&s);
+    }
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 107: Double formatting is the shortest round-trip decimal
+ * For any finite double (random bits, integers, short decimals and the
+ * extremes), the output reads back as the same double, has as many
+ * significant digits as the shortest %.*e that reads back, uses an
+ * exponent exactly when %.17g does, and fits CYAN_FMT_F64_MAX
+ *============================================================================*/
+
+static int shortest_digits(double v) {
+    char b[40];
+    for (int p = 1; p < 17; p++) {
+        snprintf(b, sizeof(b), "%.*e", p - 1, v);
+        if (strtod(b, NULL) == v) return p;
+    }
+    return 17;
+}
+
+static int significant_digits(const char *text) {
+    char digits[40];
+    int n = 0;
+    bool leading = true;
+    for (const char *p = text; *p && *p != 'e'; p++) {
+        if (*p < '0' || *p > '9' || (leading && *p == '0')) continue;
+        leading = false;
+        digits[n++] = *p;
+    }
+    while (n > 1 && digits[n - 1] == '0') n--;
+    return n == 0 ? 1 : n;
+}
+
+static double rand_double(u64 *state) {
+    static const double edges[] = {
+        0.0, -0.0, 5e-324, 2.2250738585072014e-308, 1.7976931348623157e308,
+        0.1, 0.3, 1e21, 1e22, 1e23, 9007199254740993.0, 1e16, 1e17, 0.0001, 0.00001
+    };
+    u64 r = next_rand(state);
+    double v;
+    switch (r & 3) {
+        case 0: return edges[(r >> 2) % (sizeof(edges) / sizeof(edges[0]))];
+        case 1: return (double)(i64)next_rand(state) / (double)(1 << ((r >> 2) & 15));
+        case 2: return (double)((r >> 2) % 100000) / pow(10, (double)((r >> 20) % 12));
+        default:
+            r = next_rand(state);
+            memcpy(&v, &r, sizeof(v));
+            return v;
+    }
+}
+
+static enum theft_trial_res prop_f64_shortest_roundtrip(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u64 state = (u64)*val_ptr * 2654435761u + 1;
+    char expect[128], buf[CYAN_FMT_F64_MAX + 1];
+    bool ok = true;
+
+    for (int round = 0; round < 200 && ok; round++) {
+        double v = rand_double(&state);
+        if (isnan(v) || isinf(v)) continue;
+
+        size_t n = cyan_fmt_f64(buf, v);
+        buf[n] = '\0';
+        double back = strtod(buf, NULL);
+        char g17[40];
+        snprintf(g17, sizeof(g17), "%.17g", v);
+        if (n > CYAN_FMT_F64_MAX || back != v || signbit(back) != signbit(v) ||
+            significant_digits(buf) != shortest_digits(v) ||
+            (strchr(buf, 'e') != NULL) != (strchr(g17, 'e') != NULL)) {
+            ok = false;
+        }
+
+        String s = prefixed(&state, expect);
+        string_append_f64(&s, v);
+        strcat(expect, buf);
+        if (strcmp(string_cstr(&s), expect) != 0 || string_len(&s) != strlen(expect)) ok = false;
+        string_free(&s);
+    }
+
+    /* Special values */
+    const double specials[] = { NAN, INFINITY, -INFINITY };
+    const char *names[] = { "nan", "inf", "-inf" };
+    for (int i = 0; i < 3; i++) {
+        size_t n = cyan_fmt_f64(buf, specials[i]);
+        if (n != strlen(names[i]) || memcmp(buf, names[i], n) != 0) ok = false;
+    }
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 108: string_fmt and string_format match snprintf
+ * For any mix of text, chars, bools, integers of every width, floats,
+ * Strings, slices and hex values, string_fmt appends what snprintf prints
+ * for the same values (floats as their shortest round-trip digits), and
+ * string_format / string_formatted produce snprintf's output for lengths
+ * on both sides of the spare capacity
+ *============================================================================*/
+
+static enum theft_trial_res prop_fmt_matches_snprintf(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u64 state = (u64)*val_ptr * 2654435761u + 1;
+    static char expect[4096], ref[1024];
+    bool ok = true;
+
+    for (int round = 0; round < 20 && ok; round++) {
+        i64 i = (i64)rand_u64(&state);
+        u64 u = rand_u64(&state);
+        int small = (int)(next_rand(&state) % 2001) - 1000;
+        short sh = (short)next_rand(&state);
+        unsigned char uc = (unsigned char)next_rand(&state);
+        bool flag = next_rand(&state) & 1;
+        char c = (char)('a' + next_rand(&state) % 26);
+        u32 fbits = (u32)next_rand(&state) & 0x7f7fffffu;   /* Finite, positive */
+        float f;
+        memcpy(&f, &fbits, sizeof(f));
+        double d = rand_double(&state);
+        if (isnan(d) || isinf(d)) d = 1.5;
+
+        String word = string_from("path/to/resource");
+        Slice_char part = string_slice(&word, 5, 7);
+
+        String s = prefixed(&state, expect);
+        string_fmt(&s, "i=", i, " u=", u, " small=", small, " sh=", sh, " uc=", uc, " ", flag);
+        string_fmt(&s, " ", c, " w=", &word, " p=", part, " x=", string_fmt_hex(u), " f=", f, " d=", d);
+
+        char fbuf[CYAN_FMT_F64_MAX + 1], dbuf[CYAN_FMT_F64_MAX + 1];
+        fbuf[cyan_fmt_f32(fbuf, f)] = '\0';
+        dbuf[cyan_fmt_f64(dbuf, d)] = '\0';
+        if (strtof(fbuf, NULL) != f) ok = false;
+        snprintf(ref, sizeof(ref), "i=%lld u=%llu small=%d sh=%d uc=%u %s %c w=%s p=%.*s x=%llx f=%s d=%s",
+                 (long long)i, (unsigned long long)u, small, sh, uc, flag ? "true" : "false", c,
+                 string_cstr(&word), (int)part.len, part.data, (unsigned long long)u, fbuf, dbuf);
+        strcat(expect, ref);
+        if (strcmp(string_cstr(&s), expect) != 0 || string_len(&s) != strlen(expect)) ok = false;
+        string_free(&s);
+        string_free(&word);
+
+        /* Lengths around the spare capacity, including exact fits */
+        int width = (int)(next_rand(&state) % 80);
+        s = prefixed(&state, expect);
+        string_format(&s, "%*d|%s", width, small, "tail");
+        snprintf(ref, sizeof(ref), "%*d|%s", width, small, "tail");
+        strcat(expect, ref);
+        if (strcmp(string_cstr(&s), expect) != 0 || string_len(&s) != strlen(expect)) ok = false;
+        string_free(&s);
+
+        String fresh = string_formatted("%*lld", width, (long long)i);
+        snprintf(ref, sizeof(ref), "%*lld", width, (long long)i);
+        if (strcmp(string_cstr(&fresh), ref) != 0 || string_len(&fresh) != strlen(ref) ||
+            string_is_inline(&fresh) != (strlen(ref) <= CYAN_STRING_INLINE_CAP)) {
+            ok = false;
+        }
+        string_free(&fresh);
+    }
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} StringNumTest;
+
+static StringNumTest string_num_tests[] = {
+    {
+        "Property 106: Integer formatting matches printf",
+        prop_int_matches_printf,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 107: Double formatting is the shortest round-trip decimal",
+        prop_f64_shortest_roundtrip,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 108: string_fmt and string_format match snprintf",
+        prop_fmt_matches_snprintf,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_STRING_NUM_TESTS (sizeof(string_num_tests) / sizeof(string_num_tests[0]))
+
+int run_string_num_tests(theft_seed seed) {
+    int failures = 0;
+
+    printf("\nString Number Formatting Tests:\n");
+
+    for (size_t i = 0; i < NUM_STRING_NUM_TESTS; i++) {
+        StringNumTest *test = &string_num_tests[i];
+
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+
+        enum theft_run_res res = theft_run(&config);
+
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+
+    return failures;
+}
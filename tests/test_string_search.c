@@ -0,0 +1,242 @@
+/**
+ * @file test_string_search.c
+ * @brief Property-based tests for substring search and splitting
+ *
+ * Tests validate correctness properties:
+ * - Property 102: Search results match a naive scan
+ * - Property 103: Split pieces rejoin to the input
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "theft.h"
+#include "test_util.h"
+#include <cyan/string.h>
+#include <cyan/string_search.h>
+
+#define MAX_HAY 400
+
+/* Fill buf with n bytes over a small alphabet so needles recur */
+static void fill_text(u32 *state, char *buf, size_t n, u32 alphabet) {
+    for (size_t i = 0; i < n; i++) buf[i] = (char)('a' + next_rand(state) % alphabet);
+    buf[n] = '\0';
+}
+
+/* Reference implementations */
+static size_t naive_find(const char *h, size_t n, const char *nd, size_t m) {
+    for (size_t i = 0; i + m <= n; i++) {
+        if (memcmp(h + i, nd, m) == 0) return i;
+    }
+    return SIZE_MAX;
+}
+
+static size_t naive_rfind(const char *h, size_t n, const char *nd, size_t m) {
+    if (m > n) return SIZE_MAX;
+    for (size_t i = n - m + 1; i-- > 0;) {
+        if (memcmp(h + i, nd, m) == 0) return i;
+    }
+    return SIZE_MAX;
+}
+
+static size_t naive_count(const char *h, size_t n, const char *nd, size_t m) {
+    if (m == 0) return n + 1;
+    size_t count = 0;
+    for (size_t i = 0; i + m <= n;) {
+        if (memcmp(h + i, nd, m) == 0) {
+            count++;
+            i += m;
+        } else {
+            i++;
+        }
+    }
+    return count;
+}
+
+static bool opt_is(Option_size_t o, size_t expect) {
+    return expect == SIZE_MAX ? !o.has_value : (o.has_value && o.value == expect);
+}
+
+/*============================================================================
+ * Property 102: Search results match a naive scan
+ * For any haystack and needle (empty, taken from the haystack, or random,
+ * with lengths on both sides of the SIMD block sizes), find, rfind,
+ * contains, count, find_byte and rfind_byte on slices and Strings agree
+ * with a byte-by-byte reference
+ *============================================================================*/
+
+static enum theft_trial_res prop_search_matches_naive(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u32 state = (u32)(*val_ptr);
+    static char hay[MAX_HAY + 1], nd[MAX_HAY + 1];
+    bool ok = true;
+
+    for (int round = 0; round < 20 && ok; round++) {
+        u32 alphabet = 2 + next_rand(&state) % 4;
+        size_t n = next_rand(&state) % MAX_HAY;
+        fill_text(&state, hay, n, alphabet);
+
+        size_t m = next_rand(&state) % 8 == 0 ? 0 : 1 + next_rand(&state) % 40;
+        if (m > 0 && n > 0 && next_rand(&state) % 2 == 0) {
+            size_t from = next_rand(&state) % n;
+            if (m > n - from) m = n - from;
+            memcpy(nd, hay + from, m);
+            nd[m] = '\0';
+        } else {
+            fill_text(&state, nd, m, alphabet);
+        }
+
+        Slice_char h = slice_char_from_array(hay, n);
+        Slice_char needle = slice_char_from_array(nd, m);
+        size_t first = naive_find(hay, n, nd, m);
+        size_t last = naive_rfind(hay, n, nd, m);
+        size_t count = naive_count(hay, n, nd, m);
+
+        if (!opt_is(slice_char_find(h, needle), first) ||
+            !opt_is(slice_char_rfind(h, needle), last) ||
+            slice_char_contains(h, needle) != (first != SIZE_MAX) ||
+            slice_char_count(h, needle) != count) {
+            ok = false;
+        }
+
+        char c = (char)('a' + next_rand(&state) % alphabet);
+        if (!opt_is(slice_char_find_byte(h, c), naive_find(hay, n, &c, 1)) ||
+            !opt_is(slice_char_rfind_byte(h, c), naive_rfind(hay, n, &c, 1))) {
+            ok = false;
+        }
+
+        String s = string_from(hay);
+        if (!opt_is(string_find(&s, nd), first) ||
+            !opt_is(string_rfind(&s, nd), last) ||
+            string_contains(&s, nd) != (first != SIZE_MAX) ||
+            string_count(&s, nd) != count ||
+            !opt_is(string_find_byte(&s, c), naive_find(hay, n, &c, 1))) {
+            ok = false;
+        }
+        string_free(&s);
+    }
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 103: Split pieces rejoin to the input
+ * For any input and non-empty separator, the split pieces view the input's
+ * own bytes, contain no separator, number count(sep) + 1, and joining them
+ * with the separator reproduces the input
+ *============================================================================*/
+
+static enum theft_trial_res prop_split_rejoins(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u32 state = (u32)(*val_ptr);
+    static char text[MAX_HAY + 1];
+    char sep[4];
+    bool ok = true;
+
+    for (int round = 0; round < 20 && ok; round++) {
+        u32 alphabet = 2 + next_rand(&state) % 3;
+        size_t n = next_rand(&state) % MAX_HAY;
+        fill_text(&state, text, n, alphabet);
+        size_t m = 1 + next_rand(&state) % 3;
+        fill_text(&state, sep, m, alphabet);
+
+        String s = string_from(text);
+        SplitIter it = string_split_iter(&s, sep);
+        String joined = string_new();
+        Slice_char piece;
+        size_t pieces = 0;
+        while (split_iter_next(&it, &piece)) {
+            if (piece.len > 0 &&
+                (piece.data < string_cstr(&s) || piece.data + piece.len > string_cstr(&s) + n)) {
+                ok = false;
+            }
+            if (naive_find(piece.data, piece.len, sep, m) != SIZE_MAX) ok = false;
+            if (pieces++ > 0) string_append(&joined, sep);
+            for (size_t i = 0; i < piece.len; i++) string_push(&joined, piece.data[i]);
+        }
+        if (split_iter_next(&it, &piece)) ok = false;   /* Stays exhausted */
+
+        if (pieces != naive_count(text, n, sep, m) + 1 ||
+            string_len(&joined) != n ||
+            memcmp(string_cstr(&joined), text, n) != 0) {
+            ok = false;
+        }
+
+        /* An empty separator yields the input unsplit */
+        SplitIter whole = slice_char_split_iter(string_as_slice(&s), slice_char_from_array("", 0));
+        if (!split_iter_next(&whole, &piece) || piece.len != n || split_iter_next(&whole, &piece)) {
+            ok = false;
+        }
+
+        string_free(&joined);
+        string_free(&s);
+    }
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} StringSearchTest;
+
+static StringSearchTest string_search_tests[] = {
+    {
+        "Property 102: Search results match a naive scan",
+        prop_search_matches_naive,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 103: Split pieces rejoin to the input",
+        prop_split_rejoins,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_STRING_SEARCH_TESTS (sizeof(string_search_tests) / sizeof(string_search_tests[0]))
+
+int run_string_search_tests(theft_seed seed) {
+    int failures = 0;
+
+    printf("\nString Search Tests:\n");
+
+    for (size_t i = 0; i < NUM_STRING_SEARCH_TESTS; i++) {
+        StringSearchTest *test = &string_search_tests[i];
+
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+
+        enum theft_run_res res = theft_run(&config);
+
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+
+    return failures;
+}
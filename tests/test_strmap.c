@@ -0,0 +1,297 @@
+/**
+ * @file test_strmap.c
+ * @brief Property-based tests for the string-keyed StrMap type
+ * 
+ * Tests validate correctness properties:
+ * - Property 70: StrMap keys compare by contents, not by pointer
+ * - Property 71: StrMap remove then get returns None
+ * - Property 72: StrMap works through the MAP_* vtable macros
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "theft.h"
+#include <cyan/option.h>
+#include <cyan/strmap.h>
+
+/* Define Option and StrMap types for testing */
+OPTION_DEFINE(int);
+STRMAP_DEFINE(int);
+
+/* Write a key derived from a seed and index into buf */
+static size_t make_key(char *buf, size_t size, int seed, int i) {
+    /* Vary the length so keys cross the 16- and 48-byte hash paths */
+    int pad = (int)(((unsigned)seed + (unsigned)i) % 60u);
+    return (size_t)snprintf(buf, size, "key-%d-%d-%.*s", seed, i, pad,
+                            "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+}
+
+/*============================================================================
+ * Property 70: StrMap keys compare by contents, not by pointer
+ * For any keys written into a reused buffer, each key is found by C string,
+ * String and Slice_char lookups built from fresh copies of its text
+ *============================================================================*/
+
+static enum theft_trial_res prop_strmap_contents(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    int seed = (int)(*val_ptr);
+    
+    StrMap_int m = strmap_int_new();
+    char buf[128];
+    
+    /* Insert through a single reused buffer */
+    for (int i = 0; i < 100; i++) {
+        make_key(buf, sizeof(buf), seed, i);
+        strmap_int_insert(&m, buf, i);
+    }
+    
+    if (strmap_int_len(&m) != 100) {
+        strmap_int_free(&m);
+        return THEFT_TRIAL_FAIL;
+    }
+    
+    for (int i = 0; i < 100; i++) {
+        size_t len = make_key(buf, sizeof(buf), seed, i);
+        
+        Option_int by_cstr = strmap_int_get(&m, buf);
+        
+        String s = string_from(buf);
+        Option_int by_str = strmap_int_get_str(&m, &s);
+        string_free(&s);
+        
+        /* Slice over a larger buffer, so the key is not null-terminated */
+        char wide[160];
+        memcpy(wide, buf, len);
+        memcpy(wide + len, "TRAILING", 8);
+        Option_int by_slice = strmap_int_get_slice(&m, slice_char_from_array(wide, len));
+        
+        if (!is_some(by_cstr) || !is_some(by_str) || !is_some(by_slice) ||
+            unwrap(by_cstr) != i || unwrap(by_str) != i || unwrap(by_slice) != i) {
+            strmap_int_free(&m);
+            return THEFT_TRIAL_FAIL;
+        }
+        
+        /* A key that is a strict prefix must not match */
+        if (strmap_int_contains_slice(&m, slice_char_from_array(buf, len - 1))) {
+            strmap_int_free(&m);
+            return THEFT_TRIAL_FAIL;
+        }
+    }
+    
+    /* Overwriting by contents keeps a single entry */
+    make_key(buf, sizeof(buf), seed, 7);
+    strmap_int_insert(&m, buf, -1);
+    if (strmap_int_len(&m) != 100 || unwrap(strmap_int_get(&m, buf)) != -1) {
+        strmap_int_free(&m);
+        return THEFT_TRIAL_FAIL;
+    }
+    
+    /* The empty string is a valid key */
+    strmap_int_insert(&m, "", 12345);
+    if (!strmap_int_contains(&m, "") || unwrap(strmap_int_get(&m, "")) != 12345) {
+        strmap_int_free(&m);
+        return THEFT_TRIAL_FAIL;
+    }
+    
+    strmap_int_free(&m);
+    return THEFT_TRIAL_PASS;
+}
+
+/*============================================================================
+ * Property 71: StrMap remove then get returns None
+ * For any keys, after repeated remove/insert cycles, removed keys return
+ * None and all remaining keys keep their values, and updating entries
+ * through their own key bytes at the resize threshold is safe
+ *============================================================================*/
+
+static enum theft_trial_res prop_strmap_remove(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    int seed = (int)(*val_ptr);
+    
+    StrMap_int m = strmap_int_new();
+    char buf[128];
+    
+    for (int i = 0; i < 50; i++) {
+        make_key(buf, sizeof(buf), seed, i);
+        strmap_int_insert(&m, buf, i);
+    }
+    
+    /* Churn: remove and re-add so tombstones and dead key bytes pile up */
+    for (int round = 0; round < 20; round++) {
+        for (int i = 0; i < 50; i += 2) {
+            make_key(buf, sizeof(buf), seed, i);
+            Option_int removed = strmap_int_remove(&m, buf);
+            if (!is_some(removed) || unwrap(removed) != i + round * 1000) {
+                strmap_int_free(&m);
+                return THEFT_TRIAL_FAIL;
+            }
+            if (strmap_int_contains(&m, buf)) {
+                strmap_int_free(&m);
+                return THEFT_TRIAL_FAIL;
+            }
+            strmap_int_insert(&m, buf, i + (round + 1) * 1000);
+        }
+    }
+    
+    for (int i = 0; i < 50; i++) {
+        make_key(buf, sizeof(buf), seed, i);
+        int expected = (i % 2 == 0) ? i + 20 * 1000 : i;
+        Option_int opt = strmap_int_get(&m, buf);
+        if (!is_some(opt) || unwrap(opt) != expected) {
+            strmap_int_free(&m);
+            return THEFT_TRIAL_FAIL;
+        }
+    }
+    
+    /* Iteration sees every live key exactly once */
+    size_t count = 0;
+    StrMapIter_int it = strmap_int_iter(&m);
+    Option_StrMapEntry_int e;
+    while ((e = strmap_int_iter_next(&it)).has_value) {
+        if (strlen(e.value.key) != e.value.key_len ||
+            unwrap(strmap_int_get(&m, e.value.key)) != e.value.value) {
+            strmap_int_free(&m);
+            return THEFT_TRIAL_FAIL;
+        }
+        count++;
+    }
+    
+    if (count != 50 || is_some(strmap_int_remove(&m, "missing"))) {
+        strmap_int_free(&m);
+        return THEFT_TRIAL_FAIL;
+    }
+    strmap_int_free(&m);
+    
+    /* At the resize threshold, updating through the map's own key bytes
+     * neither resizes nor reads freed memory */
+    m = strmap_int_new();
+    for (int i = 0; m.capacity == 0 ||
+                    (m.len + m.tombstones + 1) * 100 / m.capacity <= CYAN_HASHMAP_LOAD_FACTOR; i++) {
+        make_key(buf, sizeof(buf), seed, i);
+        strmap_int_insert(&m, buf, i);
+    }
+    size_t cap = m.capacity, len = m.len;
+    it = strmap_int_iter(&m);
+    while ((e = strmap_int_iter_next(&it)).has_value) {
+        strmap_int_insert_slice(&m, slice_char_from_array(e.value.key, e.value.key_len), e.value.value + 1);
+    }
+    bool ok = m.capacity == cap && m.len == len;
+    for (int i = 0; i < (int)len && ok; i++) {
+        make_key(buf, sizeof(buf), seed, i);
+        Option_int opt = strmap_int_get(&m, buf);
+        if (!is_some(opt) || unwrap(opt) != i + 1) ok = false;
+    }
+    
+    strmap_int_free(&m);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 72: StrMap works through the MAP_* vtable macros
+ * For any key, MAP_INSERT/MAP_GET/MAP_CONTAINS/MAP_REMOVE/MAP_LEN behave
+ * the same as the direct strmap functions
+ *============================================================================*/
+
+static enum theft_trial_res prop_strmap_vtable(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    int seed = (int)(*val_ptr);
+    
+    StrMap_int m = strmap_int_new();
+    char buf[128];
+    make_key(buf, sizeof(buf), seed, 0);
+    
+    MAP_INSERT(m, buf, seed);
+    Option_int got = MAP_GET(m, buf);
+    if (!is_some(got) || unwrap(got) != seed || !MAP_CONTAINS(m, buf) || MAP_LEN(m) != 1) {
+        MAP_FREE(m);
+        return THEFT_TRIAL_FAIL;
+    }
+    
+    Option_int removed = MAP_REMOVE(m, buf);
+    if (!is_some(removed) || unwrap(removed) != seed || MAP_LEN(m) != 0) {
+        MAP_FREE(m);
+        return THEFT_TRIAL_FAIL;
+    }
+    
+    MAP_FREE(m);
+    if (m.buckets != NULL || m.arena.head != NULL) {
+        return THEFT_TRIAL_FAIL;
+    }
+    
+    return THEFT_TRIAL_PASS;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+/* Minimum iterations for property tests */
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} StrMapTest;
+
+static StrMapTest strmap_tests[] = {
+    {
+        "Property 70: StrMap keys compare by contents, not by pointer",
+        prop_strmap_contents,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 71: StrMap remove then get returns None",
+        prop_strmap_remove,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 72: StrMap works through the MAP_* vtable macros",
+        prop_strmap_vtable,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_STRMAP_TESTS (sizeof(strmap_tests) / sizeof(strmap_tests[0]))
+
+int run_strmap_tests(theft_seed seed) {
+    int failures = 0;
+    
+    printf("\nStrMap Type Tests:\n");
+    
+    for (size_t i = 0; i < NUM_STRMAP_TESTS; i++) {
+        StrMapTest *test = &strmap_tests[i];
+        
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+        
+        enum theft_run_res res = theft_run(&config);
+        
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+    
+    return failures;
+}
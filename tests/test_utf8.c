@@ -0,0 +1,354 @@
+/**
+ * @file test_utf8.c
+ * @brief Property-based tests for UTF-8 validation, counting and transcoding
+ *
+ * Tests validate correctness properties:
+ * - Property 109: Validation, counting and iteration agree with a reference decoder
+ * - Property 110: Transcoding through UTF-16 and UTF-32 round-trips and rejects invalid input
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "theft.h"
+#include "test_util.h"
+#include <cyan/utf8.h>
+
+#define MAX_BYTES 600
+#define MAX_CPS 200
+
+/* Random valid code point, spread over all encoded lengths */
+static u32 random_cp(u32 *state) {
+    switch (next_rand(state) % 5) {
+        case 0: return 0x20 + next_rand(state) % 0x5F;
+        case 1: return 0x80 + next_rand(state) % 0x780;
+        case 2: {
+            u32 cp = 0x800 + next_rand(state) % 0xF800;
+            return cp >= 0xD800 && cp <= 0xDFFF ? cp - 0x800 : cp;
+        }
+        case 3: return 0x10000 + next_rand(state) % 0x100000;
+        default: return next_rand(state) % 2 ? 0x10FFFF : 0xFFFF;
+    }
+}
+
+/* Encode independently of the header; returns the length */
+static size_t ref_encode(u32 cp, unsigned char *out) {
+    if (cp < 0x80) {
+        out[0] = (unsigned char)cp;
+        return 1;
+    }
+    size_t len = cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+    static const unsigned char leads[5] = { 0, 0, 0xC0, 0xE0, 0xF0 };
+    for (size_t k = len - 1; k > 0; k--) {
+        out[k] = (unsigned char)(0x80 | (cp & 0x3F));
+        cp >>= 6;
+    }
+    out[0] = (unsigned char)(leads[len] | cp);
+    return len;
+}
+
+/* Reference validator: decode by bit pattern, then range-check the value */
+static bool ref_valid(const unsigned char *p, size_t n, size_t *cps) {
+    size_t i = 0;
+    *cps = 0;
+    while (i < n) {
+        unsigned b = p[i];
+        size_t len;
+        u32 cp, min;
+        if (b < 0x80) {
+            len = 1;
+            cp = b;
+            min = 0;
+        } else if ((b & 0xE0) == 0xC0) {
+            len = 2;
+            cp = b & 0x1F;
+            min = 0x80;
+        } else if ((b & 0xF0) == 0xE0) {
+            len = 3;
+            cp = b & 0x0F;
+            min = 0x800;
+        } else if ((b & 0xF8) == 0xF0) {
+            len = 4;
+            cp = b & 0x07;
+            min = 0x10000;
+        } else {
+            return false;
+        }
+        if (i + len > n) return false;
+        for (size_t k = 1; k < len; k++) {
+            if ((p[i + k] & 0xC0) != 0x80) return false;
+            cp = (cp << 6) | (p[i + k] & 0x3F);
+        }
+        if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return false;
+        i += len;
+        (*cps)++;
+    }
+    return true;
+}
+
+/* Build text from ASCII runs and random code points, then maybe corrupt it */
+static size_t make_text(u32 *state, unsigned char *buf, u32 *cps, size_t *ncps) {
+    static const unsigned char bad[] = { 0x80, 0xBF, 0xC0, 0xC1, 0xC2, 0xE0, 0xED, 0xEF,
+                                         0xF0, 0xF4, 0xF5, 0xF8, 0xFF, 0x9F, 0xA0, 0x8F };
+    size_t n = 0;
+    *ncps = 0;
+    size_t target = next_rand(state) % MAX_BYTES;
+    while (n + 4 <= target && *ncps < MAX_CPS) {
+        if (next_rand(state) % 4 == 0) {
+            /* A run of ASCII long enough to cover whole SIMD blocks */
+            size_t run = next_rand(state) % 70;
+            for (size_t k = 0; k < run && n + 4 <= target && *ncps < MAX_CPS; k++) {
+                cps[(*ncps)++] = 'a' + next_rand(state) % 26;
+                buf[n++] = (unsigned char)cps[*ncps - 1];
+            }
+        } else {
+            cps[*ncps] = random_cp(state);
+            n += ref_encode(cps[(*ncps)++], buf + n);
+        }
+    }
+    if (n > 0 && next_rand(state) % 2) {
+        size_t edits = 1 + next_rand(state) % 3;
+        for (size_t e = 0; e < edits; e++) {
+            size_t at = next_rand(state) % n;
+            if (next_rand(state) % 4 == 0) {
+                n = at;   /* Truncate, possibly mid-sequence */
+                if (n == 0) break;
+            } else {
+                buf[at] = next_rand(state) % 4 ? bad[next_rand(state) % sizeof(bad)]
+                                               : (unsigned char)(1 + next_rand(state) % 255);
+            }
+        }
+        *ncps = SIZE_MAX;   /* Code points no longer known */
+    }
+    return n;
+}
+
+/*============================================================================
+ * Property 109: Validation, counting and iteration agree with a reference decoder
+ * For any text built from valid code points and then possibly corrupted
+ * (stray continuations, overlongs, surrogates, out-of-range leads,
+ * truncation), validate matches a reference decoder on the scalar and
+ * SIMD paths at every start offset, count matches the reference count,
+ * and the iterator yields the original code points for valid text and
+ * U+FFFD for each maximal invalid subpart otherwise
+ *============================================================================*/
+
+static enum theft_trial_res prop_utf8_validate(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u32 state = (u32)(*val_ptr);
+    static unsigned char buf[MAX_BYTES + 64];
+    static u32 cps[MAX_BYTES];
+    bool ok = true;
+
+    size_t ncps;
+    size_t n = make_text(&state, buf, cps, &ncps);
+    Slice_char all = slice_char_from_array((const char *)buf, n);
+
+    /* Every suffix moves block boundaries across the sequences */
+    for (size_t start = 0; start < n || start == 0; start++) {
+        const unsigned char *p = buf + start;
+        size_t len = n - start;
+        size_t expect_cps;
+        bool expect = ref_valid(p, len, &expect_cps);
+        Slice_char s = slice_char_from_array((const char *)p, len);
+        if (slice_char_utf8_validate(s) != expect || _cyan_utf8_validate_scalar(p, len) != expect) ok = false;
+#if _CYAN_STR_HAS_X86_SIMD
+        if (__builtin_cpu_supports("avx2") && _cyan_utf8_validate_avx2(p, len) != expect) ok = false;
+#endif
+        if (expect && slice_char_utf8_count(s) != expect_cps) ok = false;
+        if (!ok || start > 40) break;
+    }
+
+    /* String entry points see the same bytes; no generated byte is zero */
+    buf[n] = '\0';
+    String str = string_from((const char *)buf);
+    if (string_len(&str) != all.len) ok = false;
+    size_t ref_cps;
+    bool valid = ref_valid(buf, n, &ref_cps);
+    if (string_utf8_validate(&str) != valid) ok = false;
+    if (valid && string_utf8_count(&str) != ref_cps) ok = false;
+    if (ncps != SIZE_MAX && (!valid || ref_cps != ncps)) ok = false;
+
+    /* Iteration: original code points when valid, replacements otherwise */
+    Utf8Iter it = string_utf8_iter(&str);
+    u32 cp;
+    size_t k = 0;
+    size_t replaced = 0;
+    while (ok && utf8_iter_next(&it, &cp)) {
+        if (ncps != SIZE_MAX && (k >= ncps || cp != cps[k])) ok = false;
+        if (cp == UTF8_REPLACEMENT) replaced++;
+        if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) ok = false;
+        k++;
+    }
+    if (ok && ncps != SIZE_MAX && k != ncps) ok = false;
+    if (ok && !valid && replaced == 0) ok = false;
+    string_free(&str);
+
+    /* Maximal-subpart replacement on fixed inputs */
+    static const struct {
+        const char *bytes;
+        size_t len;
+        size_t yields;
+    } cases[] = {
+        { "\xE0\x80", 2, 2 },             /* E0 needs A0..BF: two subparts */
+        { "\xF0\x9F\x98", 3, 1 },         /* Truncated 4-byte sequence */
+        { "\xED\xA0\x80", 3, 3 },         /* Surrogate: every byte replaced */
+        { "a\xC3" "b", 3, 3 },            /* Lead followed by ASCII */
+        { "\xF4\x90\x80\x80", 4, 4 },     /* Above U+10FFFF */
+        { "\xE2\x82\xAC", 3, 1 },         /* Euro sign, valid */
+    };
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        Utf8Iter ci = slice_char_utf8_iter(slice_char_from_array(cases[c].bytes, cases[c].len));
+        size_t yields = 0;
+        while (utf8_iter_next(&ci, &cp)) yields++;
+        if (yields != cases[c].yields) ok = false;
+    }
+
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Property 110: Transcoding through UTF-16 and UTF-32 round-trips and rejects invalid input
+ * For any list of code points, appending it as UTF-32 gives the reference
+ * encoding, UTF-8 -> UTF-16 -> UTF-8 and UTF-8 -> UTF-32 reproduce the
+ * input with utf16_len and count giving the exact sizes, and invalid UTF-8,
+ * unpaired surrogates and out-of-range values are rejected with the
+ * string left unchanged
+ *============================================================================*/
+
+static enum theft_trial_res prop_utf8_transcode(struct theft *t, void *arg1) {
+    (void)t;
+    int64_t *val_ptr = (int64_t *)arg1;
+    u32 state = (u32)(*val_ptr);
+    static u32 cps[MAX_CPS];
+    static u32 back32[MAX_CPS];
+    static u16 units[2 * MAX_CPS];
+    static unsigned char ref[4 * MAX_CPS];
+    bool ok = true;
+
+    /* Mostly ASCII in some trials, to cover the block fast paths */
+    size_t n = next_rand(&state) % MAX_CPS;
+    bool ascii_heavy = next_rand(&state) % 2;
+    size_t ref_len = 0;
+    for (size_t i = 0; i < n; i++) {
+        cps[i] = ascii_heavy && next_rand(&state) % 8 ? 0x20 + next_rand(&state) % 0x5F : random_cp(&state);
+        ref_len += ref_encode(cps[i], ref + ref_len);
+    }
+
+    String utf8 = string_from("prefix:");
+    if (!string_append_utf32(&utf8, cps, n)) ok = false;
+    Slice_char body = slice_char_from_array(string_cstr(&utf8) + 7, string_len(&utf8) - 7);
+    if (body.len != ref_len || memcmp(body.data, ref, ref_len) != 0) ok = false;
+    if (!string_utf8_validate(&utf8) || slice_char_utf8_count(body) != n) ok = false;
+
+    /* UTF-8 -> UTF-16 -> UTF-8 */
+    size_t need16 = slice_char_utf16_len(body);
+    Option_size_t w16 = slice_char_utf8_to_utf16(body, units);
+    if (!w16.has_value || w16.value != need16) ok = false;
+    String again = string_new();
+    if (ok && (!string_append_utf16(&again, units, w16.value) ||
+               string_len(&again) != ref_len || memcmp(string_cstr(&again), ref, ref_len) != 0)) {
+        ok = false;
+    }
+
+    /* UTF-8 -> UTF-32 */
+    Option_size_t w32 = slice_char_utf8_to_utf32(body, back32);
+    if (!w32.has_value || w32.value != n || memcmp(back32, cps, n * sizeof(u32)) != 0) ok = false;
+
+    /* Rejections leave the string as it was */
+    size_t before = string_len(&again);
+    u16 lone[3] = { 'x', 0xD83D, 'y' };
+    u16 low_first[2] = { 0xDE00, 0xD83D };
+    u16 cut[1] = { 0xDBFF };
+    u32 surrogate[2] = { 'x', 0xDFFF };
+    u32 too_large[2] = { 'x', 0x110000 };
+    if (string_append_utf16(&again, lone, 3) || string_append_utf16(&again, low_first, 2) ||
+        string_append_utf16(&again, cut, 1) || string_append_utf32(&again, surrogate, 2) ||
+        string_append_utf32(&again, too_large, 2) || string_len(&again) != before ||
+        string_cstr(&again)[before] != '\0') {
+        ok = false;
+    }
+
+    /* Corrupting one byte of multibyte text makes decoding fail */
+    if (ref_len > 0 && ok) {
+        unsigned char broken[4 * MAX_CPS];
+        memcpy(broken, ref, ref_len);
+        broken[next_rand(&state) % ref_len] = 0xFF;
+        Slice_char bs = slice_char_from_array((const char *)broken, ref_len);
+        if (slice_char_utf8_validate(bs) || slice_char_utf8_to_utf16(bs, units).has_value ||
+            slice_char_utf8_to_utf32(bs, back32).has_value) {
+            ok = false;
+        }
+    }
+
+    string_free(&again);
+    string_free(&utf8);
+    return ok ? THEFT_TRIAL_PASS : THEFT_TRIAL_FAIL;
+}
+
+/*============================================================================
+ * Test Registration
+ *============================================================================*/
+
+#define MIN_TEST_TRIALS 100
+
+typedef struct {
+    const char *name;
+    theft_propfun1 *prop;
+    enum theft_builtin_type_info type;
+} Utf8Test;
+
+static Utf8Test utf8_tests[] = {
+    {
+        "Property 109: Validation, counting and iteration agree with a reference decoder",
+        prop_utf8_validate,
+        THEFT_BUILTIN_int64_t
+    },
+    {
+        "Property 110: Transcoding through UTF-16 and UTF-32 round-trips and rejects invalid input",
+        prop_utf8_transcode,
+        THEFT_BUILTIN_int64_t
+    },
+};
+
+#define NUM_UTF8_TESTS (sizeof(utf8_tests) / sizeof(utf8_tests[0]))
+
+int run_utf8_tests(theft_seed seed) {
+    int failures = 0;
+
+    printf("\nUTF-8 Tests:\n");
+
+    for (size_t i = 0; i < NUM_UTF8_TESTS; i++) {
+        Utf8Test *test = &utf8_tests[i];
+
+        struct theft_run_config config = {
+            .name = test->name,
+            .prop1 = test->prop,
+            .type_info = { theft_get_builtin_type_info(test->type) },
+            .trials = MIN_TEST_TRIALS,
+            .seed = seed ? seed : theft_seed_of_time(),
+        };
+
+        enum theft_run_res res = theft_run(&config);
+
+        const char *status;
+        switch (res) {
+            case THEFT_RUN_PASS:
+                status = "\033[32mPASS\033[0m";
+                break;
+            case THEFT_RUN_FAIL:
+                status = "\033[31mFAIL\033[0m";
+                failures++;
+                break;
+            default:
+                status = "\033[31mERROR\033[0m";
+                failures++;
+                break;
+        }
+        printf("  [%s] %s\n", status, test->name);
+    }
+
+    return failures;
+}
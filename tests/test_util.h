@@ -0,0 +1,21 @@
+/**
+ * @file test_util.h
+ * @brief Helpers shared by the property-based test files
+ */
+
+#ifndef CYAN_TEST_UTIL_H
+#define CYAN_TEST_UTIL_H
+
+#include <stdint.h>
+
+/**
+ * @brief Step a simple LCG so each trial is deterministic in its seed
+ * @param state Generator state, seeded from the trial's theft argument
+ * @return Next pseudo-random value (24 bits)
+ */
+static inline uint32_t next_rand(uint32_t *state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+#endif /* CYAN_TEST_UTIL_H */